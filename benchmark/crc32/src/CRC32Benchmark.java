@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.nio.ByteBuffer;
+import java.util.zip.CRC32;
+
+public class CRC32Benchmark {
+    public static final byte[] bytes16 = makeBytes(16);
+    public static final byte[] bytes256 = makeBytes(256);
+    public static final byte[] bytes4096 = makeBytes(4096);
+    public static final ByteBuffer direct4096 = makeDirectBuffer(bytes4096);
+
+    public void timeUpdateByte(int count) {
+        CRC32 crc = new CRC32();
+        for (int i = 0; i < count; ++i) {
+            crc.update(i);
+        }
+    }
+
+    public void timeUpdateBytes16(int count) {
+        $noinline$updateBytes(bytes16, count);
+    }
+
+    public void timeUpdateBytes256(int count) {
+        $noinline$updateBytes(bytes256, count);
+    }
+
+    public void timeUpdateBytes4096(int count) {
+        $noinline$updateBytes(bytes4096, count);
+    }
+
+    public void timeUpdateUnalignedBytes4096(int count) {
+        CRC32 crc = new CRC32();
+        byte[] b = bytes4096;
+        for (int i = 0; i < count; ++i) {
+            crc.update(b, 1, b.length - 3);
+        }
+    }
+
+    public void timeUpdateDirectByteBuffer4096(int count) {
+        CRC32 crc = new CRC32();
+        ByteBuffer buffer = direct4096;
+        for (int i = 0; i < count; ++i) {
+            buffer.rewind();
+            crc.update(buffer);
+        }
+    }
+
+    static void $noinline$updateBytes(byte[] b, int count) {
+        if (doThrow) { throw new Error(); }
+        CRC32 crc = new CRC32();
+        for (int i = 0; i < count; ++i) {
+            crc.update(b, 0, b.length);
+        }
+    }
+
+    private static byte[] makeBytes(int length) {
+        byte[] b = new byte[length];
+        for (int i = 0; i < length; ++i) {
+            b[i] = (byte) (i * 31 + 7);
+        }
+        return b;
+    }
+
+    private static ByteBuffer makeDirectBuffer(byte[] b) {
+        ByteBuffer buffer = ByteBuffer.allocateDirect(b.length);
+        buffer.put(b);
+        buffer.flip();
+        return buffer;
+    }
+
+    public static boolean doThrow = false;
+}
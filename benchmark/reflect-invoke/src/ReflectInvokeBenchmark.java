@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Constructor;
+import java.lang.reflect.Method;
+
+public class ReflectInvokeBenchmark {
+    public static class Target {
+        public Target() {}
+
+        public Target(String s) {}
+
+        public void noArgs() {}
+
+        public static void staticNoArgs() {}
+
+        public Object objectArgs(Object a, Object b) {
+            return a;
+        }
+
+        public String stringArgs(String a, String b) {
+            return a;
+        }
+
+        public int primitiveArgs(int a, long b) {
+            return a;
+        }
+    }
+
+    private static final Method noArgs;
+    private static final Method staticNoArgs;
+    private static final Method objectArgs;
+    private static final Method stringArgs;
+    private static final Method primitiveArgs;
+    private static final Constructor<Target> noArgsConstructor;
+    private static final Constructor<Target> stringConstructor;
+
+    static {
+        try {
+            noArgs = Target.class.getMethod("noArgs");
+            staticNoArgs = Target.class.getMethod("staticNoArgs");
+            objectArgs = Target.class.getMethod("objectArgs", Object.class, Object.class);
+            stringArgs = Target.class.getMethod("stringArgs", String.class, String.class);
+            primitiveArgs = Target.class.getMethod("primitiveArgs", int.class, long.class);
+            noArgsConstructor = Target.class.getConstructor();
+            stringConstructor = Target.class.getConstructor(String.class);
+        } catch (ReflectiveOperationException e) {
+            throw new Error(e);
+        }
+    }
+
+    private final Target target = new Target();
+
+    public void timeInvokeNoArgs(int count) throws Exception {
+        Method m = noArgs;
+        Target t = target;
+        for (int i = 0; i < count; ++i) {
+            m.invoke(t);
+        }
+    }
+
+    public void timeInvokeStaticNoArgs(int count) throws Exception {
+        Method m = staticNoArgs;
+        for (int i = 0; i < count; ++i) {
+            m.invoke(null);
+        }
+    }
+
+    public void timeInvokeObjectArgs(int count) throws Exception {
+        Method m = objectArgs;
+        Target t = target;
+        Object a = "a";
+        Object b = "b";
+        for (int i = 0; i < count; ++i) {
+            m.invoke(t, a, b);
+        }
+    }
+
+    public void timeInvokeStringArgs(int count) throws Exception {
+        Method m = stringArgs;
+        Target t = target;
+        String a = "a";
+        String b = "b";
+        for (int i = 0; i < count; ++i) {
+            m.invoke(t, a, b);
+        }
+    }
+
+    public void timeInvokePrimitiveArgs(int count) throws Exception {
+        Method m = primitiveArgs;
+        Target t = target;
+        Integer a = 42;
+        Long b = 42L;
+        for (int i = 0; i < count; ++i) {
+            m.invoke(t, a, b);
+        }
+    }
+
+    public void timeNewInstanceNoArgs(int count) throws Exception {
+        Constructor<Target> c = noArgsConstructor;
+        for (int i = 0; i < count; ++i) {
+            c.newInstance();
+        }
+    }
+
+    public void timeNewInstanceStringArg(int count) throws Exception {
+        Constructor<Target> c = stringConstructor;
+        String s = "s";
+        for (int i = 0; i < count; ++i) {
+            c.newInstance(s);
+        }
+    }
+}
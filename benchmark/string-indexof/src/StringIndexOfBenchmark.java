@@ -16,6 +16,10 @@
 
 public class StringIndexOfBenchmark {
     public static final String string36 = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // length = 36
+    // Near misses of "needle" followed by the needle itself at the end, length = 1024.
+    public static final String string1024 = repeat("needlx", 169) + "needle0123";
+    public static final String string1024Uncompressed =
+        repeat("needl\u0100", 169) + "needle\u0100012";
 
     public void timeIndexOf0(int count) {
         final char c = '0';
@@ -113,10 +117,84 @@ public class StringIndexOfBenchmark {
         }
     }
 
+    public void timeIndexOfStringFirst(int count) {
+        final String pattern = "012";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern);
+        }
+    }
+
+    public void timeIndexOfStringMiddle(int count) {
+        final String pattern = "HIJ";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern);
+        }
+    }
+
+    public void timeIndexOfStringLast(int count) {
+        final String pattern = "XYZ";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern);
+        }
+    }
+
+    public void timeIndexOfStringMissing(int count) {
+        final String pattern = "XY_";
+        String s = string36;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern);
+        }
+    }
+
+    public void timeIndexOfStringLong(int count) {
+        final String pattern = "needle";
+        String s = string1024;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern);
+        }
+    }
+
+    public void timeIndexOfStringLongUncompressed(int count) {
+        final String pattern = "needle\u0100";
+        String s = string1024Uncompressed;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern);
+        }
+    }
+
+    public void timeIndexOfStringAfter(int count) {
+        final String pattern = "needle";
+        String s = string1024;
+        for (int i = 0; i < count; ++i) {
+            $noinline$indexOf(s, pattern, 512);
+        }
+    }
+
+    static int $noinline$indexOf(String s, String pattern) {
+        if (doThrow) { throw new Error(); }
+        return s.indexOf(pattern);
+    }
+
+    static int $noinline$indexOf(String s, String pattern, int fromIndex) {
+        if (doThrow) { throw new Error(); }
+        return s.indexOf(pattern, fromIndex);
+    }
+
     static int $noinline$indexOf(String s, char c) {
         if (doThrow) { throw new Error(); }
         return s.indexOf(c);
     }
 
+    private static String repeat(String s, int times) {
+        StringBuilder sb = new StringBuilder(s.length() * times);
+        for (int i = 0; i < times; ++i) {
+            sb.append(s);
+        }
+        return sb.toString();
+    }
+
     public static boolean doThrow = false;
 }
@@ -80,6 +80,10 @@ CompilerOptions::CompilerOptions()
       initialize_app_image_classes_(false),
       check_profiled_methods_(ProfileMethodsCheck::kNone),
       max_image_block_size_(std::numeric_limits<uint32_t>::max()),
+      image_compression_level_(0u),
+      train_image_zstd_dictionary_(false),
+      compilation_time_budget_ms_(0u),
+      compiled_code_size_budget_(0u),
       passes_to_run_(nullptr) {
 }
 
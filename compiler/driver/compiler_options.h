@@ -362,6 +362,32 @@ class CompilerOptions final {
     max_image_block_size_ = size;
   }
 
+  uint32_t ImageCompressionLevel() const {
+    return image_compression_level_;
+  }
+
+  bool TrainImageZstdDictionary() const {
+    return train_image_zstd_dictionary_;
+  }
+
+  void SetTrainImageZstdDictionary(bool train) {
+    train_image_zstd_dictionary_ = train;
+  }
+
+  // Wall-clock budget for method compilation in milliseconds, 0 if unlimited.
+  uint32_t GetCompilationTimeBudgetMs() const {
+    return compilation_time_budget_ms_;
+  }
+
+  // Budget for the size of the compiled code in bytes, 0 if unlimited.
+  uint32_t GetCompiledCodeSizeBudget() const {
+    return compiled_code_size_budget_;
+  }
+
+  bool HasCompilationBudget() const {
+    return compilation_time_budget_ms_ != 0u || compiled_code_size_budget_ != 0u;
+  }
+
   bool InitializeAppImageClasses() const {
     return initialize_app_image_classes_;
   }
@@ -472,6 +498,16 @@ class CompilerOptions final {
   // Maximum solid block size in the generated image.
   uint32_t max_image_block_size_;
 
+  // Compression level for the generated image, 0 for the default of the storage mode.
+  uint32_t image_compression_level_;
+
+  // Whether to compress zstd images with a dictionary trained from the image data.
+  bool train_image_zstd_dictionary_;
+
+  // Budgets for method compilation, see CompileDexFilesWithBudget() in dex2oat.
+  uint32_t compilation_time_budget_ms_;
+  uint32_t compiled_code_size_budget_;
+
   // If not null, specifies optimization passes which will be run instead of defaults.
   // Note that passes_to_run_ is not checked for correctness and providing an incorrect
   // list of passes can lead to unexpected compiler behaviour. This is caused by dependencies
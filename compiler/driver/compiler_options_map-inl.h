@@ -92,6 +92,12 @@ inline bool ReadCompilerOptions(Base& map, CompilerOptions* options, std::string
     options->check_profiled_methods_ = *map.Get(Base::CheckProfiledMethods);
   }
   map.AssignIfExists(Base::MaxImageBlockSize, &options->max_image_block_size_);
+  map.AssignIfExists(Base::ImageCompressionLevel, &options->image_compression_level_);
+  if (map.Exists(Base::ImageZstdDictionary)) {
+    options->train_image_zstd_dictionary_ = true;
+  }
+  map.AssignIfExists(Base::CompilationTimeBudgetMs, &options->compilation_time_budget_ms_);
+  map.AssignIfExists(Base::CompiledCodeSizeBudget, &options->compiled_code_size_budget_);
 
   if (map.Exists(Base::DumpTimings)) {
     options->dump_timings_ = true;
@@ -238,6 +244,28 @@ NO_INLINE void AddCompilerOptionsArgumentParserOptions(Builder& b) {
           .template WithType<unsigned int>()
           .WithHelp("Maximum solid block size for compressed images.")
           .IntoKey(Map::MaxImageBlockSize)
+
+      .Define("--image-compression-level=_")
+          .template WithType<unsigned int>()
+          .WithHelp("Compression level for lz4hc and zstd images. 0 selects the default.")
+          .IntoKey(Map::ImageCompressionLevel)
+
+      .Define("--image-zstd-dictionary")
+          .WithHelp("Compress zstd images with a dictionary trained from the image data.")
+          .IntoKey(Map::ImageZstdDictionary)
+
+      .Define("--compilation-time-budget-ms=_")
+          .template WithType<unsigned int>()
+          .WithHelp("Compile methods in order of profile hotness and stop compiling once the\n"
+                    "given wall-clock time has been spent. The remaining methods are left to\n"
+                    "the interpreter and JIT. The output is not deterministic.")
+          .IntoKey(Map::CompilationTimeBudgetMs)
+
+      .Define("--compiled-code-size-budget=_")
+          .template WithType<unsigned int>()
+          .WithHelp("Compile methods in order of profile hotness and stop compiling once the\n"
+                    "compiled code reaches the given number of bytes.")
+          .IntoKey(Map::CompiledCodeSizeBudget)
       // Obsolete flags
       .Ignore({
         "--num-dex-methods=_",
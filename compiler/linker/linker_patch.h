@@ -301,6 +301,33 @@ class LinkerPatch {
     return baker_custom_value2_;
   }
 
+  // The dex file of the target reference, if any. Used for serializing the patches of
+  // a sharded compilation, where the dex file pointers must be translated.
+  const DexFile* GetTargetDexFile() const {
+    return target_dex_file_;
+  }
+
+  // The type-specific data of the patch, serialized field by field together with
+  // `LiteralOffset()`, `GetType()` and `GetTargetDexFile()`; see `FromRawData()`.
+  uint32_t GetRawData1() const {
+    return cmp1_;
+  }
+
+  uint32_t GetRawData2() const {
+    return pc_insn_offset_;
+  }
+
+  static LinkerPatch FromRawData(size_t literal_offset,
+                                 Type patch_type,
+                                 const DexFile* target_dex_file,
+                                 uint32_t raw_data1,
+                                 uint32_t raw_data2) {
+    LinkerPatch patch(literal_offset, patch_type, target_dex_file);
+    patch.cmp1_ = raw_data1;
+    patch.pc_insn_offset_ = raw_data2;
+    return patch;
+  }
+
  private:
   LinkerPatch(size_t literal_offset, Type patch_type, const DexFile* target_dex_file)
       : target_dex_file_(target_dex_file),
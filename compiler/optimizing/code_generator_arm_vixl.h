@@ -120,6 +120,15 @@ using VIXLInt32Literal = vixl::aarch32::Literal<int32_t>;
 using VIXLUInt32Literal = vixl::aarch32::Literal<uint32_t>;
 
 #define UNIMPLEMENTED_INTRINSIC_LIST_ARM(V)                                \
+  V(ArraysEqualsByte)                                                      \
+  V(ArraysEqualsChar)                                                      \
+  V(ArraysEqualsInt)                                                       \
+  V(ArraysMismatchByte)                                                    \
+  V(ArraysHashCodeByte)                                                    \
+  V(ArraysHashCodeInt)                                                     \
+  V(ArraysFillByte)                                                        \
+  V(ArraysFillInt)                                                         \
+  V(StringHashCode)                                                        \
   V(MathRoundDouble) /* Could be done by changing rounding mode, maybe? */ \
   V(UnsafeCASLong)   /* High register pressure */                          \
   V(SystemArrayCopyChar)                                                   \
@@ -56,6 +56,15 @@ static_assert(kQuietNaN == 0x200);
 static constexpr int32_t kFClassNaNMinValue = 0x100;
 
 #define UNIMPLEMENTED_INTRINSIC_LIST_RISCV64(V) \
+  V(ArraysEqualsByte)                           \
+  V(ArraysEqualsChar)                           \
+  V(ArraysEqualsInt)                            \
+  V(ArraysMismatchByte)                         \
+  V(ArraysHashCodeByte)                         \
+  V(ArraysHashCodeInt)                          \
+  V(ArraysFillByte)                             \
+  V(ArraysFillInt)                              \
+  V(StringHashCode)                             \
   V(SystemArrayCopyByte)                        \
   V(SystemArrayCopyChar)                        \
   V(SystemArrayCopyInt)                         \
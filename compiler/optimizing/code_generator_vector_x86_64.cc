@@ -25,6 +25,11 @@ namespace x86_64 {
 // NOLINT on __ macro to suppress wrong warning/fix (misc-macro-parentheses) from clang-tidy.
 #define __ down_cast<X86_64Assembler*>(GetAssembler())->  // NOLINT
 
+// Whether the vector operation uses the full 256-bit YMM registers (AVX2).
+static bool IsAvx2Vector(HVecOperation* instruction) {
+  return instruction->GetVectorNumberOfBytes() == 32u;
+}
+
 void LocationsBuilderX86_64::VisitVecReplicateScalar(HVecReplicateScalar* instruction) {
   LocationSummary* locations = new (GetGraph()->GetAllocator()) LocationSummary(instruction);
   HInstruction* input = instruction->InputAt(0);
@@ -65,6 +70,41 @@ void InstructionCodeGeneratorX86_64::VisitVecReplicateScalar(HVecReplicateScalar
     return;
   }
 
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastb256(dst, dst);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastw256(dst, dst);
+        break;
+      case DataType::Type::kInt32:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ false);
+        __ vpbroadcastd256(dst, dst);
+        break;
+      case DataType::Type::kInt64:
+        __ movd(dst, locations->InAt(0).AsRegister<CpuRegister>(), /*64-bit*/ true);
+        __ vpbroadcastq256(dst, dst);
+        break;
+      case DataType::Type::kFloat32:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastss256(dst, dst);
+        break;
+      case DataType::Type::kFloat64:
+        DCHECK(locations->InAt(0).Equals(locations->Out()));
+        __ vbroadcastsd256(dst, dst);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -248,6 +288,10 @@ void InstructionCodeGeneratorX86_64::VisitVecCnv(HVecCnv* instruction) {
   DataType::Type from = instruction->GetInputType();
   DataType::Type to = instruction->GetResultType();
   if (from == DataType::Type::kInt32 && to == DataType::Type::kFloat32) {
+    if (IsAvx2Vector(instruction)) {
+      __ vcvtdq2ps256(dst, src);
+      return;
+    }
     DCHECK_EQ(4u, instruction->GetVectorLength());
     __ cvtdq2ps(dst, src);
   } else {
@@ -263,6 +307,40 @@ void InstructionCodeGeneratorX86_64::VisitVecNeg(HVecNeg* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpxor256(dst, dst, dst);
+        __ vpsubb256(dst, dst, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpxor256(dst, dst, dst);
+        __ vpsubw256(dst, dst, src);
+        break;
+      case DataType::Type::kInt32:
+        __ vpxor256(dst, dst, dst);
+        __ vpsubd256(dst, dst, src);
+        break;
+      case DataType::Type::kInt64:
+        __ vpxor256(dst, dst, dst);
+        __ vpsubq256(dst, dst, src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vpxor256(dst, dst, dst);
+        __ vsubps256(dst, dst, src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vpxor256(dst, dst, dst);
+        __ vsubpd256(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -355,6 +433,33 @@ void InstructionCodeGeneratorX86_64::VisitVecNot(HVecNot* instruction) {
   LocationSummary* locations = instruction->GetLocations();
   XmmRegister src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool: {  // special case boolean-not
+        XmmRegister tmp = locations->GetTemp(0).AsFpuRegister<XmmRegister>();
+        __ vpxor256(dst, dst, dst);
+        __ vpcmpeqb256(tmp, tmp, tmp);  // all ones
+        __ vpsubb256(dst, dst, tmp);  // 32 x one
+        __ vpxor256(dst, dst, src);
+        break;
+      }
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+      case DataType::Type::kFloat32:
+      case DataType::Type::kFloat64:
+        __ vpcmpeqb256(dst, dst, dst);  // all ones
+        __ vpxor256(dst, dst, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool: {  // special case boolean-not
       DCHECK_EQ(16u, instruction->GetVectorLength());
@@ -452,6 +557,34 @@ void InstructionCodeGeneratorX86_64::VisitVecAdd(HVecAdd* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpaddb256(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpaddw256(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        __ vpaddd256(dst, other_src, src);
+        break;
+      case DataType::Type::kInt64:
+        __ vpaddq256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vaddps256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vaddpd256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -559,6 +692,34 @@ void InstructionCodeGeneratorX86_64::VisitVecSub(HVecSub* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+        __ vpsubb256(dst, other_src, src);
+        break;
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsubw256(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        __ vpsubd256(dst, other_src, src);
+        break;
+      case DataType::Type::kInt64:
+        __ vpsubq256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vsubps256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vsubpd256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint8:
     case DataType::Type::kInt8:
@@ -639,6 +800,27 @@ void InstructionCodeGeneratorX86_64::VisitVecMul(HVecMul* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpmullw256(dst, other_src, src);
+        break;
+      case DataType::Type::kInt32:
+        __ vpmulld256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat32:
+        __ vmulps256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vmulpd256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -678,6 +860,20 @@ void InstructionCodeGeneratorX86_64::VisitVecDiv(HVecDiv* instruction) {
   XmmRegister other_src = locations->InAt(0).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kFloat32:
+        __ vdivps256(dst, other_src, src);
+        break;
+      case DataType::Type::kFloat64:
+        __ vdivpd256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kFloat32:
       DCHECK_EQ(4u, instruction->GetVectorLength());
@@ -806,6 +1002,25 @@ void InstructionCodeGeneratorX86_64::VisitVecAnd(HVecAnd* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+      case DataType::Type::kFloat32:
+      case DataType::Type::kFloat64:
+        __ vpand256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -847,6 +1062,25 @@ void InstructionCodeGeneratorX86_64::VisitVecAndNot(HVecAndNot* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+      case DataType::Type::kFloat32:
+      case DataType::Type::kFloat64:
+        __ vpandn256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -888,6 +1122,25 @@ void InstructionCodeGeneratorX86_64::VisitVecOr(HVecOr* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+      case DataType::Type::kFloat32:
+      case DataType::Type::kFloat64:
+        __ vpor256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -929,6 +1182,25 @@ void InstructionCodeGeneratorX86_64::VisitVecXor(HVecXor* instruction) {
   XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
   DCHECK(cpu_has_avx || other_src == dst);
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kBool:
+      case DataType::Type::kUint8:
+      case DataType::Type::kInt8:
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+      case DataType::Type::kInt32:
+      case DataType::Type::kInt64:
+      case DataType::Type::kFloat32:
+      case DataType::Type::kFloat64:
+        __ vpxor256(dst, other_src, src);
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -982,6 +1254,24 @@ void InstructionCodeGeneratorX86_64::VisitVecShl(HVecShl* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsllw256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpslld256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        __ vpsllq256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1011,6 +1301,21 @@ void InstructionCodeGeneratorX86_64::VisitVecShr(HVecShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsraw256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpsrad256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1036,6 +1341,24 @@ void InstructionCodeGeneratorX86_64::VisitVecUShr(HVecUShr* instruction) {
   DCHECK(locations->InAt(0).Equals(locations->Out()));
   int32_t value = locations->InAt(1).GetConstant()->AsIntConstant()->GetValue();
   XmmRegister dst = locations->Out().AsFpuRegister<XmmRegister>();
+  if (IsAvx2Vector(instruction)) {
+    switch (instruction->GetPackedType()) {
+      case DataType::Type::kUint16:
+      case DataType::Type::kInt16:
+        __ vpsrlw256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt32:
+        __ vpsrld256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      case DataType::Type::kInt64:
+        __ vpsrlq256(dst, dst, Immediate(static_cast<int8_t>(value)));
+        break;
+      default:
+        LOG(FATAL) << "Unsupported SIMD type: " << instruction->GetPackedType();
+        UNREACHABLE();
+    }
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kUint16:
     case DataType::Type::kInt16:
@@ -1269,6 +1592,11 @@ void InstructionCodeGeneratorX86_64::VisitVecLoad(HVecLoad* instruction) {
   Address address = VecAddress(locations, size, instruction->IsStringCharAt());
   XmmRegister reg = locations->Out().AsFpuRegister<XmmRegister>();
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
+  if (IsAvx2Vector(instruction)) {
+    DCHECK(!instruction->IsStringCharAt());
+    __ vmovdqu256(reg, address);
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kInt16:  // (short) s.charAt(.) can yield HVecLoad/Int16/StringCharAt.
     case DataType::Type::kUint16:
@@ -1328,6 +1656,10 @@ void InstructionCodeGeneratorX86_64::VisitVecStore(HVecStore* instruction) {
   Address address = VecAddress(locations, size, /*is_string_char_at*/ false);
   XmmRegister reg = locations->InAt(2).AsFpuRegister<XmmRegister>();
   bool is_aligned16 = instruction->GetAlignment().IsAlignedAt(16);
+  if (IsAvx2Vector(instruction)) {
+    __ vmovdqu256(address, reg);
+    return;
+  }
   switch (instruction->GetPackedType()) {
     case DataType::Type::kBool:
     case DataType::Type::kUint8:
@@ -49,6 +49,15 @@ static constexpr size_t kRuntimeParameterFpuRegistersLength =
     arraysize(kRuntimeParameterFpuRegisters);
 
 #define UNIMPLEMENTED_INTRINSIC_LIST_X86(V) \
+  V(ArraysEqualsByte)                       \
+  V(ArraysEqualsChar)                       \
+  V(ArraysEqualsInt)                        \
+  V(ArraysMismatchByte)                     \
+  V(ArraysHashCodeByte)                     \
+  V(ArraysHashCodeInt)                      \
+  V(ArraysFillByte)                         \
+  V(ArraysFillInt)                          \
+  V(StringHashCode)                         \
   V(MathRoundDouble)                        \
   V(FloatIsInfinite)                        \
   V(DoubleIsInfinite)                       \
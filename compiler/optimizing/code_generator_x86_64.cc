@@ -1527,7 +1527,7 @@ size_t CodeGeneratorX86_64::RestoreCoreRegister(size_t stack_index, uint32_t reg
 
 size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
   if (GetGraph()->HasSIMD()) {
-    __ movups(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
+    StoreSIMDRegister(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   } else {
     __ movsd(Address(CpuRegister(RSP), stack_index), XmmRegister(reg_id));
   }
@@ -1536,7 +1536,7 @@ size_t CodeGeneratorX86_64::SaveFloatingPointRegister(size_t stack_index, uint32
 
 size_t CodeGeneratorX86_64::RestoreFloatingPointRegister(size_t stack_index, uint32_t reg_id) {
   if (GetGraph()->HasSIMD()) {
-    __ movups(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
+    LoadSIMDRegister(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   } else {
     __ movsd(XmmRegister(reg_id), Address(CpuRegister(RSP), stack_index));
   }
@@ -1561,7 +1561,62 @@ void CodeGeneratorX86_64::InvokeRuntimeWithoutRecordingPcInfo(int32_t entry_poin
   GenerateInvokeRuntime(entry_point_offset);
 }
 
+bool CodeGeneratorX86_64::UsesAvx2Vectors() const {
+  return GetInstructionSetFeatures().HasAVX2();
+}
+
+bool CodeGeneratorX86_64::HasVectorOperationsOf256Bits() const {
+  // The loop optimizer falls back to 128-bit vectors for some loops, so a graph with
+  // SIMD code may not touch the upper halves of the YMM registers at all.
+  if (!GetGraph()->HasSIMD() || !UsesAvx2Vectors()) {
+    return false;
+  }
+  for (HBasicBlock* block : GetGraph()->GetReversePostOrder()) {
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsVecOperation() &&
+          instruction->AsVecOperation()->GetVectorNumberOfBytes() > 2 * kX86_64WordSize) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void CodeGeneratorX86_64::LoadSIMDRegister(XmmRegister dst, const Address& src) {
+  if (has_256bit_vectors_) {
+    __ vmovdqu256(dst, src);
+  } else {
+    __ movups(dst, src);
+  }
+}
+
+void CodeGeneratorX86_64::StoreSIMDRegister(const Address& dst, XmmRegister src) {
+  if (has_256bit_vectors_) {
+    __ vmovdqu256(dst, src);
+  } else {
+    __ movups(dst, src);
+  }
+}
+
+void CodeGeneratorX86_64::MoveSIMDRegister(XmmRegister dst, XmmRegister src) {
+  if (has_256bit_vectors_) {
+    __ vmovaps256(dst, src);
+  } else {
+    __ movaps(dst, src);
+  }
+}
+
+void CodeGeneratorX86_64::MaybeClearUpperSIMDRegisters() {
+  if (has_256bit_vectors_) {
+    __ vzeroupper();
+  }
+}
+
 void CodeGeneratorX86_64::GenerateInvokeRuntime(int32_t entry_point_offset) {
+  // Runtime entrypoints are compiled without VEX.256 code; the SIMD registers are
+  // dead across the call or have been spilled by the slow path.
+  MaybeClearUpperSIMDRegisters();
   __ gs()->call(Address::Absolute(entry_point_offset, /* no_rip= */ true));
 }
 
@@ -1608,6 +1663,7 @@ CodeGeneratorX86_64::CodeGeneratorX86_64(HGraph* graph,
                     stats,
                     ArrayRef<const bool>(detail::kIsIntrinsicUnimplemented)),
       block_labels_(nullptr),
+      has_256bit_vectors_(false),
       location_builder_(graph, this),
       instruction_visitor_(graph, this),
       move_resolver_(graph->GetAllocator(), this),
@@ -1945,6 +2001,7 @@ void CodeGeneratorX86_64::GenerateFrameExit() {
       }
     }
   }
+  MaybeClearUpperSIMDRegisters();
   __ ret();
   __ cfi().RestoreState();
   __ cfi().DefCFAOffset(GetFrameSize());
@@ -6400,15 +6457,16 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsSIMDStackSlot()) {
     if (destination.IsFpuRegister()) {
-      __ movups(destination.AsFpuRegister<XmmRegister>(),
-                Address(CpuRegister(RSP), source.GetStackIndex()));
+      codegen_->LoadSIMDRegister(destination.AsFpuRegister<XmmRegister>(),
+                                 Address(CpuRegister(RSP), source.GetStackIndex()));
     } else {
       DCHECK(destination.IsSIMDStackSlot());
-      size_t high = kX86_64WordSize;
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex()));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex()), CpuRegister(TMP));
-      __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + high));
-      __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + high), CpuRegister(TMP));
+      size_t width = codegen_->GetSIMDRegisterWidth();
+      for (size_t offset = 0; offset < width; offset += kX86_64WordSize) {
+        __ movq(CpuRegister(TMP), Address(CpuRegister(RSP), source.GetStackIndex() + offset));
+        __ movq(Address(CpuRegister(RSP), destination.GetStackIndex() + offset),
+                CpuRegister(TMP));
+      }
     }
   } else if (source.IsConstant()) {
     HConstant* constant = source.GetConstant();
@@ -6456,7 +6514,12 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
     }
   } else if (source.IsFpuRegister()) {
     if (destination.IsFpuRegister()) {
-      __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      if (codegen_->GetGraph()->HasSIMD()) {
+        codegen_->MoveSIMDRegister(destination.AsFpuRegister<XmmRegister>(),
+                                   source.AsFpuRegister<XmmRegister>());
+      } else {
+        __ movaps(destination.AsFpuRegister<XmmRegister>(), source.AsFpuRegister<XmmRegister>());
+      }
     } else if (destination.IsStackSlot()) {
       __ movss(Address(CpuRegister(RSP), destination.GetStackIndex()),
                source.AsFpuRegister<XmmRegister>());
@@ -6465,8 +6528,8 @@ void ParallelMoveResolverX86_64::EmitMove(size_t index) {
                source.AsFpuRegister<XmmRegister>());
     } else {
        DCHECK(destination.IsSIMDStackSlot());
-      __ movups(Address(CpuRegister(RSP), destination.GetStackIndex()),
-                source.AsFpuRegister<XmmRegister>());
+      codegen_->StoreSIMDRegister(Address(CpuRegister(RSP), destination.GetStackIndex()),
+                                  source.AsFpuRegister<XmmRegister>());
     }
   }
 }
@@ -6501,12 +6564,12 @@ void ParallelMoveResolverX86_64::Exchange64(XmmRegister reg, int mem) {
   __ movd(reg, CpuRegister(TMP));
 }
 
-void ParallelMoveResolverX86_64::Exchange128(XmmRegister reg, int mem) {
-  size_t extra_slot = 2 * kX86_64WordSize;
+void ParallelMoveResolverX86_64::ExchangeSIMD(XmmRegister reg, int mem) {
+  size_t extra_slot = codegen_->GetSIMDRegisterWidth();
   __ subq(CpuRegister(RSP), Immediate(extra_slot));
-  __ movups(Address(CpuRegister(RSP), 0), XmmRegister(reg));
-  ExchangeMemory64(0, mem + extra_slot, 2);
-  __ movups(XmmRegister(reg), Address(CpuRegister(RSP), 0));
+  codegen_->StoreSIMDRegister(Address(CpuRegister(RSP), 0), XmmRegister(reg));
+  ExchangeMemory64(0, mem + extra_slot, extra_slot / kX86_64WordSize);
+  codegen_->LoadSIMDRegister(XmmRegister(reg), Address(CpuRegister(RSP), 0));
   __ addq(CpuRegister(RSP), Immediate(extra_slot));
 }
 
@@ -6575,11 +6638,13 @@ void ParallelMoveResolverX86_64::EmitSwap(size_t index) {
   } else if (source.IsDoubleStackSlot() && destination.IsFpuRegister()) {
     Exchange64(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else if (source.IsSIMDStackSlot() && destination.IsSIMDStackSlot()) {
-    ExchangeMemory64(destination.GetStackIndex(), source.GetStackIndex(), 2);
+    ExchangeMemory64(destination.GetStackIndex(),
+                     source.GetStackIndex(),
+                     codegen_->GetSIMDRegisterWidth() / kX86_64WordSize);
   } else if (source.IsFpuRegister() && destination.IsSIMDStackSlot()) {
-    Exchange128(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
+    ExchangeSIMD(source.AsFpuRegister<XmmRegister>(), destination.GetStackIndex());
   } else if (destination.IsFpuRegister() && source.IsSIMDStackSlot()) {
-    Exchange128(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
+    ExchangeSIMD(destination.AsFpuRegister<XmmRegister>(), source.GetStackIndex());
   } else {
     LOG(FATAL) << "Unimplemented swap between " << source << " and " << destination;
   }
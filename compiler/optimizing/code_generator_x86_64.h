@@ -54,9 +54,6 @@ static constexpr size_t kRuntimeParameterFpuRegistersLength =
 static constexpr FloatRegister non_volatile_xmm_regs[] = { XMM12, XMM13, XMM14, XMM15 };
 
 #define UNIMPLEMENTED_INTRINSIC_LIST_X86_64(V) \
-  V(CRC32Update)                               \
-  V(CRC32UpdateBytes)                          \
-  V(CRC32UpdateByteBuffer)                     \
   V(FP16ToFloat)                               \
   V(FP16ToHalf)                                \
   V(FP16Floor)                                 \
@@ -69,8 +66,6 @@ static constexpr FloatRegister non_volatile_xmm_regs[] = { XMM12, XMM13, XMM14,
   V(FP16Compare)                               \
   V(FP16Min)                                   \
   V(FP16Max)                                   \
-  V(StringStringIndexOf)                       \
-  V(StringStringIndexOfAfter)                  \
   V(StringBufferAppend)                        \
   V(StringBufferLength)                        \
   V(StringBufferToString)                      \
@@ -204,7 +199,7 @@ class ParallelMoveResolverX86_64 : public ParallelMoveResolverWithSwap {
   void Exchange64(CpuRegister reg1, CpuRegister reg2);
   void Exchange64(CpuRegister reg, int mem);
   void Exchange64(XmmRegister reg, int mem);
-  void Exchange128(XmmRegister reg, int mem);
+  void ExchangeSIMD(XmmRegister reg, int mem);
   void ExchangeMemory32(int mem1, int mem2);
   void ExchangeMemory64(int mem1, int mem2, int num_of_qwords);
 
@@ -429,9 +424,23 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   }
 
   size_t GetSIMDRegisterWidth() const override {
-    return 2 * kX86_64WordSize;
+    // AVX2 gives us 256-bit YMM registers, otherwise we use 128-bit XMM registers.
+    return UsesAvx2Vectors() ? 4 * kX86_64WordSize : 2 * kX86_64WordSize;
   }
 
+  // Whether vector code may use the full 256-bit YMM registers.
+  bool UsesAvx2Vectors() const;
+
+  // Load, store and move a SIMD register. These use the full 256-bit YMM registers only
+  // in graphs with 256-bit vector operations.
+  void LoadSIMDRegister(XmmRegister dst, const Address& src);
+  void StoreSIMDRegister(const Address& dst, XmmRegister src);
+  void MoveSIMDRegister(XmmRegister dst, XmmRegister src);
+
+  // Clear the upper halves of the YMM registers before leaving code that has used
+  // them, to avoid AVX-SSE transition penalties in the callee or caller.
+  void MaybeClearUpperSIMDRegisters();
+
   HGraphVisitor* GetLocationBuilder() override {
     return &location_builder_;
   }
@@ -501,6 +510,7 @@ class CodeGeneratorX86_64 : public CodeGenerator {
 
   void Initialize() override {
     block_labels_ = CommonInitializeLabels<Label>();
+    has_256bit_vectors_ = HasVectorOperationsOf256Bits();
   }
 
   bool NeedsTwoRegisters([[maybe_unused]] DataType::Type type) const override { return false; }
@@ -721,9 +731,14 @@ class CodeGeneratorX86_64 : public CodeGenerator {
   static void EmitPcRelativeLinkerPatches(const ArenaDeque<PatchInfo<Label>>& infos,
                                           ArenaVector<linker::LinkerPatch>* linker_patches);
 
+  // Whether the graph has vector operations on the full 256-bit YMM registers.
+  bool HasVectorOperationsOf256Bits() const;
+
   // Labels for each block that will be compiled.
   Label* block_labels_;  // Indexed by block id.
   Label frame_entry_label_;
+  // Whether the code uses the upper halves of the YMM registers, set in `Initialize()`.
+  bool has_256bit_vectors_;
   LocationsBuilderX86_64 location_builder_;
   InstructionCodeGeneratorX86_64 instruction_visitor_;
   ParallelMoveResolverX86_64 move_resolver_;
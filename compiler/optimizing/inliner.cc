@@ -34,6 +34,8 @@
 #include "jit/jit_code_cache.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
+#include "mirror/method_handle_impl-inl.h"
+#include "mirror/method_type-inl.h"
 #include "mirror/object_array-alloc-inl.h"
 #include "mirror/object_array-inl.h"
 #include "nodes.h"
@@ -76,6 +78,13 @@ static constexpr bool kUseAOTInlineCaches = true;
 // Controls the use of inlining try catches.
 static constexpr bool kInlineTryCatches = true;
 
+// Controls the use of profile data to scale the inlining budget of each call site.
+static constexpr bool kUseCallSiteHotness = true;
+
+// Factor applied to the instruction and environment budgets of call sites that
+// the profile reports as hot.
+static constexpr size_t kHotCallSiteBudgetFactor = 2;
+
 // We check for line numbers to make sure the DepthString implementation
 // aligns the output nicely.
 #define LOG_INTERNAL(msg) \
@@ -124,14 +133,110 @@ static size_t CountNumberOfInstructions(HGraph* graph) {
 }
 
 void HInliner::UpdateInliningBudget() {
-  if (total_number_of_instructions_ >= kMaximumNumberOfTotalInstructions) {
+  const size_t maximum_number_of_total_instructions = (call_site_hotness_ == kCallSiteHot)
+      ? kMaximumNumberOfTotalInstructions * kHotCallSiteBudgetFactor
+      : kMaximumNumberOfTotalInstructions;
+  // Cold call sites only get small methods inlined, which pays for the extra
+  // budget we give to hot call sites.
+  if (call_site_hotness_ == kCallSiteCold ||
+      total_number_of_instructions_ >= maximum_number_of_total_instructions) {
     // Always try to inline small methods.
     inlining_budget_ = kMaximumNumberOfInstructionsForSmallMethod;
   } else {
     inlining_budget_ = std::max(
         kMaximumNumberOfInstructionsForSmallMethod,
-        kMaximumNumberOfTotalInstructions - total_number_of_instructions_);
+        maximum_number_of_total_instructions - total_number_of_instructions_);
+  }
+}
+
+size_t HInliner::GetMaximumNumberOfCumulatedDexRegisters() const {
+  return (call_site_hotness_ == kCallSiteHot)
+      ? kMaximumNumberOfCumulatedDexRegisters * kHotCallSiteBudgetFactor
+      : kMaximumNumberOfCumulatedDexRegisters;
+}
+
+bool HInliner::IsHotCallee(ArtMethod* method, bool use_profile) const {
+  if (method == nullptr || method->IsAbstract()) {
+    return false;
+  }
+  if (use_profile) {
+    const ProfileCompilationInfo* pci =
+        codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+    return pci->GetMethodHotness(
+        MethodReference(method->GetDexFile(), method->GetDexMethodIndex())).IsHot();
+  }
+  // Methods get a profiling info when their hotness counter reaches the warmup threshold.
+  return Runtime::Current()->GetJit()->GetCodeCache()->GetProfilingInfo(
+      method, Thread::Current()) != nullptr;
+}
+
+HInliner::CallSiteHotness HInliner::GetCallSiteHotness(HInvoke* invoke_instruction,
+                                                       ArtMethod* resolved_method,
+                                                       CallSiteHotness default_hotness) {
+  if (!kUseCallSiteHotness || graph_->IsCompilingBaseline()) {
+    return default_hotness;
+  }
+
+  // Like `TryInlineFromInlineCache()`, the Zygote JIT uses the profile.
+  const bool use_profile = Runtime::Current()->IsAotCompiler() || Runtime::Current()->IsZygote();
+  if (use_profile) {
+    const ProfileCompilationInfo* pci =
+        codegen_->GetCompilerOptions().GetProfileCompilationInfo();
+    if (pci == nullptr) {
+      return default_hotness;
+    }
+    ProfileCompilationInfo::MethodHotness caller_hotness = pci->GetMethodHotness(MethodReference(
+        caller_compilation_unit_.GetDexFile(), caller_compilation_unit_.GetDexMethodIndex()));
+    // Profiles without any inline cache for the caller tell us nothing about its call sites.
+    if (!caller_hotness.IsHot() || caller_hotness.GetInlineCacheMap()->empty()) {
+      return default_hotness;
+    }
+  }
+
+  // A call site is cold if it was not executed while the caller was being profiled, and hot
+  // if one of its targets reached the hotness threshold.
+  if (!invoke_instruction->IsInvokeStaticOrDirect()) {
+    StackHandleScope<InlineCache::kIndividualCacheSize> classes(Thread::Current());
+    InlineCacheType inline_cache_type = use_profile
+        ? GetInlineCacheAOT(invoke_instruction, &classes)
+        : GetInlineCacheJIT(invoke_instruction, &classes);
+    if (inline_cache_type == kInlineCacheUninitialized) {
+      // The profile only has inline caches for the call sites that the baseline compiler
+      // instrumented; for the others we fall back to the hotness of the target below.
+      if (!use_profile || MayHaveProfiledInlineCache(invoke_instruction)) {
+        return kCallSiteCold;
+      }
+    } else if (resolved_method != nullptr) {
+      PointerSize pointer_size = caller_compilation_unit_.GetClassLinker()->GetImagePointerSize();
+      for (size_t i = 0; i != classes.Size(); ++i) {
+        if (classes.GetReference(i) == nullptr) {
+          continue;
+        }
+        ObjPtr<mirror::Class> klass = classes.GetReference(i)->AsClass();
+        ArtMethod* target =
+            klass->FindVirtualMethodForVirtualOrInterface(resolved_method, pointer_size);
+        if (IsHotCallee(target, use_profile)) {
+          return kCallSiteHot;
+        }
+      }
+    }
   }
+  return IsHotCallee(resolved_method, use_profile) ? kCallSiteHot : default_hotness;
+}
+
+bool HInliner::TryInlineAtCallSite(HInvoke* invoke_instruction) {
+  // Scale the budget by the hotness of this call site for the duration of this attempt.
+  const CallSiteHotness previous_hotness = call_site_hotness_;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    call_site_hotness_ = GetCallSiteHotness(
+        invoke_instruction, invoke_instruction->GetResolvedMethod(), previous_hotness);
+  }
+  UpdateInliningBudget();
+  const bool result = TryInline(invoke_instruction);
+  call_site_hotness_ = previous_hotness;
+  UpdateInliningBudget();
+  return result;
 }
 
 bool HInliner::Run() {
@@ -152,6 +257,11 @@ bool HInliner::Run() {
     total_number_of_instructions_ = CountNumberOfInstructions(graph_);
   }
 
+  // Inlined call sites inherit the hotness of the call site they were inlined at.
+  if (parent_ != nullptr) {
+    call_site_hotness_ = parent_->call_site_hotness_;
+  }
+
   UpdateInliningBudget();
   DCHECK_NE(total_number_of_instructions_, 0u);
   DCHECK_NE(inlining_budget_, 0u);
@@ -187,7 +297,7 @@ bool HInliner::Run() {
               call->GetMethodReference().PrettyMethod(/* with_signature= */ false);
           // Tests prevent inlining by having $noinline$ in their method names.
           if (callee_name.find("$noinline$") == std::string::npos) {
-            if (TryInline(call)) {
+            if (TryInlineAtCallSite(call)) {
               did_inline = true;
             } else if (honor_inline_directives) {
               bool should_have_inlined = (callee_name.find("$inline$") != std::string::npos);
@@ -197,7 +307,7 @@ bool HInliner::Run() {
         } else {
           DCHECK(!honor_inline_directives);
           // Normal case: try to inline.
-          if (TryInline(call)) {
+          if (TryInlineAtCallSite(call)) {
             did_inline = true;
           }
         }
@@ -233,6 +343,21 @@ static bool IsMethodOrDeclaringClassFinal(ArtMethod* method)
   return method->IsFinal() || method->GetDeclaringClass()->IsFinal();
 }
 
+bool HInliner::MayHaveProfiledInlineCache(HInvoke* invoke_instruction) const {
+  // Keep in sync with `ProfilingInfoBuilder::IsInlineCacheUseful()`.
+  if (!invoke_instruction->IsInvokeVirtual() && !invoke_instruction->IsInvokeInterface()) {
+    return false;
+  }
+  if (codegen_->IsImplementedIntrinsic(invoke_instruction)) {
+    return false;
+  }
+  if (invoke_instruction->InputAt(0)->GetReferenceTypeInfo().IsExact()) {
+    return false;
+  }
+  ArtMethod* resolved_method = invoke_instruction->GetResolvedMethod();
+  return resolved_method == nullptr || !IsMethodOrDeclaringClassFinal(resolved_method);
+}
+
 /**
  * Given the `resolved_method` looked up in the dex cache, try to find
  * the actual runtime target of an interface or virtual call.
@@ -456,6 +581,34 @@ bool HInliner::TryInline(HInvoke* invoke_instruction) {
     MaybeRecordStat(stats_, MethodCompilationStat::kNotInlinedUnresolved);
     return false;
   } else if (invoke_instruction->IsInvokePolymorphic()) {
+    HInvoke* replacement = nullptr;
+    bool requires_inlining = false;
+    bool replaced;
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      replaced = TryReplaceMethodHandleInvokeExact(invoke_instruction->AsInvokePolymorphic(),
+                                                   &replacement,
+                                                   &requires_inlining);
+    }
+    if (replaced) {
+      if (!TryInline(replacement) && requires_inlining) {
+        // The replacement cannot be called, go back to the original call.
+        HInstruction* receiver =
+            replacement->GetNumberOfArguments() != 0u ? replacement->InputAt(0) : nullptr;
+        replacement->ReplaceWith(invoke_instruction);
+        replacement->GetBlock()->RemoveInstruction(replacement);
+        if (receiver != nullptr && receiver->IsNullCheck() && !receiver->HasUses()) {
+          // Remove the null check added for the replacement.
+          receiver->GetBlock()->RemoveInstruction(receiver);
+        }
+        MaybeRecordStat(stats_, MethodCompilationStat::kNotInlinedPolymorphic);
+        return false;
+      }
+      invoke_instruction->GetBlock()->RemoveInstruction(invoke_instruction);
+      // Like devirtualization, consider the replacement as inlining.
+      MaybeRecordStat(stats_, MethodCompilationStat::kMethodHandleInvokeExactReplaced);
+      return true;
+    }
     MaybeRecordStat(stats_, MethodCompilationStat::kNotInlinedPolymorphic);
     return false;
   } else if (invoke_instruction->IsInvokeCustom()) {
@@ -1410,6 +1563,294 @@ bool HInliner::TryDevirtualize(HInvoke* invoke_instruction,
   return true;
 }
 
+// Returns whether `cls` is initialized whenever the code we are compiling runs,
+// so that its static methods can be called without a class initialization check.
+static bool IsInitializedForCompiledCode(ObjPtr<mirror::Class> cls,
+                                         const CompilerOptions& compiler_options)
+    REQUIRES_SHARED(Locks::mutator_lock_) {
+  if (!cls->IsInitialized()) {
+    return false;
+  }
+  if (compiler_options.IsJitCompiler()) {
+    return Runtime::Current()->GetJit()->CanAssumeInitialized(
+        cls, compiler_options.IsJitCompilerForSharedCode());
+  }
+  // For AOT, the class must be initialized in the boot or app image.
+  if (Runtime::Current()->GetHeap()->ObjectIsInBootImageSpace(cls)) {
+    return true;
+  }
+  std::string temp;
+  return compiler_options.IsGeneratingImage() &&
+         compiler_options.IsImageClass(cls->GetDescriptor(&temp));
+}
+
+ArtMethod* HInliner::FindConstMethodHandleTarget(HLoadMethodHandle* load_method_handle,
+                                                 HInvokePolymorphic* invoke_instruction,
+                                                 /*out*/ InvokeType* invoke_type) {
+  const DexFile& dex_file = *caller_compilation_unit_.GetDexFile();
+  if (!IsSameDexFile(load_method_handle->GetDexFile(), dex_file)) {
+    return nullptr;
+  }
+  const dex::MethodHandleItem& method_handle =
+      dex_file.GetMethodHandle(load_method_handle->GetMethodHandleIndex());
+  const DexFile::MethodHandleType handle_type =
+      static_cast<DexFile::MethodHandleType>(method_handle.method_handle_type_);
+  const dex::MethodId& method_id = dex_file.GetMethodId(method_handle.field_or_method_idx_);
+  // Proto and type ids are unique within a dex file, so we can compare the indexes.
+  switch (handle_type) {
+    case DexFile::MethodHandleType::kInvokeStatic:
+      // The type of the handle is the type of the method.
+      if (invoke_instruction->GetProtoIndex() != method_id.proto_idx_) {
+        return nullptr;
+      }
+      *invoke_type = kStatic;
+      break;
+    case DexFile::MethodHandleType::kInvokeInstance:
+    case DexFile::MethodHandleType::kInvokeDirect: {
+      // The type of the handle has the referenced class as an additional first parameter.
+      const dex::ProtoId& call_site_proto =
+          dex_file.GetProtoId(invoke_instruction->GetProtoIndex());
+      const dex::ProtoId& method_proto = dex_file.GetProtoId(method_id.proto_idx_);
+      if (call_site_proto.return_type_idx_ != method_proto.return_type_idx_) {
+        return nullptr;
+      }
+      const dex::TypeList* call_site_params = dex_file.GetProtoParameters(call_site_proto);
+      const dex::TypeList* method_params = dex_file.GetProtoParameters(method_proto);
+      uint32_t num_method_params = (method_params != nullptr) ? method_params->Size() : 0u;
+      if (call_site_params == nullptr ||
+          call_site_params->Size() != num_method_params + 1u ||
+          call_site_params->GetTypeItem(0u).type_idx_ != method_id.class_idx_) {
+        return nullptr;
+      }
+      for (uint32_t i = 0; i != num_method_params; ++i) {
+        if (call_site_params->GetTypeItem(i + 1u).type_idx_ !=
+                method_params->GetTypeItem(i).type_idx_) {
+          return nullptr;
+        }
+      }
+      *invoke_type = (handle_type == DexFile::MethodHandleType::kInvokeDirect) ? kDirect : kVirtual;
+      break;
+    }
+    default:
+      // Field accessors, constructors and interface methods are not supported.
+      return nullptr;
+  }
+  return caller_compilation_unit_.GetClassLinker()->LookupResolvedMethod(
+      method_handle.field_or_method_idx_,
+      caller_compilation_unit_.GetDexCache().Get(),
+      caller_compilation_unit_.GetClassLoader().Get());
+}
+
+ArtMethod* HInliner::FindKnownImageMethodHandleTarget(HStaticFieldGet* field_get,
+                                                      HInvokePolymorphic* invoke_instruction,
+                                                      /*out*/ InvokeType* invoke_type) {
+  // As for `VarHandle`s, if the `MethodHandle` comes from a static final field of a class
+  // initialized in an image, we can use the `MethodHandle` as seen at compile time. We do
+  // this only for AOT, see `InstructionSimplifierVisitor::CanUseKnownImageVarHandle()`.
+  if (!codegen_->GetCompilerOptions().IsAotCompiler()) {
+    return nullptr;
+  }
+  ArtField* field = field_get->GetFieldInfo().GetField();
+  DCHECK(field->IsStatic());
+  if (!field->IsFinal()) {
+    return nullptr;
+  }
+  HInstruction* load_class = field_get->InputAt(0);
+  if (!load_class->IsLoadClass() || !load_class->AsLoadClass()->IsInImage()) {
+    return nullptr;
+  }
+  ObjPtr<mirror::Class> declaring_class = field->GetDeclaringClass();
+  if (!declaring_class->IsVisiblyInitialized()) {
+    return nullptr;
+  }
+
+  // Handles created by `asType()`, `bindTo()` and other combinators are transformers
+  // and we leave them to the runtime.
+  ObjPtr<mirror::Object> object = field->GetObject(declaring_class);
+  if (object == nullptr || object->GetClass() != GetClassRoot<mirror::MethodHandleImpl>()) {
+    return nullptr;
+  }
+  ObjPtr<mirror::MethodHandle> method_handle = ObjPtr<mirror::MethodHandle>::DownCast(object);
+  switch (method_handle->GetHandleKind()) {
+    case mirror::MethodHandle::Kind::kInvokeStatic:
+      *invoke_type = kStatic;
+      break;
+    case mirror::MethodHandle::Kind::kInvokeDirect:
+      *invoke_type = kDirect;
+      break;
+    case mirror::MethodHandle::Kind::kInvokeVirtual:
+      *invoke_type = kVirtual;
+      break;
+    default:
+      return nullptr;
+  }
+
+  // The call site type must match the type of the handle exactly.
+  const DexFile& dex_file = *caller_compilation_unit_.GetDexFile();
+  const dex::ProtoId& call_site_proto = dex_file.GetProtoId(invoke_instruction->GetProtoIndex());
+  const dex::TypeList* call_site_params = dex_file.GetProtoParameters(call_site_proto);
+  uint32_t num_params = (call_site_params != nullptr) ? call_site_params->Size() : 0u;
+  ObjPtr<mirror::MethodType> method_type = method_handle->GetMethodType();
+  if (static_cast<uint32_t>(method_type->GetNumberOfPTypes()) != num_params) {
+    return nullptr;
+  }
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  auto is_same_type = [&](dex::TypeIndex type_index, ObjPtr<mirror::Class> klass)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    return class_linker->LookupResolvedType(type_index,
+                                            caller_compilation_unit_.GetDexCache().Get(),
+                                            caller_compilation_unit_.GetClassLoader().Get()) ==
+           klass;
+  };
+  if (!is_same_type(call_site_proto.return_type_idx_, method_type->GetRType())) {
+    return nullptr;
+  }
+  ObjPtr<mirror::ObjectArray<mirror::Class>> ptypes = method_type->GetPTypes();
+  for (uint32_t i = 0; i != num_params; ++i) {
+    if (!is_same_type(call_site_params->GetTypeItem(i).type_idx_, ptypes->Get(i))) {
+      return nullptr;
+    }
+  }
+  return method_handle->GetTargetMethod();
+}
+
+bool HInliner::TryReplaceMethodHandleInvokeExact(HInvokePolymorphic* invoke_instruction,
+                                                 /*out*/ HInvoke** replacement,
+                                                 /*out*/ bool* requires_inlining) {
+  if (invoke_instruction->GetIntrinsic() != Intrinsics::kMethodHandleInvokeExact) {
+    return false;
+  }
+  DCHECK(IsSameDexFile(*invoke_instruction->GetMethodReference().dex_file,
+                       *caller_compilation_unit_.GetDexFile()));
+  HInstruction* handle = invoke_instruction->InputAt(0);
+  if (handle->IsNullCheck()) {
+    handle = handle->InputAt(0);
+  }
+  InvokeType invoke_type = kStatic;
+  ArtMethod* method = nullptr;
+  if (handle->IsLoadMethodHandle()) {
+    method = FindConstMethodHandleTarget(
+        handle->AsLoadMethodHandle(), invoke_instruction, &invoke_type);
+  } else if (handle->IsStaticFieldGet()) {
+    method = FindKnownImageMethodHandleTarget(
+        handle->AsStaticFieldGet(), invoke_instruction, &invoke_type);
+  }
+  if (method == nullptr) {
+    return false;
+  }
+  LOG_NOTE() << "Replacing MethodHandle.invokeExact() with a call to " << method->PrettyMethod();
+
+  // Check that the target can be called like the target of a regular invoke.
+  ObjPtr<mirror::Class> declaring_class = method->GetDeclaringClass();
+  if (method->IsConstructor() ||
+      declaring_class->IsInterface() ||
+      declaring_class->IsProxyClass()) {
+    return false;
+  }
+  if (invoke_type == kStatic) {
+    // As in the instruction builder, static methods and constructors of the declaring
+    // class run only after its class initialization check.
+    auto is_static_method_or_constructor_of_cls = [&](const DexCompilationUnit& compilation_unit)
+        REQUIRES_SHARED(Locks::mutator_lock_) {
+      return (compilation_unit.GetAccessFlags() & (kAccStatic | kAccConstructor)) != 0u &&
+             compilation_unit.GetCompilingClass().Get() == declaring_class;
+    };
+    if (!method->IsStatic() ||
+        !(IsInitializedForCompiledCode(declaring_class, codegen_->GetCompilerOptions()) ||
+          is_static_method_or_constructor_of_cls(outer_compilation_unit_) ||
+          is_static_method_or_constructor_of_cls(caller_compilation_unit_))) {
+      return false;
+    }
+  } else if (method->IsStatic()) {
+    return false;
+  } else if (invoke_type == kDirect) {
+    if (!method->IsPrivate()) {
+      return false;
+    }
+  } else if (method->IsPrivate() || method->IsFinal() || declaring_class->IsFinal()) {
+    // There is a single target, we do not need the virtual dispatch.
+    invoke_type = kDirect;
+  }
+  // The method must be referenced from the caller's dex file for sharpening and .bss entries.
+  if (!IsSameDexFile(*method->GetDexFile(), *caller_compilation_unit_.GetDexFile())) {
+    return false;
+  }
+  MethodReference method_reference(method->GetDexFile(), method->GetDexMethodIndex());
+
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  // The `MethodHandle` is the first argument of the `invoke-polymorphic`.
+  size_t number_of_arguments = invoke_instruction->GetNumberOfArguments() - 1u;
+  HInvoke* new_invoke = nullptr;
+  if (invoke_type == kVirtual) {
+    new_invoke = new (graph_->GetAllocator()) HInvokeVirtual(graph_->GetAllocator(),
+                                                             number_of_arguments,
+                                                             invoke_instruction->GetType(),
+                                                             dex_pc,
+                                                             method_reference,
+                                                             method,
+                                                             method_reference,
+                                                             method->GetVtableIndex(),
+                                                             !graph_->IsDebuggable());
+  } else {
+    HInvokeStaticOrDirect::DispatchInfo dispatch_info =
+        HSharpening::SharpenLoadMethod(method,
+                                       /* has_method_id= */ true,
+                                       /* for_interface_call= */ false,
+                                       codegen_);
+    if (dispatch_info.method_load_kind == MethodLoadKind::kRuntimeCall ||
+        dispatch_info.code_ptr_location == CodePtrLocation::kCallCriticalNative) {
+      // The runtime call would look at the `invoke-polymorphic` instruction
+      // to find the method, so keep the original call.
+      return false;
+    }
+    // Same for the .bss entry, which starts out as the resolution method: the first
+    // call would go to the resolution trampoline. The replacement can then only be
+    // used if it gets inlined.
+    *requires_inlining = dispatch_info.method_load_kind == MethodLoadKind::kBssEntry;
+    HInvokeStaticOrDirect* invoke_static_or_direct =
+        new (graph_->GetAllocator()) HInvokeStaticOrDirect(
+            graph_->GetAllocator(),
+            number_of_arguments,
+            invoke_instruction->GetType(),
+            dex_pc,
+            method_reference,
+            method,
+            dispatch_info,
+            invoke_type,
+            method_reference,
+            HInvokeStaticOrDirect::ClinitCheckRequirement::kNone,
+            !graph_->IsDebuggable());
+    if (HInvokeStaticOrDirect::NeedsCurrentMethodInput(dispatch_info)) {
+      invoke_static_or_direct->SetRawInputAt(
+          invoke_static_or_direct->GetCurrentMethodIndexUnchecked(), graph_->GetCurrentMethod());
+    }
+    new_invoke = invoke_static_or_direct;
+  }
+  for (size_t index = 0; index != number_of_arguments; ++index) {
+    new_invoke->SetArgumentAt(index, invoke_instruction->InputAt(index + 1u));
+  }
+  if (invoke_type != kStatic) {
+    // The `MethodHandle` throws NPE for a null receiver.
+    HInstruction* receiver = new_invoke->InputAt(0);
+    if (receiver->CanBeNull()) {
+      HNullCheck* null_check = new (graph_->GetAllocator()) HNullCheck(receiver, dex_pc);
+      invoke_instruction->GetBlock()->InsertInstructionBefore(null_check, invoke_instruction);
+      null_check->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+      null_check->SetReferenceTypeInfoIfValid(receiver->GetReferenceTypeInfo());
+      new_invoke->SetArgumentAt(0, null_check);
+    }
+  }
+  invoke_instruction->GetBlock()->InsertInstructionBefore(new_invoke, invoke_instruction);
+  new_invoke->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  if (invoke_instruction->GetType() == DataType::Type::kReference) {
+    new_invoke->SetReferenceTypeInfoIfValid(invoke_instruction->GetReferenceTypeInfo());
+  }
+  *replacement = new_invoke;
+
+  // The caller removes `invoke_instruction` once it knows the replacement can be kept.
+  invoke_instruction->ReplaceWith(new_invoke);
+  return true;
+}
 
 bool HInliner::TryInlineAndReplace(HInvoke* invoke_instruction,
                                    ArtMethod* method,
@@ -2050,7 +2491,7 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
   }
 
   const bool too_many_registers =
-      total_number_of_dex_registers_ > kMaximumNumberOfCumulatedDexRegisters;
+      total_number_of_dex_registers_ > GetMaximumNumberOfCumulatedDexRegisters();
   bool needs_bss_check = false;
   const bool can_encode_in_stack_map = CanEncodeInlinedMethodInStackMap(
       *outer_compilation_unit_.GetDexFile(), resolved_method, codegen_, &needs_bss_check);
@@ -2081,6 +2522,12 @@ bool HInliner::CanInlineBody(const HGraph* callee_graph,
          !instr_it.Done();
          instr_it.Advance()) {
       if (++number_of_instructions > inlining_budget_) {
+        if (call_site_hotness_ == kCallSiteCold) {
+          LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedColdCallSite)
+              << "Method " << resolved_method->PrettyMethod()
+              << " is not inlined because the call site is cold and the method is not small.";
+          return false;
+        }
         LOG_FAIL(stats_, MethodCompilationStat::kNotInlinedInstructionBudget)
             << "Method " << resolved_method->PrettyMethod()
             << " is not inlined because the outer method has reached"
@@ -2324,7 +2771,7 @@ void HInliner::RunOptimizations(HGraph* callee_graph,
 
   // Bail early for pathological cases on the environment (for example recursive calls,
   // or too large environment).
-  if (total_number_of_dex_registers_ > kMaximumNumberOfCumulatedDexRegisters) {
+  if (total_number_of_dex_registers_ > GetMaximumNumberOfCumulatedDexRegisters()) {
     LOG_NOTE() << "Calls in " << callee_graph->GetArtMethod()->PrettyMethod()
              << " will not be inlined because the outer method has reached"
              << " its environment budget limit.";
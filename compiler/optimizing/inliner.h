@@ -58,6 +58,7 @@ class HInliner : public HOptimization {
         caller_environment_(caller_environment),
         depth_(depth),
         inlining_budget_(0),
+        call_site_hotness_(kCallSiteUnknown),
         try_catch_inlining_allowed_(try_catch_inlining_allowed),
         run_extra_type_propagation_(false),
         inline_stats_(nullptr) {}
@@ -82,8 +83,18 @@ class HInliner : public HOptimization {
     kInlineCacheMissingTypes = 5
   };
 
+  // How often a call site executes, as far as profile data can tell.
+  enum CallSiteHotness {
+    kCallSiteUnknown = 0,
+    kCallSiteCold = 1,
+    kCallSiteHot = 2
+  };
+
   bool TryInline(HInvoke* invoke_instruction);
 
+  // Call `TryInline` with the inlining budget scaled by the hotness of the call site.
+  bool TryInlineAtCallSite(HInvoke* invoke_instruction);
+
   // Try to inline `resolved_method` in place of `invoke_instruction`. `do_rtp` is whether
   // reference type propagation can run after the inlining. If the inlining is successful, this
   // method will replace and remove the `invoke_instruction`.
@@ -191,6 +202,30 @@ class HInliner : public HOptimization {
                        HInvoke** replacement)
     REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to replace a `MethodHandle.invokeExact()` on a constant direct method handle
+  // with a regular invoke of the handle's target, which we can then try to inline.
+  // The uses of `invoke_instruction` are moved to the `replacement`, inserted before it.
+  // If `requires_inlining` is set, the replacement can only be kept if it is inlined.
+  bool TryReplaceMethodHandleInvokeExact(HInvokePolymorphic* invoke_instruction,
+                                         /*out*/ HInvoke** replacement,
+                                         /*out*/ bool* requires_inlining)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Find the target of the method handle loaded by `const-method-handle` if its type
+  // matches the call site of `invoke_instruction` exactly.
+  ArtMethod* FindConstMethodHandleTarget(HLoadMethodHandle* load_method_handle,
+                                         HInvokePolymorphic* invoke_instruction,
+                                         /*out*/ InvokeType* invoke_type)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Find the target of the method handle held in a static final field of a class
+  // initialized in the boot or app image if its type matches the call site of
+  // `invoke_instruction` exactly. AOT only.
+  ArtMethod* FindKnownImageMethodHandleTarget(HStaticFieldGet* field_get,
+                                              HInvokePolymorphic* invoke_instruction,
+                                              /*out*/ InvokeType* invoke_type)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Try getting the inline cache from JIT code cache.
   // Return true if the inline cache was successfully allocated and the
   // invoke info was found in the profile info.
@@ -315,9 +350,30 @@ class HInliner : public HOptimization {
                                                 HInstruction* return_replacement,
                                                 HInstruction* invoke_instruction);
 
-  // Update the inlining budget based on `total_number_of_instructions_`.
+  // Update the inlining budget based on `total_number_of_instructions_` and
+  // `call_site_hotness_`.
   void UpdateInliningBudget();
 
+  // Classify `invoke_instruction` using the inline caches and the hotness of its targets, from
+  // the JIT or the profile. Returns `default_hotness` when they have nothing to say about this
+  // call site.
+  CallSiteHotness GetCallSiteHotness(HInvoke* invoke_instruction,
+                                     ArtMethod* resolved_method,
+                                     CallSiteHotness default_hotness)
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Whether `method` is hot according to the profile or, for the JIT, its hotness counter.
+  bool IsHotCallee(ArtMethod* method, bool use_profile) const
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Whether the baseline compiler would have given `invoke_instruction` an inline cache, so
+  // that a profile without one for this call site means that the call was not executed.
+  bool MayHaveProfiledInlineCache(HInvoke* invoke_instruction) const
+    REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Maximum number of cumulated dex registers for the current call site.
+  size_t GetMaximumNumberOfCumulatedDexRegisters() const;
+
   // Count the number of calls of `method` being inlined recursively.
   size_t CountRecursiveCallsOf(ArtMethod* method) const;
 
@@ -340,6 +396,11 @@ class HInliner : public HOptimization {
   // The budget left for inlining, in number of instructions.
   size_t inlining_budget_;
 
+  // Hotness of the call site currently being inlined. Hot call sites get a larger
+  // budget, cold ones only get small methods inlined. Nested inliners start with
+  // the hotness of the call site they were created for.
+  CallSiteHotness call_site_hotness_;
+
   // States if we are allowing try catch inlining to occur at this particular instance of inlining.
   bool try_catch_inlining_allowed_;
 
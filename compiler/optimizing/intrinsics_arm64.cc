@@ -2247,6 +2247,134 @@ void IntrinsicCodeGeneratorARM64::VisitStringEquals(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+// Compute `hash = hash * 31^length + sum(element[i] * 31^(length - 1 - i))`, the polynomial hash
+// of Arrays.hashCode() and String.hashCode(), for `length` elements of `type` at `ptr`.
+// The loop is unrolled by four. The four elements are combined with shifts and subtractions
+// (x * 31 == (x << 5) - x) off the critical path, which then has a single multiply-add per four
+// elements. Clobbers `ptr` and `length`.
+static void GenerateHashCodeLoop(MacroAssembler* masm,
+                                 DataType::Type type,
+                                 const Register& ptr,
+                                 const Register& length,
+                                 const Register& hash,
+                                 const Register& multiplier) {
+  const int32_t element_size = DataType::Size(type);
+  UseScratchRegisterScope temps(masm);
+  Register tmp0 = temps.AcquireW();
+  Register tmp1 = temps.AcquireW();
+  auto load_element = [&](const Register& dst) {
+    MemOperand address(ptr, element_size, PostIndex);
+    switch (type) {
+      case DataType::Type::kInt8:
+        __ Ldrsb(dst, address);
+        break;
+      case DataType::Type::kUint8:
+        __ Ldrb(dst, address);
+        break;
+      case DataType::Type::kUint16:
+        __ Ldrh(dst, address);
+        break;
+      case DataType::Type::kInt32:
+        __ Ldr(dst, address);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected type " << type;
+        UNREACHABLE();
+    }
+  };
+
+  vixl::aarch64::Label loop_4elements, process_1element, loop_1element, done;
+
+  __ Mov(multiplier, 31 * 31 * 31 * 31);
+  __ Subs(length, length, 4);
+  __ B(&process_1element, lt);
+  __ Bind(&loop_4elements);
+  // tmp1 = ((element[0] * 31 + element[1]) * 31 + element[2]) * 31 + element[3]
+  load_element(tmp0);
+  load_element(tmp1);
+  __ Add(tmp1, tmp1, Operand(tmp0, LSL, 5));
+  __ Sub(tmp1, tmp1, tmp0);
+  load_element(tmp0);
+  __ Add(tmp0, tmp0, Operand(tmp1, LSL, 5));
+  __ Sub(tmp0, tmp0, tmp1);
+  load_element(tmp1);
+  __ Add(tmp1, tmp1, Operand(tmp0, LSL, 5));
+  __ Sub(tmp1, tmp1, tmp0);
+  // hash = hash * 31^4 + tmp1
+  __ Madd(hash, hash, multiplier, tmp1);
+  __ Subs(length, length, 4);
+  __ B(&loop_4elements, ge);
+
+  // The code below works with values of `length` in the range [-4, -1].
+  __ Bind(&process_1element);
+  __ Adds(length, length, 4);
+  __ B(&done, eq);
+  __ Bind(&loop_1element);
+  // hash = hash * 31 + element
+  load_element(tmp0);
+  __ Add(tmp0, tmp0, Operand(hash, LSL, 5));
+  __ Sub(hash, tmp0, hash);
+  __ Subs(length, length, 1);
+  __ B(&loop_1element, ne);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitStringHashCode(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitStringHashCode(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register str = WRegisterFrom(locations->InAt(0));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  Register multiplier = WRegisterFrom(locations->GetTemp(2));
+  Register out = WRegisterFrom(locations->Out());
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  const int32_t hash_code_offset = mirror::String::HashCodeOffset().Int32Value();
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  vixl::aarch64::Label done;
+  // Return the cached hash code if it has been computed already.
+  __ Ldr(out, MemOperand(str.X(), hash_code_offset));
+  __ Cbnz(out, &done);
+
+  __ Ldr(length, MemOperand(str.X(), count_offset));
+  __ Add(ptr, str.X(), value_offset);
+  if (mirror::kUseStringCompression) {
+    vixl::aarch64::Label uncompressed, hash_computed;
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    __ Tbnz(length, 0, &uncompressed);
+    __ Lsr(length, length, 1u);
+    GenerateHashCodeLoop(masm, DataType::Type::kUint8, ptr, length, out, multiplier);
+    __ B(&hash_computed);
+    __ Bind(&uncompressed);
+    __ Lsr(length, length, 1u);
+    GenerateHashCodeLoop(masm, DataType::Type::kUint16, ptr, length, out, multiplier);
+    __ Bind(&hash_computed);
+  } else {
+    GenerateHashCodeLoop(masm, DataType::Type::kUint16, ptr, length, out, multiplier);
+  }
+  // Cache the hash code. Like String.hashCode(), this is a benign race as all threads
+  // compute the same value.
+  __ Str(out, MemOperand(str.X(), hash_code_offset));
+
+  __ Bind(&done);
+}
+
 static void GenerateVisitStringIndexOf(HInvoke* invoke,
                                        MacroAssembler* masm,
                                        CodeGeneratorARM64* codegen,
@@ -3918,6 +4046,402 @@ void IntrinsicCodeGeneratorARM64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
   GenerateCodeForCalculationCRC32ValueOfBytes(masm, crc, ptr, length, out);
 }
 
+// Compare `length` bytes at `a_ptr` and `b_ptr`, 16 bytes at a time, and branch to `not_equal`
+// on the first difference. `length` is a multiple of `element_size`. Falls through if equal.
+// Clobbers `a_ptr`, `b_ptr` and `length`.
+static void GenerateMemoryEquals(MacroAssembler* masm,
+                                 const Register& a_ptr,
+                                 const Register& b_ptr,
+                                 const Register& length,
+                                 const Register& temp0,
+                                 const Register& temp1,
+                                 size_t element_size,
+                                 vixl::aarch64::Label* not_equal) {
+  UseScratchRegisterScope temps(masm);
+  Register temp2 = temps.AcquireX();
+  Register temp3 = temps.AcquireX();
+
+  vixl::aarch64::Label loop, process_8bytes, process_4bytes, process_2bytes, process_1byte, done;
+
+  __ Subs(length, length, 16);
+  __ B(&process_8bytes, lt);
+  __ Bind(&loop);
+  __ Ldp(temp0, temp1, MemOperand(a_ptr, 16, PostIndex));
+  __ Ldp(temp2, temp3, MemOperand(b_ptr, 16, PostIndex));
+  __ Cmp(temp0, temp2);
+  __ Ccmp(temp1, temp3, NoFlag, eq);
+  __ B(not_equal, ne);
+  __ Subs(length, length, 16);
+  __ B(&loop, ge);
+
+  // The code below works with values of `length` in the range [-16, -1]; its low
+  // four bits are the number of remaining bytes.
+  __ Bind(&process_8bytes);
+  __ Tbz(length, 3, &process_4bytes);
+  __ Ldr(temp0, MemOperand(a_ptr, 8, PostIndex));
+  __ Ldr(temp2, MemOperand(b_ptr, 8, PostIndex));
+  __ Cmp(temp0, temp2);
+  __ B(not_equal, ne);
+
+  __ Bind(&process_4bytes);
+  if (element_size <= 4u) {
+    __ Tbz(length, 2, &process_2bytes);
+    __ Ldr(temp0.W(), MemOperand(a_ptr, 4, PostIndex));
+    __ Ldr(temp2.W(), MemOperand(b_ptr, 4, PostIndex));
+    __ Cmp(temp0.W(), temp2.W());
+    __ B(not_equal, ne);
+  }
+
+  __ Bind(&process_2bytes);
+  if (element_size <= 2u) {
+    __ Tbz(length, 1, &process_1byte);
+    __ Ldrh(temp0.W(), MemOperand(a_ptr, 2, PostIndex));
+    __ Ldrh(temp2.W(), MemOperand(b_ptr, 2, PostIndex));
+    __ Cmp(temp0.W(), temp2.W());
+    __ B(not_equal, ne);
+  }
+
+  __ Bind(&process_1byte);
+  if (element_size == 1u) {
+    __ Tbz(length, 0, &done);
+    __ Ldrb(temp0.W(), MemOperand(a_ptr));
+    __ Ldrb(temp2.W(), MemOperand(b_ptr));
+    __ Cmp(temp0.W(), temp2.W());
+    __ B(not_equal, ne);
+  }
+  __ Bind(&done);
+}
+
+static void CreateArraysEqualsLocations(HInvoke* invoke, ArenaAllocator* allocator) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Arrays.equals(T[] a, T[] b) for a primitive type T.
+static void GenerateArraysEquals(HInvoke* invoke, MacroAssembler* masm, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register a = WRegisterFrom(locations->InAt(0));
+  Register b = WRegisterFrom(locations->InAt(1));
+  Register a_ptr = XRegisterFrom(locations->GetTemp(0));
+  Register b_ptr = XRegisterFrom(locations->GetTemp(1));
+  Register temp0 = XRegisterFrom(locations->GetTemp(2));
+  Register temp1 = XRegisterFrom(locations->GetTemp(3));
+  Register length = WRegisterFrom(locations->Out());
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Int32Value();
+
+  vixl::aarch64::Label return_true, return_false, end;
+
+  // Reference equality check, return true if same reference (or both null).
+  __ Cmp(a, b);
+  __ B(&return_true, eq);
+  // Return false if only one of the arrays is null.
+  __ Cbz(a, &return_false);
+  __ Cbz(b, &return_false);
+
+  // Return false if the lengths differ.
+  __ Ldr(length, MemOperand(a.X(), length_offset));
+  __ Ldr(temp0.W(), MemOperand(b.X(), length_offset));
+  __ Cmp(length, temp0.W());
+  __ B(&return_false, ne);
+
+  // Compare the contents as bytes. The output register holds the byte count until the end.
+  if (DataType::SizeShift(type) != 0u) {
+    __ Lsl(length, length, DataType::SizeShift(type));
+  }
+  __ Add(a_ptr, a.X(), data_offset);
+  __ Add(b_ptr, b.X(), data_offset);
+  GenerateMemoryEquals(
+      masm, a_ptr, b_ptr, length, temp0, temp1, DataType::Size(type), &return_false);
+
+  __ Bind(&return_true);
+  __ Mov(length, 1);
+  __ B(&end);
+
+  __ Bind(&return_false);
+  __ Mov(length, 0);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetVIXLAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsChar(HInvoke* invoke) {
+  CreateArraysEqualsLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsChar(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetVIXLAssembler(), DataType::Type::kUint16);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetVIXLAssembler(), DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysMismatchByte(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Arrays.mismatch(byte[] a, byte[] b).
+void IntrinsicCodeGeneratorARM64::VisitArraysMismatchByte(HInvoke* invoke) {
+  MacroAssembler* masm = GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register a = WRegisterFrom(locations->InAt(0));
+  Register b = WRegisterFrom(locations->InAt(1));
+  Register a_ptr = XRegisterFrom(locations->GetTemp(0));
+  Register b_ptr = XRegisterFrom(locations->GetTemp(1));
+  Register length = WRegisterFrom(locations->GetTemp(2));
+  Register index = WRegisterFrom(locations->GetTemp(3));
+  Register out = WRegisterFrom(locations->Out());
+
+  UseScratchRegisterScope temps(masm);
+  Register temp0 = temps.AcquireX();
+  Register temp1 = temps.AcquireX();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(sizeof(int8_t)).Int32Value();
+
+  // Let the slow path throw the NullPointerException.
+  SlowPathCodeARM64* slow_path =
+      new (codegen_->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ Cbz(a, slow_path->GetEntryLabel());
+  __ Cbz(b, slow_path->GetEntryLabel());
+
+  // Compare the common prefix of length min(a.length, b.length).
+  __ Ldr(length, MemOperand(a.X(), length_offset));
+  __ Ldr(temp0.W(), MemOperand(b.X(), length_offset));
+  __ Cmp(length, temp0.W());
+  __ Csel(length, length, temp0.W(), lt);
+  __ Add(a_ptr, a.X(), data_offset);
+  __ Add(b_ptr, b.X(), data_offset);
+  __ Mov(index, 0);
+
+  vixl::aarch64::Label word_loop, byte_loop, found_in_word, found, no_mismatch, end;
+
+  // Compare 8 bytes at a time while they are within the common prefix.
+  __ Bind(&word_loop);
+  __ Add(temp0.W(), index, 8);
+  __ Cmp(temp0.W(), length);
+  __ B(&byte_loop, gt);
+  __ Ldr(temp0, MemOperand(a_ptr, index.X()));
+  __ Ldr(temp1, MemOperand(b_ptr, index.X()));
+  __ Eor(temp0, temp0, temp1);
+  __ Cbnz(temp0, &found_in_word);
+  __ Add(index, index, 8);
+  __ B(&word_loop);
+
+  // Compare the remaining bytes one at a time.
+  __ Bind(&byte_loop);
+  __ Cmp(index, length);
+  __ B(&no_mismatch, ge);
+  __ Ldrb(temp0.W(), MemOperand(a_ptr, index.X()));
+  __ Ldrb(temp1.W(), MemOperand(b_ptr, index.X()));
+  __ Cmp(temp0.W(), temp1.W());
+  __ B(&found, ne);
+  __ Add(index, index, 1);
+  __ B(&byte_loop);
+
+  // The lowest set bit of the difference is in the first differing byte (little endian).
+  __ Bind(&found_in_word);
+  __ Rbit(temp0, temp0);
+  __ Clz(temp0, temp0);
+  __ Add(index, index, Operand(temp0.W(), LSR, 3));
+  __ Bind(&found);
+  __ Mov(out, index);
+  __ B(&end);
+
+  // The common prefix matches; return -1 for equal lengths and the shorter length otherwise.
+  __ Bind(&no_mismatch);
+  __ Ldr(temp0.W(), MemOperand(a.X(), length_offset));
+  __ Ldr(temp1.W(), MemOperand(b.X(), length_offset));
+  __ Cmp(temp0.W(), temp1.W());
+  __ Mov(out, -1);
+  __ Csel(out, out, length, eq);
+
+  __ Bind(&end);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void CreateArraysHashCodeLocations(HInvoke* invoke, ArenaAllocator* allocator) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Arrays.hashCode(T[] a) for a primitive type T.
+static void GenerateArraysHashCode(HInvoke* invoke, MacroAssembler* masm, DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+  Register multiplier = WRegisterFrom(locations->GetTemp(2));
+  Register out = WRegisterFrom(locations->Out());
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Int32Value();
+
+  vixl::aarch64::Label end;
+  // The hash code of a null array is 0.
+  __ Mov(out, 0);
+  __ Cbz(array, &end);
+
+  __ Mov(out, 1);
+  __ Ldr(length, MemOperand(array.X(), length_offset));
+  __ Add(ptr, array.X(), data_offset);
+  GenerateHashCodeLoop(masm, type, ptr, length, out, multiplier);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  CreateArraysHashCodeLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetVIXLAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  CreateArraysHashCodeLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetVIXLAssembler(), DataType::Type::kInt32);
+}
+
+static void CreateArraysFillLocations(HInvoke* invoke, ArenaAllocator* allocator) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+// Lower the invoke of Arrays.fill(T[] a, T value) for a primitive type T.
+static void GenerateArraysFill(HInvoke* invoke,
+                               CodeGeneratorARM64* codegen,
+                               DataType::Type type) {
+  MacroAssembler* masm = codegen->GetVIXLAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = WRegisterFrom(locations->InAt(0));
+  Register value = WRegisterFrom(locations->InAt(1));
+  Register ptr = XRegisterFrom(locations->GetTemp(0));
+  Register length = WRegisterFrom(locations->GetTemp(1));
+
+  UseScratchRegisterScope temps(masm);
+  Register pattern = temps.AcquireX();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Int32Value();
+  const size_t element_size = DataType::Size(type);
+
+  // Let the slow path throw the NullPointerException.
+  SlowPathCodeARM64* slow_path =
+      new (codegen->GetScopedAllocator()) IntrinsicSlowPathARM64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ Cbz(array, slow_path->GetEntryLabel());
+
+  // Get the number of bytes to fill.
+  __ Ldr(length, MemOperand(array.X(), length_offset));
+  if (DataType::SizeShift(type) != 0u) {
+    __ Lsl(length, length, DataType::SizeShift(type));
+  }
+  __ Add(ptr, array.X(), data_offset);
+
+  // Replicate the value to all bytes of `pattern`.
+  if (element_size == 1u) {
+    __ Uxtb(pattern.W(), value);
+    __ Orr(pattern.W(), pattern.W(), Operand(pattern.W(), LSL, 8));
+    __ Orr(pattern.W(), pattern.W(), Operand(pattern.W(), LSL, 16));
+  } else {
+    DCHECK_EQ(element_size, 4u);
+    __ Mov(pattern.W(), value);
+  }
+  __ Orr(pattern, pattern, Operand(pattern, LSL, 32));
+
+  vixl::aarch64::Label loop, process_8bytes, process_4bytes, process_2bytes, process_1byte, done;
+
+  __ Subs(length, length, 16);
+  __ B(&process_8bytes, lt);
+  __ Bind(&loop);
+  __ Stp(pattern, pattern, MemOperand(ptr, 16, PostIndex));
+  __ Subs(length, length, 16);
+  __ B(&loop, ge);
+
+  // The code below works with values of `length` in the range [-16, -1]; its low
+  // four bits are the number of remaining bytes.
+  __ Bind(&process_8bytes);
+  __ Tbz(length, 3, &process_4bytes);
+  __ Str(pattern, MemOperand(ptr, 8, PostIndex));
+
+  __ Bind(&process_4bytes);
+  __ Tbz(length, 2, &process_2bytes);
+  __ Str(pattern.W(), MemOperand(ptr, 4, PostIndex));
+
+  __ Bind(&process_2bytes);
+  if (element_size == 1u) {
+    __ Tbz(length, 1, &process_1byte);
+    __ Strh(pattern.W(), MemOperand(ptr, 2, PostIndex));
+
+    __ Bind(&process_1byte);
+    __ Tbz(length, 0, &done);
+    __ Strb(pattern.W(), MemOperand(ptr));
+  }
+
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillByte(HInvoke* invoke) {
+  GenerateArraysFill(invoke, codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderARM64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorARM64::VisitArraysFillInt(HInvoke* invoke) {
+  GenerateArraysFill(invoke, codegen_, DataType::Type::kInt32);
+}
+
 void IntrinsicLocationsBuilderARM64::VisitFP16ToFloat(HInvoke* invoke) {
   if (!codegen_->GetInstructionSetFeatures().HasFP16()) {
     return;
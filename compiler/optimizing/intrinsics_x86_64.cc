@@ -1304,6 +1304,129 @@ void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
   __ Bind(&end);
 }
 
+// Compute `hash = hash * 31^length + sum(element[i] * 31^(length - 1 - i))`, the polynomial hash
+// of Arrays.hashCode() and String.hashCode(), for `length` elements of `type` at `ptr`.
+// The loop is unrolled by four with independent multiplications of the elements, so that only
+// one multiplication per four elements is on the critical path. Clobbers `ptr`, `length`, `tmp`.
+static void GenerateHashCodeLoop(X86_64Assembler* assembler,
+                                 DataType::Type type,
+                                 CpuRegister ptr,
+                                 CpuRegister length,
+                                 CpuRegister hash,
+                                 CpuRegister tmp) {
+  const int32_t element_size = DataType::Size(type);
+  auto load_element = [&](int32_t index) {
+    Address address(ptr, index * element_size);
+    switch (type) {
+      case DataType::Type::kInt8:
+        __ movsxb(tmp, address);
+        break;
+      case DataType::Type::kUint8:
+        __ movzxb(tmp, address);
+        break;
+      case DataType::Type::kUint16:
+        __ movzxw(tmp, address);
+        break;
+      case DataType::Type::kInt32:
+        __ movl(tmp, address);
+        break;
+      default:
+        LOG(FATAL) << "Unexpected type " << type;
+        UNREACHABLE();
+    }
+  };
+
+  NearLabel loop_4elements, process_1element, loop_1element, done;
+
+  __ cmpl(length, Immediate(4));
+  __ j(kLess, &process_1element);
+  __ Bind(&loop_4elements);
+  // hash = hash * 31^4 + element[0] * 31^3 + element[1] * 31^2 + element[2] * 31 + element[3]
+  __ imull(hash, hash, Immediate(31 * 31 * 31 * 31));
+  load_element(0);
+  __ imull(tmp, tmp, Immediate(31 * 31 * 31));
+  __ addl(hash, tmp);
+  load_element(1);
+  __ imull(tmp, tmp, Immediate(31 * 31));
+  __ addl(hash, tmp);
+  load_element(2);
+  __ imull(tmp, tmp, Immediate(31));
+  __ addl(hash, tmp);
+  load_element(3);
+  __ addl(hash, tmp);
+  __ addq(ptr, Immediate(4 * element_size));
+  __ subl(length, Immediate(4));
+  __ cmpl(length, Immediate(4));
+  __ j(kGreaterEqual, &loop_4elements);
+
+  __ Bind(&process_1element);
+  __ testl(length, length);
+  __ j(kEqual, &done);
+  __ Bind(&loop_1element);
+  __ imull(hash, hash, Immediate(31));
+  load_element(0);
+  __ addl(hash, tmp);
+  __ addq(ptr, Immediate(element_size));
+  __ subl(length, Immediate(1));
+  __ j(kNotEqual, &loop_1element);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringHashCode(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringHashCode(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister tmp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  const int32_t hash_code_offset = mirror::String::HashCodeOffset().Int32Value();
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  Label done;
+  // Return the cached hash code if it has been computed already.
+  __ movl(out, Address(str, hash_code_offset));
+  __ testl(out, out);
+  __ j(kNotEqual, &done);
+
+  __ movl(length, Address(str, count_offset));
+  __ leaq(ptr, Address(str, value_offset));
+  if (mirror::kUseStringCompression) {
+    Label uncompressed, hash_computed;
+    // Extract the length; the compression flag goes to the carry flag.
+    __ shrl(length, Immediate(1));
+    __ j(kCarrySet, &uncompressed);
+    GenerateHashCodeLoop(assembler, DataType::Type::kUint8, ptr, length, out, tmp);
+    __ jmp(&hash_computed);
+    __ Bind(&uncompressed);
+    GenerateHashCodeLoop(assembler, DataType::Type::kUint16, ptr, length, out, tmp);
+    __ Bind(&hash_computed);
+  } else {
+    GenerateHashCodeLoop(assembler, DataType::Type::kUint16, ptr, length, out, tmp);
+  }
+  // Cache the hash code. Like String.hashCode(), this is a benign race as all threads
+  // compute the same value.
+  __ movl(Address(str, hash_code_offset), out);
+
+  __ Bind(&done);
+}
+
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
                                          bool start_at_zero) {
@@ -1487,6 +1610,260 @@ void IntrinsicCodeGeneratorX86_64::VisitStringIndexOfAfter(HInvoke* invoke) {
   GenerateStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero= */ false);
 }
 
+static void CreateStringStringIndexOfLocations(HInvoke* invoke,
+                                               ArenaAllocator* allocator,
+                                               bool start_at_zero) {
+  LocationSummary* locations = new (allocator) LocationSummary(invoke,
+                                                               LocationSummary::kCallOnSlowPath,
+                                                               kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  if (!start_at_zero) {
+    locations->SetInAt(2, Location::RequiresRegister());          // The starting index.
+  }
+  // The output doubles as the pattern index while matching a candidate.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+
+  locations->AddTemp(Location::RequiresRegister());     // Pattern length.
+  locations->AddTemp(Location::RequiresRegister());     // Last possible match index.
+  locations->AddTemp(Location::RequiresRegister());     // Current index.
+  locations->AddTemp(Location::RequiresRegister());     // Mask of first character matches.
+  locations->AddTemp(Location::RequiresRegister());     // Candidate index.
+  locations->AddTemp(Location::RequiresRegister());     // Candidate address.
+  locations->AddTemp(Location::RequiresRegister());     // Loaded character.
+  locations->AddTemp(Location::RequiresFpuRegister());  // Broadcast first pattern character.
+  locations->AddTemp(Location::RequiresFpuRegister());  // Loaded characters.
+}
+
+// Compare `pattern_length` characters of `pattern` with the characters at `address`
+// and branch to `mismatch` on the first difference. Falls through on a match.
+static void GenerateStringRegionMatch(X86_64Assembler* assembler,
+                                      CpuRegister address,
+                                      CpuRegister pattern,
+                                      CpuRegister pattern_length,
+                                      CpuRegister pattern_index,
+                                      CpuRegister value,
+                                      bool is_compressed,
+                                      Label* mismatch) {
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const ScaleFactor scale = is_compressed ? TIMES_1 : TIMES_2;
+  NearLabel loop, matched;
+
+  __ xorl(pattern_index, pattern_index);
+  __ Bind(&loop);
+  __ cmpl(pattern_index, pattern_length);
+  __ j(kGreaterEqual, &matched);
+  if (is_compressed) {
+    __ movzxb(value, Address(address, pattern_index, scale, 0));
+    __ movzxb(CpuRegister(TMP), Address(pattern, pattern_index, scale, value_offset));
+  } else {
+    __ movzxw(value, Address(address, pattern_index, scale, 0));
+    __ movzxw(CpuRegister(TMP), Address(pattern, pattern_index, scale, value_offset));
+  }
+  __ cmpl(value, CpuRegister(TMP));
+  __ j(kNotEqual, mismatch);
+  __ addl(pattern_index, Immediate(1));
+  __ jmp(&loop);
+  __ Bind(&matched);
+}
+
+// Search for `pattern` in `string_obj` starting at `index`, where both strings use the same
+// character width. Jumps to `done` with the match index in `out`, or to `not_found`.
+//
+// Candidates are found by comparing the first pattern character with 16 bytes of the string
+// at a time and then verified character by character. The vector loads never go past the end
+// of the string, the remaining tail is searched one index at a time.
+static void GenerateStringSearch(X86_64Assembler* assembler,
+                                 LocationSummary* locations,
+                                 bool is_compressed,
+                                 Label* not_found,
+                                 Label* done) {
+  CpuRegister string_obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister pattern = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister pattern_length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister limit = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister mask = locations->GetTemp(3).AsRegister<CpuRegister>();
+  CpuRegister candidate = locations->GetTemp(4).AsRegister<CpuRegister>();
+  CpuRegister address = locations->GetTemp(5).AsRegister<CpuRegister>();
+  CpuRegister value = locations->GetTemp(6).AsRegister<CpuRegister>();
+  XmmRegister first_chars = locations->GetTemp(7).AsFpuRegister<XmmRegister>();
+  XmmRegister chars = locations->GetTemp(8).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+  const ScaleFactor scale = is_compressed ? TIMES_1 : TIMES_2;
+  const int32_t chars_per_vector = is_compressed ? 16 : 8;
+  Label vector_loop, check_candidates, next_vector, candidate_mismatch;
+  Label scalar_loop, scalar_mismatch;
+
+  // Broadcast the first pattern character to all lanes.
+  if (is_compressed) {
+    __ movzxb(value, Address(pattern, value_offset));
+    __ imull(value, value, Immediate(0x01010101));
+  } else {
+    __ movzxw(value, Address(pattern, value_offset));
+    __ imull(value, value, Immediate(0x00010001));
+  }
+  __ movd(first_chars, value, /* is64bit= */ false);
+  __ pshufd(first_chars, first_chars, Immediate(0));
+
+  // Load a vector only if `index + chars_per_vector <= limit + pattern_length`, i.e. if it
+  // lies within the string.
+  __ Bind(&vector_loop);
+  __ leal(value, Address(index, chars_per_vector));
+  __ subl(value, pattern_length);
+  __ cmpl(value, limit);
+  __ j(kGreater, &scalar_loop);
+  __ movdqu(chars, Address(string_obj, index, scale, value_offset));
+  if (is_compressed) {
+    __ pcmpeqb(chars, first_chars);
+  } else {
+    __ pcmpeqw(chars, first_chars);
+  }
+  __ pmovmskb(mask, chars);
+
+  __ Bind(&check_candidates);
+  __ testl(mask, mask);
+  __ j(kEqual, &next_vector);
+  __ bsfl(candidate, mask);
+  if (!is_compressed) {
+    // Convert the byte offset to a character offset.
+    __ shrl(candidate, Immediate(1));
+  }
+  __ addl(candidate, index);
+  // Candidates come in increasing order, so none of the remaining ones can match.
+  __ cmpl(candidate, limit);
+  __ j(kGreater, not_found);
+  __ leaq(address, Address(string_obj, candidate, scale, value_offset));
+  GenerateStringRegionMatch(
+      assembler, address, pattern, pattern_length, out, value, is_compressed, &candidate_mismatch);
+  __ movl(out, candidate);
+  __ jmp(done);
+
+  __ Bind(&candidate_mismatch);
+  // Clear the mask bits of the rejected candidate, one per byte of the character.
+  for (int32_t i = 0; i != (is_compressed ? 1 : 2); ++i) {
+    __ leal(address, Address(mask, -1));
+    __ andl(mask, address);
+  }
+  __ jmp(&check_candidates);
+
+  __ Bind(&next_vector);
+  __ addl(index, Immediate(chars_per_vector));
+  __ jmp(&vector_loop);
+
+  // Search the tail one index at a time.
+  __ Bind(&scalar_loop);
+  __ cmpl(index, limit);
+  __ j(kGreater, not_found);
+  __ leaq(address, Address(string_obj, index, scale, value_offset));
+  GenerateStringRegionMatch(
+      assembler, address, pattern, pattern_length, out, value, is_compressed, &scalar_mismatch);
+  __ movl(out, index);
+  __ jmp(done);
+
+  __ Bind(&scalar_mismatch);
+  __ addl(index, Immediate(1));
+  __ jmp(&scalar_loop);
+}
+
+static void GenerateStringStringIndexOf(HInvoke* invoke,
+                                        X86_64Assembler* assembler,
+                                        CodeGeneratorX86_64* codegen,
+                                        bool start_at_zero) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  CpuRegister string_obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister pattern = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister pattern_length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister limit = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister value = locations->GetTemp(6).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+
+  // Let the slow path throw the NullPointerException for a null pattern.
+  __ testl(pattern, pattern);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  // Location of count within the String object.
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+
+  // Load the count fields containing the lengths and compression flags.
+  __ movl(limit, Address(string_obj, count_offset));
+  __ movl(pattern_length, Address(pattern, count_offset));
+
+  if (mirror::kUseStringCompression) {
+    // Strings with different compression styles are left to the slow path.
+    __ movl(value, limit);
+    __ xorl(value, pattern_length);
+    __ testl(value, Immediate(1));
+    __ j(kNotZero, slow_path->GetEntryLabel());
+    // Keep the receiver's compression flag in `value` and mask it out of the counts.
+    __ movl(value, limit);
+    __ shrl(limit, Immediate(1));
+    __ shrl(pattern_length, Immediate(1));
+  }
+
+  // An empty pattern matches at the clamped start index; leave that rare case to the slow path.
+  __ testl(pattern_length, pattern_length);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  // Ensure we have a start index >= 0.
+  __ xorl(index, index);
+  if (!start_at_zero) {
+    CpuRegister start_index = locations->InAt(2).AsRegister<CpuRegister>();
+    __ cmpl(start_index, Immediate(0));
+    __ cmov(kGreater, index, start_index, /* is64bit= */ false);  // 32-bit copy is enough.
+  }
+
+  // The last index at which a match can start is string.length - pattern.length.
+  Label not_found, done;
+  __ subl(limit, pattern_length);
+  __ cmpl(index, limit);
+  __ j(kGreater, &not_found);
+
+  if (mirror::kUseStringCompression) {
+    Label uncompressed_string_search;
+    static_assert(static_cast<uint32_t>(mirror::StringCompressionFlag::kCompressed) == 0u,
+                  "Expecting 0=compressed, 1=uncompressed");
+    __ testl(value, Immediate(1));
+    __ j(kNotZero, &uncompressed_string_search);
+    GenerateStringSearch(assembler, locations, /* is_compressed= */ true, &not_found, &done);
+    __ Bind(&uncompressed_string_search);
+  }
+  GenerateStringSearch(assembler, locations, /* is_compressed= */ false, &not_found, &done);
+
+  // Failed to match; return -1.
+  __ Bind(&not_found);
+  __ movl(out, Immediate(-1));
+
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, /* start_at_zero= */ true);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOf(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero= */ true);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  CreateStringStringIndexOfLocations(invoke, allocator_, /* start_at_zero= */ false);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringStringIndexOfAfter(HInvoke* invoke) {
+  GenerateStringStringIndexOf(invoke, GetAssembler(), codegen_, /* start_at_zero= */ false);
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitStringNewStringFromBytes(HInvoke* invoke) {
   LocationSummary* locations = new (allocator_) LocationSummary(
       invoke, LocationSummary::kCallOnMainAndSlowPath, kIntrinsified);
@@ -3419,6 +3796,745 @@ void IntrinsicLocationsBuilderX86_64::VisitReachabilityFence(HInvoke* invoke) {
 
 void IntrinsicCodeGeneratorX86_64::VisitReachabilityFence([[maybe_unused]] HInvoke* invoke) {}
 
+// The SSE4.2 `crc32` instruction implements CRC32-C (Castagnoli), not the CRC32 polynomial
+// 0x04C11DB7 used by java.util.zip.CRC32, so the intrinsics below use carry-less multiplication
+// instead. The constants are for the bit-reflected polynomial, see Intel's "Fast CRC Computation
+// for Generic Polynomials Using PCLMULQDQ Instruction".
+//
+// Barrett reduction constants: mu = x^64 / P(x) and P(x) itself, both bit-reflected.
+static constexpr int64_t kCRC32BarrettMu = INT64_C(0x1F7011641);
+static constexpr int64_t kCRC32BarrettPoly = INT64_C(0x1DB710641);
+// Constants to fold the low and the high 64 bits of a 128-bit value over the next 128 bits,
+// i.e. x^(128+64-1) mod P(x) and x^(128-1) mod P(x), bit-reflected.
+static constexpr int64_t kCRC32FoldLow = INT64_C(0x1751997D0);
+static constexpr int64_t kCRC32FoldHigh = INT64_C(0x0CCAA009E);
+
+static bool HasCarryLessMultiplication(CodeGeneratorX86_64* codegen) {
+  return codegen->GetInstructionSetFeatures().HasPCLMULQDQ();
+}
+
+// Load 128-bit constants `low` and `high` into `dst`, using `tmp` as a temporary.
+static void LoadCRC32ConstantPair(CodeGeneratorX86_64* codegen,
+                                  XmmRegister dst,
+                                  XmmRegister tmp,
+                                  int64_t low,
+                                  int64_t high) {
+  X86_64Assembler* assembler = codegen->GetAssembler();
+  codegen->Load64BitValue(dst, low);
+  codegen->Load64BitValue(tmp, high);
+  __ punpcklqdq(dst, tmp);
+}
+
+// Reduce the 32-bit `value` (the CRC state xor-ed with the next 4 bytes of data)
+// to the updated CRC state using a Barrett reduction:
+//   t1 = clmul(value, mu) mod x^32
+//   value = clmul(t1, P) >> 32
+static void GenerateCRC32BarrettReduction(X86_64Assembler* assembler,
+                                          CpuRegister value,
+                                          XmmRegister xmm_value,
+                                          XmmRegister barrett_constants) {
+  __ movd(xmm_value, value, /* is64bit= */ false);
+  __ pclmulqdq(xmm_value, barrett_constants, Immediate(0x00));
+  // Truncate t1 to 32 bits; the 32-bit `movd` zero-extends it back.
+  __ movd(value, xmm_value, /* is64bit= */ false);
+  __ movd(xmm_value, value, /* is64bit= */ false);
+  __ pclmulqdq(xmm_value, barrett_constants, Immediate(0x10));
+  __ movd(value, xmm_value, /* is64bit= */ true);
+  __ shrq(value, Immediate(32));
+}
+
+// Update the CRC state `crc` with the low byte of `value`. Clobbers `value`.
+static void GenerateCRC32UpdateByte(X86_64Assembler* assembler,
+                                    CpuRegister crc,
+                                    CpuRegister value,
+                                    XmmRegister xmm_value,
+                                    XmmRegister barrett_constants) {
+  // crc = reduce((crc ^ byte) << 24) ^ (crc >> 8)
+  __ xorl(value, crc);
+  __ shll(value, Immediate(24));
+  GenerateCRC32BarrettReduction(assembler, value, xmm_value, barrett_constants);
+  __ shrl(crc, Immediate(8));
+  __ xorl(crc, value);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitCRC32Update(HInvoke* invoke) {
+  if (!HasCarryLessMultiplication(codegen_)) {
+    return;
+  }
+
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of CRC32.update(int crc, int b).
+void IntrinsicCodeGeneratorX86_64::VisitCRC32Update(HInvoke* invoke) {
+  DCHECK(HasCarryLessMultiplication(codegen_));
+
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister crc = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister val = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister tmp = locations->GetTemp(0).AsRegister<CpuRegister>();
+  XmmRegister barrett_constants = locations->GetTemp(1).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm_value = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  // The general algorithm of the CRC32 calculation is:
+  //   crc = ~crc
+  //   result = crc32_for_byte(crc, b)
+  //   crc = ~result
+  LoadCRC32ConstantPair(
+      codegen_, barrett_constants, xmm_value, kCRC32BarrettMu, kCRC32BarrettPoly);
+  __ movl(out, crc);
+  __ notl(out);
+  __ movl(tmp, val);
+  GenerateCRC32UpdateByte(assembler, out, tmp, xmm_value, barrett_constants);
+  __ notl(out);
+}
+
+// Generate code using carry-less multiplication which calculates a CRC32 value of bytes.
+//
+// Parameters:
+//   codegen           - the code generator
+//   crc               - a register holding an initial CRC value
+//   ptr               - a register holding a memory address of bytes, clobbered
+//   length            - a register holding a number of bytes to process, clobbered
+//   out               - a register to put a result of calculation
+//   tmp               - a temporary core register
+//   barrett_constants - a temporary XMM register for the Barrett reduction constants
+//   xmm_value         - a temporary XMM register
+//   fold              - a temporary XMM register for the folded data
+//   fold_constants    - a temporary XMM register for the folding constants
+static void GenerateCodeForCalculationCRC32ValueOfBytes(CodeGeneratorX86_64* codegen,
+                                                        CpuRegister crc,
+                                                        CpuRegister ptr,
+                                                        CpuRegister length,
+                                                        CpuRegister out,
+                                                        CpuRegister tmp,
+                                                        XmmRegister barrett_constants,
+                                                        XmmRegister xmm_value,
+                                                        XmmRegister fold,
+                                                        XmmRegister fold_constants) {
+  X86_64Assembler* assembler = codegen->GetAssembler();
+
+  // The algorithm of CRC32 of bytes is:
+  //   crc = ~crc
+  //   if array has at least 32 bytes:
+  //     fold = 16_bytes(array) ^ crc
+  //     while array has 16 bytes do:
+  //       fold = clmul(fold.low, k_low) ^ clmul(fold.high, k_high) ^ 16_bytes(array)
+  //     crc = crc32_of_16bytes(0, fold)
+  //   while array has 4 bytes do:
+  //     crc = crc32_of_4bytes(crc, 4_bytes(array))
+  //   while array has a byte do:
+  //     crc = crc32_of_byte(crc, 1_byte(array))
+  //   crc = ~crc
+  Label process_4bytes, process_1byte, done;
+  NearLabel fold_loop, loop_4bytes, loop_1byte;
+
+  __ movl(out, crc);
+  __ notl(out);
+  LoadCRC32ConstantPair(
+      codegen, barrett_constants, xmm_value, kCRC32BarrettMu, kCRC32BarrettPoly);
+
+  __ cmpl(length, Immediate(32));
+  __ j(kLess, &process_4bytes);
+
+  LoadCRC32ConstantPair(codegen, fold_constants, xmm_value, kCRC32FoldLow, kCRC32FoldHigh);
+  __ movdqu(fold, Address(ptr, 0));
+  __ movd(xmm_value, out, /* is64bit= */ false);
+  __ pxor(fold, xmm_value);
+  __ addq(ptr, Immediate(16));
+  __ subl(length, Immediate(16));
+
+  // The main loop folding data by 16 bytes.
+  __ Bind(&fold_loop);
+  __ movdqa(xmm_value, fold);
+  __ pclmulqdq(fold, fold_constants, Immediate(0x00));
+  __ pclmulqdq(xmm_value, fold_constants, Immediate(0x11));
+  __ pxor(fold, xmm_value);
+  __ movdqu(xmm_value, Address(ptr, 0));
+  __ pxor(fold, xmm_value);
+  __ addq(ptr, Immediate(16));
+  __ subl(length, Immediate(16));
+  __ cmpl(length, Immediate(16));
+  __ j(kGreaterEqual, &fold_loop);
+
+  // Reduce the folded 16 bytes, 4 bytes at a time, starting from a zero CRC state.
+  __ movd(tmp, fold, /* is64bit= */ true);
+  __ movl(out, tmp);
+  GenerateCRC32BarrettReduction(assembler, out, xmm_value, barrett_constants);
+  __ shrq(tmp, Immediate(32));
+  __ xorl(out, tmp);
+  GenerateCRC32BarrettReduction(assembler, out, xmm_value, barrett_constants);
+  // Move the high 8 bytes down.
+  __ pshufd(fold, fold, Immediate(0x0E));
+  __ movd(tmp, fold, /* is64bit= */ true);
+  __ xorl(out, tmp);
+  GenerateCRC32BarrettReduction(assembler, out, xmm_value, barrett_constants);
+  __ shrq(tmp, Immediate(32));
+  __ xorl(out, tmp);
+  GenerateCRC32BarrettReduction(assembler, out, xmm_value, barrett_constants);
+
+  __ Bind(&process_4bytes);
+  __ cmpl(length, Immediate(4));
+  __ j(kLess, &process_1byte);
+  __ Bind(&loop_4bytes);
+  __ xorl(out, Address(ptr, 0));
+  GenerateCRC32BarrettReduction(assembler, out, xmm_value, barrett_constants);
+  __ addq(ptr, Immediate(4));
+  __ subl(length, Immediate(4));
+  __ cmpl(length, Immediate(4));
+  __ j(kGreaterEqual, &loop_4bytes);
+
+  __ Bind(&process_1byte);
+  __ testl(length, length);
+  __ j(kEqual, &done);
+  __ Bind(&loop_1byte);
+  __ movzxb(tmp, Address(ptr, 0));
+  GenerateCRC32UpdateByte(assembler, out, tmp, xmm_value, barrett_constants);
+  __ addq(ptr, Immediate(1));
+  __ subl(length, Immediate(1));
+  __ j(kNotEqual, &loop_1byte);
+
+  __ Bind(&done);
+  __ notl(out);
+}
+
+static void CreateCRC32UpdateBytesLocations(HInvoke* invoke,
+                                            ArenaAllocator* allocator,
+                                            LocationSummary::CallKind call_kind) {
+  LocationSummary* locations = new (allocator) LocationSummary(invoke, call_kind, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RegisterOrConstant(invoke->InputAt(2)));
+  locations->SetInAt(3, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+static void GenerateCRC32UpdateBytes(CodeGeneratorX86_64* codegen,
+                                     LocationSummary* locations,
+                                     CpuRegister base,
+                                     uint32_t data_offset) {
+  X86_64Assembler* assembler = codegen->GetAssembler();
+
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  Location offset = locations->InAt(2);
+  if (offset.IsConstant()) {
+    int32_t offset_value = offset.GetConstant()->AsIntConstant()->GetValue();
+    __ leaq(ptr, Address(base, data_offset + offset_value));
+  } else {
+    __ leaq(ptr, Address(base, offset.AsRegister<CpuRegister>(), TIMES_1, data_offset));
+  }
+
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  __ movl(length, locations->InAt(3).AsRegister<CpuRegister>());
+
+  GenerateCodeForCalculationCRC32ValueOfBytes(codegen,
+                                              locations->InAt(0).AsRegister<CpuRegister>(),
+                                              ptr,
+                                              length,
+                                              locations->Out().AsRegister<CpuRegister>(),
+                                              locations->GetTemp(2).AsRegister<CpuRegister>(),
+                                              locations->GetTemp(3).AsFpuRegister<XmmRegister>(),
+                                              locations->GetTemp(4).AsFpuRegister<XmmRegister>(),
+                                              locations->GetTemp(5).AsFpuRegister<XmmRegister>(),
+                                              locations->GetTemp(6).AsFpuRegister<XmmRegister>());
+}
+
+// The threshold for sizes of arrays to use the library provided implementation
+// of CRC32.updateBytes instead of the intrinsic.
+static constexpr int32_t kCRC32UpdateBytesThreshold = 64 * 1024;
+
+void IntrinsicLocationsBuilderX86_64::VisitCRC32UpdateBytes(HInvoke* invoke) {
+  if (!HasCarryLessMultiplication(codegen_)) {
+    return;
+  }
+
+  CreateCRC32UpdateBytesLocations(invoke, allocator_, LocationSummary::kCallOnSlowPath);
+}
+
+// Lower the invoke of CRC32.updateBytes(int crc, byte[] b, int off, int len)
+//
+// Note: The intrinsic is not used if len exceeds a threshold.
+void IntrinsicCodeGeneratorX86_64::VisitCRC32UpdateBytes(HInvoke* invoke) {
+  DCHECK(HasCarryLessMultiplication(codegen_));
+
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+
+  CpuRegister length = locations->InAt(3).AsRegister<CpuRegister>();
+  __ cmpl(length, Immediate(kCRC32UpdateBytesThreshold));
+  __ j(kAbove, slow_path->GetEntryLabel());
+
+  const uint32_t array_data_offset =
+      mirror::Array::DataOffset(Primitive::kPrimByte).Uint32Value();
+  GenerateCRC32UpdateBytes(
+      codegen_, locations, locations->InAt(1).AsRegister<CpuRegister>(), array_data_offset);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
+  if (!HasCarryLessMultiplication(codegen_)) {
+    return;
+  }
+
+  CreateCRC32UpdateBytesLocations(invoke, allocator_, LocationSummary::kNoCall);
+}
+
+// Lower the invoke of CRC32.updateByteBuffer(int crc, long addr, int off, int len)
+//
+// There is no need to generate code checking if addr is 0.
+// The method updateByteBuffer is a private method of java.util.zip.CRC32.
+// This guarantees no calls outside of the CRC32 class.
+// An address of DirectBuffer is always passed to the call of updateByteBuffer.
+// It might be an implementation of an empty DirectBuffer which can use a zero
+// address but it must have the length to be zero. The current generated code
+// correctly works with the zero length.
+void IntrinsicCodeGeneratorX86_64::VisitCRC32UpdateByteBuffer(HInvoke* invoke) {
+  DCHECK(HasCarryLessMultiplication(codegen_));
+
+  LocationSummary* locations = invoke->GetLocations();
+  GenerateCRC32UpdateBytes(
+      codegen_, locations, locations->InAt(1).AsRegister<CpuRegister>(), /* data_offset= */ 0u);
+}
+
+// Compare `length` bytes at `a_ptr` and `b_ptr`, 16 bytes at a time, and branch to `not_equal`
+// on the first difference. `length` is a multiple of `element_size`. Falls through if equal.
+// Clobbers `a_ptr`, `b_ptr`, `length` and `tmp`.
+static void GenerateMemoryEquals(X86_64Assembler* assembler,
+                                 CpuRegister a_ptr,
+                                 CpuRegister b_ptr,
+                                 CpuRegister length,
+                                 CpuRegister tmp,
+                                 XmmRegister a_data,
+                                 XmmRegister b_data,
+                                 size_t element_size,
+                                 Label* not_equal) {
+  NearLabel loop, process_8bytes, process_4bytes, process_2bytes, process_1byte, done;
+
+  __ cmpl(length, Immediate(16));
+  __ j(kLess, &process_8bytes);
+  __ Bind(&loop);
+  __ movdqu(a_data, Address(a_ptr, 0));
+  __ movdqu(b_data, Address(b_ptr, 0));
+  __ pcmpeqb(a_data, b_data);
+  __ pmovmskb(tmp, a_data);
+  __ cmpl(tmp, Immediate(0xffff));
+  __ j(kNotEqual, not_equal);
+  __ addq(a_ptr, Immediate(16));
+  __ addq(b_ptr, Immediate(16));
+  __ subl(length, Immediate(16));
+  __ cmpl(length, Immediate(16));
+  __ j(kGreaterEqual, &loop);
+
+  // Less than 16 bytes remain; their count is decomposed by the low four bits of `length`.
+  __ Bind(&process_8bytes);
+  __ testl(length, Immediate(8));
+  __ j(kZero, &process_4bytes);
+  __ movq(tmp, Address(a_ptr, 0));
+  __ cmpq(tmp, Address(b_ptr, 0));
+  __ j(kNotEqual, not_equal);
+  __ addq(a_ptr, Immediate(8));
+  __ addq(b_ptr, Immediate(8));
+
+  __ Bind(&process_4bytes);
+  if (element_size <= 4u) {
+    __ testl(length, Immediate(4));
+    __ j(kZero, &process_2bytes);
+    __ movl(tmp, Address(a_ptr, 0));
+    __ cmpl(tmp, Address(b_ptr, 0));
+    __ j(kNotEqual, not_equal);
+    __ addq(a_ptr, Immediate(4));
+    __ addq(b_ptr, Immediate(4));
+  }
+
+  __ Bind(&process_2bytes);
+  if (element_size <= 2u) {
+    __ testl(length, Immediate(2));
+    __ j(kZero, &process_1byte);
+    __ movzxw(tmp, Address(a_ptr, 0));
+    __ movzxw(CpuRegister(TMP), Address(b_ptr, 0));
+    __ cmpl(tmp, CpuRegister(TMP));
+    __ j(kNotEqual, not_equal);
+    __ addq(a_ptr, Immediate(2));
+    __ addq(b_ptr, Immediate(2));
+  }
+
+  __ Bind(&process_1byte);
+  if (element_size == 1u) {
+    __ testl(length, Immediate(1));
+    __ j(kZero, &done);
+    __ movzxb(tmp, Address(a_ptr, 0));
+    __ movzxb(CpuRegister(TMP), Address(b_ptr, 0));
+    __ cmpl(tmp, CpuRegister(TMP));
+    __ j(kNotEqual, not_equal);
+  }
+  __ Bind(&done);
+}
+
+static void CreateArraysEqualsLocations(HInvoke* invoke, ArenaAllocator* allocator) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Arrays.equals(T[] a, T[] b) for a primitive type T.
+static void GenerateArraysEquals(HInvoke* invoke,
+                                 X86_64Assembler* assembler,
+                                 DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister a = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister b = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister a_ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister b_ptr = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister a_data = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister b_data = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  Label return_true, return_false, end;
+
+  // Reference equality check, return true if same reference (or both null).
+  __ cmpl(a, b);
+  __ j(kEqual, &return_true);
+  // Return false if only one of the arrays is null.
+  __ testl(a, a);
+  __ j(kEqual, &return_false);
+  __ testl(b, b);
+  __ j(kEqual, &return_false);
+
+  // Return false if the lengths differ.
+  __ movl(length, Address(a, length_offset));
+  __ cmpl(length, Address(b, length_offset));
+  __ j(kNotEqual, &return_false);
+
+  // Compare the contents as bytes.
+  if (DataType::SizeShift(type) != 0u) {
+    __ shll(length, Immediate(DataType::SizeShift(type)));
+  }
+  __ leaq(a_ptr, Address(a, data_offset));
+  __ leaq(b_ptr, Address(b, data_offset));
+  GenerateMemoryEquals(
+      assembler, a_ptr, b_ptr, length, out, a_data, b_data, DataType::Size(type), &return_false);
+
+  __ Bind(&return_true);
+  __ movl(out, Immediate(1));
+  __ jmp(&end);
+
+  __ Bind(&return_false);
+  __ xorl(out, out);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateArraysEqualsLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsChar(HInvoke* invoke) {
+  CreateArraysEqualsLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsChar(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetAssembler(), DataType::Type::kUint16);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateArraysEqualsLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenerateArraysEquals(invoke, GetAssembler(), DataType::Type::kInt32);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysMismatchByte(HInvoke* invoke) {
+  LocationSummary* locations =
+      new (allocator_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Arrays.mismatch(byte[] a, byte[] b).
+void IntrinsicCodeGeneratorX86_64::VisitArraysMismatchByte(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister a = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister b = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister tmp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister a_data = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister b_data = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(sizeof(int8_t)).Int32Value();
+
+  // Let the slow path throw the NullPointerException.
+  SlowPathCode* slow_path = new (codegen_->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ testl(a, a);
+  __ j(kEqual, slow_path->GetEntryLabel());
+  __ testl(b, b);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  // Compare the common prefix of length min(a.length, b.length).
+  __ movl(length, Address(a, length_offset));
+  __ movl(tmp, Address(b, length_offset));
+  __ cmpl(length, tmp);
+  __ cmov(kGreater, length, tmp, /* is64bit= */ false);
+  __ xorl(index, index);
+
+  Label vector_loop, scalar_loop, found_in_vector, found, no_mismatch, end;
+
+  // Compare 16 bytes at a time while they are within the common prefix.
+  __ Bind(&vector_loop);
+  __ leal(tmp, Address(index, 16));
+  __ cmpl(tmp, length);
+  __ j(kGreater, &scalar_loop);
+  __ movdqu(a_data, Address(a, index, TIMES_1, data_offset));
+  __ movdqu(b_data, Address(b, index, TIMES_1, data_offset));
+  __ pcmpeqb(a_data, b_data);
+  __ pmovmskb(tmp, a_data);
+  __ xorl(tmp, Immediate(0xffff));
+  __ j(kNotZero, &found_in_vector);
+  __ addl(index, Immediate(16));
+  __ jmp(&vector_loop);
+
+  // Compare the remaining bytes one at a time.
+  __ Bind(&scalar_loop);
+  __ cmpl(index, length);
+  __ j(kGreaterEqual, &no_mismatch);
+  __ movzxb(tmp, Address(a, index, TIMES_1, data_offset));
+  __ movzxb(CpuRegister(TMP), Address(b, index, TIMES_1, data_offset));
+  __ cmpl(tmp, CpuRegister(TMP));
+  __ j(kNotEqual, &found);
+  __ addl(index, Immediate(1));
+  __ jmp(&scalar_loop);
+
+  // The lowest set bit of the mask is the first differing byte of the vector.
+  __ Bind(&found_in_vector);
+  __ bsfl(tmp, tmp);
+  __ addl(index, tmp);
+  __ Bind(&found);
+  __ movl(out, index);
+  __ jmp(&end);
+
+  // The common prefix matches; return -1 for equal lengths and the shorter length otherwise.
+  __ Bind(&no_mismatch);
+  __ movl(out, Immediate(-1));
+  __ movl(tmp, Address(a, length_offset));
+  __ cmpl(tmp, Address(b, length_offset));
+  __ cmov(kNotEqual, out, length, /* is64bit= */ false);
+
+  __ Bind(&end);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+static void CreateArraysHashCodeLocations(HInvoke* invoke, ArenaAllocator* allocator) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kNoCall, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+}
+
+// Lower the invoke of Arrays.hashCode(T[] a) for a primitive type T.
+static void GenerateArraysHashCode(HInvoke* invoke,
+                                   X86_64Assembler* assembler,
+                                   DataType::Type type) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister tmp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+
+  NearLabel end;
+  // The hash code of a null array is 0.
+  __ xorl(out, out);
+  __ testl(array, array);
+  __ j(kEqual, &end);
+
+  __ movl(out, Immediate(1));
+  __ movl(length, Address(array, length_offset));
+  __ leaq(ptr, Address(array, data_offset));
+  GenerateHashCodeLoop(assembler, type, ptr, length, out, tmp);
+  __ Bind(&end);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  CreateArraysHashCodeLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysHashCodeByte(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetAssembler(), DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  CreateArraysHashCodeLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysHashCodeInt(HInvoke* invoke) {
+  GenerateArraysHashCode(invoke, GetAssembler(), DataType::Type::kInt32);
+}
+
+static void CreateArraysFillLocations(HInvoke* invoke, ArenaAllocator* allocator) {
+  LocationSummary* locations =
+      new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+// Lower the invoke of Arrays.fill(T[] a, T value) for a primitive type T.
+static void GenerateArraysFill(HInvoke* invoke,
+                               CodeGeneratorX86_64* codegen,
+                               DataType::Type type) {
+  X86_64Assembler* assembler = codegen->GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister ptr = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister length = locations->GetTemp(1).AsRegister<CpuRegister>();
+  XmmRegister pattern = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+  CpuRegister tmp = CpuRegister(TMP);
+
+  const uint32_t length_offset = mirror::Array::LengthOffset().Uint32Value();
+  const uint32_t data_offset = mirror::Array::DataOffset(DataType::Size(type)).Uint32Value();
+  const size_t element_size = DataType::Size(type);
+
+  // Let the slow path throw the NullPointerException.
+  SlowPathCode* slow_path = new (codegen->GetScopedAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  // Get the number of bytes to fill.
+  __ movl(length, Address(array, length_offset));
+  if (DataType::SizeShift(type) != 0u) {
+    __ shll(length, Immediate(DataType::SizeShift(type)));
+  }
+  __ leaq(ptr, Address(array, data_offset));
+
+  // Broadcast the value to all lanes.
+  if (element_size == 1u) {
+    __ movzxb(tmp, value);
+    __ imull(tmp, tmp, Immediate(0x01010101));
+  } else {
+    DCHECK_EQ(element_size, 4u);
+    __ movl(tmp, value);
+  }
+  __ movd(pattern, tmp, /* is64bit= */ false);
+  __ pshufd(pattern, pattern, Immediate(0));
+
+  NearLabel loop, process_8bytes, process_4bytes, process_2bytes, process_1byte, done;
+
+  __ cmpl(length, Immediate(16));
+  __ j(kLess, &process_8bytes);
+  __ Bind(&loop);
+  __ movdqu(Address(ptr, 0), pattern);
+  __ addq(ptr, Immediate(16));
+  __ subl(length, Immediate(16));
+  __ cmpl(length, Immediate(16));
+  __ j(kGreaterEqual, &loop);
+
+  // Less than 16 bytes remain; their count is decomposed by the low four bits of `length`.
+  __ Bind(&process_8bytes);
+  __ movd(tmp, pattern, /* is64bit= */ true);
+  __ testl(length, Immediate(8));
+  __ j(kZero, &process_4bytes);
+  __ movq(Address(ptr, 0), tmp);
+  __ addq(ptr, Immediate(8));
+
+  __ Bind(&process_4bytes);
+  __ testl(length, Immediate(4));
+  __ j(kZero, &process_2bytes);
+  __ movl(Address(ptr, 0), tmp);
+  __ addq(ptr, Immediate(4));
+
+  __ Bind(&process_2bytes);
+  if (element_size == 1u) {
+    __ testl(length, Immediate(2));
+    __ j(kZero, &process_1byte);
+    __ movw(Address(ptr, 0), tmp);
+    __ addq(ptr, Immediate(2));
+
+    __ Bind(&process_1byte);
+    __ testl(length, Immediate(1));
+    __ j(kZero, &done);
+    __ movb(Address(ptr, 0), tmp);
+  }
+
+  __ Bind(&done);
+  __ Bind(slow_path->GetExitLabel());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  CreateArraysFillLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillByte(HInvoke* invoke) {
+  GenerateArraysFill(invoke, codegen_, DataType::Type::kInt8);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  CreateArraysFillLocations(invoke, allocator_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  GenerateArraysFill(invoke, codegen_, DataType::Type::kInt32);
+}
+
 static void CreateDivideUnsignedLocations(HInvoke* invoke, ArenaAllocator* allocator) {
   LocationSummary* locations =
       new (allocator) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
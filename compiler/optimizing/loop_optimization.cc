@@ -32,6 +32,15 @@ namespace art HIDDEN {
 // Enables vectorization (SIMDization) in the loop optimizer.
 static constexpr bool kEnableVectorization = true;
 
+// Size in bytes of the 128-bit SSE vectors on x86 and x86-64.
+static constexpr uint32_t kX86SSEVectorSizeInBytes = 16u;
+
+// Maximum number of a != b runtime tests guarding a vector loop.
+static constexpr size_t kMaxNumberOfArrayRefsDisambiguationTests = 4u;
+
+// Enables versioning of vectorized loops on their runtime disambiguation tests.
+static constexpr bool kEnableLoopVersioningForDisambiguation = true;
+
 //
 // Static helpers.
 //
@@ -513,6 +522,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
     : HOptimization(graph, name, stats),
       compiler_options_(&codegen.GetCompilerOptions()),
       simd_register_size_(codegen.GetSIMDRegisterWidth()),
+      vector_size_in_bytes_(simd_register_size_),
       induction_range_(induction_analysis),
       loop_allocator_(nullptr),
       global_allocator_(graph_->GetAllocator()),
@@ -526,8 +536,7 @@ HLoopOptimization::HLoopOptimization(HGraph* graph,
       vector_refs_(nullptr),
       vector_static_peeling_factor_(0),
       vector_dynamic_peeling_candidate_(nullptr),
-      vector_runtime_test_a_(nullptr),
-      vector_runtime_test_b_(nullptr),
+      vector_runtime_tests_(nullptr),
       vector_map_(nullptr),
       vector_permanent_map_(nullptr),
       vector_external_set_(nullptr),
@@ -587,6 +596,8 @@ bool HLoopOptimization::LocalRun() {
   ScopedArenaSafeMap<HInstruction*, HInstruction*> reds(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSet<ArrayReference> refs(loop_allocator_->Adapter(kArenaAllocLoopOptimization));
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>> tests(
+      loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> map(
       std::less<HInstruction*>(), loop_allocator_->Adapter(kArenaAllocLoopOptimization));
   ScopedArenaSafeMap<HInstruction*, HInstruction*> perm(
@@ -598,6 +609,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = &iset;
   reductions_ = &reds;
   vector_refs_ = &refs;
+  vector_runtime_tests_ = &tests;
   vector_map_ = &map;
   vector_permanent_map_ = &perm;
   vector_external_set_ = &ext_set;
@@ -608,6 +620,7 @@ bool HLoopOptimization::LocalRun() {
   iset_ = nullptr;
   reductions_ = nullptr;
   vector_refs_ = nullptr;
+  vector_runtime_tests_ = nullptr;
   vector_map_ = nullptr;
   vector_permanent_map_ = nullptr;
   vector_external_set_ = nullptr;
@@ -980,6 +993,12 @@ bool HLoopOptimization::TryVectorizedTraditional(LoopNode* node,
   if (num_of_blocks != 2 || !ShouldVectorizeCommon(node, main_phi, trip_count)) {
     return false;
   }
+  if (NeedsArrayRefsDisambiguationTest() && TryVersionLoopForArrayRefsDisambiguation(node)) {
+    // Versioning splits the loop exit edge.
+    exit = GetInnerLoopFiniteSingleExit(node->loop_info);
+    DCHECK(exit != nullptr);
+    MaybeRecordStat(stats_, MethodCompilationStat::kLoopVersionedForVectorization);
+  }
   VectorizeTraditional(node, body, exit, trip_count);
   MaybeRecordStat(stats_, MethodCompilationStat::kLoopVectorized);
   graph_->SetHasTraditionalSIMD(true);  // flag SIMD usage
@@ -1139,8 +1158,7 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
   vector_refs_->clear();
   vector_static_peeling_factor_ = 0;
   vector_dynamic_peeling_candidate_ = nullptr;
-  vector_runtime_test_a_ =
-  vector_runtime_test_b_ = nullptr;
+  vector_runtime_tests_->clear();
 
   // Traverse the data flow of the loop, in the original program order.
   for (HBlocksInLoopReversePostOrderIterator block_it(*header->GetLoopInformation());
@@ -1213,16 +1231,8 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
           // Found a[i+x] vs. b[i+y]. Accept if x == y (at worst loop-independent data dependence).
           // Conservatively assume a potential loop-carried data dependence otherwise, avoided by
           // generating an explicit a != b disambiguation runtime test on the two references.
-          if (x != y) {
-            // To avoid excessive overhead, we only accept one a != b test.
-            if (vector_runtime_test_a_ == nullptr) {
-              // First test found.
-              vector_runtime_test_a_ = a;
-              vector_runtime_test_b_ = b;
-            } else if ((vector_runtime_test_a_ != a || vector_runtime_test_b_ != b) &&
-                       (vector_runtime_test_a_ != b || vector_runtime_test_b_ != a)) {
-              return false;  // second test would be needed
-            }
+          if (x != y && !TryAddArrayRefsDisambiguationTest(a, b)) {
+            return false;  // too many tests would be needed
           }
         }
       }
@@ -1239,7 +1249,7 @@ bool HLoopOptimization::CanVectorizeDataFlow(LoopNode* node,
       uint32_t vote = (offset == 0)
           ? 0
           : ((desired_alignment - offset) >> DataType::SizeShift(i->type));
-      DCHECK_LT(vote, 16u);
+      DCHECK_LT(vote, desired_alignment);
       ++peeling_votes[vote];
     } else if (BaseAlignment() >= desired_alignment &&
                num_same_alignment > max_num_same_alignment) {
@@ -1268,8 +1278,16 @@ bool HLoopOptimization::ShouldVectorizeCommon(LoopNode* node,
   HBasicBlock* preheader = node->loop_info->GetPreHeader();
 
   bool enable_alignment_strategies = !IsInPredicatedVectorizationMode();
-  if (!TrySetSimpleLoopHeader(header, &main_phi) ||
-      !CanVectorizeDataFlow(node, header, enable_alignment_strategies) ||
+  if (!TrySetSimpleLoopHeader(header, &main_phi)) {
+    return false;
+  }
+  // Try the widest vectors first.
+  vector_size_in_bytes_ = simd_register_size_;
+  bool can_vectorize = CanVectorizeDataFlow(node, header, enable_alignment_strategies);
+  while (!can_vectorize && TryNarrowVectorSize()) {
+    can_vectorize = CanVectorizeDataFlow(node, header, enable_alignment_strategies);
+  }
+  if (!can_vectorize ||
       !IsVectorizationProfitable(trip_count) ||
       !TryAssignLastValue(node->loop_info, main_phi, preheader, /*collect_loop_uses*/ true)) {
     return false;
@@ -1310,9 +1328,7 @@ void HLoopOptimization::VectorizePredicated(LoopNode* node,
   // Generate runtime disambiguation test:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+    HInstruction* rt = GenerateArrayRefsDisambiguationTest(preheader);
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -1456,12 +1472,10 @@ void HLoopOptimization::VectorizeTraditional(LoopNode* node,
   }
   vector_index_ = graph_->GetConstant(induc_type, 0);
 
-  // Generate runtime disambiguation test:
+  // Generate runtime disambiguation test, unless the loop was versioned on it:
   // vtc = a != b ? vtc : 0;
   if (NeedsArrayRefsDisambiguationTest()) {
-    HInstruction* rt = Insert(
-        preheader,
-        new (global_allocator_) HNotEqual(vector_runtime_test_a_, vector_runtime_test_b_));
+    HInstruction* rt = GenerateArrayRefsDisambiguationTest(preheader);
     vtc = Insert(preheader,
                  new (global_allocator_)
                  HSelect(rt, vtc, graph_->GetConstant(induc_type, 0), kNoDexPc));
@@ -2010,8 +2024,83 @@ bool HLoopOptimization::VectorizeUse(LoopNode* node,
   return false;
 }
 
+bool HLoopOptimization::TryAddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b) {
+  for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
+    if ((test.first == a && test.second == b) || (test.first == b && test.second == a)) {
+      return true;  // already tested
+    }
+  }
+  // To avoid excessive overhead, we only accept a few a != b tests.
+  if (vector_runtime_tests_->size() >= kMaxNumberOfArrayRefsDisambiguationTests) {
+    return false;
+  }
+  vector_runtime_tests_->push_back(std::make_pair(a, b));
+  return true;
+}
+
+HInstruction* HLoopOptimization::GenerateArrayRefsDisambiguationTest(HBasicBlock* block) {
+  DCHECK(NeedsArrayRefsDisambiguationTest());
+  // rt = a1 != b1 && .. && an != bn;
+  HInstruction* rt = nullptr;
+  for (const std::pair<HInstruction*, HInstruction*>& test : *vector_runtime_tests_) {
+    HInstruction* ne = Insert(block, new (global_allocator_) HNotEqual(test.first, test.second));
+    rt = (rt == nullptr)
+        ? ne
+        : Insert(block, new (global_allocator_)
+                 HSelect(rt, ne, graph_->GetIntConstant(0), kNoDexPc));
+  }
+  return rt;
+}
+
+bool HLoopOptimization::TryVersionLoopForArrayRefsDisambiguation(LoopNode* node) {
+  HLoopInformation* loop_info = node->loop_info;
+  // A single test is cheaply folded into the vector trip count, with the cleanup loop
+  // running all iterations when it fails. Reductions would need to be merged with their
+  // scalar counterparts after the loops.
+  if (!kEnableLoopVersioningForDisambiguation ||
+      vector_runtime_tests_->size() < 2u ||
+      !reductions_->empty() ||
+      !LoopClonerHelper::IsLoopClonable(loop_info)) {
+    return false;
+  }
+
+  // Version the loop:
+  //   if (a1 != b1 && .. && an != bn) {
+  //     <loop>         // vectorized next, no further runtime test needed
+  //   } else {
+  //     <loop-copy>    // scalar fallback
+  //   }
+  HBasicBlock* guard = loop_info->GetPreHeader();
+  DCHECK(guard->GetLastInstruction()->IsGoto());
+  LoopClonerSimpleHelper helper(loop_info, &induction_range_);
+  helper.DoVersioning();
+  DCHECK_EQ(guard->GetSuccessors().size(), 2u);
+  DCHECK(loop_info->GetPreHeader() != guard);
+  DCHECK(guard->GetSuccessors()[0]->Dominates(loop_info->GetHeader()));
+
+  HInstruction* rt = GenerateArrayRefsDisambiguationTest(guard);
+  HInstruction* old_goto = guard->GetLastInstruction();
+  guard->RemoveInstruction(old_goto);
+  guard->AddInstruction(new (global_allocator_) HIf(rt));
+
+  // The vector loop no longer needs the runtime tests.
+  vector_runtime_tests_->clear();
+  return true;
+}
+
 uint32_t HLoopOptimization::GetVectorSizeInBytes() {
-  return simd_register_size_;
+  return vector_size_in_bytes_;
+}
+
+bool HLoopOptimization::TryNarrowVectorSize() {
+  // Loops using operations that have no 256-bit AVX2 implementation fall back
+  // to 128-bit SSE vectors.
+  if (compiler_options_->GetInstructionSet() == InstructionSet::kX86_64 &&
+      vector_size_in_bytes_ > kX86SSEVectorSizeInBytes) {
+    vector_size_in_bytes_ = kX86SSEVectorSizeInBytes;
+    return true;
+  }
+  return false;
 }
 
 bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrictions) {
@@ -2122,8 +2211,22 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
     case InstructionSet::kX86:
     case InstructionSet::kX86_64:
       // Allow vectorization for SSE4.1-enabled X86 devices only (128-bit SIMD).
+      // AVX2-enabled X86-64 devices use 256-bit SIMD for the subset of operations
+      // the code generator supports at that width.
       *restrictions |= kNoIfCond;
       if (features->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+        const uint32_t vector_size = GetVectorSizeInBytes();
+        if (vector_size > kX86SSEVectorSizeInBytes) {
+          *restrictions |= kNoAbs |
+                           kNoSignedHAdd |
+                           kNoUnsignedHAdd |
+                           kNoUnroundedHAdd |
+                           kNoStringCharAt |
+                           kNoReduction |
+                           kNoSAD |
+                           kNoWideSAD |
+                           kNoDotProd;
+        }
         switch (type) {
           case DataType::Type::kBool:
           case DataType::Type::kUint8:
@@ -2136,7 +2239,7 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 16);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kUint16:
             *restrictions |= kNoDiv |
                              kNoAbs |
@@ -2144,26 +2247,26 @@ bool HLoopOptimization::TrySetVectorType(DataType::Type type, uint64_t* restrict
                              kNoUnroundedHAdd |
                              kNoSAD |
                              kNoDotProd;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kInt16:
             *restrictions |= kNoDiv |
                              kNoAbs |
                              kNoSignedHAdd |
                              kNoUnroundedHAdd |
                              kNoSAD;
-            return TrySetVectorLength(type, 8);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kInt32:
             *restrictions |= kNoDiv | kNoSAD;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kInt64:
             *restrictions |= kNoMul | kNoDiv | kNoShr | kNoAbs | kNoSAD;
-            return TrySetVectorLength(type, 2);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kFloat32:
             *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 4);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           case DataType::Type::kFloat64:
             *restrictions |= kNoReduction;
-            return TrySetVectorLength(type, 2);
+            return TrySetVectorLength(type, vector_size / DataType::Size(type));
           default:
             break;
         }  // switch type
@@ -381,7 +381,18 @@ class HLoopOptimization : public HOptimization {
                                HInstruction* step);
 
   // Returns whether the vector loop needs runtime disambiguation test for array refs.
-  bool NeedsArrayRefsDisambiguationTest() const { return vector_runtime_test_a_ != nullptr; }
+  bool NeedsArrayRefsDisambiguationTest() const { return !vector_runtime_tests_->empty(); }
+
+  // Records the need for an a != b runtime test. Returns false if too many tests are needed.
+  bool TryAddArrayRefsDisambiguationTest(HInstruction* a, HInstruction* b);
+
+  // Generates the conjunction of all a != b runtime tests at the end of the given block.
+  HInstruction* GenerateArrayRefsDisambiguationTest(HBasicBlock* block);
+
+  // Versions the loop on the runtime disambiguation tests, so that the original loop,
+  // which is then vectorized, only runs for disjoint arrays and a scalar copy of the
+  // loop handles the remaining cases. Returns whether the loop was versioned.
+  bool TryVersionLoopForArrayRefsDisambiguation(LoopNode* node);
 
   bool VectorizeDef(LoopNode* node, HInstruction* instruction, bool generate_code);
   bool VectorizeUse(LoopNode* node,
@@ -390,6 +401,8 @@ class HLoopOptimization : public HOptimization {
                     DataType::Type type,
                     uint64_t restrictions);
   uint32_t GetVectorSizeInBytes();
+  // Falls back to a narrower vector size after a failed attempt with the current one.
+  bool TryNarrowVectorSize();
   bool TrySetVectorType(DataType::Type type, /*out*/ uint64_t* restrictions);
   bool TrySetVectorLengthImpl(uint32_t length);
 
@@ -488,6 +501,10 @@ class HLoopOptimization : public HOptimization {
   // Cached target SIMD vector register size in bytes.
   const size_t simd_register_size_;
 
+  // Vector size in bytes used for the loop being vectorized. This is the SIMD register
+  // size, unless the loop needs to fall back to narrower vectors.
+  uint32_t vector_size_in_bytes_;
+
   // Range information based on prior induction variable analysis.
   InductionVarRange induction_range_;
 
@@ -531,9 +548,9 @@ class HLoopOptimization : public HOptimization {
   uint32_t vector_static_peeling_factor_;
   const ArrayReference* vector_dynamic_peeling_candidate_;
 
-  // Dynamic data dependence test of the form a != b.
-  HInstruction* vector_runtime_test_a_;
-  HInstruction* vector_runtime_test_b_;
+  // Dynamic data dependence tests of the form a != b.
+  // Contents reside in phase-local heap memory.
+  ScopedArenaVector<std::pair<HInstruction*, HInstruction*>>* vector_runtime_tests_;
 
   // Mapping used during vectorization synthesis for both the scalar peeling/cleanup
   // loop (mode is kSequential) and the actual vector loop (mode is kVector). The data
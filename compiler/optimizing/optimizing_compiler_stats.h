@@ -79,6 +79,7 @@ enum class MethodCompilationStat {
   kLoopInvariantMoved,
   kLoopVectorized,
   kLoopVectorizedIdiom,
+  kLoopVersionedForVectorization,
   kSelectGenerated,
   kRemovedInstanceOf,
   kPropagatedIfValue,
@@ -97,6 +98,7 @@ enum class MethodCompilationStat {
   kNotInlinedStackMaps,
   kNotInlinedEnvironmentBudget,
   kNotInlinedInstructionBudget,
+  kNotInlinedColdCallSite,
   kNotInlinedLoopWithoutExit,
   kNotInlinedIrreducibleLoopCallee,
   kNotInlinedIrreducibleLoopCaller,
@@ -136,6 +138,7 @@ enum class MethodCompilationStat {
   kPartialStoreRemoved,
   kPartialAllocationMoved,
   kDevirtualized,
+  kMethodHandleInvokeExactReplaced,
   kLastStat
 };
 std::ostream& operator<<(std::ostream& os, MethodCompilationStat rhs);
@@ -55,8 +55,7 @@ void SsaLivenessAnalysis::NumberInstructions() {
       if (locations != nullptr && locations->Out().IsValid()) {
         instructions_from_ssa_index_.push_back(current);
         current->SetSsaIndex(ssa_index++);
-        current->SetLiveInterval(
-            LiveInterval::MakeInterval(allocator_, current->GetType(), current));
+        current->SetLiveInterval(MakeInterval(current));
       }
       current->SetLifetimePosition(lifetime_position);
     }
@@ -73,8 +72,7 @@ void SsaLivenessAnalysis::NumberInstructions() {
       if (locations != nullptr && locations->Out().IsValid()) {
         instructions_from_ssa_index_.push_back(current);
         current->SetSsaIndex(ssa_index++);
-        current->SetLiveInterval(
-            LiveInterval::MakeInterval(allocator_, current->GetType(), current));
+        current->SetLiveInterval(MakeInterval(current));
       }
       instructions_from_lifetime_position_.push_back(current);
       current->SetLifetimePosition(lifetime_position);
@@ -86,6 +84,15 @@ void SsaLivenessAnalysis::NumberInstructions() {
   number_of_ssa_values_ = ssa_index;
 }
 
+LiveInterval* SsaLivenessAnalysis::MakeInterval(HInstruction* instruction) {
+  LiveInterval* interval =
+      LiveInterval::MakeInterval(allocator_, instruction->GetType(), instruction);
+  if (HVecOperation::ReturnsSIMDValue(instruction)) {
+    interval->SetMinimumSIMDSpillSlots(codegen_->GetSIMDRegisterWidth() / kVRegSize);
+  }
+  return interval;
+}
+
 void SsaLivenessAnalysis::ComputeLiveness() {
   for (HBasicBlock* block : graph_->GetLinearOrder()) {
     block_infos_[block->GetBlockId()] =
@@ -496,7 +503,8 @@ size_t LiveInterval::NumberOfSpillSlotsNeeded() const {
     if (definition->IsPhi()) {
       definition = definition->InputAt(1);  // SIMD always appears on back-edge
     }
-    return definition->AsVecOperation()->GetVectorNumberOfBytes() / kVRegSize;
+    return std::max(definition->AsVecOperation()->GetVectorNumberOfBytes() / kVRegSize,
+                    GetParent()->minimum_simd_spill_slots_);
   }
   // Return number of needed spill slots based on type.
   return (type_ == DataType::Type::kInt64 || type_ == DataType::Type::kFloat64) ? 2 : 1;
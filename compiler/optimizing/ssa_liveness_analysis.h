@@ -790,6 +790,15 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
   // Dex virtual register size `kVRegSize`).
   size_t NumberOfSpillSlotsNeeded() const;
 
+  // Sets the minimum number of spill slots of a SIMD value. Spills and moves of SIMD
+  // values use the full width of the SIMD registers, which can be wider than the
+  // vector operation defining the value (e.g. 128-bit vectors on AVX2).
+  void SetMinimumSIMDSpillSlots(size_t number_of_slots) {
+    DCHECK(!IsTemp());
+    DCHECK(GetParent() == this);
+    minimum_simd_spill_slots_ = number_of_slots;
+  }
+
   bool IsFloatingPoint() const {
     return type_ == DataType::Type::kFloat32 || type_ == DataType::Type::kFloat64;
   }
@@ -1001,7 +1010,8 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
         is_temp_(is_temp),
         is_high_interval_(is_high_interval),
         high_or_low_interval_(nullptr),
-        defined_by_(defined_by) {}
+        defined_by_(defined_by),
+        minimum_simd_spill_slots_(0u) {}
 
   // Searches for a LiveRange that either covers the given position or is the
   // first next LiveRange. Returns null if no such LiveRange exists. Ranges
@@ -1140,6 +1150,9 @@ class LiveInterval : public ArenaObject<kArenaAllocSsaLiveness> {
   // The instruction represented by this interval.
   HInstruction* const defined_by_;
 
+  // Minimum number of spill slots if this interval holds a SIMD value.
+  size_t minimum_simd_spill_slots_;
+
   static constexpr int kNoRegister = -1;
   static constexpr int kNoSpillSlot = -1;
 
@@ -1246,6 +1259,9 @@ class SsaLivenessAnalysis : public ValueObject {
   // and setup the lifetime information of each instruction and block.
   void NumberInstructions();
 
+  // Create the live interval of `instruction`.
+  LiveInterval* MakeInterval(HInstruction* instruction);
+
   // Compute live ranges of instructions, as well as live_in, live_out and kill sets.
   void ComputeLiveness();
 
@@ -3473,6 +3473,348 @@ void X86_64Assembler::maxpd(XmmRegister dst, XmmRegister src) {
   EmitXmmRegisterOperand(dst.LowBits(), src);
 }
 
+/** VEX.256.F3.0F.WIG 6F /r VMOVDQU ymm1, m256 */
+void X86_64Assembler::vmovdqu256(XmmRegister dst, const Address& src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(0x6F, SET_VEX_PP_F3, dst, src);
+}
+
+/** VEX.256.F3.0F.WIG 7F /r VMOVDQU m256, ymm1 */
+void X86_64Assembler::vmovdqu256(const Address& dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  EmitVex256MemoryOperation(0x7F, SET_VEX_PP_F3, src, dst);
+}
+
+/** VEX.256.0F.WIG 28 /r VMOVAPS ymm1, ymm2/m256 */
+void X86_64Assembler::vmovaps256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x28, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F38.W0 78 /r VPBROADCASTB ymm1, xmm2/m8 */
+void X86_64Assembler::vpbroadcastb256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x78, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F38.W0 79 /r VPBROADCASTW ymm1, xmm2/m16 */
+void X86_64Assembler::vpbroadcastw256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x79, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F38.W0 58 /r VPBROADCASTD ymm1, xmm2/m32 */
+void X86_64Assembler::vpbroadcastd256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x58, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F38.W0 59 /r VPBROADCASTQ ymm1, xmm2/m64 */
+void X86_64Assembler::vpbroadcastq256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x59, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F38.W0 18 /r VBROADCASTSS ymm1, xmm2 */
+void X86_64Assembler::vbroadcastss256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x18, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F38.W0 19 /r VBROADCASTSD ymm1, xmm2 */
+void X86_64Assembler::vbroadcastsd256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x19, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.0F.WIG 5B /r VCVTDQ2PS ymm1, ymm2/m256 */
+void X86_64Assembler::vcvtdq2ps256(XmmRegister dst, XmmRegister src) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256RegisterOperation(0x5B, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                              dst.AsFloatRegister(), vvvv_reg, src);
+}
+
+/** VEX.256.66.0F.WIG FC /r VPADDB ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpaddb256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xFC, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG FD /r VPADDW ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpaddw256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xFD, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG FE /r VPADDD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpaddd256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xFE, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG D4 /r VPADDQ ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpaddq256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xD4, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG F8 /r VPSUBB ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpsubb256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xF8, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG F9 /r VPSUBW ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpsubw256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xF9, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG FA /r VPSUBD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpsubd256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xFA, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG FB /r VPSUBQ ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpsubq256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xFB, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG D5 /r VPMULLW ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpmullw256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xD5, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F38.WIG 40 /r VPMULLD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpmulld256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x40, SET_VEX_M_0F_38, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.0F.WIG 58 /r VADDPS ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vaddps256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x58, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG 58 /r VADDPD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vaddpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x58, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.0F.WIG 5C /r VSUBPS ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vsubps256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x5C, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG 5C /r VSUBPD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vsubpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x5C, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.0F.WIG 59 /r VMULPS ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vmulps256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x59, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG 59 /r VMULPD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vmulpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x59, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.0F.WIG 5E /r VDIVPS ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vdivps256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x5E, SET_VEX_M_0F, SET_VEX_PP_NONE,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG 5E /r VDIVPD ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vdivpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x5E, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG DB /r VPAND ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpand256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xDB, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG DF /r VPANDN ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpandn256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xDF, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG EB /r VPOR ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpor256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xEB, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG EF /r VPXOR ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpxor256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0xEF, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG 74 /r VPCMPEQB ymm1, ymm2, ymm3/m256 */
+void X86_64Assembler::vpcmpeqb256(XmmRegister dst, XmmRegister src1, XmmRegister src2) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(src1.AsFloatRegister());
+  EmitVex256RegisterOperation(0x74, SET_VEX_M_0F, SET_VEX_PP_66,
+                              dst.AsFloatRegister(), vvvv_reg, src2);
+}
+
+/** VEX.256.66.0F.WIG 71 /6 ib VPSLLW ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsllw256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x71, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 6, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 72 /6 ib VPSLLD ymm1, ymm2, imm8 */
+void X86_64Assembler::vpslld256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x72, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 6, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 73 /6 ib VPSLLQ ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsllq256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x73, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 6, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 71 /4 ib VPSRAW ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsraw256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x71, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 4, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 72 /4 ib VPSRAD ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrad256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x72, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 4, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 71 /2 ib VPSRLW ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrlw256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x71, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 2, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 72 /2 ib VPSRLD ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrld256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x72, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 2, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.256.66.0F.WIG 73 /2 ib VPSRLQ ymm1, ymm2, imm8 */
+void X86_64Assembler::vpsrlq256(XmmRegister dst, XmmRegister src, const Immediate& shift_count) {
+  DCHECK(CpuHasAVX2FeatureFlag());
+  DCHECK(shift_count.is_uint8());
+  X86_64ManagedRegister vvvv_reg = X86_64ManagedRegister::FromXmmRegister(dst.AsFloatRegister());
+  EmitVex256RegisterOperation(0x73, SET_VEX_M_0F, SET_VEX_PP_66, /*reg=*/ 2, vvvv_reg, src);
+  EmitUint8(shift_count.value());
+}
+
+/** VEX.128.0F.WIG 77 VZEROUPPER */
+void X86_64Assembler::vzeroupper() {
+  DCHECK(CpuHasAVXorAVX2FeatureFlag());
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(EmitVexPrefixByteZero(/*is_twobyte_form=*/ true));
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitUint8(EmitVexPrefixByteOne(/*R=*/ false, vvvv_reg, SET_VEX_L_128, SET_VEX_PP_NONE));
+  EmitUint8(0x77);
+}
+
 void X86_64Assembler::pcmpeqb(XmmRegister dst, XmmRegister src) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -3568,6 +3910,28 @@ void X86_64Assembler::shufps(XmmRegister dst, XmmRegister src, const Immediate&
 }
 
 
+void X86_64Assembler::pmovmskb(CpuRegister dst, XmmRegister src) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0xD7);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+}
+
+
+void X86_64Assembler::pclmulqdq(XmmRegister dst, XmmRegister src, const Immediate& imm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitUint8(0x66);
+  EmitOptionalRex32(dst, src);
+  EmitUint8(0x0F);
+  EmitUint8(0x3A);
+  EmitUint8(0x44);
+  EmitXmmRegisterOperand(dst.LowBits(), src);
+  EmitUint8(imm.value());
+}
+
+
 void X86_64Assembler::pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm) {
   AssemblerBuffer::EnsureCapacity ensured(&buffer_);
   EmitUint8(0x66);
@@ -5846,5 +6210,53 @@ uint8_t X86_64Assembler::EmitVexPrefixByteTwo(bool W,
   return vex_prefix;
 }
 
+void X86_64Assembler::EmitVex256Prefix(bool R,
+                                       bool X,
+                                       bool B,
+                                       X86_64ManagedRegister vvvv,
+                                       int SET_VEX_M,
+                                       int SET_VEX_PP) {
+  // The two-byte form can only encode the 0F opcode map and no REX.X or REX.B extension.
+  bool is_twobyte_form = (SET_VEX_M == SET_VEX_M_0F) && !X && !B;
+  EmitUint8(EmitVexPrefixByteZero(is_twobyte_form));
+  if (is_twobyte_form) {
+    EmitUint8(EmitVexPrefixByteOne(R, vvvv, SET_VEX_L_256, SET_VEX_PP));
+  } else {
+    EmitUint8(EmitVexPrefixByteOne(R, X, B, SET_VEX_M));
+    EmitUint8(vvvv.IsNoRegister()
+                  ? EmitVexPrefixByteTwo(/*W=*/ false, SET_VEX_L_256, SET_VEX_PP)
+                  : EmitVexPrefixByteTwo(/*W=*/ false, vvvv, SET_VEX_L_256, SET_VEX_PP));
+  }
+}
+
+void X86_64Assembler::EmitVex256RegisterOperation(uint8_t opcode,
+                                                  int SET_VEX_M,
+                                                  int SET_VEX_PP,
+                                                  int reg,
+                                                  X86_64ManagedRegister vvvv,
+                                                  XmmRegister rm) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  EmitVex256Prefix(/*R=*/ reg > 7, /*X=*/ false, rm.NeedsRex(), vvvv, SET_VEX_M, SET_VEX_PP);
+  EmitUint8(opcode);
+  EmitRegisterOperand(reg & 7, rm.LowBits());
+}
+
+void X86_64Assembler::EmitVex256MemoryOperation(uint8_t opcode,
+                                                int SET_VEX_PP,
+                                                XmmRegister reg,
+                                                const Address& address) {
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  uint8_t rex = address.rex();
+  X86_64ManagedRegister vvvv_reg = ManagedRegister::NoRegister().AsX86_64();
+  EmitVex256Prefix(reg.NeedsRex(),
+                   (rex & GET_REX_X) != 0,
+                   (rex & GET_REX_B) != 0,
+                   vvvv_reg,
+                   SET_VEX_M_0F,
+                   SET_VEX_PP);
+  EmitUint8(opcode);
+  EmitOperand(reg.LowBits(), address);
+}
+
 }  // namespace x86_64
 }  // namespace art
@@ -712,6 +712,59 @@ class X86_64Assembler final : public Assembler {
   void minpd(XmmRegister dst, XmmRegister src);
   void maxpd(XmmRegister dst, XmmRegister src);
 
+  // AVX2 operations on 256-bit vectors (VEX.256 encoding). The XMM register
+  // arguments denote the YMM registers they alias.
+  void vmovaps256(XmmRegister dst, XmmRegister src);
+  void vmovdqu256(XmmRegister dst, const Address& src);
+  void vmovdqu256(const Address& dst, XmmRegister src);
+
+  void vpbroadcastb256(XmmRegister dst, XmmRegister src);
+  void vpbroadcastw256(XmmRegister dst, XmmRegister src);
+  void vpbroadcastd256(XmmRegister dst, XmmRegister src);
+  void vpbroadcastq256(XmmRegister dst, XmmRegister src);
+  void vbroadcastss256(XmmRegister dst, XmmRegister src);
+  void vbroadcastsd256(XmmRegister dst, XmmRegister src);
+
+  void vpaddb256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpaddw256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpaddd256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpaddq256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubb256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubw256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubd256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpsubq256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpmullw256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpmulld256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+
+  void vaddps256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vaddpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vsubps256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vsubpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vmulps256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vmulpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vdivps256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vdivpd256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+
+  void vpand256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpandn256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpor256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpxor256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+  void vpcmpeqb256(XmmRegister dst, XmmRegister src1, XmmRegister src2);
+
+  void vpsllw256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpslld256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsllq256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsraw256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrad256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrlw256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrld256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+  void vpsrlq256(XmmRegister dst, XmmRegister src, const Immediate& shift_count);
+
+  void vcvtdq2ps256(XmmRegister dst, XmmRegister src);
+
+  // Clear the upper halves of all YMM registers, to avoid AVX-SSE transition penalties.
+  void vzeroupper();
+
   void pcmpeqb(XmmRegister dst, XmmRegister src);
   void pcmpeqw(XmmRegister dst, XmmRegister src);
   void pcmpeqd(XmmRegister dst, XmmRegister src);
@@ -722,6 +775,10 @@ class X86_64Assembler final : public Assembler {
   void pcmpgtd(XmmRegister dst, XmmRegister src);
   void pcmpgtq(XmmRegister dst, XmmRegister src);  // SSE4.2
 
+  void pmovmskb(CpuRegister dst, XmmRegister src);
+
+  void pclmulqdq(XmmRegister dst, XmmRegister src, const Immediate& imm);  // PCLMULQDQ
+
   void shufpd(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void shufps(XmmRegister dst, XmmRegister src, const Immediate& imm);
   void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
@@ -1111,6 +1168,7 @@ class X86_64Assembler final : public Assembler {
   }
 
   bool CpuHasAVXorAVX2FeatureFlag();
+  bool CpuHasAVX2FeatureFlag() const { return has_AVX2_; }
 
  private:
   void EmitUint8(uint8_t value);
@@ -1179,6 +1237,21 @@ class X86_64Assembler final : public Assembler {
                                int SET_VEX_L,
                                int SET_VEX_PP);
 
+  // Helpers for the VEX.256 encoded AVX2 instructions. `reg` is the ModRM.reg
+  // field (a register number, or an opcode extension), `vvvv` the VEX.vvvv operand.
+  void EmitVex256Prefix(bool R, bool X, bool B, X86_64ManagedRegister vvvv, int SET_VEX_M,
+                        int SET_VEX_PP);
+  void EmitVex256RegisterOperation(uint8_t opcode,
+                                   int SET_VEX_M,
+                                   int SET_VEX_PP,
+                                   int reg,
+                                   X86_64ManagedRegister vvvv,
+                                   XmmRegister rm);
+  void EmitVex256MemoryOperation(uint8_t opcode,
+                                 int SET_VEX_PP,
+                                 XmmRegister reg,
+                                 const Address& address);
+
   // Helper function to emit a shorter variant of XCHG if at least one operand is RAX/EAX/AX.
   bool try_xchg_rax(CpuRegister dst,
                     CpuRegister src,
@@ -1901,6 +1901,70 @@ TEST_F(AssemblerX86_64AVXTest, VFmadd213sd) {
                       "vfmadd213sd %{reg3}, %{reg2}, %{reg1}"), "vfmadd213sd");
 }
 
+// The repeat drivers name XMM registers, so the 256-bit forms are checked explicitly.
+
+TEST_F(AssemblerX86_64AVXTest, VPaddd256) {
+  GetAssembler()->vpaddd256(x86_64::XmmRegister(x86_64::XMM0),
+                            x86_64::XmmRegister(x86_64::XMM1),
+                            x86_64::XmmRegister(x86_64::XMM2));
+  GetAssembler()->vpaddd256(x86_64::XmmRegister(x86_64::XMM8),
+                            x86_64::XmmRegister(x86_64::XMM9),
+                            x86_64::XmmRegister(x86_64::XMM15));
+  DriverStr("vpaddd %ymm2, %ymm1, %ymm0\n"
+            "vpaddd %ymm15, %ymm9, %ymm8\n", "vpaddd256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMulps256) {
+  GetAssembler()->vmulps256(x86_64::XmmRegister(x86_64::XMM3),
+                            x86_64::XmmRegister(x86_64::XMM4),
+                            x86_64::XmmRegister(x86_64::XMM12));
+  DriverStr("vmulps %ymm12, %ymm4, %ymm3\n", "vmulps256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPxor256) {
+  GetAssembler()->vpxor256(x86_64::XmmRegister(x86_64::XMM5),
+                           x86_64::XmmRegister(x86_64::XMM5),
+                           x86_64::XmmRegister(x86_64::XMM5));
+  DriverStr("vpxor %ymm5, %ymm5, %ymm5\n", "vpxor256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VMovdqu256) {
+  GetAssembler()->vmovdqu256(x86_64::XmmRegister(x86_64::XMM1),
+                             x86_64::Address(x86_64::CpuRegister(x86_64::RAX),
+                                             x86_64::CpuRegister(x86_64::RBX),
+                                             x86_64::TIMES_4,
+                                             12));
+  GetAssembler()->vmovdqu256(x86_64::Address(x86_64::CpuRegister(x86_64::R9), 16),
+                             x86_64::XmmRegister(x86_64::XMM10));
+  DriverStr("vmovdqu 0xc(%rax,%rbx,4), %ymm1\n"
+            "vmovdqu %ymm10, 0x10(%r9)\n", "vmovdqu256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPbroadcastd256) {
+  GetAssembler()->vpbroadcastd256(x86_64::XmmRegister(x86_64::XMM0),
+                                  x86_64::XmmRegister(x86_64::XMM0));
+  GetAssembler()->vbroadcastss256(x86_64::XmmRegister(x86_64::XMM11),
+                                  x86_64::XmmRegister(x86_64::XMM11));
+  DriverStr("vpbroadcastd %xmm0, %ymm0\n"
+            "vbroadcastss %xmm11, %ymm11\n", "vpbroadcastd256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, VPslld256) {
+  GetAssembler()->vpslld256(x86_64::XmmRegister(x86_64::XMM2),
+                            x86_64::XmmRegister(x86_64::XMM2),
+                            x86_64::Immediate(3));
+  GetAssembler()->vpsrlq256(x86_64::XmmRegister(x86_64::XMM9),
+                            x86_64::XmmRegister(x86_64::XMM9),
+                            x86_64::Immediate(7));
+  DriverStr("vpslld $3, %ymm2, %ymm2\n"
+            "vpsrlq $7, %ymm9, %ymm9\n", "vpslld256");
+}
+
+TEST_F(AssemblerX86_64AVXTest, Vzeroupper) {
+  GetAssembler()->vzeroupper();
+  DriverStr("vzeroupper\n", "vzeroupper");
+}
+
 TEST_F(AssemblerX86_64Test, Phaddw) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::phaddw, "phaddw %{reg2}, %{reg1}"), "phaddw");
 }
@@ -2044,6 +2108,15 @@ TEST_F(AssemblerX86_64Test, PShufd) {
                       "pshufd ${imm}, %{reg2}, %{reg1}"), "pshufd");
 }
 
+TEST_F(AssemblerX86_64Test, Pmovmskb) {
+  DriverStr(RepeatrF(&x86_64::X86_64Assembler::pmovmskb, "pmovmskb %{reg2}, %{reg1}"), "pmovmskb");
+}
+
+TEST_F(AssemblerX86_64Test, Pclmulqdq) {
+  DriverStr(RepeatFFI(&x86_64::X86_64Assembler::pclmulqdq, /*imm_bytes*/ 1U,
+                      "pclmulqdq ${imm}, %{reg2}, %{reg1}"), "pclmulqdq");
+}
+
 TEST_F(AssemblerX86_64Test, Punpcklbw) {
   DriverStr(RepeatFF(&x86_64::X86_64Assembler::punpcklbw,
                      "punpcklbw %{reg2}, %{reg1}"), "punpcklbw");
@@ -79,6 +79,7 @@
 #include "dex/verification_results.h"
 #include "dex2oat_options.h"
 #include "dexlayout.h"
+#include "driver/compilation_shard.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
 #include "driver/compiler_options_map-inl.h"
@@ -109,6 +110,7 @@
 #include "scoped_thread_state_change-inl.h"
 #include "stream/buffered_output_stream.h"
 #include "stream/file_output_stream.h"
+#include "thread_pool.h"
 #include "vdex_file.h"
 #include "verifier/verifier_deps.h"
 
@@ -498,6 +500,32 @@ class ThreadLocalHashOverride {
   Handle<mirror::Object> old_field_value_;
 };
 
+// Runs the given function finishing the vdex files on a background thread, with its own
+// TimingLogger since the main one is being used by the compilation.
+class FinishVdexFilesTask final : public Task {
+ public:
+  explicit FinishVdexFilesTask(std::function<bool(TimingLogger*)>&& finish_vdex_files)
+      : finish_vdex_files_(std::move(finish_vdex_files)),
+        timings_("Background vdex writing", /*precise=*/ false, /*verbose=*/ false) {}
+
+  void Run(Thread*) override {
+    success_ = finish_vdex_files_(&timings_);
+  }
+
+  bool IsSuccessful() const {
+    return success_;
+  }
+
+  const TimingLogger& GetTimings() const {
+    return timings_;
+  }
+
+ private:
+  std::function<bool(TimingLogger*)> finish_vdex_files_;
+  TimingLogger timings_;
+  bool success_ = false;
+};
+
 class OatKeyValueStore : public SafeMap<std::string, std::string> {
  public:
   using SafeMap::Put;
@@ -686,10 +714,30 @@ class Dex2Oat final {
       Usage("Can't have both --output-vdex-fd and --output-vdex");
     }
 
+    if (incremental_vdex_ && input_vdex_fd_ == -1 && input_vdex_.empty()) {
+      Usage("--incremental-vdex requires --input-vdex-fd or --input-vdex");
+    }
+
     if (!oat_filenames_.empty() && oat_fd_ != -1) {
       Usage("--oat-file should not be used with --oat-fd");
     }
 
+    if (compilation_shard_count_ == 0u) {
+      Usage("--compilation-shard-count must be positive");
+    }
+
+    if (compilation_shard_index_ >= compilation_shard_count_) {
+      Usage("--compilation-shard-index must be less than --compilation-shard-count");
+    }
+
+    if (compilation_shard_count_ != 1u && compilation_shard_output_.empty()) {
+      Usage("--compilation-shard-count requires --compilation-shard-output");
+    }
+
+    if (!compilation_shard_output_.empty() && !link_compilation_shards_.empty()) {
+      Usage("--compilation-shard-output should not be used with --link-compilation-shard");
+    }
+
     if ((output_vdex_fd_ == -1) != (oat_fd_ == -1)) {
       Usage("VDEX and OAT output must be specified either with one --oat-file "
             "or with --oat-fd and --output-vdex-fd file descriptors");
@@ -1076,6 +1124,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::InputVdexFd, &input_vdex_fd_);
     AssignIfExists(args, M::OutputVdexFd, &output_vdex_fd_);
     AssignIfExists(args, M::InputVdex, &input_vdex_);
+    AssignTrueIfExists(args, M::IncrementalVdex, &incremental_vdex_);
     AssignIfExists(args, M::OutputVdex, &output_vdex_);
     AssignIfExists(args, M::DmFd, &dm_fd_);
     AssignIfExists(args, M::DmFile, &dm_file_location_);
@@ -1097,6 +1146,7 @@ class Dex2Oat final {
     AssignIfExists(args, M::SwapFileFd, &swap_fd_);
     AssignIfExists(args, M::SwapDexSizeThreshold, &min_dex_file_cumulative_size_for_swap_);
     AssignIfExists(args, M::SwapDexCountThreshold, &min_dex_files_for_swap_);
+    AssignIfExists(args, M::SwapResidentLimit, &swap_resident_limit_);
     AssignIfExists(args, M::VeryLargeAppThreshold, &very_large_threshold_);
     AssignIfExists(args, M::AppImageFile, &app_image_file_name_);
     AssignIfExists(args, M::AppImageFileFd, &app_image_fd_);
@@ -1144,6 +1194,10 @@ class Dex2Oat final {
       force_determinism_ = true;
     }
     AssignTrueIfExists(args, M::CompileIndividually, &compile_individually_);
+    AssignIfExists(args, M::CompilationShardIndex, &compilation_shard_index_);
+    AssignIfExists(args, M::CompilationShardCount, &compilation_shard_count_);
+    AssignIfExists(args, M::CompilationShardOutput, &compilation_shard_output_);
+    AssignIfExists(args, M::LinkCompilationShards, &link_compilation_shards_);
 
     if (args.Exists(M::Base)) {
       ParseBase(*args.Get(M::Base));
@@ -1281,6 +1335,10 @@ class Dex2Oat final {
             ? ReplaceFileExtension(oat_filename, "vdex")
             : output_vdex_;
         if (vdex_filename == input_vdex_ && output_vdex_.empty()) {
+          if (incremental_vdex_) {
+            LOG(ERROR) << "--incremental-vdex needs an output vdex different from the input vdex";
+            return false;
+          }
           use_existing_vdex_ = true;
           std::unique_ptr<File> vdex_file(OS::OpenFileForReading(vdex_filename.c_str()));
           vdex_files_.push_back(std::move(vdex_file));
@@ -1336,6 +1394,10 @@ class Dex2Oat final {
       DCHECK_NE(output_vdex_fd_, -1);
       std::string vdex_location = ReplaceFileExtension(oat_location_, "vdex");
       if (input_vdex_file_ != nullptr && output_vdex_fd_ == input_vdex_fd_) {
+        if (incremental_vdex_) {
+          LOG(ERROR) << "--incremental-vdex needs an output vdex different from the input vdex";
+          return false;
+        }
         use_existing_vdex_ = true;
       }
 
@@ -1487,9 +1549,9 @@ class Dex2Oat final {
         std::vector<MemMap> opened_dex_files_map;
         std::vector<std::unique_ptr<const DexFile>> opened_dex_files;
         // No need to verify the dex file when we have a vdex file, which means it was already
-        // verified.
-        const bool verify =
-            (input_vdex_file_ == nullptr) && !compiler_options_->AssumeDexFilesAreVerified();
+        // verified. An incremental vdex may describe older dex files, so verify them anyway.
+        const bool verify = (input_vdex_file_ == nullptr || incremental_vdex_) &&
+                            !compiler_options_->AssumeDexFilesAreVerified();
         if (!oat_writers_[i]->WriteAndOpenDexFiles(
             vdex_files_[i].get(),
             verify,
@@ -1741,7 +1803,9 @@ class Dex2Oat final {
       TimingLogger::ScopedTiming t_dex("Parse Verifier Deps", timings_);
       std::unique_ptr<verifier::VerifierDeps> verifier_deps(
           new verifier::VerifierDeps(dex_files, /*output_only=*/ false));
-      if (!verifier_deps->ParseStoredData(dex_files, input_vdex_file_->GetVerifierDepsData())) {
+      if (!verifier_deps->ParseStoredData(dex_files,
+                                          input_vdex_file_->GetVerifierDepsData(),
+                                          unchanged_dex_files_)) {
         return dex2oat::ReturnCode::kOther;
       }
       // We can do fast verification.
@@ -1765,6 +1829,11 @@ class Dex2Oat final {
       // Nothing to validate
       return true;
     }
+    const std::vector<const DexFile*>& dex_files = compiler_options_->dex_files_for_oat_file_;
+    if (incremental_vdex_) {
+      return MatchIncrementalVdexChecksums(dex_files);
+    }
+    unchanged_dex_files_.assign(dex_files.size(), true);
     if (input_vdex_file_->GetNumberOfDexFiles()
           != compiler_options_->dex_files_for_oat_file_.size()) {
       LOG(ERROR) << "Vdex file contains a different number of dex files than the source. "
@@ -1789,6 +1858,30 @@ class Dex2Oat final {
     return true;
   }
 
+  // Records which dex files are unchanged since the input vdex was created, so that
+  // their verification results can be reused. Dex files are matched by position and
+  // location checksum, as the verifier deps in the vdex are stored by position.
+  // If no dex file is unchanged, the input vdex is dropped and everything is verified.
+  bool MatchIncrementalVdexChecksums(const std::vector<const DexFile*>& dex_files) {
+    DCHECK(incremental_vdex_);
+    size_t vdex_num_dex_files = input_vdex_file_->GetNumberOfDexFiles();
+    unchanged_dex_files_.assign(dex_files.size(), false);
+    size_t num_unchanged = 0u;
+    for (size_t i = 0; i < dex_files.size() && i < vdex_num_dex_files; i++) {
+      if (dex_files[i]->GetLocationChecksum() == input_vdex_file_->GetLocationChecksum(i)) {
+        unchanged_dex_files_[i] = true;
+        ++num_unchanged;
+      }
+    }
+    LOG(INFO) << "Incremental vdex: reusing verification of " << num_unchanged << " out of "
+              << dex_files.size() << " dex files";
+    if (num_unchanged == 0u) {
+      input_vdex_file_.reset();
+      unchanged_dex_files_.clear();
+    }
+    return true;
+  }
+
   // If we need to keep the oat file open for the image writer.
   bool ShouldKeepOatFileOpen() const {
     return IsImage() && oat_fd_ != File::kInvalidFd;
@@ -1827,11 +1920,59 @@ class Dex2Oat final {
     // This means no-vdex verify will use the individual compilation
     // mode (to reduce RAM used by the compiler).
     return compile_individually_ &&
+           !IsCompilationShard() && link_compilation_shards_.empty() &&
            (!IsImage() && !use_existing_vdex_ &&
             compiler_options_->dex_files_for_oat_file_.size() > 1 &&
             !CompilerFilter::IsAotCompilationEnabled(compiler_options_->GetCompilerFilter()));
   }
 
+  // Whether this invocation compiles one shard of the oat file instead of writing the oat file.
+  bool IsCompilationShard() const {
+    return !compilation_shard_output_.empty();
+  }
+
+  bool WriteCompilationShard() {
+    TimingLogger::ScopedTiming t("dex2oat WriteCompilationShard", timings_);
+    std::string error_msg;
+    if (!CompilationShard::Write(compilation_shard_output_,
+                                 driver_.get(),
+                                 compiler_options_->GetDexFilesForOatFile(),
+                                 compilation_shard_index_,
+                                 compilation_shard_count_,
+                                 &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return false;
+    }
+    return true;
+  }
+
+  // Add the methods compiled by the shards given with --link-compilation-shard to the driver.
+  bool LinkCompilationShards() {
+    if (link_compilation_shards_.empty()) {
+      return true;
+    }
+    TimingLogger::ScopedTiming t("dex2oat LinkCompilationShards", timings_);
+    // Patches can reference the boot class path and, for apps, the class loader context.
+    std::vector<const DexFile*> other_dex_files =
+        Runtime::Current()->GetClassLinker()->GetBootClassPath();
+    if (!IsBootImage() && !IsBootImageExtension()) {
+      std::vector<const DexFile*> class_path_files =
+          class_loader_context_->FlattenOpenedDexFiles();
+      other_dex_files.insert(
+          other_dex_files.end(), class_path_files.begin(), class_path_files.end());
+    }
+    std::string error_msg;
+    if (!CompilationShard::Link(link_compilation_shards_,
+                                driver_.get(),
+                                compiler_options_->GetDexFilesForOatFile(),
+                                other_dex_files,
+                                &error_msg)) {
+      LOG(ERROR) << error_msg;
+      return false;
+    }
+    return true;
+  }
+
   uint32_t GetCombinedChecksums() const {
     uint32_t combined_checksums = 0u;
     for (const DexFile* dex_file : compiler_options_->GetDexFilesForOatFile()) {
@@ -1909,7 +2050,9 @@ class Dex2Oat final {
                                      thread_count_,
                                      swap_fd_));
 
+    driver_->GetCompiledMethodStorage()->SetSwapResidentLimit(swap_resident_limit_);
     driver_->PrepareDexFilesForOatFile(timings_);
+    driver_->SetCompilationShard(compilation_shard_index_, compilation_shard_count_);
 
     if (!IsBootImage() && !IsBootImageExtension()) {
       driver_->SetClasspathDexFiles(class_loader_context_->FlattenOpenedDexFiles());
@@ -1991,7 +2134,12 @@ class Dex2Oat final {
                         timings_,
                         &compiler_options_->image_classes_);
     callbacks_->SetVerificationResults(nullptr);  // Should not be needed anymore.
-    driver_->CompileAll(class_loader, dex_files, timings_);
+    if (ShouldFinishVdexFilesInBackground()) {
+      StartFinishingVdexFiles();
+    }
+    if (link_compilation_shards_.empty()) {
+      driver_->CompileAll(class_loader, dex_files, timings_);
+    }
     driver_->FreeThreadPools();
     return class_loader;
   }
@@ -2096,22 +2244,20 @@ class Dex2Oat final {
       }
     }
 
-    // Initialize the writers with the compiler driver, image writer, and their
-    // dex files. The writers were created without those being there yet.
-    for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
-      std::unique_ptr<linker::OatWriter>& oat_writer = oat_writers_[i];
-      std::vector<const DexFile*>& dex_files = dex_files_per_oat_file_[i];
-      oat_writer->Initialize(driver_.get(), image_writer_.get(), dex_files);
-    }
-
-    if (!use_existing_vdex_) {
-      TimingLogger::ScopedTiming t2("dex2oat Write VDEX", timings_);
-      DCHECK(IsBootImage() || IsBootImageExtension() || oat_files_.size() == 1u);
-      verifier::VerifierDeps* verifier_deps = callbacks_->GetVerifierDeps();
-      for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
-        File* vdex_file = vdex_files_[i].get();
-        if (!oat_writers_[i]->FinishVdexFile(vdex_file, verifier_deps)) {
-          LOG(ERROR) << "Failed to finish VDEX file " << vdex_file->GetPath();
+    if (finish_vdex_files_task_ != nullptr) {
+      // The writers were initialized and the vdex files are being written in the background.
+      TimingLogger::ScopedTiming t2("dex2oat Wait for VDEX", timings_);
+      finish_vdex_files_thread_pool_->Wait(
+          Thread::Current(), /*do_work=*/ false, /*may_hold_locks=*/ false);
+      finish_vdex_files_thread_pool_.reset();
+      if (!finish_vdex_files_task_->IsSuccessful()) {
+        return false;
+      }
+    } else {
+      InitializeOatWriters();
+      if (!use_existing_vdex_) {
+        TimingLogger::ScopedTiming t2("dex2oat Write VDEX", timings_);
+        if (!FinishVdexFiles(timings_)) {
           return false;
         }
       }
@@ -2122,11 +2268,16 @@ class Dex2Oat final {
       linker::MultiOatRelativePatcher patcher(compiler_options_->GetInstructionSet(),
                                               compiler_options_->GetInstructionSetFeatures(),
                                               driver_->GetCompiledMethodStorage());
+      // The compiler's thread pools have been freed, use a separate pool for the layout.
+      std::unique_ptr<ThreadPool> layout_thread_pool;
+      if (thread_count_ > 1u) {
+        layout_thread_pool.reset(ThreadPool::Create("Oat writer thread pool", thread_count_ - 1u));
+      }
       for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
         std::unique_ptr<linker::ElfWriter>& elf_writer = elf_writers_[i];
         std::unique_ptr<linker::OatWriter>& oat_writer = oat_writers_[i];
 
-        oat_writer->PrepareLayout(&patcher);
+        oat_writer->PrepareLayout(&patcher, layout_thread_pool.get());
         elf_writer->PrepareDynamicSection(oat_writer->GetOatHeader().GetExecutableOffset(),
                                           oat_writer->GetCodeSize(),
                                           oat_writer->GetDataImgRelRoSize(),
@@ -2145,6 +2296,7 @@ class Dex2Oat final {
                                              oat_writer->GetOatSize());
         }
       }
+      layout_thread_pool.reset();
 
       for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
         std::unique_ptr<File>& oat_file = oat_files_[i];
@@ -2216,6 +2368,53 @@ class Dex2Oat final {
     return true;
   }
 
+  // Initialize the writers with the compiler driver, image writer, and their
+  // dex files. The writers were created without those being there yet.
+  void InitializeOatWriters() {
+    for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
+      std::unique_ptr<linker::OatWriter>& oat_writer = oat_writers_[i];
+      std::vector<const DexFile*>& dex_files = dex_files_per_oat_file_[i];
+      oat_writer->Initialize(driver_.get(), image_writer_.get(), dex_files);
+    }
+  }
+
+  bool FinishVdexFiles(TimingLogger* timings) {
+    DCHECK(!use_existing_vdex_);
+    DCHECK(IsBootImage() || IsBootImageExtension() || oat_files_.size() == 1u);
+    verifier::VerifierDeps* verifier_deps = callbacks_->GetVerifierDeps();
+    for (size_t i = 0, size = oat_files_.size(); i != size; ++i) {
+      File* vdex_file = vdex_files_[i].get();
+      if (!oat_writers_[i]->FinishVdexFile(vdex_file, verifier_deps, timings)) {
+        LOG(ERROR) << "Failed to finish VDEX file " << vdex_file->GetPath();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // The vdex files only depend on the dex files and on the VerifierDeps, which are final
+  // once the classes have been verified. Writing and syncing them to disk can then overlap
+  // with the compilation of the methods. This is not done for images, as the image writer
+  // is needed to initialize the oat writers and is only created after the compilation.
+  bool ShouldFinishVdexFilesInBackground() const {
+    return !IsImage() &&
+           !use_existing_vdex_ &&
+           !ShouldCompileDexFilesIndividually() &&
+           !IsCompilationShard() &&
+           compiler_options_->IsAnyCompilationEnabled();
+  }
+
+  void StartFinishingVdexFiles() {
+    DCHECK(image_writer_ == nullptr);
+    InitializeOatWriters();
+    Thread* self = Thread::Current();
+    finish_vdex_files_task_ = std::make_unique<FinishVdexFilesTask>(
+        [this](TimingLogger* timings) { return FinishVdexFiles(timings); });
+    finish_vdex_files_thread_pool_.reset(ThreadPool::Create("Vdex writer", 1));
+    finish_vdex_files_thread_pool_->AddTask(self, finish_vdex_files_task_.get());
+    finish_vdex_files_thread_pool_->StartWorkers(self);
+  }
+
   // If we are compiling an image, invoke the image creation routine. Else just skip.
   bool HandleImage() {
     if (IsImage()) {
@@ -2316,6 +2515,9 @@ class Dex2Oat final {
     if (compiler_options_->GetDumpTimings() ||
         (kIsDebugBuild && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
+      if (finish_vdex_files_task_ != nullptr) {
+        LOG(INFO) << Dumpable<TimingLogger>(finish_vdex_files_task_->GetTimings());
+      }
     }
   }
 
@@ -2601,7 +2803,7 @@ class Dex2Oat final {
 
   bool AddDexFileSources() {
     TimingLogger::ScopedTiming t2("AddDexFileSources", timings_);
-    if (input_vdex_file_ != nullptr && input_vdex_file_->HasDexSection()) {
+    if (input_vdex_file_ != nullptr && input_vdex_file_->HasDexSection() && !incremental_vdex_) {
       DCHECK_EQ(oat_writers_.size(), 1u);
       const std::string& name = zip_location_.empty() ? dex_locations_[0] : zip_location_;
       DCHECK(!name.empty());
@@ -2786,9 +2988,14 @@ class Dex2Oat final {
       DCHECK(image_filenames_.empty());
       image_filenames_.push_back(StringPrintf("FileDescriptor[%d]", image_fd_));
     }
+    std::unique_ptr<ThreadPool> thread_pool;
+    if (thread_count_ > 1u) {
+      thread_pool.reset(ThreadPool::Create("Image writer thread pool", thread_count_ - 1u));
+    }
     if (!image_writer_->Write(IsAppImage() ? app_image_fd_ : image_fd_,
                               image_filenames_,
-                              IsAppImage() ? 1u : dex_locations_.size())) {
+                              IsAppImage() ? 1u : dex_locations_.size(),
+                              thread_pool.get())) {
       LOG(ERROR) << "Failure during image file creation";
       return false;
     }
@@ -2978,6 +3185,10 @@ class Dex2Oat final {
   std::unique_ptr<linker::ImageWriter> image_writer_;
   std::unique_ptr<CompilerDriver> driver_;
 
+  // Task and thread pool finishing the vdex files while the methods are compiled.
+  std::unique_ptr<FinishVdexFilesTask> finish_vdex_files_task_;
+  std::unique_ptr<ThreadPool> finish_vdex_files_thread_pool_;
+
   std::vector<MemMap> opened_dex_files_maps_;
   std::vector<std::unique_ptr<const DexFile>> opened_dex_files_;
 
@@ -2987,6 +3198,7 @@ class Dex2Oat final {
   int swap_fd_;
   size_t min_dex_files_for_swap_ = kDefaultMinDexFilesForSwap;
   size_t min_dex_file_cumulative_size_for_swap_ = kDefaultMinDexFileCumulativeSizeForSwap;
+  size_t swap_resident_limit_ = 0u;
   size_t very_large_threshold_ = std::numeric_limits<size_t>::max();
   std::string app_image_file_name_;
   int app_image_fd_;
@@ -3014,6 +3226,10 @@ class Dex2Oat final {
 
   // Whether the given input vdex is also the output.
   bool use_existing_vdex_ = false;
+  // Whether the input vdex may come from an older version of the dex files.
+  bool incremental_vdex_ = false;
+  // For each dex file, whether its verification results can be reused from the input vdex.
+  std::vector<bool> unchanged_dex_files_;
 
   // By default, copy the dex to the vdex file only if dex files are
   // compressed in APK.
@@ -3025,6 +3241,14 @@ class Dex2Oat final {
   // Whether to force individual compilation.
   bool compile_individually_;
 
+  // The compilation shard to compile and the file to write it to, see CompilationShard.
+  unsigned int compilation_shard_index_ = 0u;
+  unsigned int compilation_shard_count_ = 1u;
+  std::string compilation_shard_output_;
+
+  // The compilation shards to link instead of compiling.
+  std::vector<std::string> link_compilation_shards_;
+
   // The classpath that determines if a given symbol should be resolved at compile time or not.
   std::string public_sdk_;
 
@@ -3083,6 +3307,22 @@ static dex2oat::ReturnCode DoCompilation(Dex2Oat& dex2oat) REQUIRES(!Locks::muta
   // process.
   ScopedGlobalRef global_ref(class_loader);
 
+  // A compilation shard only writes the compiled code; the oat file is written when linking.
+  if (dex2oat.IsCompilationShard()) {
+    bool success = dex2oat.WriteCompilationShard();
+    dex2oat.EraseOutputFiles();
+    if (!success) {
+      return dex2oat::ReturnCode::kOther;
+    }
+    dex2oat.DumpTiming();
+    return dex2oat::ReturnCode::kNoFailure;
+  }
+
+  if (!dex2oat.LinkCompilationShards()) {
+    dex2oat.EraseOutputFiles();
+    return dex2oat::ReturnCode::kOther;
+  }
+
   if (!dex2oat.WriteOutputFiles(class_loader)) {
     dex2oat.EraseOutputFiles();
     return dex2oat::ReturnCode::kOther;
@@ -117,6 +117,11 @@ static void AddGeneratedArtifactMappings(Builder& builder) {
           .WithType<std::string>()
           .WithHelp("specifies the vdex input source via a filename.")
           .IntoKey(M::InputVdex)
+      .Define("--incremental-vdex")
+          .WithHelp("allows the input vdex to come from an older version of the dex files.\n"
+                    "Verification results are reused for the dex files whose checksum is\n"
+                    "unchanged, and the other dex files are verified from scratch.")
+          .IntoKey(M::IncrementalVdex)
       .Define("--output-vdex-fd=_")
           .WithHelp("specifies the vdex output destination via a file descriptor.")
           .WithType<int>()
@@ -215,6 +220,7 @@ static void AddImageMappings(Builder& builder) {
           .WithType<ImageHeader::StorageMode>()
           .WithValueMap({{"lz4", ImageHeader::kStorageModeLZ4},
                          {"lz4hc", ImageHeader::kStorageModeLZ4HC},
+                         {"zstd", ImageHeader::kStorageModeZstd},
                          {"uncompressed", ImageHeader::kStorageModeUncompressed}})
           .WithHelp("Which format to store the image Defaults to uncompressed. Eg:"
                     " --image-format=lz4")
@@ -240,7 +246,12 @@ static void AddSwapMappings(Builder& builder) {
       .Define("--swap-dex-count-threshold=_")
           .WithType<unsigned int>()
           .WithHelp("specifies the minimum number of dex file to allow the use of swap.")
-          .IntoKey(M::SwapDexCountThreshold);
+          .IntoKey(M::SwapDexCountThreshold)
+      .Define("--swap-resident-limit=_")
+          .WithType<unsigned int>()
+          .WithHelp("specifies the number of bytes written to swap after which the swapped data is\n"
+                    "flushed to the swap file and dropped from memory. Default: no limit.")
+          .IntoKey(M::SwapResidentLimit);
   // clang-format on
 }
 
@@ -276,6 +287,32 @@ static void AddCompilerMappings(Builder& builder) {
   // clang-format on
 }
 
+static void AddShardingMappings(Builder& builder) {
+  // clang-format off
+  builder.
+      Define("--compilation-shard-index=_")
+          .WithType<unsigned int>()
+          .WithHelp("Compile only the classes of the given shard, i.e. the classes whose class\n"
+                    "def index modulo --compilation-shard-count is the shard index.")
+          .IntoKey(M::CompilationShardIndex)
+      .Define("--compilation-shard-count=_")
+          .WithType<unsigned int>()
+          .WithHelp("The number of compilation shards. Default: 1")
+          .IntoKey(M::CompilationShardCount)
+      .Define("--compilation-shard-output=_")
+          .WithType<std::string>()
+          .WithHelp("Write the compiled code of the shard to the given file instead of writing\n"
+                    "the oat file. All shards must be compiled with the same inputs and options.")
+          .IntoKey(M::CompilationShardOutput)
+      .Define("--link-compilation-shard=_")
+          .WithType<std::vector<std::string>>().AppendValues()
+          .WithHelp("Instead of compiling, load the compiled code from the given shard. Must be\n"
+                    "specified once for each shard, with the inputs and options used to compile\n"
+                    "the shards.")
+          .IntoKey(M::LinkCompilationShards);
+  // clang-format on
+}
+
 static void AddTargetMappings(Builder& builder) {
   // clang-format off
   builder.
@@ -310,6 +347,7 @@ Parser CreateDex2oatArgumentParser() {
   AddImageMappings(*parser_builder);
   AddSwapMappings(*parser_builder);
   AddCompilerMappings(*parser_builder);
+  AddShardingMappings(*parser_builder);
   AddTargetMappings(*parser_builder);
 
   // clang-format off
@@ -315,6 +315,14 @@ TEST_F(Dex2oatSwapTest, DoUseSwapSingleSmall) {
           {"--swap-dex-size-threshold=0", "--swap-dex-count-threshold=0"});
 }
 
+TEST_F(Dex2oatSwapTest, DoUseSwapWithResidentLimit) {
+  RunTest(/*use_fd=*/false,
+          /*expect_use=*/true,
+          {"--swap-dex-size-threshold=0",
+           "--swap-dex-count-threshold=0",
+           "--swap-resident-limit=4096"});
+}
+
 class Dex2oatSwapUseTest : public Dex2oatSwapTest {
  protected:
   void CheckHostResult(bool expect_use) override {
@@ -1863,6 +1871,166 @@ TEST_F(Dex2oatTest, DontExtract) {
   generate_and_check(CompilerFilter::Filter::kVerify);
 }
 
+// Test that --incremental-vdex reuses the verification of the unchanged dex files only.
+TEST_F(Dex2oatTest, IncrementalVdex) {
+  const std::string dir = GetScratchDir();
+  const std::string old_odex_location = dir + "/old.odex";
+  const std::string old_vdex_location = dir + "/old.vdex";
+  const std::string odex_location = dir + "/base.odex";
+  ASSERT_TRUE(GenerateOdexForTest(
+      GetTestDexFileName("MultiDex"), old_odex_location, CompilerFilter::Filter::kVerify));
+
+  // The primary dex file is the same in both versions, only the secondary one changed.
+  output_.clear();
+  ASSERT_TRUE(GenerateOdexForTest(GetTestDexFileName("MultiDexModifiedSecondary"),
+                                  odex_location,
+                                  CompilerFilter::Filter::kVerify,
+                                  {"--input-vdex=" + old_vdex_location,
+                                   "--incremental-vdex",
+                                   "--runtime-arg",
+                                   "-Xuse-stderr-logger"}));
+  EXPECT_NE(output_.find("reusing verification of 1 out of 2 dex files"), std::string::npos)
+      << output_;
+
+  // Without --incremental-vdex, the checksum mismatch is an error.
+  ASSERT_TRUE(GenerateOdexForTest(GetTestDexFileName("MultiDexModifiedSecondary"),
+                                  odex_location,
+                                  CompilerFilter::Filter::kVerify,
+                                  {"--input-vdex=" + old_vdex_location},
+                                  /*expect_success=*/false));
+}
+
+TEST_F(Dex2oatTest, LinkCompilationShards) {
+  const std::string dir = GetScratchDir();
+  const std::string dex_location = GetTestDexFileName("ManyMethods");
+  const std::string expected_odex_location = dir + "/expected.odex";
+  const std::string odex_location = dir + "/base.odex";
+  ASSERT_TRUE(GenerateOdexForTest(
+      dex_location, expected_odex_location, CompilerFilter::Filter::kSpeed));
+
+  // Compiling a shard does not write the oat file.
+  constexpr size_t kShardCount = 2u;
+  std::string error_msg;
+  std::vector<std::string> link_args;
+  for (size_t i = 0; i != kShardCount; ++i) {
+    const std::string shard_location = dir + "/shard" + std::to_string(i);
+    int status = GenerateOdexForTestWithStatus(
+        {dex_location},
+        odex_location,
+        CompilerFilter::Filter::kSpeed,
+        &error_msg,
+        {"--compilation-shard-index=" + std::to_string(i),
+         "--compilation-shard-count=" + std::to_string(kShardCount),
+         "--compilation-shard-output=" + shard_location});
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0) << error_msg << " " << output_;
+    EXPECT_TRUE(OS::FileExists(shard_location.c_str()));
+    EXPECT_FALSE(OS::FileExists(odex_location.c_str()));
+    link_args.push_back("--link-compilation-shard=" + shard_location);
+  }
+
+  // Linking an incomplete set of shards fails.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  odex_location,
+                                  CompilerFilter::Filter::kSpeed,
+                                  {link_args[0]},
+                                  /*expect_success=*/false));
+
+  ASSERT_TRUE(GenerateOdexForTest(
+      dex_location, odex_location, CompilerFilter::Filter::kSpeed, link_args));
+
+  // The linked oat file has the same compiled code as the one compiled in a single process.
+  std::unique_ptr<OatFile> expected_odex_file(OatFile::Open(/*zip_fd=*/-1,
+                                                            expected_odex_location,
+                                                            expected_odex_location,
+                                                            /*executable=*/false,
+                                                            /*low_4gb=*/false,
+                                                            dex_location,
+                                                            &error_msg));
+  ASSERT_TRUE(expected_odex_file != nullptr) << error_msg;
+  std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/-1,
+                                                   odex_location,
+                                                   odex_location,
+                                                   /*executable=*/false,
+                                                   /*low_4gb=*/false,
+                                                   dex_location,
+                                                   &error_msg));
+  ASSERT_TRUE(odex_file != nullptr) << error_msg;
+  ASSERT_EQ(expected_odex_file->GetOatDexFiles().size(), odex_file->GetOatDexFiles().size());
+  for (size_t i = 0; i != odex_file->GetOatDexFiles().size(); ++i) {
+    const OatDexFile* expected_oat_dex_file = expected_odex_file->GetOatDexFiles()[i];
+    const OatDexFile* oat_dex_file = odex_file->GetOatDexFiles()[i];
+    std::unique_ptr<const DexFile> dex_file = oat_dex_file->OpenDexFile(&error_msg);
+    ASSERT_TRUE(dex_file != nullptr) << error_msg;
+    for (ClassAccessor accessor : dex_file->GetClasses()) {
+      uint16_t class_def_index = accessor.GetClassDefIndex();
+      OatFile::OatClass expected_oat_class = expected_oat_dex_file->GetOatClass(class_def_index);
+      OatFile::OatClass oat_class = oat_dex_file->GetOatClass(class_def_index);
+      ASSERT_EQ(expected_oat_class.GetType(), oat_class.GetType());
+      for (uint32_t method_index = 0; method_index != accessor.NumMethods(); ++method_index) {
+        const OatFile::OatMethod expected_oat_method = expected_oat_class.GetOatMethod(method_index);
+        const OatFile::OatMethod oat_method = oat_class.GetOatMethod(method_index);
+        ASSERT_EQ(expected_oat_method.GetCodeOffset(), oat_method.GetCodeOffset());
+        ASSERT_EQ(expected_oat_method.GetQuickCodeSize(), oat_method.GetQuickCodeSize());
+        if (oat_method.GetQuickCode() != nullptr) {
+          // Compare the code bytes, including the patched references.
+          EXPECT_EQ(0, memcmp(expected_oat_method.GetQuickCode(),
+                              oat_method.GetQuickCode(),
+                              oat_method.GetQuickCodeSize()))
+              << accessor.GetDescriptor() << " method " << method_index;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(Dex2oatTest, CompiledCodeSizeBudget) {
+  const std::string dex_location = GetTestDexFileName("ManyMethods");
+  const std::string odex_location = GetScratchDir() + "/base.odex";
+  auto count_compiled_methods = [&]() {
+    std::string error_msg;
+    std::unique_ptr<OatFile> odex_file(OatFile::Open(/*zip_fd=*/-1,
+                                                     odex_location,
+                                                     odex_location,
+                                                     /*executable=*/false,
+                                                     /*low_4gb=*/false,
+                                                     dex_location,
+                                                     &error_msg));
+    CHECK(odex_file != nullptr) << error_msg;
+    size_t count = 0u;
+    for (const OatDexFile* oat_dex_file : odex_file->GetOatDexFiles()) {
+      std::unique_ptr<const DexFile> dex_file = oat_dex_file->OpenDexFile(&error_msg);
+      CHECK(dex_file != nullptr) << error_msg;
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        OatFile::OatClass oat_class = oat_dex_file->GetOatClass(accessor.GetClassDefIndex());
+        for (uint32_t method_index = 0; method_index != accessor.NumMethods(); ++method_index) {
+          if (oat_class.GetOatMethod(method_index).GetQuickCodeSize() != 0u) {
+            ++count;
+          }
+        }
+      }
+    }
+    return count;
+  };
+
+  ASSERT_TRUE(GenerateOdexForTest(dex_location, odex_location, CompilerFilter::Filter::kSpeed));
+  size_t unbudgeted_count = count_compiled_methods();
+  ASSERT_GT(unbudgeted_count, 1u);
+
+  // With a single thread, the budget is exhausted by the first compiled method.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  odex_location,
+                                  CompilerFilter::Filter::kSpeed,
+                                  {"-j1", "--compiled-code-size-budget=1"}));
+  EXPECT_EQ(count_compiled_methods(), 1u);
+
+  // A budget that is never reached compiles everything.
+  ASSERT_TRUE(GenerateOdexForTest(dex_location,
+                                  odex_location,
+                                  CompilerFilter::Filter::kSpeed,
+                                  {"--compilation-time-budget-ms=3600000"}));
+  EXPECT_EQ(count_compiled_methods(), unbudgeted_count);
+}
+
 // Test that compact dex generation with invalid dex files doesn't crash dex2oat. b/75970654
 TEST_F(Dex2oatTest, CompactDexInvalidSource) {
   ScratchFile invalid_dex;
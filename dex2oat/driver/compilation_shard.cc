@@ -0,0 +1,469 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compilation_shard.h"
+
+#include <map>
+#include <memory>
+#include <set>
+
+#include "android-base/stringprintf.h"
+#include "arch/instruction_set.h"
+#include "base/array_ref.h"
+#include "base/bit_utils.h"
+#include "base/casts.h"
+#include "base/logging.h"
+#include "base/os.h"
+#include "base/unix_file/fd_file.h"
+#include "compiled_method.h"
+#include "compiled_method_storage.h"
+#include "compiler_driver.h"
+#include "dex/dex_file.h"
+#include "dex/method_reference.h"
+#include "driver/compiler_options.h"
+#include "linker/linker_patch.h"
+
+namespace art {
+
+using android::base::StringPrintf;
+
+namespace {
+
+constexpr uint8_t kShardMagic[] = { 's', 'h', 'r', 'd' };
+constexpr uint32_t kShardVersion = 2u;
+constexpr uint32_t kNoDexFile = static_cast<uint32_t>(-1);
+
+class ShardWriter {
+ public:
+  void WriteU32(uint32_t value) {
+    WriteBytes(ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(&value), sizeof(value)));
+  }
+
+  void WriteBytes(ArrayRef<const uint8_t> data) {
+    data_.insert(data_.end(), data.begin(), data.end());
+  }
+
+  void WriteBlob(ArrayRef<const uint8_t> data) {
+    WriteU32(dchecked_integral_cast<uint32_t>(data.size()));
+    WriteBytes(data);
+  }
+
+  void WriteString(const std::string& str) {
+    WriteBlob(ArrayRef<const uint8_t>(reinterpret_cast<const uint8_t*>(str.data()), str.size()));
+  }
+
+  const std::vector<uint8_t>& GetData() const {
+    return data_;
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+class ShardReader {
+ public:
+  explicit ShardReader(ArrayRef<const uint8_t> data) : data_(data), pos_(0u) {}
+
+  bool ReadU32(/*out*/ uint32_t* value) {
+    ArrayRef<const uint8_t> bytes;
+    if (!ReadBytes(sizeof(*value), &bytes)) {
+      return false;
+    }
+    memcpy(value, bytes.data(), sizeof(*value));
+    return true;
+  }
+
+  bool ReadBytes(size_t size, /*out*/ ArrayRef<const uint8_t>* bytes) {
+    if (size > data_.size() - pos_) {
+      return false;
+    }
+    *bytes = data_.SubArray(pos_, size);
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadBlob(/*out*/ ArrayRef<const uint8_t>* bytes) {
+    uint32_t size;
+    return ReadU32(&size) && ReadBytes(size, bytes);
+  }
+
+  bool ReadString(/*out*/ std::string* str) {
+    ArrayRef<const uint8_t> bytes;
+    if (!ReadBlob(&bytes)) {
+      return false;
+    }
+    str->assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return true;
+  }
+
+  bool IsAtEnd() const {
+    return pos_ == data_.size();
+  }
+
+ private:
+  const ArrayRef<const uint8_t> data_;
+  size_t pos_;
+};
+
+void WriteDexFiles(ShardWriter* writer, const std::vector<const DexFile*>& dex_files) {
+  writer->WriteU32(dchecked_integral_cast<uint32_t>(dex_files.size()));
+  for (const DexFile* dex_file : dex_files) {
+    writer->WriteU32(dex_file->GetLocationChecksum());
+    writer->WriteString(dex_file->GetLocation());
+  }
+}
+
+bool ReadDexFiles(ShardReader* reader,
+                  /*out*/ std::vector<std::pair<uint32_t, std::string>>* dex_files) {
+  uint32_t count;
+  if (!reader->ReadU32(&count)) {
+    return false;
+  }
+  dex_files->resize(count);
+  for (std::pair<uint32_t, std::string>& entry : *dex_files) {
+    if (!reader->ReadU32(&entry.first) || !reader->ReadString(&entry.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Indexes the dex files referenced by patches, in order of first use.
+class TargetDexFiles {
+ public:
+  uint32_t GetIndex(const DexFile* dex_file) {
+    if (dex_file == nullptr) {
+      return kNoDexFile;
+    }
+    auto it = indexes_.find(dex_file);
+    if (it == indexes_.end()) {
+      it = indexes_.emplace(dex_file, dchecked_integral_cast<uint32_t>(dex_files_.size())).first;
+      dex_files_.push_back(dex_file);
+    }
+    return it->second;
+  }
+
+  const std::vector<const DexFile*>& GetDexFiles() const {
+    return dex_files_;
+  }
+
+ private:
+  std::map<const DexFile*, uint32_t> indexes_;
+  std::vector<const DexFile*> dex_files_;
+};
+
+// Patches are stored field by field with the dex file pointer replaced by an index,
+// so that the shard contents do not depend on pointer values or struct padding.
+void WritePatch(ShardWriter* writer, TargetDexFiles* targets, const linker::LinkerPatch& patch) {
+  writer->WriteU32(targets->GetIndex(patch.GetTargetDexFile()));
+  writer->WriteU32(dchecked_integral_cast<uint32_t>(patch.LiteralOffset()));
+  writer->WriteU32(enum_cast<uint32_t>(patch.GetType()));
+  writer->WriteU32(patch.GetRawData1());
+  writer->WriteU32(patch.GetRawData2());
+}
+
+bool ReadPatch(ShardReader* reader,
+               const std::vector<const DexFile*>& targets,
+               /*out*/ linker::LinkerPatch* patch) {
+  uint32_t target_index;
+  uint32_t literal_offset;
+  uint32_t type;
+  uint32_t raw_data1;
+  uint32_t raw_data2;
+  if (!reader->ReadU32(&target_index) ||
+      !reader->ReadU32(&literal_offset) ||
+      !reader->ReadU32(&type) ||
+      !reader->ReadU32(&raw_data1) ||
+      !reader->ReadU32(&raw_data2)) {
+    return false;
+  }
+  if ((target_index != kNoDexFile && target_index >= targets.size()) ||
+      !IsUint<24>(literal_offset) ||
+      type > enum_cast<uint32_t>(linker::LinkerPatch::Type::kBakerReadBarrierBranch)) {
+    return false;
+  }
+  *patch = linker::LinkerPatch::FromRawData(
+      literal_offset,
+      static_cast<linker::LinkerPatch::Type>(type),
+      target_index != kNoDexFile ? targets[target_index] : nullptr,
+      raw_data1,
+      raw_data2);
+  return true;
+}
+
+}  // anonymous namespace
+
+bool CompilationShard::Write(const std::string& filename,
+                             CompilerDriver* driver,
+                             const std::vector<const DexFile*>& dex_files,
+                             size_t shard_index,
+                             size_t shard_count,
+                             /*out*/ std::string* error_msg) {
+  CompiledMethodStorage* storage = driver->GetCompiledMethodStorage();
+  TargetDexFiles targets;
+  ShardWriter methods;
+  ShardWriter thunks;
+  uint32_t num_methods = 0u;
+  uint32_t num_thunks = 0u;
+  std::set<std::pair<std::string, std::vector<uint8_t>>> seen_thunks;
+  for (size_t dex_index = 0; dex_index != dex_files.size(); ++dex_index) {
+    const DexFile* dex_file = dex_files[dex_index];
+    for (uint32_t method_idx = 0; method_idx != dex_file->NumMethodIds(); ++method_idx) {
+      CompiledMethod* compiled_method =
+          driver->GetCompiledMethod(MethodReference(dex_file, method_idx));
+      if (compiled_method == nullptr) {
+        continue;
+      }
+      ++num_methods;
+      methods.WriteU32(dchecked_integral_cast<uint32_t>(dex_index));
+      methods.WriteU32(method_idx);
+      methods.WriteU32(compiled_method->IsIntrinsic() ? 1u : 0u);
+      methods.WriteBlob(compiled_method->GetQuickCode());
+      methods.WriteBlob(compiled_method->GetVmapTable());
+      methods.WriteBlob(compiled_method->GetCFIInfo());
+      ArrayRef<const linker::LinkerPatch> patches = compiled_method->GetPatches();
+      methods.WriteU32(dchecked_integral_cast<uint32_t>(patches.size()));
+      for (const linker::LinkerPatch& patch : patches) {
+        WritePatch(&methods, &targets, patch);
+        std::string debug_name;
+        ArrayRef<const uint8_t> thunk_code = storage->GetThunkCode(patch, &debug_name);
+        if (!thunk_code.empty() &&
+            seen_thunks.emplace(debug_name,
+                                std::vector<uint8_t>(thunk_code.begin(), thunk_code.end()))
+                .second) {
+          ++num_thunks;
+          WritePatch(&thunks, &targets, patch);
+          thunks.WriteString(debug_name);
+          thunks.WriteBlob(thunk_code);
+        }
+      }
+    }
+  }
+
+  ShardWriter writer;
+  writer.WriteBytes(ArrayRef<const uint8_t>(kShardMagic));
+  writer.WriteU32(kShardVersion);
+  writer.WriteU32(static_cast<uint32_t>(driver->GetCompilerOptions().GetInstructionSet()));
+  writer.WriteU32(dchecked_integral_cast<uint32_t>(shard_index));
+  writer.WriteU32(dchecked_integral_cast<uint32_t>(shard_count));
+  WriteDexFiles(&writer, dex_files);
+  WriteDexFiles(&writer, targets.GetDexFiles());
+  writer.WriteU32(num_methods);
+  writer.WriteBytes(ArrayRef<const uint8_t>(methods.GetData()));
+  writer.WriteU32(num_thunks);
+  writer.WriteBytes(ArrayRef<const uint8_t>(thunks.GetData()));
+
+  std::unique_ptr<File> file(OS::CreateEmptyFile(filename.c_str()));
+  if (file == nullptr) {
+    *error_msg = StringPrintf("Failed to create compilation shard '%s'", filename.c_str());
+    return false;
+  }
+  if (!file->WriteFully(writer.GetData().data(), writer.GetData().size())) {
+    *error_msg = StringPrintf("Failed to write compilation shard '%s'", filename.c_str());
+    file->Erase();
+    return false;
+  }
+  if (file->FlushCloseOrErase() != 0) {
+    *error_msg = StringPrintf("Failed to flush compilation shard '%s'", filename.c_str());
+    return false;
+  }
+  VLOG(compiler) << "Wrote " << num_methods << " methods and " << num_thunks << " thunks of "
+                 << "compilation shard " << shard_index << "/" << shard_count << " to "
+                 << filename;
+  return true;
+}
+
+bool CompilationShard::Link(const std::vector<std::string>& filenames,
+                            CompilerDriver* driver,
+                            const std::vector<const DexFile*>& dex_files,
+                            const std::vector<const DexFile*>& other_dex_files,
+                            /*out*/ std::string* error_msg) {
+  const InstructionSet isa = driver->GetCompilerOptions().GetInstructionSet();
+  CompiledMethodStorage* storage = driver->GetCompiledMethodStorage();
+  std::vector<bool> seen_shards;
+  for (const std::string& filename : filenames) {
+    auto fail = [&](const std::string& reason) {
+      *error_msg = StringPrintf("Invalid compilation shard '%s': %s",
+                                filename.c_str(),
+                                reason.c_str());
+      return false;
+    };
+    std::unique_ptr<File> file(OS::OpenFileForReading(filename.c_str()));
+    if (file == nullptr) {
+      *error_msg = StringPrintf("Failed to open compilation shard '%s'", filename.c_str());
+      return false;
+    }
+    std::vector<uint8_t> data(file->GetLength());
+    if (!file->ReadFully(data.data(), data.size())) {
+      *error_msg = StringPrintf("Failed to read compilation shard '%s'", filename.c_str());
+      return false;
+    }
+    ShardReader reader{ArrayRef<const uint8_t>(data)};
+
+    ArrayRef<const uint8_t> magic;
+    uint32_t version;
+    uint32_t shard_isa;
+    uint32_t shard_index;
+    uint32_t shard_count;
+    if (!reader.ReadBytes(sizeof(kShardMagic), &magic) ||
+        memcmp(magic.data(), kShardMagic, sizeof(kShardMagic)) != 0 ||
+        !reader.ReadU32(&version) ||
+        version != kShardVersion) {
+      return fail("bad magic or version");
+    }
+    if (!reader.ReadU32(&shard_isa) ||
+        !reader.ReadU32(&shard_index) ||
+        !reader.ReadU32(&shard_count)) {
+      return fail("truncated header");
+    }
+    if (shard_isa != static_cast<uint32_t>(isa)) {
+      return fail("instruction set mismatch");
+    }
+    if (seen_shards.empty()) {
+      seen_shards.resize(shard_count, false);
+    }
+    if (shard_count != seen_shards.size() || shard_index >= shard_count) {
+      return fail(StringPrintf("shard %u/%u does not match the other shards",
+                               shard_index,
+                               shard_count));
+    }
+    if (seen_shards[shard_index]) {
+      return fail(StringPrintf("duplicate shard %u", shard_index));
+    }
+    seen_shards[shard_index] = true;
+
+    std::vector<std::pair<uint32_t, std::string>> shard_dex_files;
+    if (!ReadDexFiles(&reader, &shard_dex_files)) {
+      return fail("truncated dex file list");
+    }
+    if (shard_dex_files.size() != dex_files.size()) {
+      return fail("dex file count mismatch");
+    }
+    for (size_t i = 0; i != dex_files.size(); ++i) {
+      if (shard_dex_files[i].first != dex_files[i]->GetLocationChecksum() ||
+          shard_dex_files[i].second != dex_files[i]->GetLocation()) {
+        return fail("dex file mismatch for " + dex_files[i]->GetLocation());
+      }
+    }
+
+    std::vector<std::pair<uint32_t, std::string>> target_entries;
+    if (!ReadDexFiles(&reader, &target_entries)) {
+      return fail("truncated patch target list");
+    }
+    std::vector<const DexFile*> targets;
+    for (const std::pair<uint32_t, std::string>& entry : target_entries) {
+      const DexFile* target = nullptr;
+      for (const std::vector<const DexFile*>* candidates : {&dex_files, &other_dex_files}) {
+        for (const DexFile* candidate : *candidates) {
+          if (candidate->GetLocationChecksum() == entry.first &&
+              candidate->GetLocation() == entry.second) {
+            target = candidate;
+            break;
+          }
+        }
+        if (target != nullptr) {
+          break;
+        }
+      }
+      if (target == nullptr) {
+        return fail("unknown patch target dex file " + entry.second);
+      }
+      targets.push_back(target);
+    }
+
+    uint32_t num_methods;
+    if (!reader.ReadU32(&num_methods)) {
+      return fail("truncated method count");
+    }
+    std::vector<linker::LinkerPatch> patches;
+    for (uint32_t i = 0; i != num_methods; ++i) {
+      uint32_t dex_index;
+      uint32_t method_idx;
+      uint32_t is_intrinsic;
+      ArrayRef<const uint8_t> code;
+      ArrayRef<const uint8_t> vmap_table;
+      ArrayRef<const uint8_t> cfi_info;
+      uint32_t num_patches;
+      if (!reader.ReadU32(&dex_index) ||
+          !reader.ReadU32(&method_idx) ||
+          !reader.ReadU32(&is_intrinsic) ||
+          !reader.ReadBlob(&code) ||
+          !reader.ReadBlob(&vmap_table) ||
+          !reader.ReadBlob(&cfi_info) ||
+          !reader.ReadU32(&num_patches)) {
+        return fail("truncated method");
+      }
+      if (dex_index >= dex_files.size() || method_idx >= dex_files[dex_index]->NumMethodIds()) {
+        return fail("method out of range");
+      }
+      patches.clear();
+      for (uint32_t j = 0; j != num_patches; ++j) {
+        linker::LinkerPatch patch = linker::LinkerPatch::IntrinsicReferencePatch(0u, 0u, 0u);
+        if (!ReadPatch(&reader, targets, &patch)) {
+          return fail("truncated or invalid patch");
+        }
+        patches.push_back(patch);
+      }
+      MethodReference method_ref(dex_files[dex_index], method_idx);
+      if (driver->GetCompiledMethod(method_ref) != nullptr) {
+        return fail("method compiled by multiple shards: " + method_ref.PrettyMethod());
+      }
+      CompiledMethod* compiled_method =
+          storage->CreateCompiledMethod(isa,
+                                        code,
+                                        vmap_table,
+                                        cfi_info,
+                                        ArrayRef<const linker::LinkerPatch>(patches),
+                                        is_intrinsic != 0u);
+      driver->AddCompiledMethod(method_ref, compiled_method);
+    }
+
+    uint32_t num_thunks;
+    if (!reader.ReadU32(&num_thunks)) {
+      return fail("truncated thunk count");
+    }
+    for (uint32_t i = 0; i != num_thunks; ++i) {
+      linker::LinkerPatch patch = linker::LinkerPatch::IntrinsicReferencePatch(0u, 0u, 0u);
+      std::string debug_name;
+      ArrayRef<const uint8_t> code;
+      if (!ReadPatch(&reader, targets, &patch) ||
+          !reader.ReadString(&debug_name) ||
+          !reader.ReadBlob(&code) ||
+          code.empty()) {
+        return fail("truncated or invalid thunk");
+      }
+      if (storage->GetThunkCode(patch).empty()) {
+        storage->SetThunkCode(patch, code, debug_name);
+      }
+    }
+    if (!reader.IsAtEnd()) {
+      return fail("trailing data");
+    }
+    VLOG(compiler) << "Linked " << num_methods << " methods and " << num_thunks << " thunks of "
+                   << "compilation shard " << shard_index << "/" << shard_count << " from "
+                   << filename;
+  }
+
+  for (size_t i = 0; i != seen_shards.size(); ++i) {
+    if (!seen_shards[i]) {
+      *error_msg = StringPrintf("Missing compilation shard %zu/%zu", i, seen_shards.size());
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace art
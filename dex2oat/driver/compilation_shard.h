@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_DEX2OAT_DRIVER_COMPILATION_SHARD_H_
+#define ART_DEX2OAT_DRIVER_COMPILATION_SHARD_H_
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace art {
+
+class CompilerDriver;
+class DexFile;
+
+// A compilation shard holds the output of compiling a subset of the classes of an oat file
+// in a separate dex2oat process: the code, stack maps, CFI and linker patches of each
+// compiled method, and the thunks they need.
+//
+// Each shard compiles the classes whose class def index modulo the shard count is the shard
+// index. Linking loads all shards into the compiler driver of another dex2oat invocation with
+// the same inputs and options, which then writes the oat file as if it compiled everything
+// itself. Since the compilation of a method does not depend on the compilation of other
+// methods, the result is the same as a single-process compilation.
+class CompilationShard {
+ public:
+  // Returns whether the class with `class_def_index` belongs to the given shard.
+  static bool ContainsClass(uint32_t class_def_index, size_t shard_index, size_t shard_count) {
+    return class_def_index % shard_count == shard_index;
+  }
+
+  // Write the methods compiled by `driver` for `dex_files` to the file `filename`.
+  static bool Write(const std::string& filename,
+                    CompilerDriver* driver,
+                    const std::vector<const DexFile*>& dex_files,
+                    size_t shard_index,
+                    size_t shard_count,
+                    /*out*/ std::string* error_msg);
+
+  // Load the shards `filenames`, which must make up a complete set, and add their compiled
+  // methods and thunks to `driver`. The `dex_files` must match the dex files the shards were
+  // compiled for. Patch targets are resolved against `dex_files` and `other_dex_files`.
+  static bool Link(const std::vector<std::string>& filenames,
+                   CompilerDriver* driver,
+                   const std::vector<const DexFile*>& dex_files,
+                   const std::vector<const DexFile*>& other_dex_files,
+                   /*out*/ std::string* error_msg);
+
+ private:
+  DISALLOW_IMPLICIT_CONSTRUCTORS(CompilationShard);
+};
+
+}  // namespace art
+
+#endif  // ART_DEX2OAT_DRIVER_COMPILATION_SHARD_H_
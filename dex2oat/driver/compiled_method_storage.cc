@@ -33,22 +33,27 @@ namespace art {
 
 namespace {  // anonymous namespace
 
-template <typename T>
-const LengthPrefixedArray<T>* CopyArray(SwapSpace* swap_space, const ArrayRef<const T>& array) {
+template <typename T, typename Stats>
+const LengthPrefixedArray<T>* CopyArray(SwapSpace* swap_space,
+                                        Stats* stats,
+                                        const ArrayRef<const T>& array) {
   DCHECK(!array.empty());
   SwapAllocator<uint8_t> allocator(swap_space);
-  void* storage = allocator.allocate(LengthPrefixedArray<T>::ComputeSize(array.size()));
+  size_t size = LengthPrefixedArray<T>::ComputeSize(array.size());
+  void* storage = allocator.allocate(size);
   LengthPrefixedArray<T>* array_copy = new(storage) LengthPrefixedArray<T>(array.size());
   std::copy(array.begin(), array.end(), array_copy->begin());
+  stats->Add(size);
   return array_copy;
 }
 
-template <typename T>
-void ReleaseArray(SwapSpace* swap_space, const LengthPrefixedArray<T>* array) {
+template <typename T, typename Stats>
+void ReleaseArray(SwapSpace* swap_space, Stats* stats, const LengthPrefixedArray<T>* array) {
   SwapAllocator<uint8_t> allocator(swap_space);
   size_t size = LengthPrefixedArray<T>::ComputeSize(array->size());
   array->~LengthPrefixedArray<T>();
   allocator.deallocate(const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(array)), size);
+  stats->Remove(size);
 }
 
 }  // anonymous namespace
@@ -56,11 +61,12 @@ void ReleaseArray(SwapSpace* swap_space, const LengthPrefixedArray<T>* array) {
 template <typename T, typename DedupeSetType>
 inline const LengthPrefixedArray<T>* CompiledMethodStorage::AllocateOrDeduplicateArray(
     const ArrayRef<const T>& data,
-    DedupeSetType* dedupe_set) {
+    DedupeSetType* dedupe_set,
+    StorageStats* stats) {
   if (data.empty()) {
     return nullptr;
   } else if (!DedupeEnabled()) {
-    return CopyArray(swap_space_.get(), data);
+    return CopyArray(swap_space_.get(), stats, data);
   } else {
     return dedupe_set->Add(Thread::Current(), data);
   }
@@ -68,9 +74,10 @@ inline const LengthPrefixedArray<T>* CompiledMethodStorage::AllocateOrDeduplicat
 
 template <typename T>
 inline void CompiledMethodStorage::ReleaseArrayIfNotDeduplicated(
-    const LengthPrefixedArray<T>* array) {
+    const LengthPrefixedArray<T>* array,
+    StorageStats* stats) {
   if (array != nullptr && !DedupeEnabled()) {
-    ReleaseArray(swap_space_.get(), array);
+    ReleaseArray(swap_space_.get(), stats, array);
   }
 }
 
@@ -88,20 +95,21 @@ class CompiledMethodStorage::DedupeHashFunc {
 template <typename T>
 class CompiledMethodStorage::LengthPrefixedArrayAlloc {
  public:
-  explicit LengthPrefixedArrayAlloc(SwapSpace* swap_space)
-      : swap_space_(swap_space) {
+  LengthPrefixedArrayAlloc(SwapSpace* swap_space, StorageStats* stats)
+      : swap_space_(swap_space), stats_(stats) {
   }
 
   const LengthPrefixedArray<T>* Copy(const ArrayRef<const T>& array) {
-    return CopyArray(swap_space_, array);
+    return CopyArray(swap_space_, stats_, array);
   }
 
   void Destroy(const LengthPrefixedArray<T>* array) {
-    ReleaseArray(swap_space_, array);
+    ReleaseArray(swap_space_, stats_, array);
   }
 
  private:
   SwapSpace* const swap_space_;
+  StorageStats* const stats_;
 };
 
 class CompiledMethodStorage::ThunkMapKey {
@@ -147,12 +155,15 @@ class CompiledMethodStorage::ThunkMapValue {
 CompiledMethodStorage::CompiledMethodStorage(int swap_fd)
     : swap_space_(swap_fd == -1 ? nullptr : new SwapSpace(swap_fd, 10 * MB)),
       dedupe_enabled_(true),
-      dedupe_code_("dedupe code", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+      dedupe_code_("dedupe code",
+                   LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get(), &code_stats_)),
       dedupe_vmap_table_("dedupe vmap table",
-                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
-      dedupe_cfi_info_("dedupe cfi info", LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get())),
+                         LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get(), &vmap_table_stats_)),
+      dedupe_cfi_info_("dedupe cfi info",
+                       LengthPrefixedArrayAlloc<uint8_t>(swap_space_.get(), &cfi_info_stats_)),
       dedupe_linker_patches_("dedupe cfi info",
-                             LengthPrefixedArrayAlloc<linker::LinkerPatch>(swap_space_.get())),
+                             LengthPrefixedArrayAlloc<linker::LinkerPatch>(
+                                 swap_space_.get(), &linker_patches_stats_)),
       thunk_map_lock_("thunk_map_lock"),
       thunk_map_(std::less<ThunkMapKey>(), SwapAllocator<ThunkMapValueType>(swap_space_.get())) {
 }
@@ -174,13 +185,32 @@ void CompiledMethodStorage::DumpMemoryUsage(std::ostream& os, bool extended) con
   }
 }
 
+void CompiledMethodStorage::DumpStats(std::ostream& os) const {
+  os << "Compiled method storage peak bytes:"
+     << " code=" << PrettySize(code_stats_.GetPeak())
+     << " vmap-table=" << PrettySize(vmap_table_stats_.GetPeak())
+     << " cfi-info=" << PrettySize(cfi_info_stats_.GetPeak())
+     << " linker-patches=" << PrettySize(linker_patches_stats_.GetPeak())
+     << " thunks=" << PrettySize(thunk_stats_.GetPeak());
+  if (swap_space_ != nullptr) {
+    os << " ";
+    swap_space_->DumpStats(os);
+  }
+}
+
+void CompiledMethodStorage::SetSwapResidentLimit(size_t limit) {
+  if (swap_space_ != nullptr) {
+    swap_space_->SetResidentLimit(limit);
+  }
+}
+
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateCode(
     const ArrayRef<const uint8_t>& code) {
-  return AllocateOrDeduplicateArray(code, &dedupe_code_);
+  return AllocateOrDeduplicateArray(code, &dedupe_code_, &code_stats_);
 }
 
 void CompiledMethodStorage::ReleaseCode(const LengthPrefixedArray<uint8_t>* code) {
-  ReleaseArrayIfNotDeduplicated(code);
+  ReleaseArrayIfNotDeduplicated(code, &code_stats_);
 }
 
 size_t CompiledMethodStorage::UniqueCodeEntries() const {
@@ -190,11 +220,11 @@ size_t CompiledMethodStorage::UniqueCodeEntries() const {
 
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateVMapTable(
     const ArrayRef<const uint8_t>& table) {
-  return AllocateOrDeduplicateArray(table, &dedupe_vmap_table_);
+  return AllocateOrDeduplicateArray(table, &dedupe_vmap_table_, &vmap_table_stats_);
 }
 
 void CompiledMethodStorage::ReleaseVMapTable(const LengthPrefixedArray<uint8_t>* table) {
-  ReleaseArrayIfNotDeduplicated(table);
+  ReleaseArrayIfNotDeduplicated(table, &vmap_table_stats_);
 }
 
 size_t CompiledMethodStorage::UniqueVMapTableEntries() const {
@@ -204,11 +234,11 @@ size_t CompiledMethodStorage::UniqueVMapTableEntries() const {
 
 const LengthPrefixedArray<uint8_t>* CompiledMethodStorage::DeduplicateCFIInfo(
     const ArrayRef<const uint8_t>& cfi_info) {
-  return AllocateOrDeduplicateArray(cfi_info, &dedupe_cfi_info_);
+  return AllocateOrDeduplicateArray(cfi_info, &dedupe_cfi_info_, &cfi_info_stats_);
 }
 
 void CompiledMethodStorage::ReleaseCFIInfo(const LengthPrefixedArray<uint8_t>* cfi_info) {
-  ReleaseArrayIfNotDeduplicated(cfi_info);
+  ReleaseArrayIfNotDeduplicated(cfi_info, &cfi_info_stats_);
 }
 
 size_t CompiledMethodStorage::UniqueCFIInfoEntries() const {
@@ -218,12 +248,13 @@ size_t CompiledMethodStorage::UniqueCFIInfoEntries() const {
 
 const LengthPrefixedArray<linker::LinkerPatch>* CompiledMethodStorage::DeduplicateLinkerPatches(
     const ArrayRef<const linker::LinkerPatch>& linker_patches) {
-  return AllocateOrDeduplicateArray(linker_patches, &dedupe_linker_patches_);
+  return AllocateOrDeduplicateArray(
+      linker_patches, &dedupe_linker_patches_, &linker_patches_stats_);
 }
 
 void CompiledMethodStorage::ReleaseLinkerPatches(
     const LengthPrefixedArray<linker::LinkerPatch>* linker_patches) {
-  ReleaseArrayIfNotDeduplicated(linker_patches);
+  ReleaseArrayIfNotDeduplicated(linker_patches, &linker_patches_stats_);
 }
 
 size_t CompiledMethodStorage::UniqueLinkerPatchesEntries() const {
@@ -297,7 +328,9 @@ void CompiledMethodStorage::SetThunkCode(const linker::LinkerPatch& linker_patch
   ThunkMapValue value(std::move(code_copy), debug_name);
   MutexLock lock(Thread::Current(), thunk_map_lock_);
   // Note: Multiple threads can try and compile the same thunk, so this may not create a new entry.
-  thunk_map_.emplace(key, std::move(value));
+  if (thunk_map_.emplace(key, std::move(value)).second) {
+    thunk_stats_.Add(code.size());
+  }
 }
 
 }  // namespace art
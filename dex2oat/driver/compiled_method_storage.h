@@ -17,6 +17,7 @@
 #ifndef ART_DEX2OAT_DRIVER_COMPILED_METHOD_STORAGE_H_
 #define ART_DEX2OAT_DRIVER_COMPILED_METHOD_STORAGE_H_
 
+#include <atomic>
 #include <iosfwd>
 #include <map>
 #include <memory>
@@ -42,6 +43,12 @@ class CompiledMethodStorage final : public CompiledCodeStorage {
 
   void DumpMemoryUsage(std::ostream& os, bool extended) const;
 
+  // Dump the peak bytes held for each kind of compiled data, and the swap statistics.
+  void DumpStats(std::ostream& os) const;
+
+  // See SwapSpace::SetResidentLimit(). Has no effect without swap.
+  void SetSwapResidentLimit(size_t limit);
+
   void SetDedupeEnabled(bool dedupe_enabled) {
     dedupe_enabled_ = dedupe_enabled;
   }
@@ -100,12 +107,37 @@ class CompiledMethodStorage final : public CompiledCodeStorage {
 
   static ThunkMapKey GetThunkMapKey(const linker::LinkerPatch& linker_patch);
 
+  // Tracks the bytes held for one kind of compiled data.
+  class StorageStats {
+   public:
+    void Add(size_t bytes) {
+      size_t current = current_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+      size_t peak = peak_.load(std::memory_order_relaxed);
+      while (current > peak &&
+             !peak_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+      }
+    }
+
+    void Remove(size_t bytes) {
+      current_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    size_t GetPeak() const {
+      return peak_.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<size_t> current_{0u};
+    std::atomic<size_t> peak_{0u};
+  };
+
   template <typename T, typename DedupeSetType>
   const LengthPrefixedArray<T>* AllocateOrDeduplicateArray(const ArrayRef<const T>& data,
-                                                           DedupeSetType* dedupe_set);
+                                                           DedupeSetType* dedupe_set,
+                                                           StorageStats* stats);
 
   template <typename T>
-  void ReleaseArrayIfNotDeduplicated(const LengthPrefixedArray<T>* array);
+  void ReleaseArrayIfNotDeduplicated(const LengthPrefixedArray<T>* array, StorageStats* stats);
 
   // DeDuplication data structures.
   template <typename ContentType>
@@ -128,6 +160,13 @@ class CompiledMethodStorage final : public CompiledCodeStorage {
 
   bool dedupe_enabled_;
 
+  // Need to be before the dedupe sets, whose allocators refer to them.
+  StorageStats code_stats_;
+  StorageStats vmap_table_stats_;
+  StorageStats cfi_info_stats_;
+  StorageStats linker_patches_stats_;
+  StorageStats thunk_stats_;
+
   ArrayDedupeSet<uint8_t> dedupe_code_;
   ArrayDedupeSet<uint8_t> dedupe_vmap_table_;
   ArrayDedupeSet<uint8_t> dedupe_cfi_info_;
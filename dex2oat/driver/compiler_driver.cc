@@ -22,6 +22,8 @@
 #include <malloc.h>  // For mallinfo
 #endif
 
+#include <atomic>
+#include <limits>
 #include <string_view>
 #include <vector>
 
@@ -44,11 +46,13 @@
 #include "class_linker-inl.h"
 #include "class_root-inl.h"
 #include "common_throws.h"
+#include "compilation_shard.h"
 #include "compiled_method-inl.h"
 #include "compiler.h"
 #include "compiler_callbacks.h"
 #include "compiler_driver-inl.h"
 #include "dex/class_accessor-inl.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/descriptors_names.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_annotations.h"
@@ -266,7 +270,9 @@ CompilerDriver::CompilerDriver(
       parallel_thread_count_(thread_count),
       stats_(new AOTCompilationStats),
       compiled_method_storage_(swap_fd),
-      max_arena_alloc_(0) {
+      max_arena_alloc_(0),
+      compilation_shard_index_(0u),
+      compilation_shard_count_(1u) {
   DCHECK(compiler_options_ != nullptr);
 
   compiled_method_storage_.SetDedupeEnabled(compiler_options_->DeduplicateCode());
@@ -349,6 +355,9 @@ void CompilerDriver::CompileAll(jobject class_loader,
   }
   if (GetCompilerOptions().GetDumpStats()) {
     stats_->Dump();
+    std::ostringstream oss;
+    compiled_method_storage_.DumpStats(oss);
+    LOG(INFO) << oss.str();
   }
 }
 
@@ -1828,8 +1837,9 @@ static void LoadAndUpdateStatus(const ClassAccessor& accessor,
 }
 
 bool CompilerDriver::FastVerify(jobject jclass_loader,
-                                const std::vector<const DexFile*>& dex_files,
-                                TimingLogger* timings) {
+                                const std::vector<const DexFile*>& all_dex_files,
+                                TimingLogger* timings,
+                                /*out*/ std::vector<const DexFile*>* remaining_dex_files) {
   CompilerCallbacks* callbacks = Runtime::Current()->GetCompilerCallbacks();
   verifier::VerifierDeps* verifier_deps = callbacks->GetVerifierDeps();
   // If there exist VerifierDeps that aren't the ones we just created to output, use them to verify.
@@ -1838,6 +1848,17 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
   }
   TimingLogger::ScopedTiming t("Fast Verify", timings);
 
+  // Only the dex files with stored data can be fast verified, the other ones
+  // need to go through the verifier.
+  std::vector<const DexFile*> dex_files;
+  for (const DexFile* dex_file : all_dex_files) {
+    if (verifier_deps->HasStoredData(*dex_file)) {
+      dex_files.push_back(dex_file);
+    } else {
+      remaining_dex_files->push_back(dex_file);
+    }
+  }
+
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<2> hs(soa.Self());
   Handle<mirror::ClassLoader> class_loader(
@@ -1910,11 +1931,17 @@ bool CompilerDriver::FastVerify(jobject jclass_loader,
 }
 
 void CompilerDriver::Verify(jobject jclass_loader,
-                            const std::vector<const DexFile*>& dex_files,
+                            const std::vector<const DexFile*>& all_dex_files,
                             TimingLogger* timings) {
-  if (FastVerify(jclass_loader, dex_files, timings)) {
-    return;
+  std::vector<const DexFile*> remaining_dex_files;
+  if (FastVerify(jclass_loader, all_dex_files, timings, &remaining_dex_files)) {
+    if (remaining_dex_files.empty()) {
+      return;
+    }
+  } else {
+    remaining_dex_files = all_dex_files;
   }
+  const std::vector<const DexFile*>& dex_files = remaining_dex_files;
 
   // If there is no existing `verifier_deps` (because of non-existing vdex), or
   // the existing `verifier_deps` is not valid anymore, create a new one. The
@@ -2687,6 +2714,12 @@ static void CompileDexFile(CompilerDriver* driver,
     const dex::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
     ClassAccessor accessor(dex_file, class_def_index);
     CompilerDriver* const driver = context.GetCompiler();
+    // Skip classes compiled by other shards.
+    if (!CompilationShard::ContainsClass(class_def_index,
+                                         driver->GetCompilationShardIndex(),
+                                         driver->GetCompilationShardCount())) {
+      return;
+    }
     // Skip compiling classes with generic verifier failures since they will still fail at runtime
     DCHECK(driver->GetVerificationResults() != nullptr);
     if (driver->GetVerificationResults()->IsClassRejected(ref)) {
@@ -2745,6 +2778,164 @@ static void CompileDexFile(CompilerDriver* driver,
   context.ForAllLambda(0, dex_file.NumClassDefs(), compile, thread_count);
 }
 
+// Compile the methods of all `dex_files` in the order of their estimated benefit, and stop once
+// the compilation time or compiled code size budget is exhausted. The methods are ranked by
+// their profile hotness (hot, then startup, then post-startup, then the rest), and within the
+// same hotness, smaller methods first as they are cheaper to compile and more likely to be
+// inlined. The methods left out run in the interpreter and can be JIT-compiled.
+static void CompileDexFilesWithBudget(CompilerDriver* driver,
+                                      jobject class_loader,
+                                      const std::vector<const DexFile*>& dex_files,
+                                      ThreadPool* thread_pool,
+                                      size_t thread_count,
+                                      TimingLogger* timings) {
+  TimingLogger::ScopedTiming t("Compile Dex Files With Budget", timings);
+  const CompilerOptions& compiler_options = driver->GetCompilerOptions();
+  const ProfileCompilationInfo* profile = compiler_options.GetProfileCompilationInfo();
+  const bool use_profile =
+      profile != nullptr && CompilerFilter::DependsOnProfile(compiler_options.GetCompilerFilter());
+
+  struct RankedMethod {
+    const DexFile* dex_file;
+    ProfileCompilationInfo::ProfileIndexType profile_index;
+    const dex::CodeItem* code_item;
+    uint32_t access_flags;
+    InvokeType invoke_type;
+    uint16_t class_def_index;
+    uint32_t method_idx;
+    uint32_t hotness_rank;
+    uint32_t code_units;
+  };
+  std::vector<RankedMethod> methods;
+  for (const DexFile* dex_file : dex_files) {
+    ProfileCompilationInfo::ProfileIndexType profile_index =
+        use_profile ? profile->FindDexFile(*dex_file) : ProfileCompilationInfo::MaxProfileIndex();
+    for (ClassAccessor accessor : dex_file->GetClasses()) {
+      uint16_t class_def_index = accessor.GetClassDefIndex();
+      if (!CompilationShard::ContainsClass(class_def_index,
+                                           driver->GetCompilationShardIndex(),
+                                           driver->GetCompilationShardCount())) {
+        continue;
+      }
+      const dex::ClassDef& class_def = accessor.GetClassDef();
+      int64_t previous_method_idx = -1;
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        const uint32_t method_idx = method.GetIndex();
+        if (method_idx == previous_method_idx) {
+          // smali can create dex files with two encoded_methods sharing the same method_idx
+          continue;
+        }
+        previous_method_idx = method_idx;
+        uint32_t hotness_rank = 0u;
+        if (profile_index != ProfileCompilationInfo::MaxProfileIndex()) {
+          hotness_rank = profile->IsHotMethod(profile_index, method_idx) ? 3u :
+              profile->IsStartupMethod(profile_index, method_idx) ? 2u :
+              profile->IsPostStartupMethod(profile_index, method_idx) ? 1u : 0u;
+        }
+        const dex::CodeItem* code_item = method.GetCodeItem();
+        uint32_t code_units = (code_item != nullptr)
+            ? CodeItemInstructionAccessor(*dex_file, code_item).InsnsSizeInCodeUnits()
+            : 0u;
+        methods.push_back({dex_file,
+                           profile_index,
+                           code_item,
+                           method.GetAccessFlags(),
+                           method.GetInvokeType(class_def.access_flags_),
+                           class_def_index,
+                           method_idx,
+                           hotness_rank,
+                           code_units});
+      }
+    }
+  }
+  std::stable_sort(methods.begin(),
+                   methods.end(),
+                   [](const RankedMethod& lhs, const RankedMethod& rhs) {
+                     if (lhs.hotness_rank != rhs.hotness_rank) {
+                       return lhs.hotness_rank > rhs.hotness_rank;
+                     }
+                     return lhs.code_units < rhs.code_units;
+                   });
+
+  const uint64_t deadline_ns = (compiler_options.GetCompilationTimeBudgetMs() != 0u)
+      ? NanoTime() + MsToNs(compiler_options.GetCompilationTimeBudgetMs())
+      : std::numeric_limits<uint64_t>::max();
+  const size_t code_size_budget = (compiler_options.GetCompiledCodeSizeBudget() != 0u)
+      ? compiler_options.GetCompiledCodeSizeBudget()
+      : std::numeric_limits<size_t>::max();
+  std::atomic<size_t> code_size(0u);
+  std::atomic<size_t> compiled_count(0u);
+  std::atomic<bool> budget_exhausted(false);
+
+  ParallelCompilationManager context(Runtime::Current()->GetClassLinker(),
+                                     class_loader,
+                                     driver,
+                                     /*dex_file=*/ nullptr,
+                                     thread_pool);
+  auto compile = [&](size_t index) {
+    if (budget_exhausted.load(std::memory_order_relaxed)) {
+      return;
+    }
+    if (NanoTime() >= deadline_ns ||
+        code_size.load(std::memory_order_relaxed) >= code_size_budget) {
+      budget_exhausted.store(true, std::memory_order_relaxed);
+      return;
+    }
+    const RankedMethod& method = methods[index];
+    const DexFile& dex_file = *method.dex_file;
+    SCOPED_TRACE << "compile " << dex_file.GetLocation() << "@" << method.method_idx;
+    ClassReference ref(&dex_file, method.class_def_index);
+    if (driver->GetVerificationResults()->IsClassRejected(ref)) {
+      return;
+    }
+    ClassLinker* class_linker = context.GetClassLinker();
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<3> hs(soa.Self());
+    Handle<mirror::ClassLoader> h_class_loader(
+        hs.NewHandle(soa.Decode<mirror::ClassLoader>(class_loader)));
+    const char* descriptor = dex_file.GetClassDescriptor(dex_file.GetClassDef(ref.index));
+    Handle<mirror::Class> klass(
+        hs.NewHandle(class_linker->FindClass(soa.Self(), descriptor, h_class_loader)));
+    Handle<mirror::DexCache> dex_cache;
+    if (klass == nullptr) {
+      soa.Self()->AssertPendingException();
+      soa.Self()->ClearException();
+      dex_cache = hs.NewHandle(class_linker->FindDexCache(soa.Self(), dex_file));
+    } else if (SkipClass(class_loader, dex_file, klass.Get())) {
+      return;
+    } else {
+      dex_cache = hs.NewHandle(klass->GetDexCache());
+    }
+
+    // Go to native so that we don't block GC during compilation.
+    ScopedThreadSuspension sts(soa.Self(), ThreadState::kNative);
+    CompileMethodQuick(soa.Self(),
+                       driver,
+                       method.code_item,
+                       method.access_flags,
+                       method.invoke_type,
+                       method.class_def_index,
+                       method.method_idx,
+                       h_class_loader,
+                       dex_file,
+                       dex_cache,
+                       method.profile_index);
+    CompiledMethod* compiled_method =
+        driver->GetCompiledMethod(MethodReference(&dex_file, method.method_idx));
+    if (compiled_method != nullptr) {
+      code_size.fetch_add(compiled_method->GetQuickCode().size(), std::memory_order_relaxed);
+      compiled_count.fetch_add(1u, std::memory_order_relaxed);
+    }
+  };
+  context.ForAllLambda(0, methods.size(), compile, thread_count);
+
+  if (budget_exhausted.load(std::memory_order_relaxed)) {
+    LOG(INFO) << "Compilation budget exhausted after compiling " << compiled_count.load()
+              << " methods with " << PrettySize(code_size.load()) << " of code; "
+              << methods.size() << " methods were considered.";
+  }
+}
+
 void CompilerDriver::Compile(jobject class_loader,
                              const std::vector<const DexFile*>& dex_files,
                              TimingLogger* timings) {
@@ -2757,6 +2948,20 @@ void CompilerDriver::Compile(jobject class_loader,
             : profile_compilation_info->DumpInfo(dex_files));
   }
 
+  if (GetCompilerOptions().HasCompilationBudget()) {
+    CompileDexFilesWithBudget(this,
+                              class_loader,
+                              dex_files,
+                              parallel_thread_pool_.get(),
+                              parallel_thread_count_,
+                              timings);
+    const ArenaPool* const arena_pool = Runtime::Current()->GetArenaPool();
+    max_arena_alloc_ = std::max(arena_pool->GetBytesAllocated(), max_arena_alloc_);
+    Runtime::Current()->ReclaimArenaPoolMemory();
+    VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
+    return;
+  }
+
   for (const DexFile* dex_file : dex_files) {
     CHECK(dex_file != nullptr);
     CompileDexFile(this,
@@ -221,6 +221,21 @@ class CompilerDriver {
     return &compiled_method_storage_;
   }
 
+  // Restrict CompileAll() to the classes of the given compilation shard.
+  void SetCompilationShard(size_t shard_index, size_t shard_count) {
+    DCHECK_LT(shard_index, shard_count);
+    compilation_shard_index_ = shard_index;
+    compilation_shard_count_ = shard_count;
+  }
+
+  size_t GetCompilationShardIndex() const {
+    return compilation_shard_index_;
+  }
+
+  size_t GetCompilationShardCount() const {
+    return compilation_shard_count_;
+  }
+
  private:
   void LoadImageClasses(TimingLogger* timings,
                         jobject class_loader,
@@ -242,10 +257,13 @@ class CompilerDriver {
       REQUIRES(!Locks::mutator_lock_);
 
   // Do fast verification through VerifierDeps if possible. Return whether
-  // verification was successful.
+  // verification was successful. Dex files without stored VerifierDeps data (e.g.
+  // dex files changed since an incremental input vdex) are not fast verified and
+  // are added to `remaining_dex_files`.
   bool FastVerify(jobject class_loader,
                   const std::vector<const DexFile*>& dex_files,
-                  TimingLogger* timings);
+                  TimingLogger* timings,
+                  /*out*/ std::vector<const DexFile*>* remaining_dex_files);
 
   void Verify(jobject class_loader,
               const std::vector<const DexFile*>& dex_files,
@@ -326,6 +344,10 @@ class CompilerDriver {
 
   size_t max_arena_alloc_;
 
+  // The compilation shard compiled by this driver, see CompilationShard.
+  size_t compilation_shard_index_;
+  size_t compilation_shard_count_;
+
   friend class CommonCompilerDriverTest;
   friend class CompileClassVisitor;
   friend class InitializeClassVisitor;
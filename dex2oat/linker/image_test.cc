@@ -20,6 +20,8 @@
 #include "image_test.h"
 
 #include "base/pointer_size.h"
+#include "base/unix_file/fd_file.h"
+#include "mirror/object.h"
 #include "oat/image.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread.h"
@@ -64,6 +66,39 @@ TEST_F(ImageTest, TestImageLayout) {
   EXPECT_LT(image_sizes.back(), image_sizes_extra.back());
 }
 
+// Copying and fixing up the image on a thread pool must produce the same image
+// as the serial copy.
+TEST_F(ImageTest, ParallelCopyAndFixupIsDeterministic) {
+  std::vector<std::vector<uint8_t>> serial_images;
+  std::vector<std::vector<uint8_t>> parallel_images;
+  for (size_t thread_count : {0u, 4u}) {
+    // Start from a fresh runtime with a fixed hash code seed, so that both compilations
+    // see the same heap.
+    TearDown();
+    runtime_.reset();
+    mirror::Object::SetHashCodeSeed(987654321u);
+    SetUp();
+    SetImageWriterThreadCount(thread_count);
+    CompilationHelper helper;
+    Compile(ImageHeader::kStorageModeUncompressed,
+            /*max_image_block_size=*/std::numeric_limits<uint32_t>::max(),
+            helper);
+    std::vector<std::vector<uint8_t>>& images =
+        (thread_count == 0u) ? serial_images : parallel_images;
+    for (ScratchFile& image_file : helper.image_files) {
+      std::unique_ptr<File> file(OS::OpenFileForReading(image_file.GetFilename().c_str()));
+      ASSERT_TRUE(file != nullptr);
+      std::vector<uint8_t> data(file->GetLength());
+      ASSERT_TRUE(file->ReadFully(data.data(), data.size()));
+      images.push_back(std::move(data));
+    }
+  }
+  ASSERT_EQ(serial_images.size(), parallel_images.size());
+  for (size_t i = 0; i != serial_images.size(); ++i) {
+    EXPECT_TRUE(serial_images[i] == parallel_images[i]) << "Image " << i << " differs";
+  }
+}
+
 TEST_F(ImageTest, ImageHeaderIsValid) {
   uint32_t image_begin = ART_BASE_ADDRESS;
   uint32_t image_size_ = kElfSegmentAlignment;
@@ -256,6 +291,8 @@ TEST_F(ImageTest, ImageChecksum) {
         bitmap.get(),
         ImageHeader::kStorageModeUncompressed,
         /*max_image_block_size=*/std::numeric_limits<uint32_t>::max(),
+        /*compression_level=*/ 0u,
+        /*train_zstd_dictionary=*/ false,
         /*update_checksum=*/ true,
         &error_msg)) << error_msg;
 
@@ -272,6 +309,8 @@ TEST_F(ImageTest, ImageChecksum) {
         bitmap.get(),
         ImageHeader::kStorageModeUncompressed,
         /*max_image_block_size=*/std::numeric_limits<uint32_t>::max(),
+        /*compression_level=*/ 0u,
+        /*train_zstd_dictionary=*/ false,
         /*update_checksum=*/ true,
         &error_msg)) << error_msg;
 
@@ -55,6 +55,7 @@
 #include "signal_catcher.h"
 #include "stream/buffered_output_stream.h"
 #include "stream/file_output_stream.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace linker {
@@ -91,6 +92,12 @@ class ImageTest : public CommonCompilerDriverTest {
     compiler_filter_ = compiler_filter;
   }
 
+  // Set the number of threads used by the ImageWriter to copy and fix up the image,
+  // or 0 to do it on the calling thread.
+  void SetImageWriterThreadCount(size_t thread_count) {
+    image_writer_thread_count_ = thread_count;
+  }
+
   void Compile(ImageHeader::StorageMode storage_mode,
                uint32_t max_image_block_size,
                /*out*/ CompilationHelper& out_helper,
@@ -131,6 +138,8 @@ class ImageTest : public CommonCompilerDriverTest {
 
   // By default we compile with "speed-profile" and an empty profile. This compiles only JNI stubs.
   CompilerFilter::Filter compiler_filter_ = CompilerFilter::kSpeedProfile;
+
+  size_t image_writer_thread_count_ = 0u;
 };
 
 inline CompilationHelper::~CompilationHelper() {
@@ -349,9 +358,14 @@ inline void ImageTest::DoCompile(ImageHeader::StorageMode storage_mode,
       }
     }
 
+    std::unique_ptr<ThreadPool> thread_pool;
+    if (image_writer_thread_count_ != 0u) {
+      thread_pool.reset(ThreadPool::Create("Image writer thread pool", image_writer_thread_count_));
+    }
     bool success_image = writer->Write(File::kInvalidFd,
                                        image_filenames,
-                                       image_filenames.size());
+                                       image_filenames.size(),
+                                       thread_pool.get());
     ASSERT_TRUE(success_image);
   }
 }
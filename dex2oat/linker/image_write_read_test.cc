@@ -21,13 +21,18 @@ namespace linker {
 
 class ImageWriteReadTest : public ImageTest {
  protected:
-  void TestWriteRead(ImageHeader::StorageMode storage_mode, uint32_t max_image_block_size);
+  void TestWriteRead(ImageHeader::StorageMode storage_mode,
+                     uint32_t max_image_block_size,
+                     bool train_zstd_dictionary = false);
 };
 
 void ImageWriteReadTest::TestWriteRead(ImageHeader::StorageMode storage_mode,
-                                       uint32_t max_image_block_size) {
+                                       uint32_t max_image_block_size,
+                                       bool train_zstd_dictionary) {
   CompilationHelper helper;
+  compiler_options_->SetTrainImageZstdDictionary(train_zstd_dictionary);
   Compile(storage_mode, max_image_block_size, /*out*/ helper);
+  uint32_t max_zstd_dictionary_size = 0u;
   std::vector<uint64_t> image_file_sizes;
   for (ScratchFile& image_file : helper.image_files) {
     std::unique_ptr<File> file(OS::OpenFileForReading(image_file.GetFilename().c_str()));
@@ -38,6 +43,11 @@ void ImageWriteReadTest::TestWriteRead(ImageHeader::StorageMode storage_mode,
     const auto& bitmap_section = image_header.GetImageBitmapSection();
     ASSERT_GE(bitmap_section.Offset(), sizeof(image_header));
     ASSERT_NE(0U, bitmap_section.Size());
+    if (!train_zstd_dictionary) {
+      ASSERT_EQ(0u, image_header.GetZstdDictionarySize());
+    }
+    max_zstd_dictionary_size =
+        std::max(max_zstd_dictionary_size, image_header.GetZstdDictionarySize());
 
     gc::Heap* heap = Runtime::Current()->GetHeap();
     ASSERT_TRUE(heap->HaveContinuousSpaces());
@@ -47,6 +57,10 @@ void ImageWriteReadTest::TestWriteRead(ImageHeader::StorageMode storage_mode,
     ASSERT_TRUE(space->IsMallocSpace());
     image_file_sizes.push_back(file->GetLength());
   }
+  if (train_zstd_dictionary) {
+    // Training can fail for small images, but not for all of the boot image.
+    ASSERT_NE(0u, max_zstd_dictionary_size);
+  }
 
   // Need to delete the compiler since it has worker threads which are attached to runtime.
   compiler_driver_.reset();
@@ -156,5 +170,26 @@ TEST_F(ImageWriteReadTest, WriteReadLZ4HCKBBlock) {
   TestWriteRead(ImageHeader::kStorageModeLZ4HC, /*max_image_block_size=*/KB);
 }
 
+TEST_F(ImageWriteReadTest, WriteReadZstd) {
+  TestWriteRead(ImageHeader::kStorageModeZstd,
+                /*max_image_block_size=*/std::numeric_limits<uint32_t>::max());
+}
+
+TEST_F(ImageWriteReadTest, WriteReadZstdKBBlock) {
+  TestWriteRead(ImageHeader::kStorageModeZstd, /*max_image_block_size=*/KB);
+}
+
+TEST_F(ImageWriteReadTest, WriteReadZstdDictionary) {
+  TestWriteRead(ImageHeader::kStorageModeZstd,
+                /*max_image_block_size=*/std::numeric_limits<uint32_t>::max(),
+                /*train_zstd_dictionary=*/ true);
+}
+
+TEST_F(ImageWriteReadTest, WriteReadZstdDictionaryKBBlock) {
+  TestWriteRead(ImageHeader::kStorageModeZstd,
+                /*max_image_block_size=*/KB,
+                /*train_zstd_dictionary=*/ true);
+}
+
 }  // namespace linker
 }  // namespace art
@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 #include <zlib.h>
 
+#include <atomic>
 #include <charconv>
 #include <memory>
 #include <numeric>
@@ -85,6 +86,7 @@
 #include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "subtype_check.h"
+#include "thread_pool.h"
 #include "well_known_classes-inl.h"
 
 using ::art::mirror::Class;
@@ -552,7 +554,8 @@ bool ImageWriter::IsInternedAppImageStringReference(ObjPtr<mirror::Object> refer
 
 bool ImageWriter::Write(int image_fd,
                         const std::vector<std::string>& image_filenames,
-                        size_t component_count) {
+                        size_t component_count,
+                        ThreadPool* thread_pool) {
   // If image_fd or oat_fd are not File::kInvalidFd then we may have empty strings in
   // image_filenames or oat_filenames.
   CHECK(!image_filenames.empty());
@@ -564,6 +567,7 @@ bool ImageWriter::Write(int image_fd,
 
   Thread* const self = Thread::Current();
   ScopedDebugDisallowReadBarriers sddrb(self);
+  thread_pool_ = thread_pool;
   {
     ScopedObjectAccess soa(self);
     for (size_t i = 0; i < oat_filenames_.size(); ++i) {
@@ -579,6 +583,7 @@ bool ImageWriter::Write(int image_fd,
     Runtime::Current()->GetHeap()->DisableObjectValidation();
     CopyAndFixupObjects();
   }
+  thread_pool_ = nullptr;
 
   if (compiler_options_.IsAppImage()) {
     CopyMetadata();
@@ -627,6 +632,8 @@ bool ImageWriter::Write(int image_fd,
                                  reinterpret_cast<const uint8_t*>(image_info.image_bitmap_.Begin()),
                                  image_storage_mode_,
                                  compiler_options_.MaxImageBlockSize(),
+                                 compiler_options_.ImageCompressionLevel(),
+                                 compiler_options_.TrainImageZstdDictionary(),
                                  /* update_checksum= */ true,
                                  &error_msg)) {
       LOG(ERROR) << error_msg;
@@ -1714,7 +1721,7 @@ class ImageWriter::LayoutHelper::CollectClassesVisitor {
       ClassTable* app_class_table = app_class_loader->GetClassTable();
       ReaderMutexLock lock(self, app_class_table->lock_);
       DCHECK_EQ(app_class_table->classes_.size(), 1u);
-      const ClassTable::ClassSet& app_class_set = app_class_table->classes_[0];
+      const ClassTable::ClassSet& app_class_set = app_class_table->classes_.front();
       DCHECK_GE(app_class_set.size(), image_info.class_table_size_);
       boot_image_classes.reserve(app_class_set.size() - image_info.class_table_size_);
       for (const ClassTable::TableSlot& slot : app_class_set) {
@@ -2942,73 +2949,116 @@ void ImageWriter::CopyAndFixupImtConflictTable(ImtConflictTable* orig, ImtConfli
   }
 }
 
+template <typename Fn>
+void ImageWriter::ForAllChunks(size_t size, Fn fn) {
+  // Small chunks keep the workers balanced, the per-chunk overhead is a single atomic add.
+  static constexpr size_t kChunkSize = 256u;
+  if (thread_pool_ == nullptr || size <= kChunkSize) {
+    fn(/*begin=*/ 0u, size);
+    return;
+  }
+  std::atomic<size_t> next_begin(0u);
+  auto run_chunks = [&next_begin, &fn, size](Thread* self) {
+    ScopedObjectAccess soa(self);
+    ScopedDebugDisallowReadBarriers sddrb(self);
+    while (true) {
+      size_t begin = next_begin.fetch_add(kChunkSize, std::memory_order_relaxed);
+      if (begin >= size) {
+        break;
+      }
+      fn(begin, std::min(begin + kChunkSize, size));
+    }
+  };
+  Thread* self = Thread::Current();
+  // Release the mutator lock while waiting; the calling thread takes it again
+  // in `run_chunks` when it participates in the work.
+  ScopedThreadSuspension sts(self, ThreadState::kNative);
+  for (size_t i = 0, num_tasks = thread_pool_->GetThreadCount() + 1u; i != num_tasks; ++i) {
+    thread_pool_->AddTask(self, new FunctionTask(run_chunks));
+  }
+  thread_pool_->StartWorkers(self);
+  thread_pool_->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+  thread_pool_->StopWorkers(self);
+}
+
+void ImageWriter::CopyAndFixupNativeObject(void* obj, const NativeObjectRelocation& relocation) {
+  const ImageInfo& image_info = GetImageInfo(relocation.oat_index);
+  auto* dest = image_info.image_.Begin() + relocation.offset;
+  DCHECK_GE(dest, image_info.image_.Begin() + image_info.image_end_);
+  DCHECK(!IsInBootImage(obj));
+  switch (relocation.type) {
+    case NativeObjectRelocationType::kRuntimeMethod:
+    case NativeObjectRelocationType::kArtMethodClean:
+    case NativeObjectRelocationType::kArtMethodDirty: {
+      CopyAndFixupMethod(reinterpret_cast<ArtMethod*>(obj),
+                         reinterpret_cast<ArtMethod*>(dest),
+                         relocation.oat_index);
+      break;
+    }
+    case NativeObjectRelocationType::kArtFieldArray: {
+      // Copy and fix up the entire field array.
+      auto* src_array = reinterpret_cast<LengthPrefixedArray<ArtField>*>(obj);
+      auto* dest_array = reinterpret_cast<LengthPrefixedArray<ArtField>*>(dest);
+      size_t size = src_array->size();
+      memcpy(dest_array, src_array, LengthPrefixedArray<ArtField>::ComputeSize(size));
+      for (size_t i = 0; i != size; ++i) {
+        CopyAndFixupReference(
+            dest_array->At(i).GetDeclaringClassAddressWithoutBarrier(),
+            src_array->At(i).GetDeclaringClass<kWithoutReadBarrier>());
+      }
+      break;
+    }
+    case NativeObjectRelocationType::kArtMethodArrayClean:
+    case NativeObjectRelocationType::kArtMethodArrayDirty: {
+      // For method arrays, copy just the header since the elements will
+      // get copied by their corresponding relocations.
+      size_t size = ArtMethod::Size(target_ptr_size_);
+      size_t alignment = ArtMethod::Alignment(target_ptr_size_);
+      memcpy(dest, obj, LengthPrefixedArray<ArtMethod>::ComputeSize(0, size, alignment));
+      // Clear padding to avoid non-deterministic data in the image.
+      // Historical note: We also did that to placate Valgrind.
+      reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(dest)->ClearPadding(size, alignment);
+      break;
+    }
+    case NativeObjectRelocationType::kIMTable: {
+      ImTable* orig_imt = reinterpret_cast<ImTable*>(obj);
+      ImTable* dest_imt = reinterpret_cast<ImTable*>(dest);
+      CopyAndFixupImTable(orig_imt, dest_imt);
+      break;
+    }
+    case NativeObjectRelocationType::kIMTConflictTable: {
+      auto* orig_table = reinterpret_cast<ImtConflictTable*>(obj);
+      CopyAndFixupImtConflictTable(
+          orig_table,
+          new(dest)ImtConflictTable(orig_table->NumEntries(target_ptr_size_), target_ptr_size_));
+      break;
+    }
+    case NativeObjectRelocationType::kGcRootPointer: {
+      auto* orig_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(obj);
+      auto* dest_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(dest);
+      CopyAndFixupReference(dest_pointer->AddressWithoutBarrier(), orig_pointer->Read());
+      break;
+    }
+  }
+}
+
 void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
   const ImageInfo& image_info = GetImageInfo(oat_index);
   // Copy ArtFields and methods to their locations and update the array for convenience.
-  for (auto& pair : native_object_relocations_) {
-    NativeObjectRelocation& relocation = pair.second;
+  // Each relocation writes only to its own destination, so they can be processed in parallel.
+  std::vector<const std::pair<void*, NativeObjectRelocation>*> relocations;
+  for (const auto& pair : native_object_relocations_) {
     // Only work with fields and methods that are in the current oat file.
-    if (relocation.oat_index != oat_index) {
-      continue;
-    }
-    auto* dest = image_info.image_.Begin() + relocation.offset;
-    DCHECK_GE(dest, image_info.image_.Begin() + image_info.image_end_);
-    DCHECK(!IsInBootImage(pair.first));
-    switch (relocation.type) {
-      case NativeObjectRelocationType::kRuntimeMethod:
-      case NativeObjectRelocationType::kArtMethodClean:
-      case NativeObjectRelocationType::kArtMethodDirty: {
-        CopyAndFixupMethod(reinterpret_cast<ArtMethod*>(pair.first),
-                           reinterpret_cast<ArtMethod*>(dest),
-                           oat_index);
-        break;
-      }
-      case NativeObjectRelocationType::kArtFieldArray: {
-        // Copy and fix up the entire field array.
-        auto* src_array = reinterpret_cast<LengthPrefixedArray<ArtField>*>(pair.first);
-        auto* dest_array = reinterpret_cast<LengthPrefixedArray<ArtField>*>(dest);
-        size_t size = src_array->size();
-        memcpy(dest_array, src_array, LengthPrefixedArray<ArtField>::ComputeSize(size));
-        for (size_t i = 0; i != size; ++i) {
-          CopyAndFixupReference(
-              dest_array->At(i).GetDeclaringClassAddressWithoutBarrier(),
-              src_array->At(i).GetDeclaringClass<kWithoutReadBarrier>());
-        }
-        break;
-      }
-      case NativeObjectRelocationType::kArtMethodArrayClean:
-      case NativeObjectRelocationType::kArtMethodArrayDirty: {
-        // For method arrays, copy just the header since the elements will
-        // get copied by their corresponding relocations.
-        size_t size = ArtMethod::Size(target_ptr_size_);
-        size_t alignment = ArtMethod::Alignment(target_ptr_size_);
-        memcpy(dest, pair.first, LengthPrefixedArray<ArtMethod>::ComputeSize(0, size, alignment));
-        // Clear padding to avoid non-deterministic data in the image.
-        // Historical note: We also did that to placate Valgrind.
-        reinterpret_cast<LengthPrefixedArray<ArtMethod>*>(dest)->ClearPadding(size, alignment);
-        break;
-      }
-      case NativeObjectRelocationType::kIMTable: {
-        ImTable* orig_imt = reinterpret_cast<ImTable*>(pair.first);
-        ImTable* dest_imt = reinterpret_cast<ImTable*>(dest);
-        CopyAndFixupImTable(orig_imt, dest_imt);
-        break;
-      }
-      case NativeObjectRelocationType::kIMTConflictTable: {
-        auto* orig_table = reinterpret_cast<ImtConflictTable*>(pair.first);
-        CopyAndFixupImtConflictTable(
-            orig_table,
-            new(dest)ImtConflictTable(orig_table->NumEntries(target_ptr_size_), target_ptr_size_));
-        break;
-      }
-      case NativeObjectRelocationType::kGcRootPointer: {
-        auto* orig_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(pair.first);
-        auto* dest_pointer = reinterpret_cast<GcRoot<mirror::Object>*>(dest);
-        CopyAndFixupReference(dest_pointer->AddressWithoutBarrier(), orig_pointer->Read());
-        break;
-      }
+    if (pair.second.oat_index == oat_index) {
+      relocations.push_back(&pair);
     }
   }
+  ForAllChunks(relocations.size(), [&](size_t begin, size_t end)
+                                       REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t i = begin; i != end; ++i) {
+      CopyAndFixupNativeObject(relocations[i]->first, relocations[i]->second);
+    }
+  });
   // Fixup the image method roots.
   auto* image_header = reinterpret_cast<ImageHeader*>(image_info.image_.Begin());
   for (size_t i = 0; i < ImageHeader::kImageMethodsCount; ++i) {
@@ -3044,7 +3094,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       MutexLock lock(Thread::Current(), *Locks::intern_table_lock_);
       CHECK(!temp_intern_table.strong_interns_.tables_.empty());
       // The UnorderedSet was inserted at the beginning.
-      CHECK_EQ(temp_intern_table.strong_interns_.tables_[0].Size(), intern_table.size());
+      CHECK_EQ(temp_intern_table.strong_interns_.tables_.front().Size(), intern_table.size());
     }
   }
 
@@ -3073,7 +3123,7 @@ void ImageWriter::CopyAndFixupNativeData(size_t oat_index) {
       ReaderMutexLock lock(Thread::Current(), temp_class_table.lock_);
       CHECK(!temp_class_table.classes_.empty());
       // The ClassSet was inserted at the beginning.
-      CHECK_EQ(temp_class_table.classes_[0].size(), table.size());
+      CHECK_EQ(temp_class_table.classes_.front().size(), table.size());
     }
   }
 }
@@ -3141,7 +3191,8 @@ inline Object* ImageWriter::CopyObject(Object* obj) {
   DCHECK_LT(offset, image_info.image_end_);
   const auto* src = reinterpret_cast<const uint8_t*>(obj);
 
-  bool done = image_info.image_bitmap_.Set(dst);  // Mark the obj as live.
+  // Mark the obj as live. Objects are copied in parallel and neighbours share bitmap words.
+  bool done = image_info.image_bitmap_.AtomicTestAndSet(dst);
   // Check if the object was already copied, unless the caller indicated that it was not.
   if (kCheckIfDone && done) {
     return nullptr;
@@ -3235,11 +3286,22 @@ void ImageWriter::CopyAndFixupObjects() {
     }
   }
 
+  // Collect the image objects first. Each object is copied to its own bin slot and only the
+  // copy is fixed up, so the objects can then be processed in parallel in any order.
+  std::vector<Object*> objects;
   auto visitor = [&](Object* obj) REQUIRES_SHARED(Locks::mutator_lock_) {
     DCHECK(obj != nullptr);
-    CopyAndFixupObject(obj);
+    if (IsImageBinSlotAssigned(obj)) {
+      objects.push_back(obj);
+    }
   };
   Runtime::Current()->GetHeap()->VisitObjects(visitor);
+  ForAllChunks(objects.size(), [&](size_t begin, size_t end)
+                                   REQUIRES_SHARED(Locks::mutator_lock_) {
+    for (size_t i = begin; i != end; ++i) {
+      CopyAndFixupObject(objects[i]);
+    }
+  });
 
   // Fill the padding objects since they are required for in order traversal of the image space.
   for (ImageInfo& image_info : image_infos_) {
@@ -3789,6 +3851,7 @@ ImageWriter::ImageWriter(const CompilerOptions& compiler_options,
       boot_image_live_objects_(nullptr),
       image_roots_(),
       image_storage_mode_(image_storage_mode),
+      thread_pool_(nullptr),
       oat_filenames_(oat_filenames),
       dex_file_oat_index_map_(dex_file_oat_index_map),
       dirty_image_objects_(dirty_image_objects) {
@@ -71,6 +71,7 @@ template<class T> class Handle;
 class ImTable;
 class ImtConflictTable;
 class JavaVMExt;
+class ThreadPool;
 class TimingLogger;
 
 namespace linker {
@@ -153,9 +154,12 @@ class ImageWriter final {
   // the names in image_filenames.
   // If oat_fd is not File::kInvalidFd, then we use that for the oat file. Otherwise we open
   // the names in oat_filenames.
+  // If a `thread_pool` is provided, the objects and native data are copied and fixed up
+  // in parallel on its workers. The resulting image is the same as with the serial copy.
   bool Write(int image_fd,
              const std::vector<std::string>& image_filenames,
-             size_t component_count)
+             size_t component_count,
+             ThreadPool* thread_pool = nullptr)
       REQUIRES(!Locks::mutator_lock_);
 
   uintptr_t GetOatDataBegin(size_t oat_index) {
@@ -460,6 +464,11 @@ class ImageWriter final {
       REQUIRES_SHARED(Locks::mutator_lock_);
   bool CreateImageRoots() REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Call `fn(begin, end)` for consecutive chunks of the range [0, size). With a `thread_pool_`,
+  // the chunks are processed in parallel and each worker holds the mutator lock shared.
+  template <typename Fn>
+  void ForAllChunks(size_t size, Fn fn) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Creates the contiguous image in memory and adjusts pointers.
   void CopyAndFixupNativeData(size_t oat_index) REQUIRES_SHARED(Locks::mutator_lock_);
   void CopyAndFixupJniStubMethods(size_t oat_index) REQUIRES_SHARED(Locks::mutator_lock_);
@@ -554,6 +563,10 @@ class ImageWriter final {
 
   NativeObjectRelocation GetNativeRelocation(void* obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Copy and fix up a single entry of `native_object_relocations_`.
+  void CopyAndFixupNativeObject(void* obj, const NativeObjectRelocation& relocation)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Location of where the object will be when the image is loaded at runtime.
   template <typename T>
   T* NativeLocationInImage(T* obj) REQUIRES_SHARED(Locks::mutator_lock_);
@@ -692,6 +705,9 @@ class ImageWriter final {
   // Which mode the image is stored as, see image.h
   const ImageHeader::StorageMode image_storage_mode_;
 
+  // The thread pool for copying and fixing up the image, only set during Write().
+  ThreadPool* thread_pool_;
+
   // The file names of oat files.
   const std::vector<std::string>& oat_filenames_;
 
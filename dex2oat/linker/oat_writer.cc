@@ -20,7 +20,10 @@
 #include <zlib.h>
 
 #include <algorithm>
+#include <atomic>
+#include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "arch/arm64/instruction_set_features_arm64.h"
@@ -43,6 +46,8 @@
 #include "debug/method_debug_info.h"
 #include "dex/art_dex_file_loader.h"
 #include "dex/class_accessor-inl.h"
+#include "dex/class_reference.h"
+#include "dex/code_item_accessors-inl.h"
 #include "dex/dex_file-inl.h"
 #include "dex/dex_file_loader.h"
 #include "dex/dex_file_types.h"
@@ -75,6 +80,7 @@
 #include "stream/buffered_output_stream.h"
 #include "stream/file_output_stream.h"
 #include "stream/output_stream.h"
+#include "thread_pool.h"
 #include "vdex_file.h"
 #include "verifier/verifier_deps.h"
 
@@ -98,6 +104,20 @@ static constexpr bool kOatWriterForceOatCodeLayout = false;
 
 static constexpr bool kOatWriterDebugOatCodeLayout = false;
 
+// When profiles are used, order the methods within each hotness bin so that callers and their
+// callees are placed next to each other, see OrderMethodsByCallGraph().
+static constexpr bool kOatWriterCallGraphOatCodeLayout = true;
+
+// Weights of the call graph edges. Calls found in the inline caches of the profile were executed
+// while profiling, so they weigh more than direct calls, which may be on cold paths.
+static constexpr uint32_t kDirectCallWeight = 1u;
+static constexpr uint32_t kProfiledCallWeight = 2u;
+
+// The maximum code size of a cluster of methods placed together by the call graph ordering.
+// Clusters are not grown beyond a page, so that merging does not split hot callers and callees
+// that already fit on a single page.
+static constexpr size_t kMaxCallGraphClusterSize = kMinPageSize;
+
 using UnalignedDexFileHeader __attribute__((__aligned__(1))) = DexFile::Header;
 
 const UnalignedDexFileHeader* AsUnalignedDexFileHeader(const uint8_t* raw_data) {
@@ -390,6 +410,7 @@ OatWriter::OatWriter(const CompilerOptions& compiler_options,
       oat_data_offset_(0u),
       oat_header_(nullptr),
       relative_patcher_(nullptr),
+      thread_pool_(nullptr),
       profile_compilation_info_(info),
       compact_dex_level_(compact_dex_level) {}
 
@@ -594,10 +615,12 @@ void OatWriter::Initialize(const CompilerDriver* compiler_driver,
   write_state_ = WriteState::kPrepareLayout;
 }
 
-void OatWriter::PrepareLayout(MultiOatRelativePatcher* relative_patcher) {
+void OatWriter::PrepareLayout(MultiOatRelativePatcher* relative_patcher,
+                              ThreadPool* thread_pool) {
   CHECK(write_state_ == WriteState::kPrepareLayout);
 
   relative_patcher_ = relative_patcher;
+  thread_pool_ = thread_pool;
   SetMultiOatRelativePatcherAdjustment();
 
   if (GetCompilerOptions().IsBootImage() || GetCompilerOptions().IsBootImageExtension()) {
@@ -655,6 +678,7 @@ void OatWriter::PrepareLayout(MultiOatRelativePatcher* relative_patcher) {
 
   CHECK_EQ(dex_files_->size(), oat_dex_files_.size());
 
+  thread_pool_ = nullptr;
   write_state_ = WriteState::kWriteRoData;
 }
 
@@ -735,69 +759,109 @@ static bool HasCompiledCode(const CompiledMethod* method) {
   return method != nullptr && !method->GetQuickCode().empty();
 }
 
-class OatWriter::InitBssLayoutMethodVisitor : public DexMethodVisitor {
+// Collects the .data.img.rel.ro and .bss references of compiled methods. Each task of the
+// InitBssLayout() pass fills its own collector and the collectors are merged afterwards.
+// The merged maps are ordered by their keys, so the result is the same for any distribution
+// of the methods over the tasks.
+class OatWriter::BssReferenceCollector {
  public:
-  explicit InitBssLayoutMethodVisitor(OatWriter* writer)
-      : DexMethodVisitor(writer, /* offset */ 0u) {}
+  explicit BssReferenceCollector(const OatWriter* writer) : writer_(writer) {}
 
-  bool VisitMethod([[maybe_unused]] size_t class_def_method_index,
-                   const ClassAccessor::Method& method) override {
+  void VisitMethod(const DexFile* dex_file, const ClassAccessor::Method& method) {
     // Look for patches with .bss references and prepare maps with placeholders for their offsets.
     CompiledMethod* compiled_method = writer_->compiler_driver_->GetCompiledMethod(
-        MethodReference(dex_file_, method.GetIndex()));
+        MethodReference(dex_file, method.GetIndex()));
     if (HasCompiledCode(compiled_method)) {
       for (const LinkerPatch& patch : compiled_method->GetPatches()) {
         if (patch.GetType() == LinkerPatch::Type::kBootImageRelRo) {
-          writer_->boot_image_rel_ro_entries_.Overwrite(patch.BootImageOffset(),
+          boot_image_rel_ro_entries_.Overwrite(patch.BootImageOffset(),
                                                         /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kMethodBssEntry) {
           MethodReference target_method = patch.TargetMethod();
           AddBssReference(target_method,
                           target_method.dex_file->NumMethodIds(),
-                          &writer_->bss_method_entry_references_);
-          writer_->bss_method_entries_.Overwrite(target_method, /* placeholder */ 0u);
+                          &bss_method_entry_references_);
+          bss_method_entries_.Overwrite(target_method, /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kTypeAppImageRelRo) {
-          writer_->app_image_rel_ro_type_entries_.Overwrite(patch.TargetType(),
+          app_image_rel_ro_type_entries_.Overwrite(patch.TargetType(),
                                                             /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kTypeBssEntry) {
           TypeReference target_type = patch.TargetType();
           AddBssReference(target_type,
                           target_type.dex_file->NumTypeIds(),
-                          &writer_->bss_type_entry_references_);
-          writer_->bss_type_entries_.Overwrite(target_type, /* placeholder */ 0u);
+                          &bss_type_entry_references_);
+          bss_type_entries_.Overwrite(target_type, /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kPublicTypeBssEntry) {
           TypeReference target_type = patch.TargetType();
           AddBssReference(target_type,
                           target_type.dex_file->NumTypeIds(),
-                          &writer_->bss_public_type_entry_references_);
-          writer_->bss_public_type_entries_.Overwrite(target_type, /* placeholder */ 0u);
+                          &bss_public_type_entry_references_);
+          bss_public_type_entries_.Overwrite(target_type, /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kPackageTypeBssEntry) {
           TypeReference target_type = patch.TargetType();
           AddBssReference(target_type,
                           target_type.dex_file->NumTypeIds(),
-                          &writer_->bss_package_type_entry_references_);
-          writer_->bss_package_type_entries_.Overwrite(target_type, /* placeholder */ 0u);
+                          &bss_package_type_entry_references_);
+          bss_package_type_entries_.Overwrite(target_type, /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kStringBssEntry) {
           StringReference target_string = patch.TargetString();
           AddBssReference(target_string,
                           target_string.dex_file->NumStringIds(),
-                          &writer_->bss_string_entry_references_);
-          writer_->bss_string_entries_.Overwrite(target_string, /* placeholder */ 0u);
+                          &bss_string_entry_references_);
+          bss_string_entries_.Overwrite(target_string, /* placeholder */ 0u);
         } else if (patch.GetType() == LinkerPatch::Type::kMethodTypeBssEntry) {
           ProtoReference target_proto = patch.TargetProto();
           AddBssReference(target_proto,
                           target_proto.dex_file->NumProtoIds(),
-                          &writer_->bss_method_type_entry_references_);
-          writer_->bss_method_type_entries_.Overwrite(target_proto, /* placeholder */ 0u);
+                          &bss_method_type_entry_references_);
+          bss_method_type_entries_.Overwrite(target_proto, /* placeholder */ 0u);
         }
       }
     } else {
       DCHECK(compiled_method == nullptr || compiled_method->GetPatches().empty());
     }
-    return true;
+  }
+
+  void MergeInto(/*inout*/ OatWriter* writer) {
+    MergeEntries(boot_image_rel_ro_entries_, &writer->boot_image_rel_ro_entries_);
+    MergeReferences(&bss_method_entry_references_, &writer->bss_method_entry_references_);
+    MergeEntries(bss_method_entries_, &writer->bss_method_entries_);
+    MergeEntries(app_image_rel_ro_type_entries_, &writer->app_image_rel_ro_type_entries_);
+    MergeReferences(&bss_type_entry_references_, &writer->bss_type_entry_references_);
+    MergeEntries(bss_type_entries_, &writer->bss_type_entries_);
+    MergeReferences(&bss_public_type_entry_references_,
+                    &writer->bss_public_type_entry_references_);
+    MergeEntries(bss_public_type_entries_, &writer->bss_public_type_entries_);
+    MergeReferences(&bss_package_type_entry_references_,
+                    &writer->bss_package_type_entry_references_);
+    MergeEntries(bss_package_type_entries_, &writer->bss_package_type_entries_);
+    MergeReferences(&bss_string_entry_references_, &writer->bss_string_entry_references_);
+    MergeEntries(bss_string_entries_, &writer->bss_string_entries_);
+    MergeReferences(&bss_method_type_entry_references_,
+                    &writer->bss_method_type_entry_references_);
+    MergeEntries(bss_method_type_entries_, &writer->bss_method_type_entries_);
   }
 
  private:
+  template <typename Map>
+  static void MergeEntries(const Map& src, /*inout*/ Map* dest) {
+    for (const auto& entry : src) {
+      dest->Overwrite(entry.first, /* placeholder */ 0u);
+    }
+  }
+
+  static void MergeReferences(/*inout*/ SafeMap<const DexFile*, BitVector>* src,
+                              /*inout*/ SafeMap<const DexFile*, BitVector>* dest) {
+    for (auto& entry : *src) {
+      auto dest_it = dest->find(entry.first);
+      if (dest_it == dest->end()) {
+        dest->Put(entry.first, std::move(entry.second));
+      } else {
+        dest_it->second.Union(&entry.second);
+      }
+    }
+  }
+
   void AddBssReference(const DexFileReference& ref,
                        size_t number_of_indexes,
                        /*inout*/ SafeMap<const DexFile*, BitVector>* references) {
@@ -813,90 +877,33 @@ class OatWriter::InitBssLayoutMethodVisitor : public DexMethodVisitor {
     }
     refs_it->second.SetBit(ref.index);
   }
-};
-
-class OatWriter::InitOatClassesMethodVisitor : public DexMethodVisitor {
- public:
-  InitOatClassesMethodVisitor(OatWriter* writer, size_t offset)
-      : DexMethodVisitor(writer, offset),
-        compiled_methods_(),
-        compiled_methods_with_code_(0u) {
-    size_t num_classes = 0u;
-    for (const OatDexFile& oat_dex_file : writer_->oat_dex_files_) {
-      num_classes += oat_dex_file.class_offsets_.size();
-    }
-    // If we aren't compiling only reserve headers.
-    writer_->oat_class_headers_.reserve(num_classes);
-    if (writer->MayHaveCompiledMethods()) {
-      writer->oat_classes_.reserve(num_classes);
-    }
-    compiled_methods_.reserve(256u);
-    // If there are any classes, the class offsets allocation aligns the offset.
-    DCHECK(num_classes == 0u || IsAligned<4u>(offset));
-  }
-
-  bool StartClass(const DexFile* dex_file, size_t class_def_index) override {
-    DexMethodVisitor::StartClass(dex_file, class_def_index);
-    compiled_methods_.clear();
-    compiled_methods_with_code_ = 0u;
-    return true;
-  }
-
-  bool VisitMethod([[maybe_unused]] size_t class_def_method_index,
-                   const ClassAccessor::Method& method) override {
-    // Fill in the compiled_methods_ array for methods that have a
-    // CompiledMethod. We track the number of non-null entries in
-    // compiled_methods_with_code_ since we only want to allocate
-    // OatMethodOffsets for the compiled methods.
-    uint32_t method_idx = method.GetIndex();
-    CompiledMethod* compiled_method =
-        writer_->compiler_driver_->GetCompiledMethod(MethodReference(dex_file_, method_idx));
-    compiled_methods_.push_back(compiled_method);
-    if (HasCompiledCode(compiled_method)) {
-      ++compiled_methods_with_code_;
-    }
-    return true;
-  }
 
-  bool EndClass() override {
-    ClassReference class_ref(dex_file_, class_def_index_);
-    ClassStatus status;
-    bool found = writer_->compiler_driver_->GetCompiledClass(class_ref, &status);
-    if (!found) {
-      const VerificationResults* results = writer_->verification_results_;
-      if (results != nullptr && results->IsClassRejected(class_ref)) {
-        // The oat class status is used only for verification of resolved classes,
-        // so use ClassStatus::kErrorResolved whether the class was resolved or unresolved
-        // during compile-time verification.
-        status = ClassStatus::kErrorResolved;
-      } else {
-        status = ClassStatus::kNotReady;
-      }
-    }
-    // We never emit kRetryVerificationAtRuntime, instead we mark the class as
-    // resolved and the class will therefore be re-verified at runtime.
-    if (status == ClassStatus::kRetryVerificationAtRuntime) {
-      status = ClassStatus::kResolved;
-    }
-
-    writer_->oat_class_headers_.emplace_back(offset_,
-                                             compiled_methods_with_code_,
-                                             compiled_methods_.size(),
-                                             status);
-    OatClassHeader& header = writer_->oat_class_headers_.back();
-    offset_ += header.SizeOf();
-    if (writer_->MayHaveCompiledMethods()) {
-      writer_->oat_classes_.emplace_back(compiled_methods_,
-                                         compiled_methods_with_code_,
-                                         header.type_);
-      offset_ += writer_->oat_classes_.back().SizeOf();
-    }
-    return DexMethodVisitor::EndClass();
-  }
+  const OatWriter* const writer_;
+
+  // Per-task copies of the corresponding OatWriter maps, see MergeInto().
+  SafeMap<uint32_t, size_t> boot_image_rel_ro_entries_;
+  SafeMap<const DexFile*, BitVector> bss_method_entry_references_;
+  SafeMap<MethodReference, size_t, MethodReferenceValueComparator> bss_method_entries_;
+  SafeMap<TypeReference, size_t, TypeReferenceValueComparator> app_image_rel_ro_type_entries_;
+  SafeMap<const DexFile*, BitVector> bss_type_entry_references_;
+  SafeMap<TypeReference, size_t, TypeReferenceValueComparator> bss_type_entries_;
+  SafeMap<const DexFile*, BitVector> bss_public_type_entry_references_;
+  SafeMap<TypeReference, size_t, TypeReferenceValueComparator> bss_public_type_entries_;
+  SafeMap<const DexFile*, BitVector> bss_package_type_entry_references_;
+  SafeMap<TypeReference, size_t, TypeReferenceValueComparator> bss_package_type_entries_;
+  SafeMap<const DexFile*, BitVector> bss_string_entry_references_;
+  SafeMap<StringReference, size_t, StringReferenceValueComparator> bss_string_entries_;
+  SafeMap<const DexFile*, BitVector> bss_method_type_entry_references_;
+  SafeMap<ProtoReference, size_t, ProtoReferenceValueComparator> bss_method_type_entries_;
+};
 
- private:
-  dchecked_vector<CompiledMethod*> compiled_methods_;
-  size_t compiled_methods_with_code_;
+// The data collected for each class by the parallel part of the InitOatClasses() pass.
+struct OatWriter::OatClassData {
+  // The CompiledMethod for each method in the class, or null if there is none.
+  dchecked_vector<CompiledMethod*> compiled_methods;
+  // The number of `compiled_methods` with code; only these get OatMethodOffsets.
+  size_t compiled_methods_with_code = 0u;
+  ClassStatus status = ClassStatus::kNotReady;
 };
 
 // CompiledMethod + metadata required to do ordered method layout.
@@ -1114,6 +1121,18 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
       // Since most methods will have the same ordering criteria,
       // we preserve the original insertion order within the same sort order.
       std::stable_sort(ordered_methods_.begin(), ordered_methods_.end());
+      if (kOatWriterCallGraphOatCodeLayout && !kOatWriterForceOatCodeLayout) {
+        auto bin_begin = ordered_methods_.begin();
+        while (bin_begin != ordered_methods_.end()) {
+          auto bin_end = std::find_if(bin_begin,
+                                      ordered_methods_.end(),
+                                      [bin_begin](const OrderedMethodData& method_data) {
+                                        return method_data.hotness_bits != bin_begin->hotness_bits;
+                                      });
+          OrderMethodsByCallGraph(writer_->profile_compilation_info_, bin_begin, bin_end);
+          bin_begin = bin_end;
+        }
+      }
     } else {
       // The profile-less behavior is as if every method had 0 hotness
       // associated with it.
@@ -1127,6 +1146,119 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
   }
 
  private:
+  // Reorder the methods in [begin, end) by their call graph, see OatWriter::OrderByCallGraph().
+  // Direct calls are taken from the method patches of the compiled code, virtual and interface
+  // calls from the inline caches in the profile.
+  static void OrderMethodsByCallGraph(const ProfileCompilationInfo* pci,
+                                      OrderedMethodList::iterator begin,
+                                      OrderedMethodList::iterator end) {
+    const size_t num_methods = std::distance(begin, end);
+    if (num_methods <= 1u) {
+      return;
+    }
+    // Duplicate methods keep their own entries but only the first one gets call edges.
+    std::map<MethodReference, size_t> method_indexes;
+    // Methods by declaring class descriptor, name and signature, to find the targets of the
+    // inline caches.
+    std::map<std::string, size_t> method_indexes_by_name;
+    std::vector<size_t> code_sizes;
+    code_sizes.reserve(num_methods);
+    for (size_t i = 0; i != num_methods; ++i) {
+      const MethodReference& method_ref = begin[i].method_reference;
+      const dex::MethodId& method_id = method_ref.GetMethodId();
+      method_indexes.emplace(method_ref, i);
+      method_indexes_by_name.emplace(
+          GetMethodKey(method_ref.dex_file->GetMethodDeclaringClassDescriptor(method_id),
+                       *method_ref.dex_file,
+                       method_id),
+          i);
+      code_sizes.push_back(begin[i].compiled_method->GetQuickCode().size());
+    }
+    std::vector<CallGraphEdge> calls;
+    for (size_t i = 0; i != num_methods; ++i) {
+      for (const LinkerPatch& patch : begin[i].compiled_method->GetPatches()) {
+        // Direct calls load the callee with a method patch, see `HSharpening`.
+        if (patch.GetType() != LinkerPatch::Type::kCallRelative &&
+            patch.GetType() != LinkerPatch::Type::kMethodRelative &&
+            patch.GetType() != LinkerPatch::Type::kMethodBssEntry) {
+          continue;
+        }
+        auto it = method_indexes.find(patch.TargetMethod());
+        if (it != method_indexes.end()) {
+          calls.push_back({i, it->second, kDirectCallWeight});
+        }
+      }
+      AddProfiledCalls(pci, begin[i], i, method_indexes_by_name, &calls);
+    }
+    if (calls.empty()) {
+      return;
+    }
+
+    std::vector<size_t> order = OrderByCallGraph(ArrayRef<const size_t>(code_sizes),
+                                                 ArrayRef<const CallGraphEdge>(calls),
+                                                 kMaxCallGraphClusterSize);
+    DCHECK_EQ(order.size(), num_methods);
+    OrderedMethodList reordered;
+    reordered.reserve(num_methods);
+    for (size_t index : order) {
+      reordered.push_back(begin[index]);
+    }
+    std::copy(reordered.begin(), reordered.end(), begin);
+  }
+
+  // Key for `method_indexes_by_name` in `OrderMethodsByCallGraph()`.
+  static std::string GetMethodKey(std::string_view class_descriptor,
+                                  const DexFile& dex_file,
+                                  const dex::MethodId& method_id) {
+    std::string key(class_descriptor);
+    key += "->";
+    key += dex_file.GetMethodName(method_id);
+    key += dex_file.GetMethodSignature(method_id).ToString();
+    return key;
+  }
+
+  // Add an edge from the method at index `caller_index` to each receiver type's target
+  // of the virtual and interface calls that have an inline cache in the profile.
+  static void AddProfiledCalls(const ProfileCompilationInfo* pci,
+                               const OrderedMethodData& caller,
+                               size_t caller_index,
+                               const std::map<std::string, size_t>& method_indexes_by_name,
+                               /*inout*/ std::vector<CallGraphEdge>* calls) {
+    if (pci == nullptr || caller.code_item == nullptr) {
+      return;
+    }
+    ProfileCompilationInfo::MethodHotness hotness = pci->GetMethodHotness(caller.method_reference);
+    if (!hotness.IsHot() || hotness.GetInlineCacheMap()->empty()) {
+      return;
+    }
+    const ProfileCompilationInfo::InlineCacheMap& inline_caches = *hotness.GetInlineCacheMap();
+    const DexFile* dex_file = caller.method_reference.dex_file;
+    for (const DexInstructionPcPair& inst : CodeItemInstructionAccessor(*dex_file,
+                                                                        caller.code_item)) {
+      switch (inst->Opcode()) {
+        case Instruction::INVOKE_VIRTUAL:
+        case Instruction::INVOKE_VIRTUAL_RANGE:
+        case Instruction::INVOKE_INTERFACE:
+        case Instruction::INVOKE_INTERFACE_RANGE:
+          break;
+        default:
+          continue;
+      }
+      auto it = inline_caches.find(inst.DexPc());
+      if (it == inline_caches.end() || it->second.is_megamorphic || it->second.is_missing_types) {
+        continue;
+      }
+      const dex::MethodId& method_id = dex_file->GetMethodId(inst->VRegB());
+      for (dex::TypeIndex type_index : it->second.classes) {
+        auto target_it = method_indexes_by_name.find(
+            GetMethodKey(pci->GetTypeDescriptor(dex_file, type_index), *dex_file, method_id));
+        if (target_it != method_indexes_by_name.end()) {
+          calls->push_back({caller_index, target_it->second, kProfiledCallWeight});
+        }
+      }
+    }
+  }
+
   // Cached profile index for the current dex file.
   ProfileCompilationInfo::ProfileIndexType profile_index_;
   const DexFile* profile_index_dex_file_;
@@ -1136,6 +1268,76 @@ class OatWriter::LayoutCodeMethodVisitor final : public OatDexMethodVisitor {
   OrderedMethodList ordered_methods_;
 };
 
+// Pettis-Hansen style clustering of the call graph. Call edges are weighted by the sum of the
+// weights of their call sites and processed from the heaviest one, merging the cluster of the
+// callee after the cluster of the caller as long as the merged cluster does not exceed
+// `max_cluster_size`.
+// Clusters are then emitted in the order of their first method in the input order, so the
+// result depends only on the input and not on the order of `calls`.
+std::vector<size_t> OatWriter::OrderByCallGraph(ArrayRef<const size_t> code_sizes,
+                                                ArrayRef<const CallGraphEdge> calls,
+                                                size_t max_cluster_size) {
+  const size_t num_methods = code_sizes.size();
+  std::map<std::pair<size_t, size_t>, uint32_t> edge_weights;
+  for (const CallGraphEdge& call : calls) {
+    DCHECK_LT(call.caller, num_methods);
+    DCHECK_LT(call.callee, num_methods);
+    if (call.caller != call.callee) {
+      edge_weights[std::make_pair(call.caller, call.callee)] += call.weight;
+    }
+  }
+  struct WeightedEdge {
+    uint32_t weight;
+    size_t caller;
+    size_t callee;
+  };
+  std::vector<WeightedEdge> edges;
+  edges.reserve(edge_weights.size());
+  for (const auto& [key, weight] : edge_weights) {
+    edges.push_back({weight, key.first, key.second});
+  }
+  // Heaviest edges first; `edge_weights` iteration order breaks ties.
+  std::stable_sort(edges.begin(),
+                   edges.end(),
+                   [](const WeightedEdge& lhs, const WeightedEdge& rhs) {
+                     return lhs.weight > rhs.weight;
+                   });
+
+  std::vector<size_t> cluster_of(num_methods);
+  std::vector<std::vector<size_t>> cluster_members(num_methods);
+  std::vector<size_t> cluster_size(num_methods);
+  for (size_t i = 0; i != num_methods; ++i) {
+    cluster_of[i] = i;
+    cluster_members[i].push_back(i);
+    cluster_size[i] = code_sizes[i];
+  }
+  for (const WeightedEdge& edge : edges) {
+    size_t caller_cluster = cluster_of[edge.caller];
+    size_t callee_cluster = cluster_of[edge.callee];
+    if (caller_cluster == callee_cluster ||
+        cluster_size[caller_cluster] + cluster_size[callee_cluster] > max_cluster_size) {
+      continue;
+    }
+    for (size_t member : cluster_members[callee_cluster]) {
+      cluster_of[member] = caller_cluster;
+      cluster_members[caller_cluster].push_back(member);
+    }
+    cluster_members[callee_cluster].clear();
+    cluster_size[caller_cluster] += cluster_size[callee_cluster];
+    cluster_size[callee_cluster] = 0u;
+  }
+
+  std::vector<size_t> order;
+  order.reserve(num_methods);
+  for (size_t i = 0; i != num_methods; ++i) {
+    std::vector<size_t>& members = cluster_members[cluster_of[i]];
+    order.insert(order.end(), members.begin(), members.end());
+    members.clear();  // Emit each cluster once.
+  }
+  DCHECK_EQ(order.size(), num_methods);
+  return order;
+}
+
 // Given a method order, reserve the offsets for each CompiledMethod in the OAT file.
 class OatWriter::LayoutReserveOffsetCodeMethodVisitor : public OrderedMethodVisitor {
  public:
@@ -1929,6 +2131,68 @@ class OatWriter::WriteCodeMethodVisitor : public OrderedMethodVisitor {
   }
 };
 
+size_t OatWriter::GetNumberOfTasks() const {
+  // The calling thread participates in the work.
+  return (thread_pool_ != nullptr) ? thread_pool_->GetThreadCount() + 1u : 1u;
+}
+
+void OatWriter::ForAllClasses(
+    const std::function<void(size_t, size_t, const ClassReference&)>& fn) {
+  std::vector<ClassReference> classes;
+  for (const DexFile* dex_file : *dex_files_) {
+    for (uint32_t i = 0, num_class_defs = dex_file->NumClassDefs(); i != num_class_defs; ++i) {
+      classes.emplace_back(dex_file, i);
+    }
+  }
+  if (thread_pool_ == nullptr) {
+    for (size_t i = 0, size = classes.size(); i != size; ++i) {
+      fn(/*task_index=*/ 0u, i, classes[i]);
+    }
+    return;
+  }
+
+  Thread* self = Thread::Current();
+  std::atomic<size_t> next_index(0u);
+  for (size_t task_index = 0, num_tasks = GetNumberOfTasks(); task_index != num_tasks;
+       ++task_index) {
+    thread_pool_->AddTask(
+        self, new FunctionTask([&classes, &next_index, &fn, task_index](Thread*) {
+          while (true) {
+            size_t i = next_index.fetch_add(1u, std::memory_order_relaxed);
+            if (i >= classes.size()) {
+              break;
+            }
+            fn(task_index, i, classes[i]);
+          }
+        }));
+  }
+  thread_pool_->StartWorkers(self);
+  thread_pool_->Wait(self, /*do_work=*/ true, /*may_hold_locks=*/ false);
+  thread_pool_->StopWorkers(self);
+}
+
+ClassStatus OatWriter::GetOatClassStatus(const ClassReference& class_ref) const {
+  ClassStatus status;
+  bool found = compiler_driver_->GetCompiledClass(class_ref, &status);
+  if (!found) {
+    const VerificationResults* results = verification_results_;
+    if (results != nullptr && results->IsClassRejected(class_ref)) {
+      // The oat class status is used only for verification of resolved classes,
+      // so use ClassStatus::kErrorResolved whether the class was resolved or unresolved
+      // during compile-time verification.
+      status = ClassStatus::kErrorResolved;
+    } else {
+      status = ClassStatus::kNotReady;
+    }
+  }
+  // We never emit kRetryVerificationAtRuntime, instead we mark the class as
+  // resolved and the class will therefore be re-verified at runtime.
+  if (status == ClassStatus::kRetryVerificationAtRuntime) {
+    status = ClassStatus::kResolved;
+  }
+  return status;
+}
+
 // Visit all methods from all classes in all dex files with the specified visitor.
 bool OatWriter::VisitDexMethods(DexMethodVisitor* visitor) {
   for (const DexFile* dex_file : *dex_files_) {
@@ -1985,11 +2249,59 @@ size_t OatWriter::InitClassOffsets(size_t offset) {
 }
 
 size_t OatWriter::InitOatClasses(size_t offset) {
-  // calculate the offsets within OatDexFiles to OatClasses
-  InitOatClassesMethodVisitor visitor(this, offset);
-  bool success = VisitDexMethods(&visitor);
-  CHECK(success);
-  offset = visitor.GetOffset();
+  size_t num_classes = 0u;
+  for (const OatDexFile& oat_dex_file : oat_dex_files_) {
+    num_classes += oat_dex_file.class_offsets_.size();
+  }
+  // If there are any classes, the class offsets allocation aligns the offset.
+  DCHECK(num_classes == 0u || IsAligned<4u>(offset));
+
+  // Look up the compiled methods and the status of each class. This does not depend on
+  // other classes, so it can be done in parallel.
+  std::vector<OatClassData> oat_class_data(num_classes);
+  {
+    TimingLogger::ScopedTiming split("CollectOatClassData", timings_);
+    ForAllClasses([&]([[maybe_unused]] size_t task_index,
+                      size_t class_index,
+                      const ClassReference& class_ref) {
+      DCHECK_LT(class_index, oat_class_data.size());
+      OatClassData& data = oat_class_data[class_index];
+      if (MayHaveCompiledMethods()) {
+        ClassAccessor accessor(*class_ref.dex_file, class_ref.index);
+        data.compiled_methods.reserve(accessor.NumMethods());
+        for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+          CompiledMethod* compiled_method = compiler_driver_->GetCompiledMethod(
+              MethodReference(class_ref.dex_file, method.GetIndex()));
+          data.compiled_methods.push_back(compiled_method);
+          if (HasCompiledCode(compiled_method)) {
+            ++data.compiled_methods_with_code;
+          }
+        }
+      }
+      data.status = GetOatClassStatus(class_ref);
+    });
+  }
+
+  // Calculate the offsets within OatDexFiles to OatClasses in definition order.
+  // If we aren't compiling only reserve headers.
+  oat_class_headers_.reserve(num_classes);
+  if (MayHaveCompiledMethods()) {
+    oat_classes_.reserve(num_classes);
+  }
+  for (const OatClassData& data : oat_class_data) {
+    oat_class_headers_.emplace_back(offset,
+                                    data.compiled_methods_with_code,
+                                    data.compiled_methods.size(),
+                                    data.status);
+    OatClassHeader& header = oat_class_headers_.back();
+    offset += header.SizeOf();
+    if (MayHaveCompiledMethods()) {
+      oat_classes_.emplace_back(data.compiled_methods,
+                                data.compiled_methods_with_code,
+                                header.type_);
+      offset += oat_classes_.back().SizeOf();
+    }
+  }
 
   // Update oat_dex_files_.
   auto oat_class_it = oat_class_headers_.begin();
@@ -2350,6 +2662,33 @@ size_t OatWriter::InitOatCodeDexFiles(size_t offset) {
         new OrderedMethodList(
             layout_reserve_code_visitor.ReleaseOrderedMethods()));
 
+    if (VLOG_IS_ON(compiler)) {
+      // Report how many direct calls within this oat file stay on the caller's page.
+      std::set<MethodReference> oat_methods;
+      for (const OrderedMethodData& ordered_method : *ordered_methods_) {
+        oat_methods.insert(ordered_method.method_reference);
+      }
+      size_t num_calls = 0u;
+      size_t num_same_page_calls = 0u;
+      for (const OrderedMethodData& ordered_method : *ordered_methods_) {
+        uint32_t method_offset = relative_patcher_->GetOffset(ordered_method.method_reference);
+        for (const LinkerPatch& patch : ordered_method.compiled_method->GetPatches()) {
+          if (patch.GetType() != LinkerPatch::Type::kCallRelative ||
+              oat_methods.find(patch.TargetMethod()) == oat_methods.end()) {
+            continue;
+          }
+          uint32_t call_offset = method_offset + patch.LiteralOffset();
+          uint32_t target_offset = relative_patcher_->GetOffset(patch.TargetMethod());
+          ++num_calls;
+          if (call_offset / kMinPageSize == target_offset / kMinPageSize) {
+            ++num_same_page_calls;
+          }
+        }
+      }
+      VLOG(compiler) << "Direct calls within the caller's " << kMinPageSize << "B page: "
+                     << num_same_page_calls << "/" << num_calls;
+    }
+
     if (kOatWriterDebugOatCodeLayout) {
       LOG(INFO) << "IniatOatCodeDexFiles: method order: ";
       for (const OrderedMethodData& ordered_method : *ordered_methods_) {
@@ -2404,10 +2743,24 @@ size_t OatWriter::InitDataImgRelRoLayout(size_t offset) {
 }
 
 void OatWriter::InitBssLayout(InstructionSet instruction_set) {
-  {
-    InitBssLayoutMethodVisitor visitor(this);
-    bool success = VisitDexMethods(&visitor);
-    DCHECK(success);
+  if (MayHaveCompiledMethods()) {
+    std::vector<BssReferenceCollector> collectors;
+    collectors.reserve(GetNumberOfTasks());
+    for (size_t i = 0, num_tasks = GetNumberOfTasks(); i != num_tasks; ++i) {
+      collectors.emplace_back(this);
+    }
+    ForAllClasses([&](size_t task_index,
+                      [[maybe_unused]] size_t class_index,
+                      const ClassReference& class_ref) {
+      DCHECK_LT(task_index, collectors.size());
+      ClassAccessor accessor(*class_ref.dex_file, class_ref.index);
+      for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+        collectors[task_index].VisitMethod(class_ref.dex_file, method);
+      }
+    });
+    for (BssReferenceCollector& collector : collectors) {
+      collector.MergeInto(this);
+    }
   }
 
   DCHECK_EQ(bss_size_, 0u);
@@ -2533,6 +2886,7 @@ bool OatWriter::WriteRodata(OutputStream* out) {
 }
 
 void OatWriter::WriteVerifierDeps(verifier::VerifierDeps* verifier_deps,
+                                  TimingLogger* timings,
                                   /*out*/std::vector<uint8_t>* buffer) {
   if (verifier_deps == nullptr) {
     // Nothing to write. Record the offset, but no need
@@ -2541,7 +2895,7 @@ void OatWriter::WriteVerifierDeps(verifier::VerifierDeps* verifier_deps,
     return;
   }
 
-  TimingLogger::ScopedTiming split("VDEX verifier deps", timings_);
+  TimingLogger::ScopedTiming split("VDEX verifier deps", timings);
 
   DCHECK(buffer->empty());
   verifier_deps->Encode(*dex_files_, buffer);
@@ -3694,8 +4048,9 @@ bool OatWriter::WriteDexLayoutSections(OutputStream* oat_rodata,
   return true;
 }
 
-void OatWriter::WriteTypeLookupTables(/*out*/std::vector<uint8_t>* buffer) {
-  TimingLogger::ScopedTiming split("WriteTypeLookupTables", timings_);
+void OatWriter::WriteTypeLookupTables(TimingLogger* timings,
+                                      /*out*/std::vector<uint8_t>* buffer) {
+  TimingLogger::ScopedTiming split("WriteTypeLookupTables", timings);
   size_t type_lookup_table_size = 0u;
   for (const DexFile* dex_file : *dex_files_) {
     type_lookup_table_size +=
@@ -3738,12 +4093,17 @@ void OatWriter::WriteTypeLookupTables(/*out*/std::vector<uint8_t>* buffer) {
   }
 }
 
-bool OatWriter::FinishVdexFile(File* vdex_file, verifier::VerifierDeps* verifier_deps) {
+bool OatWriter::FinishVdexFile(File* vdex_file,
+                               verifier::VerifierDeps* verifier_deps,
+                               TimingLogger* timings) {
+  if (timings == nullptr) {
+    timings = timings_;
+  }
   size_t old_vdex_size = vdex_size_;
   std::vector<uint8_t> buffer;
   buffer.reserve(64 * KB);
-  WriteVerifierDeps(verifier_deps, &buffer);
-  WriteTypeLookupTables(&buffer);
+  WriteVerifierDeps(verifier_deps, timings, &buffer);
+  WriteTypeLookupTables(timings, &buffer);
   DCHECK_EQ(vdex_size_, old_vdex_size + buffer.size());
 
   // Resize the vdex file.
@@ -3841,7 +4201,7 @@ bool OatWriter::FinishVdexFile(File* vdex_file, verifier::VerifierDeps* verifier
   // All the contents (except the header) of the vdex file has been emitted in memory. Flush it
   // to disk.
   {
-    TimingLogger::ScopedTiming split("VDEX flush contents", timings_);
+    TimingLogger::ScopedTiming split("VDEX flush contents", timings);
     // Sync the data to the disk while the header is invalid. We do not want to end up with
     // a valid header and invalid data if the process is suddenly killed.
     if (extract_dex_files_into_vdex_) {
@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 #include <cstddef>
+#include <functional>
 #include <list>
 #include <memory>
 #include <vector>
@@ -29,6 +30,7 @@
 #include "base/mem_map.h"
 #include "base/safe_map.h"
 #include "debug/debug_info.h"
+#include "dex/class_reference.h"
 #include "dex/compact_dex_level.h"
 #include "dex/method_reference.h"
 #include "dex/string_reference.h"
@@ -47,6 +49,7 @@ class DexContainer;
 class OatHeader;
 class OutputStream;
 class ProfileCompilationInfo;
+class ThreadPool;
 class TimingLogger;
 class TypeLookupTable;
 class VdexFile;
@@ -176,10 +179,18 @@ class OatWriter {
   void Initialize(const CompilerDriver* compiler_driver,
                   ImageWriter* image_writer,
                   const std::vector<const DexFile*>& dex_files);
-  bool FinishVdexFile(File* vdex_file, verifier::VerifierDeps* verifier_deps);
-
-  // Prepare layout of remaining data.
-  void PrepareLayout(MultiOatRelativePatcher* relative_patcher);
+  // Write the verifier deps and type lookup tables and finalize the vdex file. This only
+  // depends on the dex files and the verifier deps, so the caller may run it on another
+  // thread while the methods are compiled, passing a separate `timings` logger as
+  // TimingLogger is not thread-safe. By default, the writer's logger is used.
+  bool FinishVdexFile(File* vdex_file,
+                      verifier::VerifierDeps* verifier_deps,
+                      TimingLogger* timings = nullptr);
+
+  // Prepare layout of remaining data. If a `thread_pool` is provided, the per-class passes
+  // that do not depend on the layout of other classes are distributed over its workers.
+  void PrepareLayout(MultiOatRelativePatcher* relative_patcher,
+                     ThreadPool* thread_pool = nullptr);
   // Write the rest of .rodata section (ClassOffsets[], OatClass[], maps).
   bool WriteRodata(OutputStream* out);
   // Write the code to the .text section.
@@ -250,6 +261,20 @@ class OatWriter {
     return compiler_options_;
   }
 
+  // A call from the method at index `caller` to the method at index `callee`.
+  struct CallGraphEdge {
+    size_t caller;
+    size_t callee;
+    uint32_t weight = 1u;
+  };
+
+  // Order methods so that callers and their callees are adjacent, see
+  // OrderMethodsByCallGraph(). `code_sizes` holds the code size of each method and `calls`
+  // holds one entry per call site. Returns the new order as indexes of the input methods.
+  static std::vector<size_t> OrderByCallGraph(ArrayRef<const size_t> code_sizes,
+                                              ArrayRef<const CallGraphEdge> calls,
+                                              size_t max_cluster_size);
+
  private:
   struct BssMappingInfo;
   class ChecksumUpdatingOutputStream;
@@ -264,8 +289,6 @@ class OatWriter {
   // to actually write it.
   class DexMethodVisitor;
   class OatDexMethodVisitor;
-  class InitBssLayoutMethodVisitor;
-  class InitOatClassesMethodVisitor;
   class LayoutCodeMethodVisitor;
   class LayoutReserveOffsetCodeMethodVisitor;
   struct OrderedMethodData;
@@ -280,6 +303,20 @@ class OatWriter {
   // with a given DexMethodVisitor.
   bool VisitDexMethods(DexMethodVisitor* visitor);
 
+  // The InitBssLayout() and InitOatClasses() passes look at each class independently,
+  // so they collect the per-class data in parallel and merge it in definition order.
+  class BssReferenceCollector;
+  struct OatClassData;
+
+  // Call `fn(task_index, class_index, class_ref)` for all classes in all the compiled dex
+  // files, where `class_index` is the index of the class in definition order. The classes
+  // are distributed over the tasks of the `thread_pool_`, if any; a task runs on a single
+  // thread, so `fn` can keep per-task state indexed by `task_index` without locking.
+  void ForAllClasses(
+      const std::function<void(size_t, size_t, const ClassReference&)>& fn);
+  size_t GetNumberOfTasks() const;
+  ClassStatus GetOatClassStatus(const ClassReference& class_ref) const;
+
   // If `update_input_vdex` is true, then this method won't actually write the dex files,
   // and the compiler will just re-use the existing vdex file.
   bool WriteDexFiles(File* file,
@@ -291,8 +328,9 @@ class OatWriter {
   bool OpenDexFiles(File* file,
                     /*inout*/ std::vector<MemMap>* opened_dex_files_map,
                     /*out*/ std::vector<std::unique_ptr<const DexFile>>* opened_dex_files);
-  void WriteTypeLookupTables(/*out*/std::vector<uint8_t>* buffer);
+  void WriteTypeLookupTables(TimingLogger* timings, /*out*/std::vector<uint8_t>* buffer);
   void WriteVerifierDeps(verifier::VerifierDeps* verifier_deps,
+                         TimingLogger* timings,
                          /*out*/std::vector<uint8_t>* buffer);
 
   size_t InitOatHeader(uint32_t num_dex_files, SafeMap<std::string, std::string>* key_value_store);
@@ -589,6 +627,9 @@ class OatWriter {
   // The helper for processing relative patches is external so that we can patch across oat files.
   MultiOatRelativePatcher* relative_patcher_;
 
+  // The thread pool for the parallel layout passes, only set during PrepareLayout().
+  ThreadPool* thread_pool_;
+
   // Profile info used to generate new layout of files.
   ProfileCompilationInfo* profile_compilation_info_;
 
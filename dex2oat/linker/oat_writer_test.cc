@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+
 #include "android-base/stringprintf.h"
 
 #include "arch/instruction_set_features.h"
@@ -888,5 +890,69 @@ TEST_F(OatTest, ZipFileInputWithEmptyDex) {
   TestZipFileInputWithEmptyDex();
 }
 
+TEST_F(OatTest, CallGraphLayoutPlacesCalleesAfterCallers) {
+  // Method 4 calls method 2 twice, so that edge is merged first. Method 3 makes no calls.
+  const std::vector<size_t> code_sizes = { 16u, 16u, 16u, 16u, 16u, 16u };
+  const std::vector<OatWriter::CallGraphEdge> calls = {
+      { 0u, 4u }, { 4u, 2u }, { 1u, 5u }, { 4u, 2u }, { 3u, 3u }
+  };
+  std::vector<size_t> order = OatWriter::OrderByCallGraph(
+      ArrayRef<const size_t>(code_sizes),
+      ArrayRef<const OatWriter::CallGraphEdge>(calls),
+      /*max_cluster_size=*/ 4096u);
+  // Each callee directly follows its caller. Clusters keep the order of their first method.
+  EXPECT_EQ((std::vector<size_t>{ 0u, 4u, 2u, 1u, 5u, 3u }), order);
+}
+
+TEST_F(OatTest, CallGraphLayoutLimitsClusterSize) {
+  const std::vector<size_t> code_sizes = { 16u, 16u, 16u, 16u };
+  const std::vector<OatWriter::CallGraphEdge> calls = { { 0u, 3u }, { 0u, 3u }, { 0u, 2u } };
+  // Only the heaviest edge fits in a cluster of two methods.
+  EXPECT_EQ((std::vector<size_t>{ 0u, 3u, 1u, 2u }),
+            OatWriter::OrderByCallGraph(ArrayRef<const size_t>(code_sizes),
+                                        ArrayRef<const OatWriter::CallGraphEdge>(calls),
+                                        /*max_cluster_size=*/ 32u));
+  EXPECT_EQ((std::vector<size_t>{ 0u, 3u, 2u, 1u }),
+            OatWriter::OrderByCallGraph(ArrayRef<const size_t>(code_sizes),
+                                        ArrayRef<const OatWriter::CallGraphEdge>(calls),
+                                        /*max_cluster_size=*/ 48u));
+}
+
+TEST_F(OatTest, CallGraphLayoutUsesEdgeWeights) {
+  const std::vector<size_t> code_sizes = { 16u, 16u, 16u, 16u };
+  // A profiled call outweighs two direct call sites.
+  const std::vector<OatWriter::CallGraphEdge> calls = { { 0u, 2u }, { 0u, 2u }, { 0u, 3u, 3u } };
+  EXPECT_EQ((std::vector<size_t>{ 0u, 3u, 1u, 2u }),
+            OatWriter::OrderByCallGraph(ArrayRef<const size_t>(code_sizes),
+                                        ArrayRef<const OatWriter::CallGraphEdge>(calls),
+                                        /*max_cluster_size=*/ 32u));
+}
+
+TEST_F(OatTest, CallGraphLayoutIsDeterministic) {
+  // Several edges with the same weight, so that ties must be broken deterministically.
+  const std::vector<size_t> code_sizes = { 8u, 24u, 16u, 32u, 8u, 40u, 16u, 8u };
+  std::vector<OatWriter::CallGraphEdge> calls = {
+      { 7u, 1u }, { 2u, 6u }, { 0u, 5u }, { 5u, 3u }, { 6u, 4u }, { 1u, 0u }, { 3u, 2u }
+  };
+  const std::vector<size_t> expected = OatWriter::OrderByCallGraph(
+      ArrayRef<const size_t>(code_sizes),
+      ArrayRef<const OatWriter::CallGraphEdge>(calls),
+      /*max_cluster_size=*/ 64u);
+  ASSERT_EQ(code_sizes.size(), expected.size());
+  // The order of the call sites, as found in the patches, does not change the layout.
+  for (size_t i = 0; i != calls.size(); ++i) {
+    std::rotate(calls.begin(), calls.begin() + 1, calls.end());
+    EXPECT_EQ(expected,
+              OatWriter::OrderByCallGraph(ArrayRef<const size_t>(code_sizes),
+                                          ArrayRef<const OatWriter::CallGraphEdge>(calls),
+                                          /*max_cluster_size=*/ 64u));
+  }
+  std::reverse(calls.begin(), calls.end());
+  EXPECT_EQ(expected,
+            OatWriter::OrderByCallGraph(ArrayRef<const size_t>(code_sizes),
+                                        ArrayRef<const OatWriter::CallGraphEdge>(calls),
+                                        /*max_cluster_size=*/ 64u));
+}
+
 }  // namespace linker
 }  // namespace art
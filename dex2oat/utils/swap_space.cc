@@ -18,13 +18,17 @@
 
 #include <sys/mman.h>
 
+#include <unistd.h>
+
 #include <algorithm>
 #include <numeric>
+#include <ostream>
 
 #include "base/bit_utils.h"
 #include "base/mem_map.h"
 #include "base/macros.h"
 #include "base/mutex.h"
+#include "base/utils.h"
 #include "thread-current-inl.h"
 
 namespace art {
@@ -63,6 +67,11 @@ inline void SwapSpace::InsertChunk(const SpaceChunk& chunk) {
 SwapSpace::SwapSpace(int fd, size_t initial_size)
     : fd_(fd),
       size_(0),
+      resident_limit_(0u),
+      allocated_since_trim_(0u),
+      peak_allocated_since_trim_(0u),
+      trim_count_(0u),
+      trim_in_progress_(false),
       lock_("SwapSpace lock", static_cast<LockLevel>(LockLevel::kDefaultMutexLevel - 1)) {
   // Assume that the file is unlinked.
 
@@ -106,10 +115,68 @@ static size_t CollectFree(const FreeByStartSet& free_by_start, const FreeBySizeS
   return sum1;
 }
 
-void* SwapSpace::Alloc(size_t size) {
+void SwapSpace::SetResidentLimit(size_t limit) {
+  MutexLock lock(Thread::Current(), lock_);
+  resident_limit_ = limit;
+}
+
+void SwapSpace::DumpStats(std::ostream& os) const {
+  MutexLock lock(Thread::Current(), lock_);
+  os << "swap=" << PrettySize(size_)
+     << " peak-unflushed=" << PrettySize(peak_allocated_since_trim_)
+     << " trims=" << trim_count_;
+}
+
+void SwapSpace::Trim(const std::vector<SpaceChunk>& maps) {
+  // Write the dirty pages back so that dropping them from the mappings below leaves only clean,
+  // reclaimable page cache. Dropping dirty pages of a shared mapping would not lose data either,
+  // but the kernel could not reclaim them before writeback. Data written concurrently by other
+  // threads is kept in the page cache, so this is safe without the lock. The maps are only
+  // unmapped when the swap space is destroyed.
+  if (fdatasync(fd_) != 0) {
+    PLOG(WARNING) << "Failed to sync swap file";
+  } else {
+    for (const SpaceChunk& map : maps) {
+      if (madvise(map.ptr, map.size, MADV_DONTNEED) != 0) {
+        PLOG(WARNING) << "Failed to trim swap space chunk at " << static_cast<const void*>(map.ptr)
+                      << " size=" << map.size;
+      }
+    }
+  }
   MutexLock lock(Thread::Current(), lock_);
+  DCHECK(trim_in_progress_);
+  trim_in_progress_ = false;
+}
+
+void* SwapSpace::Alloc(size_t size) {
+  std::vector<SpaceChunk> maps_to_trim;
+  void* ptr;
+  {
+    MutexLock lock(Thread::Current(), lock_);
+    ptr = AllocLocked(size, &maps_to_trim);
+  }
+  if (!maps_to_trim.empty()) {
+    Trim(maps_to_trim);
+  }
+  return ptr;
+}
+
+void* SwapSpace::AllocLocked(size_t size, /*out*/ std::vector<SpaceChunk>* maps_to_trim) {
   size = RoundUp(size, 8U);
 
+  if (resident_limit_ != 0u &&
+      allocated_since_trim_ + size > resident_limit_ &&
+      !trim_in_progress_ &&
+      !maps_.empty()) {
+    // Trim after releasing the lock, see `Alloc()`.
+    *maps_to_trim = maps_;
+    trim_in_progress_ = true;
+    allocated_since_trim_ = 0u;
+    ++trim_count_;
+  }
+  allocated_since_trim_ += size;
+  peak_allocated_since_trim_ = std::max(peak_allocated_since_trim_, allocated_since_trim_);
+
   // Check the free list for something that fits.
   // TODO: Smarter implementation. Global biggest chunk, ...
   auto it = free_by_start_.empty()
@@ -165,6 +232,7 @@ SwapSpace::SpaceChunk SwapSpace::NewFileChunk(size_t min_size) {
   }
   size_ += next_part;
   SpaceChunk new_chunk = {ptr, next_part};
+  maps_.push_back(new_chunk);
   return new_chunk;
 #else
   UNUSED(min_size, kMinimumMapSize);
@@ -20,6 +20,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <cstdlib>
+#include <iosfwd>
 #include <list>
 #include <set>
 #include <vector>
@@ -44,6 +45,16 @@ class SwapSpace {
     return size_;
   }
 
+  // Bound the memory held for the swap file. Once `limit` bytes have been allocated since the
+  // last trim, the dirty pages are written back to the file and dropped from the mappings, so
+  // that the kernel can reclaim them. A `limit` of 0 disables trimming. This only limits the
+  // pages kept resident by allocations: reading data back faults its pages in again, and
+  // they stay resident until the next trim. The trim runs without `lock_`, on the allocating
+  // thread, so that other threads can keep allocating during the I/O.
+  void SetResidentLimit(size_t limit) REQUIRES(!lock_);
+
+  void DumpStats(std::ostream& os) const REQUIRES(!lock_);
+
  private:
   // Chunk of space.
   struct SpaceChunk {
@@ -95,9 +106,24 @@ class SwapSpace {
   void RemoveChunk(FreeBySizeSet::const_iterator free_by_size_pos) REQUIRES(lock_);
   void InsertChunk(const SpaceChunk& chunk) REQUIRES(lock_);
 
+  void* AllocLocked(size_t size, /*out*/ std::vector<SpaceChunk>* maps_to_trim) REQUIRES(lock_);
+
+  // Write back and drop the pages of `maps`, a copy of `maps_` taken under `lock_`.
+  void Trim(const std::vector<SpaceChunk>& maps) REQUIRES(!lock_);
+
   int fd_;
   size_t size_;
 
+  // All mapped chunks of the file, used for trimming.
+  std::vector<SpaceChunk> maps_ GUARDED_BY(lock_);
+  size_t resident_limit_ GUARDED_BY(lock_);
+  // Bytes allocated since the last trim, an upper bound of the dirty data in the mappings.
+  size_t allocated_since_trim_ GUARDED_BY(lock_);
+  size_t peak_allocated_since_trim_ GUARDED_BY(lock_);
+  size_t trim_count_ GUARDED_BY(lock_);
+  // Whether a thread is trimming, so that others do not start another trim meanwhile.
+  bool trim_in_progress_ GUARDED_BY(lock_);
+
   // NOTE: Boost.Bimap would be useful for the two following members.
 
   // Map start of a free chunk to its size.
@@ -32,12 +32,13 @@ namespace art {
 
 class SwapSpaceTest : public CommonArtTest {};
 
-static void SwapTest(bool use_file) {
+static void SwapTest(bool use_file, size_t resident_limit = 0u) {
   ScratchFile scratch;
   int fd = scratch.GetFd();
   unlink(scratch.GetFilename().c_str());
 
   SwapSpace pool(fd, 1 * MB);
+  pool.SetResidentLimit(resident_limit);
   SwapAllocator<void> alloc(use_file ? &pool : nullptr);
 
   SwapVector<int32_t> v(alloc);
@@ -79,4 +80,9 @@ TEST_F(SwapSpaceTest, Swap) {
   SwapTest(true);
 }
 
+TEST_F(SwapSpaceTest, SwapWithResidentLimit) {
+  // The vectors are larger than the limit, so their data must survive trimming.
+  SwapTest(true, /*resident_limit=*/ 1 * MB);
+}
+
 }  // namespace art
@@ -1387,6 +1387,16 @@ DISASSEMBLER_ENTRY(cmp,
     byte_operand = (*instr == 0xC0);
     break;
   case 0xC3: opcode1 = "ret"; break;
+  case TWO_BYTE_VEX:
+    // Of the VEX-encoded instructions, only `vzeroupper` is decoded.
+    if (supports_rex_ && instr[1] == 0xF8 && instr[2] == 0x77) {
+      opcode1 = "vzeroupper";
+      instr += 2;
+    } else {
+      opcode_tmp = StringPrintf("unknown opcode '%02X'", *instr);
+      opcode1 = opcode_tmp.c_str();
+    }
+    break;
 
   case 0xC6:
     static const char* c6_opcodes[] = {"mov",        "unknown-c6", "unknown-c6",
@@ -67,7 +67,15 @@
   METRIC(YoungGcDuration, MetricsCounter)                           \
   METRIC(FullGcScannedBytes, MetricsCounter)                        \
   METRIC(FullGcFreedBytes, MetricsCounter)                          \
-  METRIC(FullGcDuration, MetricsCounter)
+  METRIC(FullGcDuration, MetricsCounter)                            \
+  METRIC(LazyImageDecompressionBlockCount, MetricsCounter)          \
+  METRIC(LazyImageDecompressionFaultedBlockCount, MetricsCounter)   \
+  METRIC(MutexContentionCount, MetricsCounter)                      \
+  METRIC(MutexContentionWaitTime, MetricsHistogram, 15, 0, 100'000) \
+  METRIC(TimeToSafepoint, MetricsHistogram, 15, 0, 100'000)         \
+  METRIC(TimeToCheckpoint, MetricsHistogram, 15, 0, 100'000)        \
+  METRIC(BackgroundClassVerificationTotalTime, MetricsCounter)      \
+  METRIC(BackgroundClassVerificationCount, MetricsCounter)
 
 // Increasing counter metrics, reported as Value Metrics in delta increments.
 #define ART_VALUE_METRICS(METRIC)                              \
@@ -44,6 +44,7 @@
 #include "base/bit_utils_iterator.h"
 #include "base/file_utils.h"
 #include "base/indenter.h"
+#include "base/mem_map.h"
 #include "base/os.h"
 #include "base/safe_map.h"
 #include "base/stats-inl.h"
@@ -87,6 +88,7 @@
 #include "oat/oat_file_assistant_context.h"
 #include "oat/oat_file_manager.h"
 #include "oat/stack_map.h"
+#include "profile/profile_compilation_info.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack.h"
 #include "stream/buffered_output_stream.h"
@@ -351,6 +353,7 @@ class OatDumperOptions {
                    bool list_methods,
                    bool dump_header_only,
                    bool dump_method_and_offset_as_json,
+                   const char* code_locality_profile,
                    const char* export_dex_location,
                    const char* app_image,
                    const char* oat_filename,
@@ -366,6 +369,7 @@ class OatDumperOptions {
         list_methods_(list_methods),
         dump_header_only_(dump_header_only),
         dump_method_and_offset_as_json(dump_method_and_offset_as_json),
+        code_locality_profile_(code_locality_profile),
         export_dex_location_(export_dex_location),
         app_image_(app_image),
         oat_filename_(oat_filename != nullptr ? std::make_optional(oat_filename) : std::nullopt),
@@ -383,6 +387,7 @@ class OatDumperOptions {
   const bool list_methods_;
   const bool dump_header_only_;
   const bool dump_method_and_offset_as_json;
+  const char* const code_locality_profile_;
   const char* const export_dex_location_;
   const char* const app_image_;
   const std::optional<std::string> oat_filename_;
@@ -428,6 +433,9 @@ class OatDumper {
     if (options_.dump_method_and_offset_as_json) {
       return DumpMethodAndOffsetAsJson(os);
     }
+    if (options_.code_locality_profile_ != nullptr) {
+      return DumpCodeLocality(os);
+    }
 
     bool success = true;
     const OatHeader& oat_header = oat_file_.GetOatHeader();
@@ -771,6 +779,74 @@ class OatDumper {
     return true;
   }
 
+  // For each profile hotness bin, report how many pages the compiled code of its methods
+  // touches compared to the minimum number of pages that code would need.
+  bool DumpCodeLocality(std::ostream& os) {
+    ProfileCompilationInfo profile;
+    if (!profile.Load(options_.code_locality_profile_, /*clear_if_invalid=*/ false)) {
+      os << "Failed to load profile " << options_.code_locality_profile_ << "\n";
+      return false;
+    }
+    struct BinStats {
+      size_t num_methods = 0u;
+      size_t code_size = 0u;
+      std::set<uint32_t> pages;
+    };
+    std::map<uint32_t, BinStats> bins;
+    for (const OatDexFile* oat_dex_file : oat_dex_files_) {
+      CHECK(oat_dex_file != nullptr);
+      std::string error_msg;
+      const DexFile* const dex_file = art::OpenDexFile(oat_dex_file, &error_msg);
+      if (dex_file == nullptr) {
+        LOG(WARNING) << "Failed to open dex file '" << oat_dex_file->GetDexFileLocation()
+                     << "': " << error_msg;
+        return false;
+      }
+      ProfileCompilationInfo::ProfileIndexType profile_index = profile.FindDexFile(*dex_file);
+      for (ClassAccessor accessor : dex_file->GetClasses()) {
+        const OatFile::OatClass oat_class = oat_dex_file->GetOatClass(accessor.GetClassDefIndex());
+        uint32_t class_method_index = 0;
+        for (const ClassAccessor::Method& method : accessor.GetMethods()) {
+          const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_method_index);
+          class_method_index++;
+          uint32_t code_size = oat_method.GetQuickCodeSize();
+          if (code_size == 0u) {
+            continue;
+          }
+          uint32_t hotness_bits = 0u;
+          if (profile_index != ProfileCompilationInfo::MaxProfileIndex()) {
+            // Same binning as the OatWriter code layout.
+            uint32_t method_index = method.GetIndex();
+            hotness_bits = (profile.IsHotMethod(profile_index, method_index) ? 1u : 0u) |
+                (profile.IsStartupMethod(profile_index, method_index) ? 2u : 0u) |
+                (profile.IsPostStartupMethod(profile_index, method_index) ? 4u : 0u);
+          }
+          BinStats& bin = bins[hotness_bits];
+          uint32_t code_offset = oat_method.GetCodeOffset() & ~1u;  // Clear the Thumb2 bit.
+          bin.num_methods++;
+          bin.code_size += code_size;
+          for (uint32_t page = code_offset / kMinPageSize;
+               page <= (code_offset + code_size - 1u) / kMinPageSize;
+               ++page) {
+            bin.pages.insert(page);
+          }
+        }
+      }
+    }
+    os << "CODE LOCALITY (" << kMinPageSize << "B pages):\n";
+    for (const auto& [hotness_bits, bin] : bins) {
+      os << StringPrintf("%s%s%s: %zu methods, %zu bytes, %zu pages (minimum %zu)\n",
+                         (hotness_bits & 1u) != 0u ? "H" : "-",
+                         (hotness_bits & 2u) != 0u ? "S" : "-",
+                         (hotness_bits & 4u) != 0u ? "P" : "-",
+                         bin.num_methods,
+                         bin.code_size,
+                         bin.pages.size(),
+                         RoundUp(bin.code_size, kMinPageSize) / kMinPageSize);
+    }
+    return true;
+  }
+
   size_t ComputeSize(const void* oat_data) {
     if (reinterpret_cast<const uint8_t*>(oat_data) < oat_file_.Begin() ||
         reinterpret_cast<const uint8_t*>(oat_data) > oat_file_.End()) {
@@ -2006,6 +2082,9 @@ class ImageDumper {
       file_bytes += uncompressed_size - data_size;
       stats_.art_file_stats.AddBytes(file_bytes);
       stats_.art_file_stats["Header"].AddBytes(sizeof(ImageHeader));
+      if (image_header_.HasCompressedBlock()) {
+        DumpImageBlocks(os, file.get(), image_filename);
+      }
     }
 
     size_t pointer_size = static_cast<size_t>(image_header_.GetPointerSize());
@@ -2030,6 +2109,36 @@ class ImageDumper {
   }
 
  private:
+  // Dump the storage mode and compression ratio of each image block.
+  void DumpImageBlocks(std::ostream& os, File* file, const std::string& image_filename) {
+    std::string error_msg;
+    MemMap map = MemMap::MapFile(sizeof(ImageHeader) + image_header_.GetDataSize(),
+                                 PROT_READ,
+                                 MAP_PRIVATE,
+                                 file->Fd(),
+                                 /*start=*/ 0,
+                                 /*low_4gb=*/ false,
+                                 image_filename.c_str(),
+                                 &error_msg);
+    if (!map.IsValid()) {
+      LOG(WARNING) << "Failed to map image blocks of " << image_filename << ": " << error_msg;
+      return;
+    }
+    os << "IMAGE BLOCKS: " << image_header_.GetBlockCount() << "\n";
+    os << "ZSTD DICTIONARY SIZE: " << image_header_.GetZstdDictionary(map.Begin()).size() << "\n";
+    size_t index = 0u;
+    for (const ImageHeader::Block& block : image_header_.GetBlocks(map.Begin())) {
+      os << StringPrintf("  %zu: ", index++) << block.GetStorageMode()
+         << StringPrintf(" image=0x%08x-0x%08x stored=%u ratio=%.2f\n",
+                         block.GetImageOffset(),
+                         block.GetImageOffset() + block.GetImageSize(),
+                         block.GetDataSize(),
+                         static_cast<double>(block.GetImageSize()) /
+                             std::max(block.GetDataSize(), 1u));
+    }
+    os << "\n";
+  }
+
   static void PrettyObjectValue(std::ostream& os,
                                 ObjPtr<mirror::Class> type,
                                 ObjPtr<mirror::Object> value)
@@ -3252,6 +3361,8 @@ struct OatdumpArgs : public CmdlineArgs {
       imt_stat_dump_ = true;
     } else if (option == "--dump-method-and-offset-as-json") {
       dump_method_and_offset_as_json = true;
+    } else if (StartsWith(option, "--dump-code-locality=")) {
+      code_locality_profile_ = raw_option + strlen("--dump-code-locality=");
     } else {
       return kParseUnknownArgument;
     }
@@ -3400,6 +3511,10 @@ Options:
         "                                    signatures ONLY, in a standard json format.\n"
         "      Example: --dump-method-and-offset-as-json\n"
         "\n"
+        "  --dump-code-locality=<file.prof>: dumps, for each hotness bin of the profile,\n"
+        "      the number of pages touched by the compiled code of its methods.\n"
+        "      Example: --dump-code-locality=/data/misc/profiles/ref/app/primary.prof\n"
+        "\n"
         "  --export-dex-to=<directory>: may be used to export oat embedded dex files.\n"
         "      Example: --export-dex-to=/data/local/tmp\n"
         "\n"
@@ -3455,6 +3570,7 @@ Options:
   bool dump_header_only_ = false;
   bool imt_stat_dump_ = false;
   bool dump_method_and_offset_as_json = false;
+  const char* code_locality_profile_ = nullptr;
   uint32_t addr2instr_ = 0;
   const char* export_dex_location_ = nullptr;
   const char* app_image_ = nullptr;
@@ -3480,6 +3596,7 @@ struct OatdumpMain : public CmdlineMain<OatdumpArgs> {
                                                    args_->list_methods_,
                                                    args_->dump_header_only_,
                                                    args_->dump_method_and_offset_as_json,
+                                                   args_->code_locality_profile_,
                                                    args_->export_dex_location_,
                                                    args_->app_image_,
                                                    args_->oat_filename_,
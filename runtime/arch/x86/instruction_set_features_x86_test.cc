@@ -30,7 +30,7 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromDefaultVariant) {
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
   EXPECT_EQ(x86_features->GetFeatureString(),
             is_runtime_isa ? X86InstructionSetFeatures::FromCppDefines()->GetFeatureString()
-                    : "-ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt");
+                    : "-ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt,-pclmulqdq");
   EXPECT_EQ(x86_features->AsBitmap(),
             is_runtime_isa ? X86InstructionSetFeatures::FromCppDefines()->AsBitmap() : 0);
 }
@@ -43,7 +43,7 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromAtomVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt",
+  EXPECT_STREQ("ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt,-pclmulqdq",
                x86_features->GetFeatureString().c_str());
   EXPECT_EQ(x86_features->AsBitmap(), 1U);
 
@@ -53,7 +53,7 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromAtomVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt",
+  EXPECT_STREQ("ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt,-pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
   EXPECT_EQ(x86_64_features->AsBitmap(), 1U);
 
@@ -68,9 +68,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromSandybridgeVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_features->AsBitmap(), 103U);
 
   // Build features for a 64-bit x86-64 sandybridge processor.
   std::unique_ptr<const InstructionSetFeatures> x86_64_features(
@@ -78,9 +78,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromSandybridgeVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_64_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_64_features->AsBitmap(), 103U);
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
@@ -93,9 +93,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromSilvermontVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_features->AsBitmap(), 103U);
 
   // Build features for a 64-bit x86-64 silvermont processor.
   std::unique_ptr<const InstructionSetFeatures> x86_64_features(
@@ -103,9 +103,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromSilvermontVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_64_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_64_features->AsBitmap(), 103U);
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
@@ -118,9 +118,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromGoldmontVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_features->AsBitmap(), 103U);
 
   // Build features for a 64-bit x86-64 goldmont processor.
   std::unique_ptr<const InstructionSetFeatures> x86_64_features(
@@ -128,9 +128,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromGoldmontVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_64_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_64_features->AsBitmap(), 103U);
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
@@ -143,9 +143,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromGoldmontPlusVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_features->AsBitmap(), 103U);
 
   // Build features for a 64-bit x86-64 goldmont-plus processor.
   std::unique_ptr<const InstructionSetFeatures> x86_64_features(
@@ -153,9 +153,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromGoldmontPlusVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_64_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_64_features->AsBitmap(), 103U);
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
@@ -168,9 +168,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromTremontVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_features->AsBitmap(), 103U);
 
   // Build features for a 64-bit x86-64 tremont processor.
   std::unique_ptr<const InstructionSetFeatures> x86_64_features(
@@ -178,9 +178,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromTremontVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,-avx,-avx2,popcnt,pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_64_features->AsBitmap(), 39U);
+  EXPECT_EQ(x86_64_features->AsBitmap(), 103U);
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
@@ -193,9 +193,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromKabylakeVariant) {
   ASSERT_TRUE(x86_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_features->GetInstructionSet(), InstructionSet::kX86);
   EXPECT_TRUE(x86_features->Equals(x86_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,avx2,popcnt,pclmulqdq",
                x86_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_features->AsBitmap(), 63U);
+  EXPECT_EQ(x86_features->AsBitmap(), 127U);
 
   // Build features for a 64-bit x86-64 kabylake processor.
   std::unique_ptr<const InstructionSetFeatures> x86_64_features(
@@ -203,9 +203,9 @@ TEST(X86InstructionSetFeaturesTest, X86FeaturesFromKabylakeVariant) {
   ASSERT_TRUE(x86_64_features.get() != nullptr) << error_msg;
   EXPECT_EQ(x86_64_features->GetInstructionSet(), InstructionSet::kX86_64);
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
-  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,avx2,popcnt",
+  EXPECT_STREQ("ssse3,sse4.1,sse4.2,avx,avx2,popcnt,pclmulqdq",
                x86_64_features->GetFeatureString().c_str());
-  EXPECT_EQ(x86_64_features->AsBitmap(), 63U);
+  EXPECT_EQ(x86_64_features->AsBitmap(), 127U);
 
   EXPECT_FALSE(x86_64_features->Equals(x86_features.get()));
 }
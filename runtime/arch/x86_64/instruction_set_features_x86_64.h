@@ -85,9 +85,10 @@ class X86_64InstructionSetFeatures final : public X86InstructionSetFeatures {
                                bool has_SSE4_2,
                                bool has_AVX,
                                bool has_AVX2,
-                               bool has_POPCNT)
+                               bool has_POPCNT,
+                               bool has_PCLMULQDQ)
       : X86InstructionSetFeatures(has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                  has_AVX2, has_POPCNT) {
+                                  has_AVX2, has_POPCNT, has_PCLMULQDQ) {
   }
 
   static X86_64FeaturesUniquePtr Convert(X86FeaturesUniquePtr&& in) {
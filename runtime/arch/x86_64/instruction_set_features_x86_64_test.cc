@@ -30,7 +30,7 @@ TEST(X86_64InstructionSetFeaturesTest, X86Features) {
   EXPECT_TRUE(x86_64_features->Equals(x86_64_features.get()));
   EXPECT_EQ(x86_64_features->GetFeatureString(),
             is_runtime_isa ? X86_64InstructionSetFeatures::FromCppDefines()->GetFeatureString()
-                    : "-ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt");
+                    : "-ssse3,-sse4.1,-sse4.2,-avx,-avx2,-popcnt,-pclmulqdq");
   EXPECT_EQ(x86_64_features->AsBitmap(),
             is_runtime_isa ? X86_64InstructionSetFeatures::FromCppDefines()->AsBitmap() : 0);
 }
@@ -19,7 +19,10 @@
 #include <errno.h>
 #include <sys/time.h>
 
+#include <algorithm>
+#include <set>
 #include <sstream>
+#include <vector>
 
 #include "android-base/stringprintf.h"
 
@@ -28,8 +31,10 @@
 #include "base/systrace.h"
 #include "base/time_utils.h"
 #include "base/value_object.h"
+#include "base/safe_map.h"
 #include "monitor.h"
 #include "mutex-inl.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-inl.h"
 #include "thread.h"
@@ -53,6 +58,14 @@ struct AllMutexData {
 };
 static struct AllMutexData gAllMutexData[kAllMutexDataSize];
 
+// Mutexes with sampled contention statistics, guarded by gContentionStatsMutexesGuard. These are
+// constant-initialized, since static mutexes in other files may be constructed before this file's
+// dynamic initialization.
+static Atomic<bool> gContentionStatsMutexesGuard(false);
+static std::set<BaseMutex*>* gContentionStatsMutexes = nullptr;
+
+std::atomic<bool> BaseMutex::contention_stats_enabled_(true);
+
 struct DumpStackLastTimeTLSData : public art::TLSData {
   explicit DumpStackLastTimeTLSData(uint64_t last_dump_time_ms)
       : last_dump_time_ms_(last_dump_time_ms) {}
@@ -166,14 +179,29 @@ class ScopedAllMutexesLock final {
   const BaseMutex* const mutex_;
 };
 
+class ScopedContentionStatsMutexesLock final {
+ public:
+  ScopedContentionStatsMutexesLock() {
+    for (uint32_t i = 0; !gContentionStatsMutexesGuard.CompareAndSetWeakAcquire(false, true); ++i) {
+      BackOff(i);
+    }
+  }
+
+  ~ScopedContentionStatsMutexesLock() {
+    DCHECK(gContentionStatsMutexesGuard.load(std::memory_order_relaxed));
+    gContentionStatsMutexesGuard.store(false, std::memory_order_release);
+  }
+};
+
 // Scoped class that generates events at the beginning and end of lock contention.
 class ScopedContentionRecorder final : public ValueObject {
  public:
   ScopedContentionRecorder(BaseMutex* mutex, uint64_t blocked_tid, uint64_t owner_tid)
-      : mutex_(kLogLockContentions ? mutex : nullptr),
+      : mutex_(mutex),
+        sampled_(mutex->CountContention()),
         blocked_tid_(kLogLockContentions ? blocked_tid : 0),
         owner_tid_(kLogLockContentions ? owner_tid : 0),
-        start_nano_time_(kLogLockContentions ? NanoTime() : 0) {
+        start_nano_time_(kLogLockContentions || sampled_ ? NanoTime() : 0) {
     if (ATraceEnabled()) {
       std::string msg = StringPrintf("Lock contention on %s (owner tid: %" PRIu64 ")",
                                      mutex->GetName(), owner_tid);
@@ -183,14 +211,20 @@ class ScopedContentionRecorder final : public ValueObject {
 
   ~ScopedContentionRecorder() {
     ATraceEnd();
-    if (kLogLockContentions) {
-      uint64_t end_nano_time = NanoTime();
-      mutex_->RecordContention(blocked_tid_, owner_tid_, end_nano_time - start_nano_time_);
+    if (kLogLockContentions || sampled_) {
+      uint64_t wait_ns = NanoTime() - start_nano_time_;
+      if (kLogLockContentions) {
+        mutex_->RecordContention(blocked_tid_, owner_tid_, wait_ns);
+      }
+      if (sampled_) {
+        mutex_->RecordSampledWaitTime(wait_ns);
+      }
     }
   }
 
  private:
   BaseMutex* const mutex_;
+  const bool sampled_;
   const uint64_t blocked_tid_;
   const uint64_t owner_tid_;
   const uint64_t start_nano_time_;
@@ -198,8 +232,17 @@ class ScopedContentionRecorder final : public ValueObject {
 
 BaseMutex::BaseMutex(const char* name, LockLevel level)
     : name_(name),
+      contention_stats_(level != kMonitorLock ? new ContentionStats() : nullptr),
       level_(level),
       should_respond_to_empty_checkpoint_request_(false) {
+  if (contention_stats_ != nullptr) {
+    ScopedContentionStatsMutexesLock mu;
+    if (gContentionStatsMutexes == nullptr) {
+      // Leaked like the set of all mutexes.
+      gContentionStatsMutexes = new std::set<BaseMutex*>();
+    }
+    gContentionStatsMutexes->insert(this);
+  }
   if (kLogLockContentions) {
     ScopedAllMutexesLock mu(this);
     std::set<BaseMutex*>** all_mutexes_ptr = &gAllMutexData->all_mutexes;
@@ -217,6 +260,13 @@ BaseMutex::~BaseMutex() {
     ScopedAllMutexesLock mu(this);
     gAllMutexData->all_mutexes->erase(this);
   }
+  if (contention_stats_ != nullptr) {
+    {
+      ScopedContentionStatsMutexesLock mu;
+      gContentionStatsMutexes->erase(this);
+    }
+    delete contention_stats_;
+  }
 }
 
 void BaseMutex::DumpAll(std::ostream& os) {
@@ -245,6 +295,86 @@ void BaseMutex::DumpAll(std::ostream& os) {
   }
 }
 
+void BaseMutex::SetContentionStatsEnabled(bool enabled) {
+  contention_stats_enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+bool BaseMutex::CountContention() {
+  if (contention_stats_ == nullptr || !IsContentionStatsEnabled()) {
+    return false;
+  }
+  uint64_t contentions = contention_stats_->contentions.fetch_add(1u, std::memory_order_relaxed);
+  Runtime* runtime = Runtime::Current();
+  if (runtime != nullptr) {
+    runtime->GetMetrics()->MutexContentionCount()->Add(1u);
+  }
+  return contentions % kContentionSamplePeriod == 0u;
+}
+
+void BaseMutex::RecordSampledWaitTime(uint64_t wait_ns) {
+  DCHECK(contention_stats_ != nullptr);
+  contention_stats_->sampled_wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+  const auto& bounds = ContentionStats::kWaitTimeBucketBoundsNs;
+  size_t bucket = std::upper_bound(std::begin(bounds), std::end(bounds), wait_ns) -
+                  std::begin(bounds);
+  contention_stats_->sampled_waits[bucket].fetch_add(1u, std::memory_order_relaxed);
+  Runtime* runtime = Runtime::Current();
+  if (runtime != nullptr) {
+    runtime->GetMetrics()->MutexContentionWaitTime()->Add(NsToUs(wait_ns));
+  }
+}
+
+void BaseMutex::DumpContentionStats(std::ostream& os) {
+  struct Totals {
+    uint64_t contentions = 0u;
+    uint64_t sampled_wait_ns = 0u;
+    uint64_t sampled_waits[ContentionStats::kNumWaitTimeBuckets] = {};
+  };
+  // Aggregate by name, mutexes of the same kind such as class table locks share their name.
+  SafeMap<std::string, Totals> totals;
+  {
+    ScopedContentionStatsMutexesLock mu;
+    if (gContentionStatsMutexes == nullptr) {
+      return;
+    }
+    for (const BaseMutex* mutex : *gContentionStatsMutexes) {
+      const ContentionStats* stats = mutex->contention_stats_;
+      uint64_t contentions = stats->contentions.load(std::memory_order_relaxed);
+      if (contentions == 0u) {
+        continue;
+      }
+      Totals& mutex_totals = totals.GetOrCreate(mutex->GetName(), []() { return Totals(); });
+      mutex_totals.contentions += contentions;
+      mutex_totals.sampled_wait_ns += stats->sampled_wait_ns.load(std::memory_order_relaxed);
+      for (size_t i = 0; i != ContentionStats::kNumWaitTimeBuckets; ++i) {
+        mutex_totals.sampled_waits[i] += stats->sampled_waits[i].load(std::memory_order_relaxed);
+      }
+    }
+  }
+  // Most contended first.
+  std::vector<std::pair<std::string, Totals>> sorted(totals.begin(), totals.end());
+  std::sort(sorted.begin(), sorted.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.second.contentions > rhs.second.contentions;
+  });
+  os << "Mutex contention (wait times sampled 1/" << kContentionSamplePeriod << "):\n";
+  for (const auto& [name, mutex_totals] : sorted) {
+    uint64_t num_samples = 0u;
+    for (uint64_t count : mutex_totals.sampled_waits) {
+      num_samples += count;
+    }
+    os << "  " << name << ": contended=" << mutex_totals.contentions;
+    if (num_samples != 0u) {
+      os << " average wait=" << PrettyDuration(mutex_totals.sampled_wait_ns / num_samples)
+         << " waits=";
+      for (size_t i = 0; i != ContentionStats::kNumWaitTimeBuckets; ++i) {
+        os << (i != 0u ? "/" : "") << mutex_totals.sampled_waits[i];
+      }
+    }
+    os << "\n";
+  }
+  os << "  (waits by time <10us/<100us/<1ms/<10ms/<100ms/>=100ms)\n";
+}
+
 void BaseMutex::CheckSafeToWait(Thread* self) {
   if (!kDebugLocking) {
     return;
@@ -633,12 +763,11 @@ bool Mutex::ExclusiveTryLock(Thread* self) {
 template bool Mutex::ExclusiveTryLock<false>(Thread* self);
 template bool Mutex::ExclusiveTryLock<true>(Thread* self);
 
-bool Mutex::ExclusiveTryLockWithSpinning(Thread* self) {
+bool Mutex::ExclusiveTryLockWithSpinning(Thread* self, size_t max_spins) {
   // Spin a small number of times, since this affects our ability to respond to suspension
   // requests. We spin repeatedly only if the mutex repeatedly becomes available and unavailable
   // in rapid succession, and then we will typically not spin for the maximal period.
-  const int kMaxSpins = 5;
-  for (int i = 0; i < kMaxSpins; ++i) {
+  for (size_t i = 0; i < max_spins; ++i) {
     if (ExclusiveTryLock(self)) {
       return true;
     }
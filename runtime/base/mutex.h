@@ -72,6 +72,10 @@ constexpr size_t kContentionLogSize = 4;
 constexpr size_t kContentionLogDataSize = kLogLockContentions ? 1 : 0;
 constexpr size_t kAllMutexDataSize = kLogLockContentions ? 1 : 0;
 
+// Sampled contention statistics are cheap enough to keep in release builds. Every contention is
+// counted, and the wait time of one in kContentionSamplePeriod contentions is measured.
+constexpr uint32_t kContentionSamplePeriod = 8;
+
 // Base class for all Mutex implementations
 class BaseMutex {
  public:
@@ -87,6 +91,36 @@ class BaseMutex {
 
   static void DumpAll(std::ostream& os);
 
+  // Enable or disable the sampled contention statistics of all mutexes, except monitor locks.
+  // Enabled by default.
+  static void SetContentionStatsEnabled(bool enabled);
+  static bool IsContentionStatsEnabled() {
+    return contention_stats_enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Dump the sampled contention statistics of contended mutexes, aggregated by mutex name.
+  static void DumpContentionStats(std::ostream& os);
+
+  // Sampled contention statistics of a mutex.
+  struct ContentionStats {
+    // Upper bounds of the wait time buckets, in nanoseconds. The last bucket has no bound.
+    static constexpr uint64_t kWaitTimeBucketBoundsNs[] = {
+        10'000u, 100'000u, 1'000'000u, 10'000'000u, 100'000'000u};
+    static constexpr size_t kNumWaitTimeBuckets = arraysize(kWaitTimeBucketBoundsNs) + 1u;
+
+    // Number of times the mutex has been contended.
+    std::atomic<uint64_t> contentions{0u};
+    // Sum of the sampled wait times in nanoseconds.
+    std::atomic<uint64_t> sampled_wait_ns{0u};
+    // Number of sampled waits by wait time bucket.
+    std::atomic<uint64_t> sampled_waits[kNumWaitTimeBuckets] = {};
+  };
+
+  // Returns the contention statistics, or null for monitor locks.
+  const ContentionStats* GetContentionStats() const {
+    return contention_stats_;
+  }
+
   bool ShouldRespondToEmptyCheckpointRequest() const {
     return should_respond_to_empty_checkpoint_request_;
   }
@@ -119,6 +153,11 @@ class BaseMutex {
   void RecordContention(uint64_t blocked_tid, uint64_t owner_tid, uint64_t nano_time_blocked);
   void DumpContention(std::ostream& os) const;
 
+  // Count a contention in the sampled statistics. Returns whether to measure its wait time and
+  // record it with RecordSampledWaitTime().
+  bool CountContention();
+  void RecordSampledWaitTime(uint64_t wait_ns);
+
   const char* const name_;
 
   // A log entry that records contention but makes no guarantee that either tid will be held live.
@@ -142,6 +181,10 @@ class BaseMutex {
   };
   ContentionLogData contention_log_data_[kContentionLogDataSize];
 
+  // Sampled contention statistics. Not kept for monitor locks, which are many.
+  ContentionStats* const contention_stats_;
+  static std::atomic<bool> contention_stats_enabled_;
+
   const LockLevel level_;  // Support for lock hierarchy.
   bool should_respond_to_empty_checkpoint_request_;
 
@@ -190,8 +233,11 @@ class EXPORT LOCKABLE Mutex : public BaseMutex {
   template <bool kCheck = kDebugLocking>
   bool ExclusiveTryLock(Thread* self) TRY_ACQUIRE(true);
   bool TryLock(Thread* self) TRY_ACQUIRE(true) { return ExclusiveTryLock(self); }
-  // Equivalent to ExclusiveTryLock, but retry for a short period before giving up.
-  bool ExclusiveTryLockWithSpinning(Thread* self) TRY_ACQUIRE(true);
+  // Equivalent to ExclusiveTryLock, but retry for a short period before giving up. Each spin
+  // waits briefly for the mutex to be released.
+  static constexpr size_t kDefaultMaxSpins = 5;
+  bool ExclusiveTryLockWithSpinning(Thread* self, size_t max_spins = kDefaultMaxSpins)
+      TRY_ACQUIRE(true);
 
   // Release exclusive access.
   void ExclusiveUnlock(Thread* self) RELEASE();
@@ -16,6 +16,8 @@
 
 #include "mutex-inl.h"
 
+#include <sstream>
+
 #include "common_runtime_test.h"
 #include "thread-current-inl.h"
 
@@ -179,4 +181,49 @@ TEST_F(MutexTest, SharedTryLockUnlock) {
   SharedTryLockUnlockTest();
 }
 
+static void* ContendedLockCallback(void* arg) {
+  Mutex* mu = reinterpret_cast<Mutex*>(arg);
+  mu->Lock(Thread::Current());
+  mu->Unlock(Thread::Current());
+  return nullptr;
+}
+
+// GCC has trouble with our mutex tests, so we have to turn off thread safety analysis.
+static void ContentionStatsTest() NO_THREAD_SAFETY_ANALYSIS {
+  Mutex monitor_mu("test monitor mutex", kMonitorLock);
+  EXPECT_TRUE(monitor_mu.GetContentionStats() == nullptr);
+
+  Mutex mu("contention stats test mutex");
+  const BaseMutex::ContentionStats* stats = mu.GetContentionStats();
+  ASSERT_TRUE(stats != nullptr);
+  EXPECT_EQ(0u, stats->contentions.load());
+  mu.Lock(Thread::Current());
+
+  pthread_t pthread;
+  int pthread_create_result = pthread_create(&pthread, nullptr, ContendedLockCallback, &mu);
+  ASSERT_EQ(0, pthread_create_result);
+
+  // Hold the mutex until the other thread blocks on it.
+  while (stats->contentions.load() == 0u) {
+    usleep(1000);
+  }
+  mu.Unlock(Thread::Current());
+  EXPECT_EQ(pthread_join(pthread, nullptr), 0);
+
+  // The first contention is sampled.
+  uint64_t num_samples = 0u;
+  for (const auto& sampled_waits : stats->sampled_waits) {
+    num_samples += sampled_waits.load();
+  }
+  EXPECT_NE(0u, num_samples);
+  std::ostringstream oss;
+  BaseMutex::DumpContentionStats(oss);
+  EXPECT_NE(oss.str().find("contention stats test mutex: contended="), std::string::npos)
+      << oss.str();
+}
+
+TEST_F(MutexTest, ContentionStats) {
+  ContentionStatsTest();
+}
+
 }  // namespace art
@@ -10715,6 +10715,13 @@ void ClassLinker::DumpForSigQuit(std::ostream& os) {
     }
   }
   os << "Done dumping class loaders\n";
+  os << "Dex cache hashed array misses/conflicts:\n";
+  for (const auto& entry : dex_caches_) {
+    ObjPtr<mirror::DexCache> dex_cache = DecodeDexCacheLocked(soa.Self(), &entry.second);
+    if (dex_cache != nullptr) {
+      dex_cache->DumpStats(os);
+    }
+  }
   Runtime* runtime = Runtime::Current();
   os << "Classes initialized: " << runtime->GetStat(KIND_GLOBAL_CLASS_INIT_COUNT) << " in "
      << PrettyDuration(runtime->GetStat(KIND_GLOBAL_CLASS_INIT_TIME)) << "\n";
@@ -10979,6 +10986,9 @@ void ClassLinker::CleanupClassLoaders() {
   // Do the delete outside the lock to avoid lock violation in jit code cache.
   {
     WriterMutexLock mu(self, *Locks::classlinker_classes_lock_);
+    // We are called after each GC, so this also frees the class sets that class tables retired
+    // before the previous GC.
+    boot_class_table_->FreeRetiredSets();
     for (auto it = class_loaders_.begin(); it != class_loaders_.end(); ) {
       auto this_it = it;
       ++it;
@@ -10989,6 +10999,8 @@ void ClassLinker::CleanupClassLoaders() {
       if (class_loader == nullptr) {
         VLOG(class_linker) << "Freeing class loader";
         to_delete.splice(to_delete.end(), class_loaders_, this_it);
+      } else {
+        data.class_table->FreeRetiredSets();
       }
     }
   }
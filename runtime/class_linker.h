@@ -716,7 +716,8 @@ class EXPORT ClassLinker {
   // entries are roots, but potentially not image classes.
   void DropFindArrayClassCache() REQUIRES_SHARED(Locks::mutator_lock_);
 
-  // Clean up class loaders, this needs to happen after JNI weak globals are cleared.
+  // Clean up class loaders, this needs to happen after JNI weak globals are cleared. Also frees
+  // the class sets retired by the class tables before the previous GC.
   void CleanupClassLoaders()
       REQUIRES(!Locks::classlinker_classes_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -23,10 +23,28 @@
 
 namespace art HIDDEN {
 
-ClassTable::ClassTable() : lock_("Class loader classes", kClassLoaderClassesLock) {
+ClassTable::ClassTable()
+    : lock_("Class loader classes", kClassLoaderClassesLock), releasable_lookup_sets_count_(0u) {
   Runtime* const runtime = Runtime::Current();
+  WriterMutexLock mu(Thread::Current(), lock_);
   classes_.push_back(ClassSet(runtime->GetHashTableMinLoadFactor(),
                               runtime->GetHashTableMaxLoadFactor()));
+  PublishLookupSets();
+}
+
+void ClassTable::PublishLookupSets() {
+  // Search from the last table, assuming that apps shall search for their own classes
+  // more often than for boot image classes. For prebuilt boot images, this also helps
+  // by searching the large table from the framework boot image extension compiled as
+  // single-image before the individual small tables from the primary boot image
+  // compiled as multi-image.
+  std::vector<const ClassSet*>& lookup_sets = published_lookup_sets_.emplace_back();
+  lookup_sets.reserve(classes_.size());
+  for (const ClassSet& class_set : ReverseRange(classes_)) {
+    lookup_sets.push_back(&class_set);
+  }
+  // Pairs with the acquire load in `Lookup()`, which must see the class sets fully constructed.
+  lookup_sets_.store(&lookup_sets, std::memory_order_release);
 }
 
 void ClassTable::FreezeSnapshot() {
@@ -36,6 +54,21 @@ void ClassTable::FreezeSnapshot() {
   const ClassSet& last_set = classes_.back();
   ClassSet new_set(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   classes_.push_back(std::move(new_set));
+  PublishLookupSets();
+}
+
+void ClassTable::FreeRetiredSets() {
+  WriterMutexLock mu(Thread::Current(), lock_);
+  // Lookups run with the mutator lock held, so the GC pause since the last call waited for any
+  // lookup that could have loaded the sets and lists retired before that call.
+  releasable_classes_.clear();
+  DCHECK_LT(releasable_lookup_sets_count_, published_lookup_sets_.size());
+  published_lookup_sets_.erase(
+      published_lookup_sets_.begin(),
+      std::next(published_lookup_sets_.begin(), releasable_lookup_sets_count_));
+  // The ones retired since then may still be in use until the next pause.
+  releasable_classes_.splice(releasable_classes_.end(), retired_classes_);
+  releasable_lookup_sets_count_ = published_lookup_sets_.size() - 1u;
 }
 
 ObjPtr<mirror::Class> ClassTable::UpdateClass(ObjPtr<mirror::Class> klass, size_t hash) {
@@ -60,7 +93,9 @@ ObjPtr<mirror::Class> ClassTable::UpdateClass(ObjPtr<mirror::Class> klass, size_
   CHECK(!klass->IsTemp()) << klass->PrettyDescriptor();
   VerifyObject(klass);
   // Update the element in the hash set with the new class. This is safe to do since the descriptor
-  // doesn't change.
+  // doesn't change. Make the class data visible to lookups before the class, as in
+  // `InsertWithHash()`.
+  std::atomic_thread_fence(std::memory_order_release);
   *existing_it = slot;
   return existing;
 }
@@ -79,8 +114,8 @@ size_t ClassTable::CountDefiningLoaderClasses(ObjPtr<mirror::ClassLoader> defini
 size_t ClassTable::NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += CountDefiningLoaderClasses(defining_loader, classes_[i]);
+  for (auto it = classes_.begin(); it != std::prev(classes_.end()); ++it) {
+    sum += CountDefiningLoaderClasses(defining_loader, *it);
   }
   return sum;
 }
@@ -93,8 +128,8 @@ size_t ClassTable::NumNonZygoteClasses(ObjPtr<mirror::ClassLoader> defining_load
 size_t ClassTable::NumReferencedZygoteClasses() const {
   ReaderMutexLock mu(Thread::Current(), lock_);
   size_t sum = 0;
-  for (size_t i = 0; i < classes_.size() - 1; ++i) {
-    sum += classes_[i].size();
+  for (auto it = classes_.begin(); it != std::prev(classes_.end()); ++it) {
+    sum += it->size();
   }
   return sum;
 }
@@ -106,15 +141,14 @@ size_t ClassTable::NumReferencedNonZygoteClasses() const {
 
 ObjPtr<mirror::Class> ClassTable::Lookup(const char* descriptor, size_t hash) {
   DescriptorHashPair pair(descriptor, hash);
-  ReaderMutexLock mu(Thread::Current(), lock_);
-  // Search from the last table, assuming that apps shall search for their own classes
-  // more often than for boot image classes. For prebuilt boot images, this also helps
-  // by searching the large table from the framework boot image extension compiled as
-  // single-image before the individual small tables from the primary boot image
-  // compiled as multi-image.
-  for (ClassSet& class_set : ReverseRange(classes_)) {
-    auto it = class_set.FindWithHash(pair, hash);
-    if (it != class_set.end()) {
+  // No lock needed, the published class sets are never reallocated, and they are not deleted
+  // before the next pause, which waits for this lookup holding the mutator lock. A class
+  // inserted concurrently may or may not be found, as if the lookup ran before or after the
+  // insertion under a lock.
+  const std::vector<const ClassSet*>* lookup_sets = lookup_sets_.load(std::memory_order_acquire);
+  for (const ClassSet* class_set : *lookup_sets) {
+    auto it = class_set->FindWithHash(pair, hash);
+    if (it != class_set->end()) {
       return it->Read();
     }
   }
@@ -127,7 +161,31 @@ void ClassTable::Insert(ObjPtr<mirror::Class> klass) {
 
 void ClassTable::InsertWithHash(ObjPtr<mirror::Class> klass, size_t hash) {
   WriterMutexLock mu(Thread::Current(), lock_);
-  classes_.back().InsertWithHash(TableSlot(klass, hash), hash);
+  ClassSet& active_set = classes_.back();
+  TableSlot slot(klass, hash);
+  if (active_set.size() >= active_set.ElementsUntilExpand()) {
+    // Inserting would reallocate the storage of the active set under concurrent lookups.
+    // Grow a copy instead, publish it and retire the old set. Size the copy to the minimum
+    // load factor, like `HashSet<>` expands.
+    double min_load_factor = active_set.GetMinLoadFactor();
+    double max_load_factor = active_set.GetMaxLoadFactor();
+    ClassSet new_set(min_load_factor, max_load_factor);
+    new_set.reserve(static_cast<size_t>(active_set.size() * max_load_factor / min_load_factor));
+    for (const TableSlot& table_slot : active_set) {
+      new_set.Put(table_slot);
+    }
+    new_set.InsertWithHash(slot, hash);
+    retired_classes_.splice(retired_classes_.end(), classes_, std::prev(classes_.end()));
+    classes_.push_back(std::move(new_set));
+    PublishLookupSets();
+  } else {
+    // Make the class data visible to lookups before the class, like the lock release did.
+    // Lookups depend on the loaded slot for reading the class data.
+    std::atomic_thread_fence(std::memory_order_release);
+    size_t num_buckets = active_set.NumBuckets();
+    active_set.InsertWithHash(slot, hash);
+    DCHECK_EQ(num_buckets, active_set.NumBuckets());
+  }
 }
 
 bool ClassTable::InsertStrongRoot(ObjPtr<mirror::Object> obj) {
@@ -178,7 +236,8 @@ void ClassTable::AddClassSet(ClassSet&& set) {
   // the number of searched frozen tables and not search them again.
   // TODO: Make use of this in `ClassLinker::FindClass()`.
   DCHECK(!classes_.empty());
-  classes_.insert(classes_.end() - 1, std::move(set));
+  classes_.insert(std::prev(classes_.end()), std::move(set));
+  PublishLookupSets();
 }
 
 void ClassTable::ClearStrongRoots() {
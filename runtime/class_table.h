@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_CLASS_TABLE_H_
 #define ART_RUNTIME_CLASS_TABLE_H_
 
+#include <atomic>
+#include <list>
 #include <string>
 #include <utility>
 #include <vector>
@@ -161,6 +163,12 @@ class ClassTable {
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Free the class sets and lookup lists that were retired before the previous call. Called after
+  // each GC, so that the GC pause in between guarantees that no lookup still reads them.
+  void FreeRetiredSets()
+      REQUIRES(!lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Returns the number of classes in previous snapshots defined by `defining_loader`.
   size_t NumZygoteClasses(ObjPtr<mirror::ClassLoader> defining_loader) const
       REQUIRES(!lock_)
@@ -221,6 +229,7 @@ class ClassTable {
       REQUIRES_SHARED(Locks::mutator_lock_);
 
   // Return the first class that matches the descriptor. Returns null if there are none.
+  // Does not take `lock_`, see `lookup_sets_`.
   ObjPtr<mirror::Class> Lookup(const char* descriptor, size_t hash)
       REQUIRES(!lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
@@ -285,10 +294,27 @@ class ClassTable {
       REQUIRES(lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Publish the current `classes_` for lookups, in lookup order.
+  void PublishLookupSets() REQUIRES(lock_);
+
   // Lock to guard inserting and removing.
   mutable ReaderWriterMutex lock_;
-  // We have a vector to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
-  std::vector<ClassSet> classes_ GUARDED_BY(lock_);
+  // We have a list to help prevent dirty pages after the zygote forks by calling FreezeSnapshot.
+  // The class sets are never moved, so that lookups can keep using them without `lock_`.
+  std::list<ClassSet> classes_ GUARDED_BY(lock_);
+  // Lookups read the class sets published in `lookup_sets_` without taking `lock_`. Inserting
+  // into a set never reallocates its storage while it is published: when the active set needs to
+  // grow, it is copied into a larger set which replaces it in `classes_`, and the old set is moved
+  // to `retired_classes_`. Lookups that started earlier may still read retired sets and old
+  // published lists. Lookups hold the mutator lock, so these are freed by `FreeRetiredSets()`
+  // once a pause has passed since their retirement.
+  std::atomic<const std::vector<const ClassSet*>*> lookup_sets_;
+  std::list<std::vector<const ClassSet*>> published_lookup_sets_ GUARDED_BY(lock_);
+  std::list<ClassSet> retired_classes_ GUARDED_BY(lock_);
+  // Sets and the number of leading `published_lookup_sets_` that were retired before the last
+  // `FreeRetiredSets()` call, freed by the next one.
+  std::list<ClassSet> releasable_classes_ GUARDED_BY(lock_);
+  size_t releasable_lookup_sets_count_ GUARDED_BY(lock_);
   // Extra strong roots that can be either dex files or dex caches. Dex files used by the class
   // loader which may not be owned by the class loader must be held strongly live. Also dex caches
   // are held live to prevent them being unloading once they have classes in them.
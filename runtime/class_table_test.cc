@@ -18,6 +18,7 @@
 
 #include "art_field-inl.h"
 #include "art_method-inl.h"
+#include "base/atomic.h"
 #include "class_linker-inl.h"
 #include "common_runtime_test.h"
 #include "dex/dex_file.h"
@@ -27,6 +28,7 @@
 #include "mirror/class-alloc-inl.h"
 #include "obj_ptr.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 namespace art HIDDEN {
 namespace mirror {
@@ -66,11 +68,125 @@ class CollectRootVisitor {
 };
 
 
+struct LookupEntry {
+  std::string descriptor;
+  uint32_t hash;
+  mirror::Class* klass;
+};
+
 class ClassTableTest : public CommonRuntimeTest {
  protected:
   ClassTableTest() {
     use_boot_image_ = true;  // Make the Runtime creation cheaper.
   }
+
+  // Collect up to `max_entries` boot class path classes. They are not moving.
+  std::vector<LookupEntry> CollectBootClasses(size_t max_entries) {
+    ScopedObjectAccess soa(Thread::Current());
+    std::vector<LookupEntry> entries;
+    auto collect = [&](ObjPtr<mirror::Class> klass) REQUIRES_SHARED(Locks::mutator_lock_) {
+      if (klass->GetClassLoader() == nullptr && !klass->IsTemp()) {
+        std::string temp;
+        entries.push_back({klass->GetDescriptor(&temp), klass->DescriptorHash(), klass.Ptr()});
+      }
+      return entries.size() != max_entries;
+    };
+    ClassFuncVisitor visitor(collect);
+    class_linker_->VisitClasses(&visitor);
+    return entries;
+  }
+};
+
+class ClassTableLookupTask : public Task {
+ public:
+  ClassTableLookupTask(ClassTable* table,
+                       const std::vector<LookupEntry>* entries,
+                       size_t rounds,
+                       AtomicInteger* failures)
+      : table_(table), entries_(entries), rounds_(rounds), failures_(failures) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    for (size_t i = 0; i != rounds_; ++i) {
+      for (const LookupEntry& entry : *entries_) {
+        if (table_->Lookup(entry.descriptor.c_str(), entry.hash) != entry.klass) {
+          ++*failures_;
+        }
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ClassTable* const table_;
+  const std::vector<LookupEntry>* const entries_;
+  const size_t rounds_;
+  AtomicInteger* const failures_;
+};
+
+// Looks up classes that may be inserted concurrently, until all of them have been found.
+class ClassTableRacingLookupTask : public Task {
+ public:
+  ClassTableRacingLookupTask(ClassTable* table,
+                             const std::vector<LookupEntry>* entries,
+                             AtomicInteger* failures)
+      : table_(table), entries_(entries), failures_(failures) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    std::vector<bool> found(entries_->size(), false);
+    size_t num_found = 0u;
+    while (num_found != entries_->size()) {
+      self->AllowThreadSuspension();  // Do not block a GC while waiting for the inserter.
+      for (size_t i = 0; i != entries_->size(); ++i) {
+        const LookupEntry& entry = (*entries_)[i];
+        ObjPtr<mirror::Class> klass = table_->Lookup(entry.descriptor.c_str(), entry.hash);
+        if (klass == nullptr) {
+          if (found[i]) {
+            ++*failures_;  // Lost a class that was found before.
+          }
+        } else if (klass != entry.klass) {
+          ++*failures_;
+        } else if (!found[i]) {
+          found[i] = true;
+          ++num_found;
+        }
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ClassTable* const table_;
+  const std::vector<LookupEntry>* const entries_;
+  AtomicInteger* const failures_;
+};
+
+class ClassTableInsertTask : public Task {
+ public:
+  ClassTableInsertTask(ClassTable* table, const std::vector<LookupEntry>* entries)
+      : table_(table), entries_(entries) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    for (const LookupEntry& entry : *entries_) {
+      table_->InsertWithHash(entry.klass, entry.hash);
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  ClassTable* const table_;
+  const std::vector<LookupEntry>* const entries_;
 };
 
 TEST_F(ClassTableTest, ClassTable) {
@@ -112,6 +228,12 @@ TEST_F(ClassTableTest, ClassTable) {
   EXPECT_EQ(table.NumZygoteClasses(class_loader.Get()), 1u);
   EXPECT_EQ(table.NumNonZygoteClasses(class_loader.Get()), 1u);
 
+  // Freeing the retired sets keeps the published ones.
+  table.FreeRetiredSets();
+  table.FreeRetiredSets();
+  EXPECT_OBJ_PTR_EQ(table.Lookup(descriptor_x, ComputeModifiedUtf8Hash(descriptor_x)), h_X.Get());
+  EXPECT_OBJ_PTR_EQ(table.Lookup(descriptor_y, ComputeModifiedUtf8Hash(descriptor_y)), h_Y.Get());
+
   // Test adding / clearing strong roots.
   EXPECT_TRUE(table.InsertStrongRoot(obj_X.Get()));
   EXPECT_FALSE(table.InsertStrongRoot(obj_X.Get()));
@@ -161,5 +283,61 @@ TEST_F(ClassTableTest, ClassTable) {
   // TODO: Add tests for UpdateClass, InsertOatFile.
 }
 
+// Look up classes while another thread inserts classes and grows the table.
+TEST_F(ClassTableTest, ConcurrentLookups) {
+  static constexpr size_t kNumLookupThreads = 4;
+  std::vector<LookupEntry> entries = CollectBootClasses(/*max_entries=*/ 8192);
+  ASSERT_GT(entries.size(), 2u);
+  std::vector<LookupEntry> present(entries.begin(), entries.begin() + entries.size() / 2);
+  std::vector<LookupEntry> inserted(entries.begin() + entries.size() / 2, entries.end());
+  ClassTable table;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    for (const LookupEntry& entry : present) {
+      table.InsertWithHash(entry.klass, entry.hash);
+    }
+  }
+
+  Thread* self = Thread::Current();
+  AtomicInteger failures(0);
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Class table test thread pool", kNumLookupThreads + 1));
+  thread_pool->AddTask(self, new ClassTableInsertTask(&table, &inserted));
+  for (size_t i = 0; i != kNumLookupThreads; ++i) {
+    thread_pool->AddTask(self, new ClassTableLookupTask(&table, &present, 10u, &failures));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  EXPECT_EQ(0, failures.load());
+
+  ScopedObjectAccess soa(self);
+  for (const LookupEntry& entry : entries) {
+    EXPECT_EQ(entry.klass, table.Lookup(entry.descriptor.c_str(), entry.hash));
+  }
+}
+
+// Look up classes while they are being inserted. A lookup racing with the insertion of a class
+// may miss it, but must never return another class, and must find it once it has been found.
+TEST_F(ClassTableTest, ConcurrentLookupsOfInsertedClasses) {
+  static constexpr size_t kNumLookupThreads = 4;
+  std::vector<LookupEntry> entries = CollectBootClasses(/*max_entries=*/ 8192);
+  ASSERT_GT(entries.size(), 1u);
+  ClassTable table;
+
+  Thread* self = Thread::Current();
+  AtomicInteger failures(0);
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Class table test thread pool", kNumLookupThreads + 1));
+  thread_pool->AddTask(self, new ClassTableInsertTask(&table, &entries));
+  for (size_t i = 0; i != kNumLookupThreads; ++i) {
+    thread_pool->AddTask(self, new ClassTableRacingLookupTask(&table, &entries, &failures));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  EXPECT_EQ(0, failures.load());
+  ScopedObjectAccess soa(self);
+  EXPECT_EQ(entries.size(), table.NumReferencedNonZygoteClasses());
+}
+
 }  // namespace mirror
 }  // namespace art
@@ -2721,6 +2721,7 @@ void ConcurrentCopying::ReclaimPhase() {
   // dead methods from JIT's internal maps. This must be done before
   // reclaiming the memory of the dead methods' declaring classes.
   Runtime::Current()->GetClassLinker()->CleanupClassLoaders();
+  Runtime::Current()->GetInternTable()->FreeRetiredStrongTables();
 
   {
     // Double-check that the mark stack is empty.
@@ -327,6 +327,7 @@ GarbageCollector::ScopedPause::ScopedPause(GarbageCollector* collector, bool wit
   if (with_reporting) {
     GcPauseListener* pause_listener = runtime->GetHeap()->GetGcPauseListener();
     if (pause_listener != nullptr) {
+      pause_listener->SafepointReached(runtime->GetThreadList()->GetLastTimeToSafepoint());
       pause_listener->StartPause();
     }
   }
@@ -49,6 +49,7 @@
 #include "gc/space/bump_pointer_space.h"
 #include "gc/task_processor.h"
 #include "gc/verification-inl.h"
+#include "intern_table.h"
 #include "jit/jit_code_cache.h"
 #include "mark_compact-inl.h"
 #include "mirror/object-refvisitor-inl.h"
@@ -1503,6 +1504,7 @@ void MarkCompact::ReclaimPhase() {
   // Clean up class loaders after system weaks are swept since that is how we know if class
   // unloading occurred.
   runtime->GetClassLinker()->CleanupClassLoaders();
+  runtime->GetInternTable()->FreeRetiredStrongTables();
   {
     WriterMutexLock mu(thread_running_gc_, *Locks::heap_bitmap_lock_);
     // Reclaim unmarked objects.
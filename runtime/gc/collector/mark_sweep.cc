@@ -39,6 +39,7 @@
 #include "gc/reference_processor.h"
 #include "gc/space/large_object_space.h"
 #include "gc/space/space-inl.h"
+#include "intern_table.h"
 #include "mark_sweep-inl.h"
 #include "mirror/object-inl.h"
 #include "runtime.h"
@@ -348,6 +349,7 @@ void MarkSweep::ReclaimPhase() {
   // Clean up class loaders after system weaks are swept since that is how we know if class
   // unloading occurred.
   runtime->GetClassLinker()->CleanupClassLoaders();
+  runtime->GetInternTable()->FreeRetiredStrongTables();
   {
     WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
     GetHeap()->RecordFreeRevoke();
@@ -200,6 +200,7 @@ void SemiSpace::MarkingPhase() {
   }
   Runtime::Current()->BroadcastForNewSystemWeaks();
   Runtime::Current()->GetClassLinker()->CleanupClassLoaders();
+  Runtime::Current()->GetInternTable()->FreeRetiredStrongTables();
   // Revoke buffers before measuring how many objects were moved since the TLABs need to be revoked
   // before they are properly counted.
   RevokeAllThreadLocalBuffers();
@@ -17,6 +17,8 @@
 #ifndef ART_RUNTIME_GC_GC_PAUSE_LISTENER_H_
 #define ART_RUNTIME_GC_GC_PAUSE_LISTENER_H_
 
+#include <cstdint>
+
 #include "base/macros.h"
 
 namespace art HIDDEN {
@@ -26,6 +28,10 @@ class GcPauseListener {
  public:
   virtual ~GcPauseListener() {}
 
+  // Called with all threads suspended, before StartPause(), with the time the slowest thread
+  // took to reach a suspend point.
+  virtual void SafepointReached([[maybe_unused]] uint64_t time_to_safepoint_ns) {}
+
   virtual void StartPause() = 0;
   virtual void EndPause() = 0;
 };
@@ -1034,6 +1034,20 @@ void Heap::IncrementDisableThreadFlip(Thread* self) {
   }
 }
 
+bool Heap::PinObject(ObjPtr<mirror::Object> obj) {
+  return gUseReadBarrier &&
+         region_space_ != nullptr &&
+         region_space_->HasAddress(obj.Ptr()) &&
+         region_space_->PinObject(obj.Ptr());
+}
+
+bool Heap::UnpinObject(ObjPtr<mirror::Object> obj) {
+  return gUseReadBarrier &&
+         region_space_ != nullptr &&
+         region_space_->HasAddress(obj.Ptr()) &&
+         region_space_->UnpinObject(obj.Ptr());
+}
+
 void Heap::EnsureObjectUserfaulted(ObjPtr<mirror::Object> obj) {
   if (gUseUserfaultfd) {
     // Use volatile to ensure that compiler loads from memory to trigger userfaults, if required.
@@ -396,6 +396,14 @@ class Heap {
   void ThreadFlipBegin(Thread* self) REQUIRES(!*thread_flip_lock_);
   void ThreadFlipEnd(Thread* self) REQUIRES(!*thread_flip_lock_);
 
+  // Pin a movable object for a JNI critical call, so that the GC leaves it in place without
+  // being blocked. Returns false if the object cannot be pinned, in which case the caller needs
+  // to disable moving GC or thread flips instead. Only supported by the CC collector, which can
+  // exclude the region of a pinned object from evacuation.
+  bool PinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+  // Unpin an object pinned by PinObject(). Returns false if the object is not pinned.
+  bool UnpinObject(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Ensures that the obj doesn't cause userfaultfd in JNI critical calls.
   void EnsureObjectUserfaulted(ObjPtr<mirror::Object> obj) REQUIRES_SHARED(Locks::mutator_lock_);
 
@@ -53,6 +53,7 @@
 #include "dex/dex_file_loader.h"
 #include "exec_utils.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/space/lazy_image_decompressor.h"
 #include "gc/task_processor.h"
 #include "intern_table-inl.h"
 #include "mirror/class-inl.h"
@@ -748,6 +749,7 @@ class ImageSpace::Loader {
     // avoid reading proc maps for a mapping failure and slowing everything down.
     // For the boot image, we have already reserved the memory and we load the image
     // into the `image_reservation`.
+    std::unique_ptr<LazyImageDecompressor> lazy_decompressor;
     MemMap map = LoadImageFile(
         image_filename,
         image_location,
@@ -756,6 +758,7 @@ class ImageSpace::Loader {
         allow_direct_mapping,
         logger,
         image_reservation,
+        &lazy_decompressor,
         error_msg);
     if (!map.IsValid()) {
       DCHECK(!error_msg->empty());
@@ -804,6 +807,7 @@ class ImageSpace::Loader {
                                                      std::move(map),
                                                      std::move(bitmap),
                                                      image_end));
+    space->lazy_decompressor_ = std::move(lazy_decompressor);
     return space;
   }
 
@@ -991,6 +995,7 @@ class ImageSpace::Loader {
                               bool allow_direct_mapping,
                               TimingLogger* logger,
                               /*inout*/MemMap* image_reservation,
+                              /*out*/std::unique_ptr<LazyImageDecompressor>* lazy_decompressor,
                               /*out*/std::string* error_msg)
         REQUIRES_SHARED(Locks::mutator_lock_) {
     TimingLogger::ScopedTiming timing("MapImageFile", logger);
@@ -1052,6 +1057,22 @@ class ImageSpace::Loader {
       Runtime::MadviseFileForRange(
           madvise_size_limit, temp_map.Size(), temp_map.Begin(), temp_map.End(), image_filename);
 
+      // Outside of the zygote, leave the decompression to the first access of each block.
+      // The zygote would have to decompress everything before forking anyway.
+      if (is_compressed &&
+          runtime != nullptr &&
+          runtime->UseLazyImageDecompression() &&
+          !runtime->IsZygote() &&
+          LazyImageDecompressor::IsSupported()) {
+        std::string lazy_error_msg;
+        *lazy_decompressor = LazyImageDecompressor::Create(
+            image_header, &temp_map, map, image_filename, &lazy_error_msg);
+        if (*lazy_decompressor != nullptr) {
+          return map;
+        }
+        VLOG(image) << "Cannot decompress " << image_filename << " lazily: " << lazy_error_msg;
+      }
+
       if (is_compressed) {
         memcpy(map.Begin(), &image_header, sizeof(ImageHeader));
 
@@ -1062,13 +1083,16 @@ class ImageSpace::Loader {
         static constexpr size_t kMinBlocks = 2u;
         const bool use_parallel = pool != nullptr && image_header.GetBlockCount() >= kMinBlocks;
         bool failed_decompression = false;
+        const ArrayRef<const uint8_t> dictionary =
+            image_header.GetZstdDictionary(temp_map.Begin());
         for (const ImageHeader::Block& block : image_header.GetBlocks(temp_map.Begin())) {
           auto function = [&](Thread*) {
             const uint64_t start2 = NanoTime();
-            ScopedTrace trace("LZ4 decompress block");
+            ScopedTrace trace("Decompress image block");
             bool result = block.Decompress(/*out_ptr=*/map.Begin(),
                                            /*in_ptr=*/temp_map.Begin(),
-                                           error_msg);
+                                           error_msg,
+                                           dictionary);
             if (!result) {
               failed_decompression = true;
               if (error_msg != nullptr) {
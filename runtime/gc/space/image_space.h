@@ -34,6 +34,8 @@ class OatHeader;
 namespace gc {
 namespace space {
 
+class LazyImageDecompressor;
+
 // An image space is a space backed with a memory mapped image.
 class ImageSpace : public MemMapSpace {
  public:
@@ -180,6 +182,11 @@ class ImageSpace : public MemMapSpace {
     return *reinterpret_cast<ImageHeader*>(Begin());
   }
 
+  // Returns the lazy decompressor, or null if the image was not loaded lazily.
+  const LazyImageDecompressor* GetLazyDecompressor() const {
+    return lazy_decompressor_.get();
+  }
+
   // Actual filename where image was loaded from.
   // For example: /system/framework/arm64/boot.art
   const std::string GetImageFilename() const {
@@ -508,6 +515,9 @@ class ImageSpace : public MemMapSpace {
   const std::string image_location_;
   const std::vector<std::string> profile_files_;
 
+  // Decompresses the image blocks on first access if the image was loaded lazily.
+  std::unique_ptr<LazyImageDecompressor> lazy_decompressor_;
+
   friend class Space;
 
  private:
@@ -16,6 +16,9 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 #include "android-base/logging.h"
 #include "android-base/stringprintf.h"
 #include "android-base/strings.h"
@@ -24,6 +27,7 @@
 #include "class_linker.h"
 #include "dex/utf.h"
 #include "dexopt_test.h"
+#include "gc/space/lazy_image_decompressor.h"
 #include "intern_table-inl.h"
 #include "noop_compiler_callbacks.h"
 #include "oat/oat_file.h"
@@ -220,6 +224,140 @@ TEST_F(ImageSpaceTest, StringDeduplication) {
   EXPECT_FALSE(contains_test_string(app_image_space.get()));
 }
 
+class ImageSpaceLazyDecompressionTest : public ImageSpaceTest {
+ protected:
+  void SetUpRuntimeOptions(RuntimeOptions* options) override {
+    ImageSpaceTest::SetUpRuntimeOptions(options);
+    options->emplace_back("-Xlazy-image-decompression:true", nullptr);
+  }
+};
+
+TEST_F(ImageSpaceLazyDecompressionTest, FaultedAccesses) {
+  if (!LazyImageDecompressor::IsSupported()) {
+    GTEST_SKIP() << "userfaultfd is not supported";
+  }
+  const char* const kBaseName = "Extension1";
+
+  ScratchDir scratch;
+  const std::string& scratch_dir = scratch.GetPath();
+  std::string image_dir = scratch_dir + GetInstructionSetString(kRuntimeISA);
+  int mkdir_result = mkdir(image_dir.c_str(), 0700);
+  ASSERT_EQ(0, mkdir_result);
+
+  std::vector<std::string> bcp = GetLibCoreDexFileNames();
+  std::vector<std::string> bcp_locations = GetLibCoreDexLocations();
+  std::string base_bcp_string = android::base::Join(bcp, ':');
+  std::string base_bcp_locations_string = android::base::Join(bcp_locations, ':');
+  std::string base_image_location = GetImageLocation();
+
+  // Compile a zstd compressed extension with small, page aligned blocks, so that the
+  // accesses below fault on many separately decompressed parts of the image.
+  std::string jar_name = GetTestDexFileName(kBaseName);
+  ArrayRef<const std::string> dex_files(&jar_name, /*size=*/1u);
+  ScratchFile profile_file;
+  GenerateBootProfile(dex_files, profile_file.GetFile());
+  std::vector<std::string> extra_args = {
+      "--profile-file=" + profile_file.GetFilename(),
+      "--runtime-arg",
+      ART_FORMAT("-Xbootclasspath:{}:{}", base_bcp_string, jar_name),
+      "--runtime-arg",
+      ART_FORMAT("-Xbootclasspath-locations:{}:{}", base_bcp_locations_string, jar_name),
+      "--boot-image=" + base_image_location,
+      "--image-format=zstd",
+      "--max-image-block-size=16384",
+  };
+  std::string prefix = GetFilenameBase(base_image_location);
+  std::string error_msg;
+  bool success =
+      CompileBootImage(extra_args, ART_FORMAT("{}/{}", image_dir, prefix), dex_files, &error_msg);
+  ASSERT_TRUE(success) << error_msg;
+  bcp.push_back(jar_name);
+  bcp_locations.push_back(jar_name);
+  std::vector<std::string> full_image_locations = {
+      base_image_location, scratch_dir + prefix + '-' + GetFilenameBase(jar_name) + ".art"};
+
+  std::vector<std::unique_ptr<gc::space::ImageSpace>> boot_image_spaces;
+  MemMap extra_reservation;
+  auto load_extension = [&]() REQUIRES_SHARED(Locks::mutator_lock_) -> ImageSpace* {
+    boot_image_spaces.clear();
+    extra_reservation = MemMap::Invalid();
+    bool loaded = ImageSpace::LoadBootImage(
+        bcp,
+        bcp_locations,
+        /*boot_class_path_files=*/{},
+        /*boot_class_path_image_files=*/{},
+        /*boot_class_path_vdex_files=*/{},
+        /*boot_class_path_oat_files=*/{},
+        full_image_locations,
+        kRuntimeISA,
+        /*relocate=*/false,
+        /*executable=*/true,
+        /*extra_reservation_size=*/0u,
+        /*allow_in_memory_compilation=*/false,
+        Runtime::GetApexVersions(ArrayRef<const std::string>(bcp_locations)),
+        &boot_image_spaces,
+        &extra_reservation);
+    return (loaded && bcp.size() == boot_image_spaces.size()) ? boot_image_spaces.back().get()
+                                                               : nullptr;
+  };
+
+  ScopedObjectAccess soa(Thread::Current());
+  ImageSpace* space = load_extension();
+  ASSERT_TRUE(space != nullptr);
+  const LazyImageDecompressor* decompressor = space->GetLazyDecompressor();
+  if (decompressor == nullptr) {
+    GTEST_SKIP() << "Cannot register the image memory with userfaultfd";
+  }
+  ASSERT_GT(decompressor->GetBlockCount(), 1u);
+  // Read the size from the file so that the image memory is not touched before the copy.
+  std::unique_ptr<File> image_file(OS::OpenFileForReading(space->GetImageFilename().c_str()));
+  ASSERT_TRUE(image_file != nullptr);
+  ImageHeader file_header;
+  ASSERT_TRUE(image_file->PreadFully(&file_header, sizeof(file_header), /*offset=*/ 0u));
+  const size_t image_size = file_header.GetImageSize();
+
+  // Fault the blocks in order from user space. The faults are resolved by the handler.
+  std::vector<uint8_t> copy(image_size);
+  memcpy(copy.data(), space->Begin(), image_size);
+  EXPECT_NE(0u, decompressor->GetFaultedBlockCount());
+  EXPECT_EQ(0, memcmp(copy.data(), space->Begin(), image_size));
+
+  // Reload the image and fault its blocks from several threads at once, each thread
+  // starting at a different block.
+  space = load_extension();
+  ASSERT_TRUE(space != nullptr);
+  decompressor = space->GetLazyDecompressor();
+  ASSERT_TRUE(decompressor != nullptr);
+  static constexpr size_t kNumThreads = 4u;
+  const uint8_t* image_begin = space->Begin();
+  const size_t mapped_size = RoundUp(image_size, gPageSize);
+  const size_t num_pages = mapped_size / gPageSize;
+  std::atomic<bool> start(false);
+  std::vector<std::vector<uint8_t>> thread_copies(kNumThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      std::vector<uint8_t>& thread_copy = thread_copies[t];
+      thread_copy.resize(mapped_size);
+      while (!start.load(std::memory_order_acquire)) {}
+      for (size_t i = 0; i != num_pages; ++i) {
+        size_t page = (i + t * num_pages / kNumThreads) % num_pages;
+        memcpy(thread_copy.data() + page * gPageSize, image_begin + page * gPageSize, gPageSize);
+      }
+    });
+  }
+  start.store(true, std::memory_order_release);
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_NE(0u, decompressor->GetFaultedBlockCount());
+  EXPECT_LE(decompressor->GetFaultedBlockCount(), decompressor->GetBlockCount());
+  for (const std::vector<uint8_t>& thread_copy : thread_copies) {
+    EXPECT_EQ(0, memcmp(thread_copy.data(), image_begin, mapped_size));
+    EXPECT_EQ(0, memcmp(thread_copy.data(), copy.data(), image_size));
+  }
+}
+
 TEST_F(DexoptTest, ValidateOatFile) {
   std::string dex1 = GetScratchDir() + "/Dex1.jar";
   std::string multidex1 = GetScratchDir() + "/MultiDex1.jar";
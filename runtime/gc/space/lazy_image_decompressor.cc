@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "lazy_image_decompressor.h"
+
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+
+#include "android-base/stringprintf.h"
+#include "base/bit_utils.h"
+#include "base/logging.h"
+#include "base/systrace.h"
+#include "base/utils.h"
+#include "gc/collector/mark_compact.h"
+#include "runtime.h"
+
+#ifndef __BIONIC__
+#ifndef __NR_userfaultfd
+#if defined(__x86_64__)
+#define __NR_userfaultfd 323
+#elif defined(__i386__)
+#define __NR_userfaultfd 374
+#elif defined(__aarch64__)
+#define __NR_userfaultfd 282
+#elif defined(__arm__)
+#define __NR_userfaultfd 388
+#else
+#error "__NR_userfaultfd undefined"
+#endif
+#endif  // __NR_userfaultfd
+#endif  // __BIONIC__
+
+namespace art HIDDEN {
+namespace gc {
+namespace space {
+
+using android::base::StringPrintf;
+
+// All live decompressors, so that they can be completed before the process forks.
+static std::mutex gDecompressorsLock;
+static std::vector<LazyImageDecompressor*> gDecompressors;
+static std::once_flag gAtForkOnce;
+
+bool LazyImageDecompressor::IsSupported() {
+  static const bool supported = collector::KernelSupportsUffd();
+  return supported;
+}
+
+std::unique_ptr<LazyImageDecompressor> LazyImageDecompressor::Create(
+    const ImageHeader& image_header,
+    /*inout*/ MemMap* compressed_map,
+    const MemMap& image_map,
+    const char* image_filename,
+    /*out*/ std::string* error_msg) {
+  if (!IsSupported()) {
+    *error_msg = "userfaultfd is not supported";
+    return nullptr;
+  }
+  // Like the mark-compact collector, only handle faults taken in user mode, which is what
+  // unprivileged processes are allowed to.
+  int raw_fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY);
+  // On non-android devices we may not have the kernel patches that restrict
+  // userfaultfd to user mode. But that is not a security concern as we are
+  // on host. Therefore, attempt one more time without UFFD_USER_MODE_ONLY.
+  if (!kIsTargetAndroid && raw_fd == -1 && errno == EINVAL) {
+    raw_fd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+  }
+  if (raw_fd == -1) {
+    *error_msg = StringPrintf("userfaultfd failed: %s", strerror(errno));
+    return nullptr;
+  }
+  android::base::unique_fd uffd(raw_fd);
+  struct uffdio_api api = {.api = UFFD_API, .features = 0, .ioctls = 0};
+  if (ioctl(uffd.get(), UFFDIO_API, &api) != 0) {
+    *error_msg = StringPrintf("ioctl_userfaultfd: API: %s", strerror(errno));
+    return nullptr;
+  }
+  struct uffdio_register uffd_register;
+  uffd_register.range.start = reinterpret_cast<uintptr_t>(image_map.Begin());
+  uffd_register.range.len = image_map.Size();
+  uffd_register.mode = UFFDIO_REGISTER_MODE_MISSING;
+  if (ioctl(uffd.get(), UFFDIO_REGISTER, &uffd_register) != 0) {
+    *error_msg = StringPrintf("ioctl_userfaultfd: REGISTER: %s", strerror(errno));
+    return nullptr;
+  }
+  android::base::unique_fd stop_fd(eventfd(0, EFD_CLOEXEC));
+  if (stop_fd.get() == -1) {
+    *error_msg = StringPrintf("eventfd failed: %s", strerror(errno));
+    return nullptr;
+  }
+
+  std::unique_ptr<LazyImageDecompressor> decompressor(new LazyImageDecompressor(
+      image_header, std::move(*compressed_map), image_map, image_filename));
+  decompressor->uffd_ = std::move(uffd);
+  decompressor->stop_fd_ = std::move(stop_fd);
+  std::call_once(gAtForkOnce, []() {
+    CHECK_EQ(pthread_atfork(PrepareForFork, FinishFork, FinishFork), 0);
+  });
+  {
+    std::lock_guard<std::mutex> lock(gDecompressorsLock);
+    CHECK_PTHREAD_CALL(pthread_create,
+                       (&decompressor->handler_thread_, nullptr, &RunHandler, decompressor.get()),
+                       "lazy image decompressor");
+    decompressor->handler_running_ = true;
+    gDecompressors.push_back(decompressor.get());
+  }
+
+  Runtime* runtime = Runtime::Current();
+  if (runtime != nullptr) {
+    runtime->GetMetrics()->LazyImageDecompressionBlockCount()->Add(decompressor->block_count_);
+  }
+  VLOG(image) << "Decompressing " << decompressor->block_count_ << " blocks of "
+              << image_filename << " lazily in " << decompressor->groups_.size() << " groups";
+  return decompressor;
+}
+
+LazyImageDecompressor::LazyImageDecompressor(const ImageHeader& image_header,
+                                             MemMap&& compressed_map,
+                                             const MemMap& image_map,
+                                             const char* image_filename)
+    : image_filename_(image_filename),
+      compressed_map_(std::move(compressed_map)),
+      image_begin_(image_map.Begin()),
+      image_size_(image_map.Size()),
+      image_header_(image_header),
+      blocks_(image_header.GetBlocks(compressed_map_.Begin()).begin(),
+              image_header.GetBlocks(compressed_map_.Begin()).end()),
+      block_count_(blocks_.size()),
+      populated_group_count_(0u),
+      faulted_block_count_(0u),
+      handler_running_(false) {
+  DCHECK_ALIGNED_PARAM(image_size_, gPageSize);
+  // Group the blocks so that each group starts and ends on a page boundary. The first group
+  // also holds the image header and the last one extends to the end of the image memory.
+  size_t group_begin = 0u;
+  size_t blocks_begin = 0u;
+  for (size_t i = 0; i != blocks_.size(); ++i) {
+    size_t block_end = blocks_[i].GetImageOffset() + blocks_[i].GetImageSize();
+    DCHECK_LE(block_end, image_size_);
+    DCHECK(i == 0u || blocks_[i - 1].GetImageOffset() < blocks_[i].GetImageOffset());
+    bool is_last = (i + 1u == blocks_.size());
+    if (is_last || IsAlignedParam(block_end, gPageSize)) {
+      size_t group_end = is_last ? image_size_ : block_end;
+      groups_.push_back({group_begin, group_end, blocks_begin, i + 1u});
+      group_begin = group_end;
+      blocks_begin = i + 1u;
+    }
+  }
+  populated_.reset(new std::atomic<bool>[groups_.size()]);
+  for (size_t i = 0; i != groups_.size(); ++i) {
+    populated_[i].store(false, std::memory_order_relaxed);
+  }
+}
+
+LazyImageDecompressor::~LazyImageDecompressor() {
+  std::lock_guard<std::mutex> lock(gDecompressorsLock);
+  auto it = std::find(gDecompressors.begin(), gDecompressors.end(), this);
+  if (it != gDecompressors.end()) {
+    gDecompressors.erase(it);
+  }
+  StopHandler();
+  // Closing the userfaultfd unregisters the image memory.
+}
+
+void* LazyImageDecompressor::RunHandler(void* arg) {
+  reinterpret_cast<LazyImageDecompressor*>(arg)->HandleFaults();
+  return nullptr;
+}
+
+void LazyImageDecompressor::HandleFaults() {
+  while (populated_group_count_.load(std::memory_order_relaxed) != groups_.size()) {
+    struct pollfd fds[2] = {{uffd_.get(), POLLIN, 0}, {stop_fd_.get(), POLLIN, 0}};
+    int ret = TEMP_FAILURE_RETRY(poll(fds, arraysize(fds), /*timeout=*/ -1));
+    CHECK_GE(ret, 0) << "poll: " << strerror(errno);
+    if (fds[1].revents != 0) {
+      break;
+    }
+    struct uffd_msg msg;
+    ssize_t bytes = read(uffd_.get(), &msg, sizeof(msg));
+    if (bytes < 0) {
+      CHECK(errno == EAGAIN || errno == EINTR) << "read userfaultfd: " << strerror(errno);
+      continue;
+    }
+    CHECK_EQ(static_cast<size_t>(bytes), sizeof(msg));
+    CHECK_EQ(msg.event, UFFD_EVENT_PAGEFAULT);
+    uintptr_t address = static_cast<uintptr_t>(msg.arg.pagefault.address);
+    DCHECK_GE(address, reinterpret_cast<uintptr_t>(image_begin_));
+    PopulateGroup(FindGroup(address - reinterpret_cast<uintptr_t>(image_begin_)),
+                  /*faulted=*/ true);
+  }
+}
+
+void LazyImageDecompressor::StopHandler() {
+  if (!handler_running_) {
+    return;
+  }
+  uint64_t value = 1u;
+  CHECK_EQ(TEMP_FAILURE_RETRY(write(stop_fd_.get(), &value, sizeof(value))),
+           static_cast<ssize_t>(sizeof(value)));
+  CHECK_PTHREAD_CALL(pthread_join, (handler_thread_, nullptr), "lazy image decompressor");
+  handler_running_ = false;
+}
+
+size_t LazyImageDecompressor::FindGroup(size_t image_offset) const {
+  DCHECK_LT(image_offset, image_size_);
+  auto it = std::upper_bound(groups_.begin(),
+                             groups_.end(),
+                             image_offset,
+                             [](size_t offset, const BlockGroup& group) {
+                               return offset < group.image_end;
+                             });
+  DCHECK(it != groups_.end());
+  DCHECK_LE(it->image_begin, image_offset);
+  return static_cast<size_t>(std::distance(groups_.begin(), it));
+}
+
+void LazyImageDecompressor::PopulateGroup(size_t group_index, bool faulted) {
+  if (populated_[group_index].load(std::memory_order_acquire)) {
+    return;
+  }
+  ScopedTrace trace("Lazy image decompression");
+  const BlockGroup& group = groups_[group_index];
+  const size_t size = group.image_end - group.image_begin;
+  // UFFDIO_COPY needs a page aligned source, so decompress into a separate mapping.
+  std::string error_msg;
+  MemMap buffer = MemMap::MapAnonymous("lazy image decompression",
+                                       size,
+                                       PROT_READ | PROT_WRITE,
+                                       /*low_4gb=*/ false,
+                                       &error_msg);
+  CHECK(buffer.IsValid()) << error_msg;
+  if (group.image_begin == 0u) {
+    memcpy(buffer.Begin(), &image_header_, sizeof(ImageHeader));
+  }
+  // Blocks write at their image offset relative to `out_ptr`.
+  uint8_t* out_ptr = buffer.Begin() - group.image_begin;
+  for (size_t i = group.blocks_begin; i != group.blocks_end; ++i) {
+    // The image cannot be rejected anymore, so a corrupt block is fatal.
+    if (!blocks_[i].Decompress(out_ptr,
+                               compressed_map_.Begin(),
+                               &error_msg,
+                               image_header_.GetZstdDictionary(compressed_map_.Begin()))) {
+      LOG(FATAL) << "Failed to decompress image block of " << image_filename_ << ": "
+                 << error_msg;
+    }
+  }
+
+  size_t copied = 0u;
+  while (copied != size) {
+    struct uffdio_copy copy;
+    copy.dst = reinterpret_cast<uintptr_t>(image_begin_ + group.image_begin + copied);
+    copy.src = reinterpret_cast<uintptr_t>(buffer.Begin() + copied);
+    copy.len = size - copied;
+    copy.mode = 0;
+    copy.copy = 0;
+    if (ioctl(uffd_.get(), UFFDIO_COPY, &copy) == 0) {
+      break;
+    }
+    if (errno == EEXIST) {
+      // Another thread is installing the same group and finishes the rest of it.
+      break;
+    }
+    CHECK_EQ(errno, EAGAIN) << "ioctl_userfaultfd: COPY: " << strerror(errno);
+    if (copy.copy > 0) {
+      copied += static_cast<size_t>(copy.copy);
+    }
+  }
+
+  if (!populated_[group_index].exchange(true, std::memory_order_acq_rel)) {
+    populated_group_count_.fetch_add(1u, std::memory_order_relaxed);
+    if (faulted) {
+      size_t num_blocks = group.blocks_end - group.blocks_begin;
+      faulted_block_count_.fetch_add(num_blocks, std::memory_order_relaxed);
+      Runtime* runtime = Runtime::Current();
+      if (runtime != nullptr) {
+        runtime->GetMetrics()->LazyImageDecompressionFaultedBlockCount()->Add(num_blocks);
+      }
+    }
+  }
+}
+
+void LazyImageDecompressor::DecompressAll() {
+  for (size_t i = 0; i != groups_.size(); ++i) {
+    PopulateGroup(i, /*faulted=*/ false);
+  }
+  StopHandler();
+  VLOG(image) << "Lazily decompressed " << GetFaultedBlockCount() << " of " << block_count_
+              << " blocks of " << image_filename_ << " before completing the image";
+}
+
+void LazyImageDecompressor::PrepareForFork() {
+  // The lock is released in FinishFork() in both the parent and the child.
+  gDecompressorsLock.lock();
+  for (LazyImageDecompressor* decompressor : gDecompressors) {
+    decompressor->DecompressAll();
+  }
+  gDecompressors.clear();
+}
+
+void LazyImageDecompressor::FinishFork() {
+  gDecompressorsLock.unlock();
+}
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
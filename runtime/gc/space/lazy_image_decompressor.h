@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_GC_SPACE_LAZY_IMAGE_DECOMPRESSOR_H_
+#define ART_RUNTIME_GC_SPACE_LAZY_IMAGE_DECOMPRESSOR_H_
+
+#include <pthread.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "android-base/unique_fd.h"
+#include "base/macros.h"
+#include "base/mem_map.h"
+#include "oat/image.h"
+
+namespace art HIDDEN {
+namespace gc {
+namespace space {
+
+// Decompresses the blocks of a compressed image on first access instead of at load time.
+//
+// The anonymous memory reserved for the image is registered with userfaultfd in the
+// missing-page mode. A handler thread resolves each fault by decompressing the blocks
+// covering the faulting page and installing them with UFFDIO_COPY. Blocks are handled in
+// groups whose boundaries are page aligned, so that every page is installed exactly once.
+// The userfaultfd is created with UFFD_USER_MODE_ONLY, so only faults taken in user mode are
+// resolved. A system call accessing a page of the image that was not touched yet fails with
+// EFAULT instead, so image memory must be read from user space before passing it to the kernel.
+//
+// Userfaultfd registrations are not inherited across fork(), so all remaining blocks are
+// decompressed and the handler thread is stopped before the process forks.
+class LazyImageDecompressor {
+ public:
+  // Registers `image_map` for lazy decompression of the blocks described by `image_header`
+  // from `compressed_map`, which must contain the image file from offset 0. The image map
+  // must not have been touched yet. On success, takes ownership of `compressed_map`. Returns
+  // null on failure, in which case the caller should decompress the image eagerly.
+  static std::unique_ptr<LazyImageDecompressor> Create(const ImageHeader& image_header,
+                                                       /*inout*/ MemMap* compressed_map,
+                                                       const MemMap& image_map,
+                                                       const char* image_filename,
+                                                       /*out*/ std::string* error_msg);
+
+  // Returns whether lazy decompression can be used in this process.
+  static bool IsSupported();
+
+  ~LazyImageDecompressor();
+
+  size_t GetBlockCount() const {
+    return block_count_;
+  }
+
+  // The number of blocks decompressed because of a page fault.
+  size_t GetFaultedBlockCount() const {
+    return faulted_block_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // A range of blocks whose combined image range starts and ends on page boundaries.
+  struct BlockGroup {
+    size_t image_begin;  // Page aligned offset in the image.
+    size_t image_end;    // Page aligned offset in the image.
+    size_t blocks_begin;
+    size_t blocks_end;
+  };
+
+  LazyImageDecompressor(const ImageHeader& image_header,
+                        MemMap&& compressed_map,
+                        const MemMap& image_map,
+                        const char* image_filename);
+
+  static void* RunHandler(void* arg);
+  void HandleFaults();
+  void StopHandler();
+
+  size_t FindGroup(size_t image_offset) const;
+  // Decompress and install the group, unless it was already installed.
+  void PopulateGroup(size_t group_index, bool faulted);
+  // Decompress all blocks that have not been accessed yet and stop the handler thread.
+  void DecompressAll();
+
+  static void PrepareForFork();
+  static void FinishFork();
+
+  const std::string image_filename_;
+  const MemMap compressed_map_;
+  uint8_t* const image_begin_;
+  const size_t image_size_;
+  // A copy of the image header; the first page of the image is populated from it.
+  const ImageHeader image_header_;
+  const std::vector<ImageHeader::Block> blocks_;
+  const size_t block_count_;
+  std::vector<BlockGroup> groups_;
+  std::unique_ptr<std::atomic<bool>[]> populated_;
+  std::atomic<size_t> populated_group_count_;
+  std::atomic<size_t> faulted_block_count_;
+
+  android::base::unique_fd uffd_;
+  // Written to stop the handler thread.
+  android::base::unique_fd stop_fd_;
+  pthread_t handler_thread_;
+  bool handler_running_;
+
+  DISALLOW_COPY_AND_ASSIGN(LazyImageDecompressor);
+};
+
+}  // namespace space
+}  // namespace gc
+}  // namespace art
+
+#endif  // ART_RUNTIME_GC_SPACE_LAZY_IMAGE_DECOMPRESSOR_H_
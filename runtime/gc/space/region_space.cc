@@ -190,10 +190,10 @@ void RegionSpace::Region::SetAsUnevacFromSpace(bool clear_live_bytes) {
   type_ = RegionType::kRegionTypeUnevacFromSpace;
   if (IsNewlyAllocated()) {
     // A newly allocated region set as unevac from-space must be
-    // a large or large tail region.
-    DCHECK(IsLarge() || IsLargeTail()) << static_cast<uint>(state_);
-    // Always clear the live bytes of a newly allocated (large or
-    // large tail) region.
+    // a large or large tail region, or a pinned region.
+    DCHECK(IsLarge() || IsLargeTail() || IsPinned()) << static_cast<uint>(state_);
+    // Always clear the live bytes of a newly allocated (large, large
+    // tail or pinned) region.
     clear_live_bytes = true;
     // Clear the "newly allocated" status here, as we do not want the
     // GC to see it when encountering (and processing) references in the
@@ -232,6 +232,13 @@ inline bool RegionSpace::Region::ShouldBeEvacuated(EvacMode evac_mode) {
     // is live, we would just be moving around region-aligned memory.
     return false;
   }
+  if (UNLIKELY(IsPinned())) {
+    // A JNI critical section holds a pointer into the region, so its objects must stay in place.
+    // Pinning newly allocated regions is only possible without generational CC, which cannot
+    // handle them as unevac regions.
+    DCHECK(!is_newly_allocated_ || !GetUseGenerationalCC());
+    return false;
+  }
   if (UNLIKELY(evac_mode == kEvacModeForceAll)) {
     return true;
   }
@@ -393,6 +400,32 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table,
   evac_region_ = &full_region_;
 }
 
+bool RegionSpace::PinObject(mirror::Object* ref) {
+  DCHECK(HasAddress(ref));
+  // The caller is runnable, so the region cannot change type until it is suspended for the next
+  // flip, which then sees the pin.
+  Region* r = RefToRegionUnlocked(ref);
+  DCHECK(r->IsInToSpace() || r->IsInUnevacFromSpace()) << r->Type();
+  if (use_generational_cc_ && r->IsNewlyAllocated()) {
+    return false;
+  }
+  r->pin_count_.fetch_add(1u, std::memory_order_relaxed);
+  return true;
+}
+
+bool RegionSpace::UnpinObject(mirror::Object* ref) {
+  DCHECK(HasAddress(ref));
+  // A region that could not be pinned stays newly allocated while its objects are in use, as the
+  // caller blocked the flip instead, so it cannot be pinned by another thread in the meantime.
+  Region* r = RefToRegionUnlocked(ref);
+  if (!r->IsPinned()) {
+    return false;
+  }
+  uint32_t old_pin_count = r->pin_count_.fetch_sub(1u, std::memory_order_relaxed);
+  DCHECK_NE(old_pin_count, 0u);
+  return true;
+}
+
 static void ZeroAndProtectRegion(uint8_t* begin, uint8_t* end, bool release_eagerly) {
   ZeroMemory(begin, end - begin, release_eagerly);
   if (kProtectClearedRegions) {
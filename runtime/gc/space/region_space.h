@@ -280,6 +280,15 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     return false;
   }
 
+  // Pin the region containing `ref` so that it is not evacuated until UnpinObject() is called,
+  // letting JNI critical sections use the object without blocking the GC. Returns false if the
+  // region cannot be pinned: with generational CC, newly allocated regions are always evacuated.
+  // Must be called while runnable, with a to-space reference.
+  bool PinObject(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Unpin the region containing `ref`. Returns false if the region is not pinned.
+  bool UnpinObject(mirror::Object* ref) REQUIRES_SHARED(Locks::mutator_lock_);
+
   // If `ref` is in the region space, return the type of its region;
   // otherwise, return `RegionType::kRegionTypeNone`.
   RegionType GetRegionType(mirror::Object* ref) {
@@ -404,7 +413,8 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
           is_newly_allocated_(false),
           is_a_tlab_(false),
           state_(RegionState::kRegionStateAllocated),
-          type_(RegionType::kRegionTypeToSpace) {}
+          type_(RegionType::kRegionTypeToSpace),
+          pin_count_(0) {}
 
     void Init(size_t idx, uint8_t* begin, uint8_t* end) {
       idx_ = idx;
@@ -419,6 +429,7 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       is_newly_allocated_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
+      pin_count_.store(0, std::memory_order_relaxed);
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -467,6 +478,11 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
       is_newly_allocated_ = true;
     }
 
+    // Whether a JNI critical section holds a pointer into the region.
+    bool IsPinned() const {
+      return pin_count_.load(std::memory_order_relaxed) != 0u;
+    }
+
     // Non-large, non-large-tail allocated.
     bool IsAllocated() const {
       return state_ == RegionState::kRegionStateAllocated;
@@ -641,6 +657,10 @@ class RegionSpace final : public ContinuousMemMapAllocSpace {
     bool is_a_tlab_;                    // True if it's a tlab.
     RegionState state_;                 // The region state (see RegionState).
     RegionType type_;                   // The region type (see RegionType).
+    // Number of JNI critical sections holding a pointer into the region. Pinned regions are not
+    // evacuated. Only changed by runnable threads, and only read during the flip pause by
+    // RegionSpace::SetFromSpace, so relaxed accesses are sufficient.
+    Atomic<uint32_t> pin_count_;
 
     friend class RegionSpace;
   };
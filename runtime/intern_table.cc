@@ -40,6 +40,8 @@ namespace art HIDDEN {
 InternTable::InternTable()
     : log_new_roots_(false),
       weak_intern_condition_("New intern condition", *Locks::intern_table_lock_),
+      strong_interns_(/*lock_free_lookups=*/ true),
+      weak_interns_(/*lock_free_lookups=*/ false),
       weak_root_state_(gc::kWeakRootStateNormal) {
 }
 
@@ -111,20 +113,26 @@ ObjPtr<mirror::String> InternTable::LookupWeak(Thread* self, ObjPtr<mirror::Stri
   return weak_interns_.Find(s, hash);
 }
 
-ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self, ObjPtr<mirror::String> s) {
+ObjPtr<mirror::String> InternTable::LookupStrong([[maybe_unused]] Thread* self,
+                                                 ObjPtr<mirror::String> s) {
   DCHECK(s != nullptr);
   // `String::GetHashCode()` ensures that the stored hash is calculated.
   uint32_t hash = static_cast<uint32_t>(s->GetHashCode());
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(s, hash);
+  return FindStrongWithoutLock(GcRoot<mirror::String>(s), hash).first;
 }
 
-ObjPtr<mirror::String> InternTable::LookupStrong(Thread* self,
+ObjPtr<mirror::String> InternTable::LookupStrong([[maybe_unused]] Thread* self,
                                                  uint32_t utf16_length,
                                                  const char* utf8_data) {
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
-  MutexLock mu(self, *Locks::intern_table_lock_);
-  return strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
+  return FindStrongWithoutLock(Utf8String(utf16_length, utf8_data), hash).first;
+}
+
+// NO_THREAD_SAFETY_ANALYSIS: The strong table supports lookups without the lock.
+template <typename Key>
+inline std::pair<ObjPtr<mirror::String>, size_t> InternTable::FindStrongWithoutLock(
+    const Key& key, uint32_t hash) NO_THREAD_SAFETY_ANALYSIS {
+  return strong_interns_.FindWithoutLock(key, hash);
 }
 
 ObjPtr<mirror::String> InternTable::LookupWeakLocked(ObjPtr<mirror::String> s) {
@@ -207,6 +215,15 @@ ObjPtr<mirror::String> InternTable::Insert(ObjPtr<mirror::String> s,
   DCHECK_EQ(hash, static_cast<uint32_t>(s->GetStoredHashCode()));
   DCHECK_IMPLIES(hash == 0u, s->ComputeHashCode() == 0);
   Thread* const self = Thread::Current();
+  // Most strong interning finds a string that is already strongly interned, check without
+  // the lock first. This is valid even while weak roots are not accessible.
+  {
+    auto [strong, num_searched] = FindStrongWithoutLock(GcRoot<mirror::String>(s), hash);
+    if (strong != nullptr) {
+      return strong;
+    }
+    num_searched_strong_frozen_tables = std::max(num_searched_strong_frozen_tables, num_searched);
+  }
   MutexLock mu(self, *Locks::intern_table_lock_);
   if (kDebugLocking) {
     Locks::mutator_lock_->AssertSharedHeld(self);
@@ -254,15 +271,9 @@ ObjPtr<mirror::String> InternTable::InternStrong(uint32_t utf16_length, const ch
   DCHECK(utf8_data != nullptr);
   uint32_t hash = Utf8String::Hash(utf16_length, utf8_data);
   Thread* self = Thread::Current();
-  ObjPtr<mirror::String> s;
-  size_t num_searched_strong_frozen_tables;
-  {
-    // Try to avoid allocation. If we need to allocate, release the mutex before the allocation.
-    MutexLock mu(self, *Locks::intern_table_lock_);
-    DCHECK(!strong_interns_.tables_.empty());
-    num_searched_strong_frozen_tables = strong_interns_.tables_.size() - 1u;
-    s = strong_interns_.Find(Utf8String(utf16_length, utf8_data), hash);
-  }
+  // Try to avoid allocation. This does not need the lock, see `Table::FindWithoutLock()`.
+  auto [s, num_searched_strong_frozen_tables] =
+      FindStrongWithoutLock(Utf8String(utf16_length, utf8_data), hash);
   if (s != nullptr) {
     return s;
   }
@@ -319,6 +330,11 @@ void InternTable::SweepInternTableWeaks(IsMarkedVisitor* visitor) {
   weak_interns_.SweepWeaks(visitor);
 }
 
+void InternTable::FreeRetiredStrongTables() {
+  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
+  strong_interns_.FreeRetiredTables();
+}
+
 void InternTable::Table::Remove(ObjPtr<mirror::String> s, uint32_t hash) {
   // Note: We can remove weak interns even from frozen tables when promoting to strong interns.
   // We can remove strong interns only for a transaction rollback.
@@ -337,7 +353,7 @@ ObjPtr<mirror::String> InternTable::Table::Find(ObjPtr<mirror::String> s,
                                                 uint32_t hash,
                                                 size_t num_searched_frozen_tables) {
   Locks::intern_table_lock_->AssertHeld(Thread::Current());
-  auto mid = tables_.begin() + num_searched_frozen_tables;
+  auto mid = std::next(tables_.begin(), num_searched_frozen_tables);
   for (Table::InternalTable& table : MakeIterationRange(tables_.begin(), mid)) {
     DCHECK(table.set_.FindWithHash(GcRoot<mirror::String>(s), hash) == table.set_.end());
   }
@@ -366,6 +382,60 @@ ObjPtr<mirror::String> InternTable::Table::Find(const Utf8String& string, uint32
   return nullptr;
 }
 
+template <typename Key>
+FLATTEN
+std::pair<ObjPtr<mirror::String>, size_t> InternTable::Table::FindWithoutLock(const Key& key,
+                                                                               uint32_t hash) {
+  DCHECK(lock_free_lookups_);
+  // The published tables are never reallocated, and they are not deleted before the next
+  // pause, which waits for this lookup holding the mutator lock. A string inserted
+  // concurrently may or may not be found, as if the lookup ran before or after the
+  // insertion under the lock. Frozen tables are never inserted into, so the caller may skip
+  // the frozen tables searched here when searching again under the lock.
+  const std::vector<const InternalTable*>* lookup_tables =
+      lookup_tables_.load(std::memory_order_acquire);
+  for (const InternalTable* table : *lookup_tables) {
+    auto it = table->set_.FindWithHash(key, hash);
+    if (it != table->set_.end()) {
+      return {it->Read(), 0u};
+    }
+  }
+  DCHECK(!lookup_tables->empty());
+  return {nullptr, lookup_tables->size() - 1u};
+}
+
+void InternTable::Table::PublishLookupTables() {
+  if (!lock_free_lookups_) {
+    return;
+  }
+  // Search from the last table, assuming that apps shall search for their own
+  // strings more often than for boot image strings.
+  std::vector<const InternalTable*>& lookup_tables = published_lookup_tables_.emplace_back();
+  lookup_tables.reserve(tables_.size());
+  for (const InternalTable& table : ReverseRange(tables_)) {
+    lookup_tables.push_back(&table);
+  }
+  // Pairs with the acquire load in `FindWithoutLock()`, which must see the tables fully
+  // constructed.
+  lookup_tables_.store(&lookup_tables, std::memory_order_release);
+}
+
+void InternTable::Table::FreeRetiredTables() {
+  if (!lock_free_lookups_) {
+    return;
+  }
+  // Lookups run with the mutator lock held, so the GC pause since the last call waited for any
+  // lookup that could have loaded the tables and lists retired before that call.
+  releasable_tables_.clear();
+  DCHECK_LT(releasable_lookup_tables_count_, published_lookup_tables_.size());
+  published_lookup_tables_.erase(
+      published_lookup_tables_.begin(),
+      std::next(published_lookup_tables_.begin(), releasable_lookup_tables_count_));
+  // The ones retired since then may still be in use until the next pause.
+  releasable_tables_.splice(releasable_tables_.end(), retired_tables_);
+  releasable_lookup_tables_count_ = published_lookup_tables_.size() - 1u;
+}
+
 void InternTable::Table::AddNewTable() {
   // Propagate the min/max load factor from the old active set.
   DCHECK(!tables_.empty());
@@ -373,13 +443,40 @@ void InternTable::Table::AddNewTable() {
   InternalTable new_table;
   new_table.set_.SetLoadFactor(last_set.GetMinLoadFactor(), last_set.GetMaxLoadFactor());
   tables_.push_back(std::move(new_table));
+  PublishLookupTables();
 }
 
 void InternTable::Table::Insert(ObjPtr<mirror::String> s, uint32_t hash) {
   // Always insert the last table, the image tables are before and we avoid inserting into these
   // to prevent dirty pages.
   DCHECK(!tables_.empty());
-  tables_.back().set_.PutWithHash(GcRoot<mirror::String>(s), hash);
+  UnorderedSet& active_set = tables_.back().set_;
+  if (!lock_free_lookups_) {
+    active_set.PutWithHash(GcRoot<mirror::String>(s), hash);
+  } else if (active_set.size() >= active_set.ElementsUntilExpand()) {
+    // Inserting would reallocate the storage of the active set under concurrent lookups.
+    // Grow a copy instead, publish it and retire the old table. Size the copy to the minimum
+    // load factor, like `HashSet<>` expands.
+    double min_load_factor = active_set.GetMinLoadFactor();
+    double max_load_factor = active_set.GetMaxLoadFactor();
+    InternalTable new_table;
+    new_table.set_.SetLoadFactor(min_load_factor, max_load_factor);
+    new_table.set_.reserve(
+        static_cast<size_t>(active_set.size() * max_load_factor / min_load_factor));
+    for (const GcRoot<mirror::String>& root : active_set) {
+      new_table.set_.Put(root);
+    }
+    new_table.set_.PutWithHash(GcRoot<mirror::String>(s), hash);
+    retired_tables_.splice(retired_tables_.end(), tables_, std::prev(tables_.end()));
+    tables_.push_back(std::move(new_table));
+    PublishLookupTables();
+  } else {
+    // Make the string data visible to lookups before the string, like the lock release did.
+    std::atomic_thread_fence(std::memory_order_release);
+    size_t num_buckets = active_set.NumBuckets();
+    active_set.PutWithHash(GcRoot<mirror::String>(s), hash);
+    DCHECK_EQ(num_buckets, active_set.NumBuckets());
+  }
 }
 
 void InternTable::Table::VisitRoots(RootVisitor* visitor) {
@@ -437,12 +534,17 @@ void InternTable::ChangeWeakRootStateLocked(gc::WeakRootState new_state) {
   }
 }
 
-InternTable::Table::Table() {
+InternTable::Table::Table(bool lock_free_lookups)
+    : lock_free_lookups_(lock_free_lookups),
+      lookup_tables_(nullptr),
+      releasable_lookup_tables_count_(0u) {
   Runtime* const runtime = Runtime::Current();
   InternalTable initial_table;
   initial_table.set_.SetLoadFactor(runtime->GetHashTableMinLoadFactor(),
                                    runtime->GetHashTableMaxLoadFactor());
+  MutexLock mu(Thread::Current(), *Locks::intern_table_lock_);
   tables_.push_back(std::move(initial_table));
+  PublishLookupTables();
 }
 
 }  // namespace art
@@ -17,6 +17,11 @@
 #ifndef ART_RUNTIME_INTERN_TABLE_H_
 #define ART_RUNTIME_INTERN_TABLE_H_
 
+#include <atomic>
+#include <list>
+#include <utility>
+#include <vector>
+
 #include "base/dchecked_vector.h"
 #include "base/gc_visited_arena_pool.h"
 #include "base/hash_set.h"
@@ -55,6 +60,9 @@ class Transaction;
  * String.intern. Some code (XML parsers being a prime example) relies on being able to intern
  * arbitrarily many strings for the duration of a parse without permanently increasing the memory
  * footprint.
+ *
+ * Lookups in the strong table do not take `Locks::intern_table_lock_`, so that threads interning
+ * strings which are already strongly interned, such as string literals, do not contend.
  */
 class InternTable {
  public:
@@ -142,6 +150,10 @@ class InternTable {
   void SweepInternTableWeaks(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_)
       REQUIRES(!Locks::intern_table_lock_);
 
+  // Free the strong tables and lookup lists that were retired before the previous call. Called
+  // after each GC, so that the GC pause in between guarantees that no lookup still reads them.
+  void FreeRetiredStrongTables() REQUIRES(!Locks::intern_table_lock_);
+
   // Lookup a strong intern, returns null if not found.
   ObjPtr<mirror::String> LookupStrong(Thread* self, ObjPtr<mirror::String> s)
       REQUIRES(!Locks::intern_table_lock_)
@@ -236,13 +248,19 @@ class InternTable {
       ART_FRIEND_TEST(InternTableTest, CrossHash);
     };
 
-    Table();
+    explicit Table(bool lock_free_lookups);
     ObjPtr<mirror::String> Find(ObjPtr<mirror::String> s,
                                 uint32_t hash,
                                 size_t num_searched_frozen_tables = 0u)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     ObjPtr<mirror::String> Find(const Utf8String& string, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
+    // Find without holding the lock, only for tables with lock-free lookups. Tables that are
+    // inserted into concurrently may or may not be searched. Returns the string, if found, and
+    // the number of frozen tables searched.
+    template <typename Key>
+    std::pair<ObjPtr<mirror::String>, size_t> FindWithoutLock(const Key& key, uint32_t hash)
+        REQUIRES_SHARED(Locks::mutator_lock_);
     void Insert(ObjPtr<mirror::String> s, uint32_t hash)
         REQUIRES_SHARED(Locks::mutator_lock_) REQUIRES(Locks::intern_table_lock_);
     void Remove(ObjPtr<mirror::String> s, uint32_t hash)
@@ -270,9 +288,33 @@ class InternTable {
     void AddInternStrings(UnorderedSet&& intern_strings, bool is_boot_image)
         REQUIRES(Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+    // Publish the current `tables_` for lock-free lookups, in lookup order.
+    void PublishLookupTables() REQUIRES(Locks::intern_table_lock_);
+
+    // See `InternTable::FreeRetiredStrongTables()`.
+    void FreeRetiredTables() REQUIRES(Locks::intern_table_lock_);
+
     // We call AddNewTable when we create the zygote to reduce private dirty pages caused by
     // modifying the zygote intern table. The back of table is modified when strings are interned.
-    dchecked_vector<InternalTable> tables_;
+    // The tables are never moved, so that lock-free lookups can keep using them.
+    std::list<InternalTable> tables_;
+
+    // With lock-free lookups, the tables published in `lookup_tables_` are read without the
+    // lock. The storage of a published table is never reallocated: when the last table needs
+    // to grow, it is copied into a larger table which replaces it in `tables_`, and the old table
+    // is moved to `retired_tables_`. Lookups that started earlier may still read retired tables
+    // and old published lists. Lookups hold the mutator lock, so these are freed by
+    // `FreeRetiredTables()` once a pause has passed since their retirement. The weak table does
+    // not use lock-free lookups, since its strings may only be read while weak roots are
+    // accessible and are removed by sweeping.
+    const bool lock_free_lookups_;
+    std::atomic<const std::vector<const InternalTable*>*> lookup_tables_;
+    std::list<std::vector<const InternalTable*>> published_lookup_tables_;
+    std::list<InternalTable> retired_tables_;
+    // Tables and the number of leading `published_lookup_tables_` that were retired before the
+    // last `FreeRetiredTables()` call, freed by the next one.
+    std::list<InternalTable> releasable_tables_;
+    size_t releasable_lookup_tables_count_;
 
     friend class InternTable;
     friend class linker::ImageWriter;
@@ -286,6 +328,12 @@ class InternTable {
                                 size_t num_searched_strong_frozen_tables = 0u)
       REQUIRES(!Locks::intern_table_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Look up a strong intern without the lock. Returns the string, if found, and the number
+  // of frozen strong tables searched.
+  template <typename Key>
+  std::pair<ObjPtr<mirror::String>, size_t> FindStrongWithoutLock(const Key& key, uint32_t hash)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Add a table from memory to the strong interns.
   template <typename Visitor>
   size_t AddTableFromMemory(const uint8_t* ptr, const Visitor& visitor, bool is_boot_image)
@@ -16,6 +16,7 @@
 
 #include "intern_table-inl.h"
 
+#include "base/atomic.h"
 #include "base/hash_set.h"
 #include "common_runtime_test.h"
 #include "dex/utf.h"
@@ -23,7 +24,9 @@
 #include "handle_scope-inl.h"
 #include "mirror/object.h"
 #include "mirror/string.h"
+#include "runtime.h"
 #include "scoped_thread_state_change-inl.h"
+#include "thread_pool.h"
 
 namespace art HIDDEN {
 
@@ -32,6 +35,48 @@ class InternTableTest : public CommonRuntimeTest {
   InternTableTest() {
     use_boot_image_ = true;  // Make the Runtime creation cheaper.
   }
+
+  static std::vector<std::string> MakeStrings(const char* prefix, size_t count) {
+    std::vector<std::string> strings;
+    strings.reserve(count);
+    for (size_t i = 0; i != count; ++i) {
+      strings.push_back(prefix + std::to_string(i));
+    }
+    return strings;
+  }
+};
+
+// Interns ASCII strings in the runtime intern table, so that the GC keeps them alive, and checks
+// that a lookup finds the interned string.
+class InternStrongTask : public Task {
+ public:
+  InternStrongTask(const std::vector<std::string>* strings, size_t rounds, AtomicInteger* failures)
+      : strings_(strings), rounds_(rounds), failures_(failures) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    InternTable* intern_table = Runtime::Current()->GetInternTable();
+    for (size_t i = 0; i != rounds_; ++i) {
+      for (const std::string& string : *strings_) {
+        StackHandleScope<1> hs(self);
+        Handle<mirror::String> interned =
+            hs.NewHandle(intern_table->InternStrong(string.length(), string.c_str()));
+        if (interned == nullptr ||
+            intern_table->LookupStrong(self, string.length(), string.c_str()) != interned.Get()) {
+          ++*failures_;
+        }
+      }
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::vector<std::string>* const strings_;
+  const size_t rounds_;
+  AtomicInteger* const failures_;
 };
 
 TEST_F(InternTableTest, Intern) {
@@ -263,4 +308,69 @@ TEST_F(InternTableTest, InternStrongFrozenWeak) {
   ASSERT_TRUE(strong_foo == foo.Get());
 }
 
+TEST_F(InternTableTest, ConcurrentInternStrong) {
+  static constexpr size_t kNumThreads = 4;
+  std::vector<std::string> strings = MakeStrings("InternTableTest.ConcurrentInternStrong.", 4096);
+  InternTable* intern_table = Runtime::Current()->GetInternTable();
+  size_t old_strong_size = intern_table->StrongSize();
+
+  // All threads intern the same new strings, with the table growing under them.
+  Thread* self = Thread::Current();
+  AtomicInteger failures(0);
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Intern table test thread pool", kNumThreads));
+  for (size_t i = 0; i != kNumThreads; ++i) {
+    thread_pool->AddTask(self, new InternStrongTask(&strings, /*rounds=*/ 1u, &failures));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  EXPECT_EQ(0, failures.load());
+  // Each string was interned exactly once.
+  EXPECT_EQ(old_strong_size + strings.size(), intern_table->StrongSize());
+}
+
+// Re-intern existing strings while other strings are interned and the table grows. Every
+// thread must get the existing intern, never a duplicate, and the retired tables can be freed
+// once no lookup is running.
+TEST_F(InternTableTest, ConcurrentInternExistingStrong) {
+  static constexpr size_t kNumThreads = 4;
+  std::vector<std::string> existing =
+      MakeStrings("InternTableTest.ConcurrentInternExistingStrong.Existing.", 1024);
+  std::vector<std::string> added =
+      MakeStrings("InternTableTest.ConcurrentInternExistingStrong.Added.", 8192);
+  InternTable* intern_table = Runtime::Current()->GetInternTable();
+  Thread* self = Thread::Current();
+  AtomicInteger failures(0);
+  {
+    InternStrongTask task(&existing, /*rounds=*/ 1u, &failures);
+    task.Run(self);
+    ASSERT_EQ(0, failures.load());
+  }
+  size_t old_strong_size = intern_table->StrongSize();
+
+  std::unique_ptr<ThreadPool> thread_pool(
+      ThreadPool::Create("Intern table test thread pool", kNumThreads + 1));
+  thread_pool->AddTask(self, new InternStrongTask(&added, /*rounds=*/ 1u, &failures));
+  for (size_t i = 0; i != kNumThreads; ++i) {
+    thread_pool->AddTask(self, new InternStrongTask(&existing, /*rounds=*/ 10u, &failures));
+  }
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  EXPECT_EQ(0, failures.load());
+  // Only the added strings were inserted.
+  EXPECT_EQ(old_strong_size + added.size(), intern_table->StrongSize());
+
+  // Nothing is looking up, so free the retired tables as two GCs would, and check that all the
+  // strings are still found.
+  intern_table->FreeRetiredStrongTables();
+  intern_table->FreeRetiredStrongTables();
+  ScopedObjectAccess soa(self);
+  for (const std::vector<std::string>* strings : {&existing, &added}) {
+    for (const std::string& string : *strings) {
+      EXPECT_TRUE(intern_table->LookupStrong(self, string.length(), string.c_str()) != nullptr)
+          << string;
+    }
+  }
+}
+
 }  // namespace art
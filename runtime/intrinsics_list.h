@@ -181,6 +181,14 @@
   V(SystemArrayCopyChar, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/lang/System;", "arraycopy", "([CI[CII)V") \
   V(SystemArrayCopyInt, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/lang/System;", "arraycopy", "([II[III)V") \
   V(SystemArrayCopy, kStatic, kNeedsEnvironment, kAllSideEffects, kCanThrow, "Ljava/lang/System;", "arraycopy", "(Ljava/lang/Object;ILjava/lang/Object;II)V") \
+  V(ArraysEqualsByte, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "equals", "([B[B)Z") \
+  V(ArraysEqualsChar, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "equals", "([C[C)Z") \
+  V(ArraysEqualsInt, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "equals", "([I[I)Z") \
+  V(ArraysMismatchByte, kStatic, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/util/Arrays;", "mismatch", "([B[B)I") \
+  V(ArraysHashCodeByte, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "hashCode", "([B)I") \
+  V(ArraysHashCodeInt, kStatic, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/util/Arrays;", "hashCode", "([I)I") \
+  V(ArraysFillByte, kStatic, kNeedsEnvironment, kWriteSideEffects, kCanThrow, "Ljava/util/Arrays;", "fill", "([BB)V") \
+  V(ArraysFillInt, kStatic, kNeedsEnvironment, kWriteSideEffects, kCanThrow, "Ljava/util/Arrays;", "fill", "([II)V") \
   V(ThreadCurrentThread, kStatic, kNeedsEnvironment, kNoSideEffects, kNoThrow, "Ljava/lang/Thread;", "currentThread", "()Ljava/lang/Thread;") \
   V(MemoryPeekByte, kStatic, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Llibcore/io/Memory;", "peekByte", "(J)B") \
   V(MemoryPeekIntNative, kStatic, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Llibcore/io/Memory;", "peekIntNative", "(J)I") \
@@ -204,6 +212,7 @@
   V(FP16Max, kStatic, kNeedsEnvironment, kNoSideEffects, kNoThrow, "Llibcore/util/FP16;", "max", "(SS)S") \
   V(StringCompareTo, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "compareTo", "(Ljava/lang/String;)I") \
   V(StringEquals, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "equals", "(Ljava/lang/Object;)Z") \
+  V(StringHashCode, kVirtual, kNeedsEnvironment, kAllSideEffects, kNoThrow, "Ljava/lang/String;", "hashCode", "()I") \
   V(StringGetCharsNoCheck, kVirtual, kNeedsEnvironment, kReadSideEffects, kCanThrow, "Ljava/lang/String;", "getCharsNoCheck", "(II[CI)V") \
   V(StringIndexOf, kVirtual, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/lang/String;", "indexOf", "(I)I") \
   V(StringIndexOfAfter, kVirtual, kNeedsEnvironment, kReadSideEffects, kNoThrow, "Ljava/lang/String;", "indexOf", "(II)I") \
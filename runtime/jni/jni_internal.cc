@@ -2174,7 +2174,9 @@ class JNI {
       }
       return chars;
     } else {
-      if (heap->IsMovableObject(s)) {
+      // The CC collector can leave the string in place if its region is pinned. Otherwise block
+      // moving GC, or the thread flip of the CC and CMC collectors.
+      if (heap->IsMovableObject(s) && !heap->PinObject(s)) {
         StackHandleScope<1> hs(soa.Self());
         HandleWrapperObjPtr<mirror::String> h(hs.NewHandleWrapper(&s));
         if (!gUseReadBarrier && !gUseUserfaultfd) {
@@ -2202,7 +2204,7 @@ class JNI {
     ScopedObjectAccess soa(env);
     gc::Heap* heap = Runtime::Current()->GetHeap();
     ObjPtr<mirror::String> s = soa.Decode<mirror::String>(java_string);
-    if (!s->IsCompressed() && heap->IsMovableObject(s)) {
+    if (!s->IsCompressed() && heap->IsMovableObject(s) && !heap->UnpinObject(s)) {
       if (!gUseReadBarrier && !gUseUserfaultfd) {
         heap->DecrementDisableMovingGC(soa.Self());
       } else {
@@ -2369,7 +2371,9 @@ class JNI {
       return nullptr;
     }
     gc::Heap* heap = Runtime::Current()->GetHeap();
-    if (heap->IsMovableObject(array)) {
+    // The CC collector can leave the array in place if its region is pinned. Otherwise block
+    // moving GC, or the thread flip of the CC and CMC collectors.
+    if (heap->IsMovableObject(array) && !heap->PinObject(array)) {
       if (!gUseReadBarrier && !gUseUserfaultfd) {
         heap->IncrementDisableMovingGC(soa.Self());
       } else {
@@ -3014,8 +3018,9 @@ class JNI {
     if (mode != JNI_COMMIT) {
       if (is_copy) {
         delete[] reinterpret_cast<uint64_t*>(elements);
-      } else if (heap->IsMovableObject(array)) {
-        // Non copy to a movable object must means that we had disabled the moving GC.
+      } else if (heap->IsMovableObject(array) && !heap->UnpinObject(array)) {
+        // Non copy to a movable object that was not pinned must means that we had disabled the
+        // moving GC.
         if (!gUseReadBarrier && !gUseUserfaultfd) {
           heap->DecrementDisableMovingGC(soa.Self());
         } else {
@@ -24,6 +24,7 @@
 #include "local_reference_table.h"
 #include "java_vm_ext.h"
 #include "jni_env_ext.h"
+#include "mirror/array-inl.h"
 #include "mirror/string-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "scoped_thread_state_change-inl.h"
@@ -1270,6 +1271,25 @@ TEST_F(JniInternalTest, GetReleasePrimitiveArrayCriticalOfWrongType) {
   GetReleasePrimitiveArrayCriticalOfWrongType(true);
 }
 
+TEST_F(JniInternalTest, GetPrimitiveArrayCriticalDoesNotBlockGc) {
+  TEST_DISABLED_WITHOUT_BAKER_READ_BARRIERS();
+  jbyteArray array = env_->NewByteArray(100);
+  ASSERT_TRUE(array != nullptr);
+  gc::Heap* heap = Runtime::Current()->GetHeap();
+  // Collect once so that the array is no longer in a newly allocated region, which cannot be
+  // pinned with generational CC.
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  void* elements = env_->GetPrimitiveArrayCritical(array, nullptr);
+  ASSERT_TRUE(elements != nullptr);
+  // The GC does not wait for the critical section to end, and leaves the array in place.
+  heap->CollectGarbage(/* clear_soft_references= */ false);
+  {
+    ScopedObjectAccess soa(env_);
+    EXPECT_EQ(elements, soa.Decode<mirror::ByteArray>(array)->GetData());
+  }
+  env_->ReleasePrimitiveArrayCritical(array, elements, 0);
+}
+
 TEST_F(JniInternalTest, GetPrimitiveArrayRegionElementsOfWrongType) {
   GetPrimitiveArrayRegionElementsOfWrongType(false);
   GetPrimitiveArrayRegionElementsOfWrongType(true);
@@ -195,6 +195,15 @@ constexpr std::optional<int32_t> EncodeDatumId(DatumId datum_id) {
     case DatumId::kTimeElapsedDelta:
       return std::make_optional(
           statsd::ART_DATUM_DELTA_REPORTED__KIND__ART_DATUM_DELTA_TIME_ELAPSED_MS);
+    case DatumId::kLazyImageDecompressionBlockCount:
+    case DatumId::kLazyImageDecompressionFaultedBlockCount:
+    case DatumId::kMutexContentionCount:
+    case DatumId::kMutexContentionWaitTime:
+    case DatumId::kTimeToSafepoint:
+    case DatumId::kTimeToCheckpoint:
+    case DatumId::kBackgroundClassVerificationTotalTime:
+    case DatumId::kBackgroundClassVerificationCount:
+      return std::nullopt;
   }
 }
 
@@ -54,7 +54,12 @@ static void InitializeArray(T*) {
 }
 
 template<typename T>
-T* DexCache::AllocArray(MemberOffset obj_offset, size_t num, LinearAllocKind kind, bool startup) {
+T* DexCache::AllocArray(MemberOffset obj_offset,
+                        size_t num,
+                        LinearAllocKind kind,
+                        bool startup,
+                        size_t header_size) {
+  DCHECK_ALIGNED(header_size, 16u);
   Thread* self = Thread::Current();
   mirror::DexCache* dex_cache = this;
   if (gUseReadBarrier && self->GetIsGcMarking()) {
@@ -77,7 +82,9 @@ T* DexCache::AllocArray(MemberOffset obj_offset, size_t num, LinearAllocKind kin
     DCHECK(alloc->Contains(array));
     return array;  // Other thread just allocated the array.
   }
-  array = reinterpret_cast<T*>(alloc->AllocAlign16(self, RoundUp(num * sizeof(T), 16), kind));
+  uint8_t* memory = reinterpret_cast<uint8_t*>(
+      alloc->AllocAlign16(self, header_size + RoundUp(num * sizeof(T), 16), kind));
+  array = reinterpret_cast<T*>(memory + header_size);
   InitializeArray(array);  // Ensure other threads see the array initialized.
   dex_cache->SetField64Volatile<false, false>(obj_offset, reinterpret_cast64<uint64_t>(array));
   return array;
@@ -16,6 +16,8 @@
 
 #include "dex_cache-inl.h"
 
+#include <sstream>
+
 #include "art_method-inl.h"
 #include "class_linker.h"
 #include "gc/accounting/card_table-inl.h"
@@ -40,6 +42,9 @@ namespace mirror {
 // while debugging b/283632504.
 static constexpr bool kEnableFullArraysAtStartup = false;
 
+// Whether to upgrade hashed dex cache arrays that keep missing to full arrays.
+static constexpr bool kEnableFullArrayUpgrade = true;
+
 void DexCache::Initialize(const DexFile* dex_file, ObjPtr<ClassLoader> class_loader) {
   DCHECK(GetDexFile() == nullptr);
   DCHECK(GetStrings() == nullptr);
@@ -202,6 +207,35 @@ bool DexCache::ShouldAllocateFullArrayAtStartup() {
   return true;
 }
 
+bool DexCache::RecordMissAndCheckUpgrade(DexCachePairArrayStats* stats,
+                                         bool conflict,
+                                         size_t num_ids) {
+  uint32_t misses = stats->RecordMiss(conflict);
+  if (!kEnableFullArrayUpgrade || misses != num_ids * kFullArrayUpgradeMissesPerId) {
+    return false;
+  }
+  // To save on memory in dex2oat, we don't upgrade to full arrays.
+  return !Runtime::Current()->IsAotCompiler();
+}
+
+void DexCache::DumpStats(std::ostream& os) {
+  std::ostringstream oss;
+  auto dump = [&oss](const char* name, auto* pairs, const void* array) {
+    if (pairs != nullptr && pairs->GetStats()->GetMisses() != 0u) {
+      oss << " " << name << "=" << pairs->GetStats()->GetMisses() << "/"
+          << pairs->GetStats()->GetConflicts() << (array != nullptr ? " (full)" : "");
+    }
+  };
+  dump("strings", GetStrings(), GetStringsArray());
+  dump("types", GetResolvedTypes(), GetResolvedTypesArray());
+  dump("methods", GetResolvedMethods(), GetResolvedMethodsArray());
+  dump("fields", GetResolvedFields(), GetResolvedFieldsArray());
+  dump("method types", GetResolvedMethodTypes(), GetResolvedMethodTypesArray());
+  if (!oss.str().empty()) {
+    os << GetDexFile()->GetLocation() << ":" << oss.str() << "\n";
+  }
+}
+
 void DexCache::UnlinkStartupCaches() {
   if (GetDexFile() == nullptr) {
     // Unused dex cache.
@@ -119,6 +119,37 @@ template <typename T> struct alignas(2 * __SIZEOF_POINTER__) NativeDexCachePair
   }
 };
 
+// Miss and conflict counters of a hashed dex cache array, stored in the 16 bytes in front of
+// its entries. The counters are laid out in the index halves of two empty `DexCachePair`s, so
+// that visitors of the whole LinearAlloc allocation, such as the mark-compact GC, see null roots.
+class DexCachePairArrayStats {
+ public:
+  // Record a slow path store into the hashed array, evicting another entry if `conflict`.
+  // Returns the number of misses so far, including this one.
+  uint32_t RecordMiss(bool conflict) {
+    if (conflict) {
+      conflicts_.fetch_add(1u, std::memory_order_relaxed);
+    }
+    return misses_.fetch_add(1u, std::memory_order_relaxed) + 1u;
+  }
+
+  uint32_t GetMisses() const {
+    return misses_.load(std::memory_order_relaxed);
+  }
+
+  uint32_t GetConflicts() const {
+    return conflicts_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  [[maybe_unused]] uint32_t null_root0_;
+  std::atomic<uint32_t> misses_;
+  [[maybe_unused]] uint32_t null_root1_;
+  std::atomic<uint32_t> conflicts_;
+};
+static_assert(sizeof(DexCachePairArrayStats) == 16u);
+static_assert(sizeof(DexCachePairArrayStats) == 2u * sizeof(DexCachePair<Object>));
+
 template <typename T, size_t size> class NativeDexCachePairArray {
  public:
   NativeDexCachePairArray() {}
@@ -141,6 +172,17 @@ template <typename T, size_t size> class NativeDexCachePairArray {
     SetNativePair(entries_, SlotIndex(index), value);
   }
 
+  // Returns whether the slot of `index` holds the entry of another index.
+  bool HasConflict(uint32_t index) REQUIRES_SHARED(Locks::mutator_lock_) {
+    size_t stored_index = GetNativePair(index).index;
+    return stored_index != index &&
+           stored_index != NativeDexCachePair<T>::InvalidIndexForSlot(SlotIndex(index));
+  }
+
+  DexCachePairArrayStats* GetStats() {
+    return reinterpret_cast<DexCachePairArrayStats*>(this) - 1;
+  }
+
  private:
   NativeDexCachePair<T> GetNativePair(std::atomic<NativeDexCachePair<T>>* pair_array, size_t idx) {
     auto* array = reinterpret_cast<AtomicPair<uintptr_t>*>(pair_array);
@@ -186,6 +228,17 @@ template <typename T, size_t size> class DexCachePairArray {
     entries_[SlotIndex(index)].store(value, std::memory_order_release);
   }
 
+  // Returns whether the slot of `index` holds the entry of another index.
+  bool HasConflict(uint32_t index) {
+    uint32_t stored_index = GetPair(index).index;
+    return stored_index != index &&
+           stored_index != DexCachePair<T>::InvalidIndexForSlot(SlotIndex(index));
+  }
+
+  DexCachePairArrayStats* GetStats() {
+    return reinterpret_cast<DexCachePairArrayStats*>(this) - 1;
+  }
+
   void Clear(uint32_t index) {
     uint32_t slot = SlotIndex(index);
     // This is racy but should only be called from the transactional interpreter.
@@ -289,6 +342,11 @@ class MANAGED DexCache final : public Object {
   static_assert(IsPowerOfTwo(kDexCacheMethodTypeCacheSize),
                 "MethodType dex cache size is not a power of 2.");
 
+  // A hashed array is upgraded to a full array after this many misses per id of the dex file.
+  // Since each id can miss at most once without a conflict, the upgrade then saves at least
+  // `kFullArrayUpgradeMissesPerId - 1` redundant resolutions per entry of the full array.
+  static constexpr size_t kFullArrayUpgradeMissesPerId = 4;
+
   // Size of an instance of java.lang.DexCache not including referenced values.
   static constexpr uint32_t InstanceSize() {
     return sizeof(DexCache);
@@ -392,6 +450,9 @@ class MANAGED DexCache final : public Object {
     return number_of_elements <= dex_cache_size;
   }
 
+  // Dump the miss and conflict counters of the hashed arrays, if there were any misses.
+  void DumpStats(std::ostream& os) REQUIRES_SHARED(Locks::mutator_lock_);
+
 
 // NOLINTBEGIN(bugprone-macro-parentheses)
 #define DEFINE_ARRAY(name, array_kind, getter_setter, type, ids, alloc_kind) \
@@ -436,7 +497,8 @@ class MANAGED DexCache final : public Object {
       REQUIRES_SHARED(Locks::mutator_lock_) { \
     return reinterpret_cast<pair_kind ##Array<type, size>*>( \
         AllocArray<std::atomic<pair_kind<type>>>( \
-            getter_setter ##Offset(), size, alloc_kind)); \
+            getter_setter ##Offset(), size, alloc_kind, /*startup=*/ false, \
+            sizeof(DexCachePairArrayStats))); \
   } \
   template<VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags> \
   size_t Num ##getter_setter() REQUIRES_SHARED(Locks::mutator_lock_) { \
@@ -479,6 +541,10 @@ class MANAGED DexCache final : public Object {
           pairs = Allocate ##getter_setter(); \
           pairs->Set(index, resolved); \
         } \
+      } else if (RecordMissAndCheckUpgrade( \
+                     pairs->GetStats(), pairs->HasConflict(index), GetDexFile()->ids())) { \
+        array = Allocate ##getter_setter ##Array(); \
+        array->Set(index, resolved); \
       } else { \
         pairs->Set(index, resolved); \
       } \
@@ -486,7 +552,9 @@ class MANAGED DexCache final : public Object {
   } \
   void Unlink ##getter_setter ##ArrayIfStartup() \
       REQUIRES_SHARED(Locks::mutator_lock_) { \
-    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size)) { \
+    /* A full array next to a hashed array is an upgrade, not a startup allocation. */ \
+    if (!ShouldAllocateFullArray(GetDexFile()->ids(), pair_size) && \
+        Get ##getter_setter() == nullptr) { \
       Set ##getter_setter ##Array(nullptr) ; \
     } \
   }
@@ -556,11 +624,22 @@ class MANAGED DexCache final : public Object {
 // NOLINTEND(bugprone-macro-parentheses)
 
  private:
-  // Allocate new array in linear alloc and save it in the given fields.
+  // Allocate new array in linear alloc and save it in the given fields. The array is preceded
+  // by `header_size` zero-initialized bytes.
   template<typename T>
-  T* AllocArray(MemberOffset obj_offset, size_t num, LinearAllocKind kind, bool startup = false)
+  T* AllocArray(MemberOffset obj_offset,
+                size_t num,
+                LinearAllocKind kind,
+                bool startup = false,
+                size_t header_size = 0u)
      REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Record a miss of a hashed array with `num_ids` entries in the dex file, and return whether
+  // the hashed array should now be upgraded to a full array.
+  static bool RecordMissAndCheckUpgrade(DexCachePairArrayStats* stats,
+                                        bool conflict,
+                                        size_t num_ids);
+
   // Visit instance fields of the dex cache as well as its associated arrays.
   template <bool kVisitNativeRoots,
             VerifyObjectFlags kVerifyFlags = kDefaultVerifyFlags,
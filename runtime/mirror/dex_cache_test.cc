@@ -20,6 +20,7 @@
 
 #include "art_method-inl.h"
 #include "class_linker.h"
+#include "class_root-inl.h"
 #include "common_runtime_test.h"
 #include "handle_scope-inl.h"
 #include "linear_alloc.h"
@@ -61,6 +62,45 @@ TEST_F(DexCacheTest, Open) {
   EXPECT_EQ(0u, dex_cache->NumResolvedMethodTypes());
 }
 
+TEST_F(DexCacheTest, UpgradeToFullArray) {
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  ASSERT_TRUE(java_lang_dex_file_ != nullptr);
+  Handle<DexCache> dex_cache(
+      hs.NewHandle(class_linker_->AllocAndInitializeDexCache(
+          soa.Self(), *java_lang_dex_file_, /*class_loader=*/nullptr)));
+  ASSERT_TRUE(dex_cache != nullptr);
+  Handle<Class> klass(hs.NewHandle(GetClassRoot<Object>()));
+  ArtMethod* method = &*klass->GetDeclaredMethods(kRuntimePointerSize).begin();
+
+  // Alternate between two method indexes sharing a slot of the hashed array.
+  uint32_t num_method_ids = java_lang_dex_file_->NumMethodIds();
+  ASSERT_GT(num_method_ids, DexCache::kDexCacheMethodCacheSize + 1u);
+  size_t upgrade_misses = num_method_ids * DexCache::kFullArrayUpgradeMissesPerId;
+  for (size_t i = 0; i != upgrade_misses - 1u; ++i) {
+    uint32_t method_idx = 1u + (i % 2u) * DexCache::kDexCacheMethodCacheSize;
+    ASSERT_TRUE(dex_cache->GetResolvedMethod(method_idx) == nullptr);
+    dex_cache->SetResolvedMethod(method_idx, method);
+  }
+  auto* pairs = dex_cache->GetResolvedMethods();
+  ASSERT_TRUE(pairs != nullptr);
+  EXPECT_EQ(upgrade_misses - 1u, pairs->GetStats()->GetMisses());
+  EXPECT_EQ(upgrade_misses - 2u, pairs->GetStats()->GetConflicts());
+  EXPECT_TRUE(dex_cache->GetResolvedMethodsArray() == nullptr);
+
+  // The next miss upgrades to a full array, which no longer has conflicts.
+  dex_cache->SetResolvedMethod(1u, method);
+  ASSERT_TRUE(dex_cache->GetResolvedMethodsArray() != nullptr);
+  dex_cache->SetResolvedMethod(1u + DexCache::kDexCacheMethodCacheSize, method);
+  EXPECT_EQ(method, dex_cache->GetResolvedMethod(1u));
+  EXPECT_EQ(method, dex_cache->GetResolvedMethod(1u + DexCache::kDexCacheMethodCacheSize));
+  EXPECT_EQ(upgrade_misses, pairs->GetStats()->GetMisses());
+
+  // Upgraded arrays are not startup caches.
+  dex_cache->UnlinkStartupCaches();
+  EXPECT_TRUE(dex_cache->GetResolvedMethodsArray() != nullptr);
+}
+
 TEST_F(DexCacheMethodHandlesTest, Open) {
   ScopedObjectAccess soa(Thread::Current());
   StackHandleScope<1> hs(soa.Self());
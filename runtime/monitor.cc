@@ -108,6 +108,8 @@ Monitor::Monitor(Thread* self, Thread* owner, ObjPtr<mirror::Object> obj, int32_
       lock_owner_dex_pc_(0),
       lock_owner_sum_(0),
       lock_owner_request_(nullptr),
+      spin_limit_(kInitialSpinRounds),
+      contention_stats_(nullptr),
       monitor_id_(MonitorPool::ComputeMonitorId(this, self)) {
 #ifdef __LP64__
   DCHECK(false) << "Should not be reached in 64b";
@@ -142,6 +144,8 @@ Monitor::Monitor(Thread* self,
       lock_owner_dex_pc_(0),
       lock_owner_sum_(0),
       lock_owner_request_(nullptr),
+      spin_limit_(kInitialSpinRounds),
+      contention_stats_(nullptr),
       monitor_id_(id) {
 #ifdef __LP64__
   next_free_ = nullptr;
@@ -426,7 +430,7 @@ bool Monitor::TryLock(Thread* self, bool spin) {
     lock_count_++;
     CHECK_NE(lock_count_, 0u);  // Abort on overflow.
   } else {
-    bool success = spin ? monitor_lock_.ExclusiveTryLockWithSpinning(self)
+    bool success = spin ? TryLockWithAdaptiveSpinning(self)
         : monitor_lock_.ExclusiveTryLock(self);
     if (!success) {
       return false;
@@ -443,6 +447,70 @@ bool Monitor::TryLock(Thread* self, bool spin) {
   return true;
 }
 
+// Returns false if `thread` is alive and not runnable, so that it cannot release a lock soon.
+// This does not detect runnable threads that are descheduled.
+static bool MayBeRunning(Thread* self, Thread* thread) REQUIRES(!Locks::thread_list_lock_) {
+  // Acquiring thread_list_lock_ ensures that the thread doesn't disappear while we're
+  // looking at it.
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  return !Runtime::Current()->GetThreadList()->Contains(thread) ||
+         thread->GetState() == ThreadState::kRunnable;
+}
+
+static bool MayBeRunning(Thread* self, uint32_t thread_id) REQUIRES(!Locks::thread_list_lock_) {
+  MutexLock mu(self, *Locks::thread_list_lock_);
+  Thread* thread = Runtime::Current()->GetThreadList()->FindThreadByThreadId(thread_id);
+  return thread == nullptr || thread->GetState() == ThreadState::kRunnable;
+}
+
+bool Monitor::TryLockWithAdaptiveSpinning(Thread* self) {
+  if (monitor_lock_.ExclusiveTryLock(self)) {
+    return true;
+  }
+  MonitorContentionStats* stats = GetContentionStats(self);
+  stats->contended_locks.fetch_add(1u, std::memory_order_relaxed);
+  uint32_t spin_limit = spin_limit_.load(std::memory_order_relaxed);
+  Thread* owner = owner_.load(std::memory_order_relaxed);
+  Thread* checked_owner = nullptr;
+  uint32_t checked_round = 0u;
+  for (uint32_t round = 0u; round != spin_limit; ++round) {
+    stats->spin_rounds.fetch_add(1u, std::memory_order_relaxed);
+    if (monitor_lock_.ExclusiveTryLockWithSpinning(self, /*max_spins=*/ 1u)) {
+      spin_limit_.store(std::min(spin_limit + 1u, kMaxSpinRounds), std::memory_order_relaxed);
+      stats->spin_acquisitions.fetch_add(1u, std::memory_order_relaxed);
+      return true;
+    }
+    // The brief wait failed. A new owner means that the monitor is being handed over and
+    // a null owner is about to release it, so keep spinning. If the owner is unchanged,
+    // stop as soon as it is not runnable. Recheck the same owner only every
+    // `kOwnerCheckRounds` rounds, since `MayBeRunning()` takes `thread_list_lock_`.
+    Thread* new_owner = owner_.load(std::memory_order_relaxed);
+    if (new_owner != nullptr &&
+        new_owner == owner &&
+        (new_owner != checked_owner || round - checked_round >= kOwnerCheckRounds)) {
+      if (!MayBeRunning(self, new_owner)) {
+        stats->owner_not_runnable.fetch_add(1u, std::memory_order_relaxed);
+        break;
+      }
+      checked_owner = new_owner;
+      checked_round = round;
+    }
+    owner = new_owner;
+  }
+  spin_limit_.store(std::max(spin_limit / 2u, kMinSpinRounds), std::memory_order_relaxed);
+  return false;
+}
+
+MonitorContentionStats* Monitor::GetContentionStats(Thread* self) {
+  MonitorContentionStats* stats = contention_stats_.load(std::memory_order_relaxed);
+  if (UNLIKELY(stats == nullptr)) {
+    // Racing threads get the same stats from the monitor list.
+    stats = Runtime::Current()->GetMonitorList()->GetContentionStats(self, GetObject()->GetClass());
+    contention_stats_.store(stats, std::memory_order_relaxed);
+  }
+  return stats;
+}
+
 template <LockReason reason>
 void Monitor::Lock(Thread* self) {
   bool called_monitors_callback = false;
@@ -522,6 +590,10 @@ void Monitor::Lock(Thread* self) {
     // We already tried spinning above. The shutdown procedure currently assumes we stop
     // touching monitors shortly after we suspend, so don't spin again here.
     monitor_lock_.ExclusiveLock(self);
+    // Set by the failed `TryLockWithAdaptiveSpinning()` above.
+    MonitorContentionStats* stats = contention_stats_.load(std::memory_order_relaxed);
+    DCHECK(stats != nullptr);
+    stats->blocked_acquisitions.fetch_add(1u, std::memory_order_relaxed);
 
     if (log_contention && orig_owner != nullptr) {
       // Woken from contention.
@@ -1167,8 +1239,13 @@ ObjPtr<mirror::Object> Monitor::MonitorEnter(Thread* self,
           // Contention.
           contention_count++;
           Runtime* runtime = Runtime::Current();
-          if (contention_count
-              <= kExtraSpinIters + runtime->GetMaxSpinsBeforeThinLockInflation()) {
+          // Before yielding to the owner, check that it is runnable. Otherwise it is not going to
+          // release the lock soon, so inflate right away and block on the monitor.
+          bool owner_may_be_running =
+              contention_count != kExtraSpinIters + 1u || MayBeRunning(self, owner_thread_id);
+          if (owner_may_be_running &&
+              contention_count
+                  <= kExtraSpinIters + runtime->GetMaxSpinsBeforeThinLockInflation()) {
             // TODO: Consider switching the thread state to kWaitingForLockInflation when we are
             // yielding.  Use sched_yield instead of NanoSleep since NanoSleep can wait much longer
             // than the parameter you pass in. This can cause thread suspension to take excessively
@@ -1687,6 +1764,35 @@ size_t MonitorList::Size() {
   return list_.size();
 }
 
+MonitorContentionStats* MonitorList::GetContentionStats(Thread* self,
+                                                        ObjPtr<mirror::Class> klass) {
+  std::string descriptor = klass->PrettyDescriptor();
+  MutexLock mu(self, monitor_list_lock_);
+  std::unique_ptr<MonitorContentionStats>& stats = contention_stats_[descriptor];
+  if (stats == nullptr) {
+    stats = std::make_unique<MonitorContentionStats>();
+  }
+  return stats.get();
+}
+
+void MonitorList::DumpForSigQuit(std::ostream& os) {
+  MutexLock mu(Thread::Current(), monitor_list_lock_);
+  os << "Monitor contention by class:";
+  if (contention_stats_.empty()) {
+    os << " none";
+  }
+  os << "\n";
+  for (const auto& [descriptor, stats] : contention_stats_) {
+    os << "  " << descriptor
+       << ": contended=" << stats->contended_locks.load(std::memory_order_relaxed)
+       << " spin_acquired=" << stats->spin_acquisitions.load(std::memory_order_relaxed)
+       << " blocked=" << stats->blocked_acquisitions.load(std::memory_order_relaxed)
+       << " spin_rounds=" << stats->spin_rounds.load(std::memory_order_relaxed)
+       << " owner_not_runnable=" << stats->owner_not_runnable.load(std::memory_order_relaxed)
+       << "\n";
+  }
+}
+
 class MonitorDeflateVisitor : public IsMarkedVisitor {
  public:
   MonitorDeflateVisitor() : self_(Thread::Current()), deflate_count_(0) {}
@@ -24,6 +24,9 @@
 #include <atomic>
 #include <iosfwd>
 #include <list>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "base/allocator.h"
@@ -48,6 +51,7 @@ class Thread;
 using MonitorId = uint32_t;
 
 namespace mirror {
+class Class;
 class Object;
 }  // namespace mirror
 
@@ -56,6 +60,20 @@ enum class LockReason {
   kForLock,
 };
 
+// Contention statistics for the monitors of all objects of a class. Dumped on SIGQUIT.
+struct MonitorContentionStats {
+  // Monitor acquisitions that found the monitor held by another thread.
+  std::atomic<uint64_t> contended_locks{0};
+  // Contended acquisitions that succeeded by spinning.
+  std::atomic<uint64_t> spin_acquisitions{0};
+  // Contended acquisitions that blocked.
+  std::atomic<uint64_t> blocked_acquisitions{0};
+  // Spin rounds, see `Monitor::TryLockWithAdaptiveSpinning()`.
+  std::atomic<uint64_t> spin_rounds{0};
+  // Contended acquisitions that stopped spinning because the owner was not runnable.
+  std::atomic<uint64_t> owner_not_runnable{0};
+};
+
 class Monitor {
  public:
   // The default number of spins that are done before thread suspension is used to forcibly inflate
@@ -238,6 +256,20 @@ class Monitor {
       TRY_ACQUIRE(true, monitor_lock_)
       REQUIRES_SHARED(Locks::mutator_lock_);
 
+  // Try to acquire `monitor_lock_`, spinning for up to `spin_limit_` rounds if it is held.
+  // Stops spinning after the first failed round in which the owner stayed the same and is not
+  // runnable, since it cannot release the monitor soon then. Adjusts `spin_limit_` based on
+  // whether spinning succeeded.
+  bool TryLockWithAdaptiveSpinning(Thread* self)
+      TRY_ACQUIRE(true, monitor_lock_)
+      REQUIRES(!Locks::thread_list_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
+  // Returns the contention statistics for the class of the monitor's object.
+  MonitorContentionStats* GetContentionStats(Thread* self)
+      REQUIRES(!Locks::thread_list_lock_)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   template<LockReason reason = LockReason::kForLock>
   void Lock(Thread* self)
       ACQUIRE(monitor_lock_)
@@ -428,6 +460,24 @@ class Monitor {
 
   void MaybeEnableTimeout() REQUIRES(Locks::mutator_lock_);
 
+  // Bounds of `spin_limit_`. The initial limit matches the spinning of
+  // `Mutex::ExclusiveTryLockWithSpinning()`.
+  static constexpr uint32_t kMinSpinRounds = 1u;
+  static constexpr uint32_t kInitialSpinRounds = Mutex::kDefaultMaxSpins;
+  static constexpr uint32_t kMaxSpinRounds = 32u;
+  // While the owner stays the same, check whether it is runnable only every this many rounds.
+  // The check takes `thread_list_lock_`, which all spinning threads would contend on.
+  static constexpr uint32_t kOwnerCheckRounds = 8u;
+
+  // The number of rounds to spin for a contended monitor. Grows by one after each contended
+  // acquisition that succeeded by spinning and halves after each one that blocked, so that we
+  // spin longer only for monitors that are usually held briefly. Updated without ordering,
+  // racing updates just lose some history.
+  std::atomic<uint32_t> spin_limit_;
+
+  // Contention statistics of the object's class, set on first contention.
+  std::atomic<MonitorContentionStats*> contention_stats_;
+
   // The denser encoded version of this monitor as stored in the lock word.
   MonitorId monitor_id_;
 
@@ -459,6 +509,13 @@ class MonitorList {
   size_t DeflateMonitors() REQUIRES(!monitor_list_lock_) REQUIRES(Locks::mutator_lock_);
   EXPORT size_t Size() REQUIRES(!monitor_list_lock_);
 
+  // Returns the contention statistics for monitors of objects of class `klass`. These are kept
+  // for the lifetime of the runtime, so that they survive monitor deflation.
+  MonitorContentionStats* GetContentionStats(Thread* self, ObjPtr<mirror::Class> klass)
+      REQUIRES(!monitor_list_lock_) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  void DumpForSigQuit(std::ostream& os) REQUIRES(!monitor_list_lock_);
+
   using Monitors = std::list<Monitor*, TrackingAllocator<Monitor*, kAllocatorTagMonitorList>>;
 
  private:
@@ -470,6 +527,8 @@ class MonitorList {
   Mutex monitor_list_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
   ConditionVariable monitor_add_condition_ GUARDED_BY(monitor_list_lock_);
   Monitors list_ GUARDED_BY(monitor_list_lock_);
+  std::map<std::string, std::unique_ptr<MonitorContentionStats>> contention_stats_
+      GUARDED_BY(monitor_list_lock_);
 
   friend class Monitor;
   DISALLOW_COPY_AND_ASSIGN(MonitorList);
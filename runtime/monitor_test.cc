@@ -17,6 +17,7 @@
 #include "monitor.h"
 
 #include <memory>
+#include <sstream>
 #include <string>
 
 #include "base/atomic.h"
@@ -391,5 +392,116 @@ TEST_F(MonitorTest, TestTryLock) {
   thread_pool->StopWorkers(self);
 }
 
+class ContendedLockTask : public Task {
+ public:
+  explicit ContendedLockTask(jobject obj) : obj_(obj) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    StackHandleScope<1u> hs(self);
+    Handle<mirror::Object> obj = hs.NewHandle(soa.Decode<mirror::Object>(obj_));
+    // Lock is held by another thread, blocks until it is released.
+    ObjectLock<mirror::Object> lock(self, obj);
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  jobject obj_;
+};
+
+// Test that spinning for a monitor stops when the owner is not runnable and that the contention
+// is recorded for the class of the object.
+TEST_F(MonitorTest, ContentionStats) {
+  Thread* const self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("the pool", 1));
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "contended")));
+  jobject g_obj = soa.Vm()->AddGlobalRef(self, obj.Get());
+  ASSERT_TRUE(g_obj != nullptr);
+  MonitorContentionStats* stats =
+      Runtime::Current()->GetMonitorList()->GetContentionStats(self, obj->GetClass());
+  EXPECT_EQ(stats, Runtime::Current()->GetMonitorList()->GetContentionStats(self, obj->GetClass()));
+  uint64_t old_contended_locks = stats->contended_locks.load();
+  uint64_t old_blocked_acquisitions = stats->blocked_acquisitions.load();
+  uint64_t old_owner_not_runnable = stats->owner_not_runnable.load();
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    // Inflate the lock, so that the contending thread spins on the monitor.
+    obj->IdentityHashCode();
+    ASSERT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+    thread_pool->AddTask(self, new ContendedLockTask(g_obj));
+    thread_pool->StartWorkers(self);
+    // Stay suspended while holding the monitor until the contending thread stops spinning.
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    for (size_t i = 0; i != 10000u && stats->owner_not_runnable.load() == old_owner_not_runnable;
+         ++i) {
+      usleep(1000);
+    }
+  }
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  }
+  EXPECT_GT(stats->contended_locks.load(), old_contended_locks);
+  EXPECT_GT(stats->owner_not_runnable.load(), old_owner_not_runnable);
+  EXPECT_GT(stats->blocked_acquisitions.load(), old_blocked_acquisitions);
+
+  std::ostringstream oss;
+  Runtime::Current()->GetMonitorList()->DumpForSigQuit(oss);
+  EXPECT_NE(oss.str().find("java.lang.String: contended="), std::string::npos) << oss.str();
+  thread_pool->StopWorkers(self);
+  soa.Vm()->DeleteGlobalRef(self, g_obj);
+}
+
+// Test that threads contending for a monitor whose owner sleeps stop spinning after the first
+// failed round instead of spinning for the whole spin limit.
+TEST_F(MonitorTest, SpinningStopsForSleepingOwner) {
+  static constexpr size_t kNumContenders = 4u;
+  Thread* const self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("the pool", kNumContenders));
+  ScopedObjectAccess soa(self);
+  StackHandleScope<1> hs(self);
+  Handle<mirror::Object> obj(
+      hs.NewHandle<mirror::Object>(mirror::String::AllocFromModifiedUtf8(self, "sleeping")));
+  jobject g_obj = soa.Vm()->AddGlobalRef(self, obj.Get());
+  ASSERT_TRUE(g_obj != nullptr);
+  MonitorContentionStats* stats =
+      Runtime::Current()->GetMonitorList()->GetContentionStats(self, obj->GetClass());
+  uint64_t old_contended_locks = stats->contended_locks.load();
+  uint64_t old_spin_rounds = stats->spin_rounds.load();
+  uint64_t old_owner_not_runnable = stats->owner_not_runnable.load();
+  {
+    ObjectLock<mirror::Object> lock(self, obj);
+    obj->IdentityHashCode();
+    ASSERT_EQ(obj->GetLockWord(false).GetState(), LockWord::kFatLocked);
+    for (size_t i = 0; i != kNumContenders; ++i) {
+      thread_pool->AddTask(self, new ContendedLockTask(g_obj));
+    }
+    // Sleep while holding the monitor until all contending threads have stopped spinning.
+    ScopedThreadSuspension sts(self, ThreadState::kSleeping);
+    thread_pool->StartWorkers(self);
+    for (size_t i = 0;
+         i != 10000u &&
+             stats->owner_not_runnable.load() != old_owner_not_runnable + kNumContenders;
+         ++i) {
+      usleep(1000);
+    }
+  }
+  {
+    ScopedThreadSuspension sts(self, ThreadState::kSuspended);
+    thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  }
+  EXPECT_EQ(stats->contended_locks.load(), old_contended_locks + kNumContenders);
+  EXPECT_EQ(stats->owner_not_runnable.load(), old_owner_not_runnable + kNumContenders);
+  // Each contending thread did a single brief wait before checking the owner.
+  EXPECT_EQ(stats->spin_rounds.load(), old_spin_rounds + kNumContenders);
+  thread_pool->StopWorkers(self);
+  soa.Vm()->DeleteGlobalRef(self, g_obj);
+}
 
 }  // namespace art
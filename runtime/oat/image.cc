@@ -20,7 +20,9 @@
 #include <lz4hc.h>
 #include <sstream>
 #include <sys/stat.h>
+#include <zdict.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include "android-base/stringprintf.h"
 
@@ -34,8 +36,8 @@
 namespace art HIDDEN {
 
 const uint8_t ImageHeader::kImageMagic[] = { 'a', 'r', 't', '\n' };
-// Last change: Add JniStubMethodsSection.
-const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '0', '\0' };
+// Last change: Add zstd storage mode.
+const uint8_t ImageHeader::kImageVersion[] = { '1', '1', '2', '\0' };
 
 ImageHeader::ImageHeader(uint32_t image_reservation_size,
                          uint32_t component_count,
@@ -250,6 +252,31 @@ bool ImageHeader::Block::Decompress(uint8_t* out_ptr,
       }
       break;
     }
+    case kStorageModeZstd: {
+      std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+      size_t result = ZSTD_decompress_usingDict(dctx.get(),
+                                                out_ptr + image_offset_,
+                                                image_size_,
+                                                in_ptr + data_offset_,
+                                                data_size_,
+                                                dictionary.data(),
+                                                dictionary.size());
+      if (ZSTD_isError(result)) {
+        if (error_msg != nullptr) {
+          *error_msg = android::base::StringPrintf("ZSTD_decompress_usingDict() failed: %s",
+                                                   ZSTD_getErrorName(result));
+        }
+        return false;
+      }
+      if (result != image_size_) {
+        if (error_msg != nullptr) {
+          *error_msg = (std::ostringstream() << "Decompressed size different than image size: "
+                                             << result << ", and " << image_size_).str();
+        }
+        return false;
+      }
+      break;
+    }
     default: {
       if (error_msg != nullptr) {
         *error_msg = (std::ostringstream() << "Invalid image format " << storage_mode_).str();
@@ -279,29 +306,53 @@ const char* ImageHeader::GetImageSectionName(ImageSections index) {
   }
 }
 
+// Default zstd level. Decompression speed barely depends on the level, so favor size.
+static constexpr int kDefaultZstdCompressionLevel = 19;
+
 // Compress data from `source` into `storage`.
 static bool CompressData(ArrayRef<const uint8_t> source,
                          ImageHeader::StorageMode image_storage_mode,
+                         uint32_t compression_level,
+                         ArrayRef<const uint8_t> dictionary,
                          /*out*/ dchecked_vector<uint8_t>* storage) {
   const uint64_t compress_start_time = NanoTime();
 
-  // Bound is same for both LZ4 and LZ4HC.
-  storage->resize(LZ4_compressBound(source.size()));
   size_t data_size = 0;
-  if (image_storage_mode == ImageHeader::kStorageModeLZ4) {
-    data_size = LZ4_compress_default(
-        reinterpret_cast<char*>(const_cast<uint8_t*>(source.data())),
-        reinterpret_cast<char*>(storage->data()),
-        source.size(),
-        storage->size());
+  if (image_storage_mode == ImageHeader::kStorageModeZstd) {
+    storage->resize(ZSTD_compressBound(source.size()));
+    std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+    int level = (compression_level != 0u)
+        ? std::min(static_cast<int>(compression_level), ZSTD_maxCLevel())
+        : kDefaultZstdCompressionLevel;
+    size_t result = ZSTD_compress_usingDict(cctx.get(),
+                                            storage->data(),
+                                            storage->size(),
+                                            source.data(),
+                                            source.size(),
+                                            dictionary.data(),
+                                            dictionary.size(),
+                                            level);
+    data_size = ZSTD_isError(result) ? 0u : result;
   } else {
-    DCHECK_EQ(image_storage_mode, ImageHeader::kStorageModeLZ4HC);
-    data_size = LZ4_compress_HC(
-        reinterpret_cast<const char*>(const_cast<uint8_t*>(source.data())),
-        reinterpret_cast<char*>(storage->data()),
-        source.size(),
-        storage->size(),
-        LZ4HC_CLEVEL_MAX);
+    // Bound is same for both LZ4 and LZ4HC.
+    storage->resize(LZ4_compressBound(source.size()));
+    if (image_storage_mode == ImageHeader::kStorageModeLZ4) {
+      data_size = LZ4_compress_default(
+          reinterpret_cast<char*>(const_cast<uint8_t*>(source.data())),
+          reinterpret_cast<char*>(storage->data()),
+          source.size(),
+          storage->size());
+    } else {
+      DCHECK_EQ(image_storage_mode, ImageHeader::kStorageModeLZ4HC);
+      data_size = LZ4_compress_HC(
+          reinterpret_cast<const char*>(const_cast<uint8_t*>(source.data())),
+          reinterpret_cast<char*>(storage->data()),
+          source.size(),
+          storage->size(),
+          (compression_level != 0u)
+              ? std::min(static_cast<int>(compression_level), LZ4HC_CLEVEL_MAX)
+              : LZ4HC_CLEVEL_MAX);
+    }
   }
 
   if (data_size == 0) {
@@ -313,41 +364,97 @@ static bool CompressData(ArrayRef<const uint8_t> source,
               << PrettyDuration(NanoTime() - compress_start_time);
   if (kIsDebugBuild) {
     dchecked_vector<uint8_t> decompressed(source.size());
-    size_t decompressed_size;
+    ImageHeader::Block block(image_storage_mode,
+                             /*data_offset=*/ 0u,
+                             /*data_size=*/ storage->size(),
+                             /*image_offset=*/ 0u,
+                             /*image_size=*/ source.size());
     std::string error_msg;
-    bool ok = LZ4_decompress_safe_checked(
-        reinterpret_cast<char*>(storage->data()),
-        reinterpret_cast<char*>(decompressed.data()),
-        storage->size(),
-        decompressed.size(),
-        &decompressed_size,
-        &error_msg);
-    if (!ok) {
+    if (!block.Decompress(decompressed.data(), storage->data(), &error_msg, dictionary)) {
       LOG(FATAL) << error_msg;
       UNREACHABLE();
     }
-    CHECK_EQ(decompressed_size, decompressed.size());
     CHECK_EQ(memcmp(source.data(), decompressed.data(), source.size()), 0) << image_storage_mode;
   }
   return true;
 }
 
+// Train a zstd dictionary from samples of the image data. Returns an empty dictionary if
+// training fails, for example because the image is too small.
+static dchecked_vector<uint8_t> TrainZstdDictionary(ArrayRef<const uint8_t> data) {
+  static constexpr size_t kSampleSize = 4 * KB;
+  static constexpr size_t kMaxSamplesSize = 8 * MB;
+  static constexpr size_t kDictionaryCapacity = 64 * KB;
+  const uint64_t start_time = NanoTime();
+  const size_t num_chunks = data.size() / kSampleSize;
+  const size_t stride = std::max<size_t>(1u, num_chunks * kSampleSize / kMaxSamplesSize);
+  dchecked_vector<uint8_t> samples;
+  std::vector<size_t> sample_sizes;
+  for (size_t i = 0; i < num_chunks; i += stride) {
+    samples.insert(samples.end(),
+                   data.begin() + i * kSampleSize,
+                   data.begin() + (i + 1u) * kSampleSize);
+    sample_sizes.push_back(kSampleSize);
+  }
+  dchecked_vector<uint8_t> dictionary(kDictionaryCapacity);
+  size_t result = ZDICT_trainFromBuffer(dictionary.data(),
+                                        dictionary.size(),
+                                        samples.data(),
+                                        sample_sizes.data(),
+                                        sample_sizes.size());
+  if (ZDICT_isError(result)) {
+    VLOG(image) << "Failed to train zstd dictionary: " << ZDICT_getErrorName(result);
+    return {};
+  }
+  dictionary.resize(result);
+  VLOG(image) << "Trained zstd dictionary of " << dictionary.size() << " bytes from "
+              << sample_sizes.size() << " samples in "
+              << PrettyDuration(NanoTime() - start_time);
+  return dictionary;
+}
+
+// Pick a block size for zstd compressed images so that loading can decompress the blocks
+// in parallel. The result is a multiple of the maximum page size so that the blocks can
+// also be decompressed separately on demand.
+static uint32_t GetZstdBlockSize(uint32_t image_size, uint32_t max_image_block_size) {
+  static constexpr uint32_t kTargetBlockCount = 16u;
+  static constexpr uint32_t kMinBlockSize = 256 * KB;
+  uint32_t block_size = RoundUp(image_size / kTargetBlockCount, kMaxPageSize);
+  block_size = std::max(block_size, kMinBlockSize);
+  if (max_image_block_size < block_size) {
+    // Respect an explicit limit, but keep the page alignment when possible.
+    block_size = (max_image_block_size >= kMaxPageSize)
+        ? RoundDown(max_image_block_size, kMaxPageSize)
+        : max_image_block_size;
+  }
+  return block_size;
+}
+
 bool ImageHeader::WriteData(const ImageFileGuard& image_file,
                             const uint8_t* data,
                             const uint8_t* bitmap_data,
                             ImageHeader::StorageMode image_storage_mode,
                             uint32_t max_image_block_size,
+                            uint32_t compression_level,
+                            bool train_zstd_dictionary,
                             bool update_checksum,
                             std::string* error_msg) {
   const bool is_compressed = image_storage_mode != ImageHeader::kStorageModeUncompressed;
+  const bool is_zstd = image_storage_mode == ImageHeader::kStorageModeZstd;
   dchecked_vector<std::pair<uint32_t, uint32_t>> block_sources;
   dchecked_vector<ImageHeader::Block> blocks;
 
   // Add a set of solid blocks such that no block is larger than the maximum size. A solid block
-  // is a block that must be decompressed all at once.
+  // is a block that must be decompressed all at once. For zstd, the block ends are aligned to
+  // the block size.
+  const uint32_t block_size =
+      is_zstd ? GetZstdBlockSize(GetImageSize(), max_image_block_size) : max_image_block_size;
   auto add_blocks = [&](uint32_t offset, uint32_t size) {
     while (size != 0u) {
-      const uint32_t cur_size = std::min(size, max_image_block_size);
+      uint32_t cur_size = std::min(size, block_size);
+      if (is_zstd) {
+        cur_size = std::min(size, block_size - offset % block_size);
+      }
       block_sources.emplace_back(offset, cur_size);
       offset += cur_size;
       size -= cur_size;
@@ -365,6 +472,12 @@ bool ImageHeader::WriteData(const ImageFileGuard& image_file,
                              sizeof(ImageHeader));
   }
 
+  dchecked_vector<uint8_t> zstd_dictionary;
+  if (is_zstd && train_zstd_dictionary) {
+    zstd_dictionary = TrainZstdDictionary(ArrayRef<const uint8_t>(
+        data + sizeof(ImageHeader), GetImageSize() - sizeof(ImageHeader)));
+  }
+
   // Copy and compress blocks.
   uint32_t out_offset = sizeof(ImageHeader);
   for (const std::pair<uint32_t, uint32_t> block : block_sources) {
@@ -372,7 +485,11 @@ bool ImageHeader::WriteData(const ImageFileGuard& image_file,
     dchecked_vector<uint8_t> compressed_data;
     ArrayRef<const uint8_t> image_data;
     if (is_compressed) {
-      if (!CompressData(raw_image_data, image_storage_mode, &compressed_data)) {
+      if (!CompressData(raw_image_data,
+                        image_storage_mode,
+                        compression_level,
+                        ArrayRef<const uint8_t>(zstd_dictionary),
+                        &compressed_data)) {
         *error_msg = "Error compressing data for " +
             image_file->GetPath() + ": " + std::string(strerror(errno));
         return false;
@@ -416,6 +533,20 @@ bool ImageHeader::WriteData(const ImageFileGuard& image_file,
     this->blocks_offset_ = out_offset;
     this->blocks_count_ = blocks.size();
     out_offset += blocks_bytes;
+
+    if (!zstd_dictionary.empty()) {
+      if (!image_file->PwriteFully(zstd_dictionary.data(), zstd_dictionary.size(), out_offset)) {
+        *error_msg = "Failed to write image zstd dictionary " +
+            image_file->GetPath() + ": " + std::string(strerror(errno));
+        return false;
+      }
+      if (update_checksum) {
+        image_checksum = adler32(image_checksum, zstd_dictionary.data(), zstd_dictionary.size());
+      }
+      this->zstd_dictionary_offset_ = out_offset;
+      this->zstd_dictionary_size_ = zstd_dictionary.size();
+      out_offset += zstd_dictionary.size();
+    }
   }
 
   // Data size includes everything except the bitmap.
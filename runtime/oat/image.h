@@ -19,6 +19,7 @@
 
 #include <string.h>
 
+#include "base/array_ref.h"
 #include "base/iteration_range.h"
 #include "base/macros.h"
 #include "base/os.h"
@@ -83,6 +84,7 @@ class PACKED(8) ImageHeader {
     kStorageModeUncompressed,
     kStorageModeLZ4,
     kStorageModeLZ4HC,
+    kStorageModeZstd,
     kStorageModeCount,  // Number of elements in enum.
   };
   static constexpr StorageMode kDefaultStorageMode = kStorageModeUncompressed;
@@ -101,7 +103,12 @@ class PACKED(8) ImageHeader {
           image_offset_(image_offset),
           image_size_(image_size) {}
 
-    bool Decompress(uint8_t* out_ptr, const uint8_t* in_ptr, std::string* error_msg) const;
+    // Decompress the block. The `dictionary` is only used by the zstd storage mode,
+    // see `ImageHeader::GetZstdDictionary()`.
+    bool Decompress(uint8_t* out_ptr,
+                    const uint8_t* in_ptr,
+                    std::string* error_msg,
+                    ArrayRef<const uint8_t> dictionary = {}) const;
 
     StorageMode GetStorageMode() const {
       return storage_mode_;
@@ -111,6 +118,10 @@ class PACKED(8) ImageHeader {
       return data_size_;
     }
 
+    uint32_t GetImageOffset() const {
+      return image_offset_;
+    }
+
     uint32_t GetImageSize() const {
       return image_size_;
     }
@@ -427,13 +438,26 @@ class PACKED(8) ImageHeader {
     return blocks_count_;
   }
 
+  uint32_t GetZstdDictionarySize() const {
+    return zstd_dictionary_size_;
+  }
+
+  // Return the dictionary used by zstd compressed blocks, empty if there is none.
+  ArrayRef<const uint8_t> GetZstdDictionary(const uint8_t* image_begin) const {
+    return ArrayRef<const uint8_t>(image_begin + zstd_dictionary_offset_, zstd_dictionary_size_);
+  }
+
   // Helper for writing `data` and `bitmap_data` into `image_file`, following
-  // the information stored in this header and passed as arguments.
+  // the information stored in this header and passed as arguments. A `compression_level`
+  // of 0 selects the default level for the storage mode. With `train_zstd_dictionary`,
+  // zstd blocks are compressed with a dictionary trained from the image data.
   EXPORT bool WriteData(const ImageFileGuard& image_file,
                         const uint8_t* data,
                         const uint8_t* bitmap_data,
                         ImageHeader::StorageMode image_storage_mode,
                         uint32_t max_image_block_size,
+                        uint32_t compression_level,
+                        bool train_zstd_dictionary,
                         bool update_checksum,
                         std::string* error_msg);
 
@@ -524,6 +548,10 @@ class PACKED(8) ImageHeader {
   uint32_t blocks_offset_ = 0u;
   uint32_t blocks_count_ = 0u;
 
+  // Dictionary shared by zstd compressed blocks, stored after the blocks.
+  uint32_t zstd_dictionary_offset_ = 0u;
+  uint32_t zstd_dictionary_size_ = 0u;
+
   friend class linker::ImageWriter;
   friend class RuntimeImageHelper;
 };
@@ -31,6 +31,7 @@
 #include "base/file_utils.h"
 #include "base/logging.h"  // For VLOG.
 #include "base/mutex-inl.h"
+#include "base/scoped_flock.h"
 #include "base/sdk_version.h"
 #include "base/stl_util.h"
 #include "base/systrace.h"
@@ -51,6 +52,7 @@
 #include "oat_file.h"
 #include "oat_file_assistant.h"
 #include "obj_ptr-inl.h"
+#include "profile/profile_compilation_info.h"
 #include "runtime_image.h"
 #include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
@@ -154,7 +156,8 @@ std::vector<const OatFile*> OatFileManager::GetBootOatFiles() const {
 }
 
 OatFileManager::OatFileManager()
-    : only_use_system_oat_files_(false) {}
+    : only_use_system_oat_files_(false),
+      startup_verification_started_(false) {}
 
 OatFileManager::~OatFileManager() {
   // Explicitly clear oat_files_ since the OatFile destructor calls back into OatFileManager for
@@ -484,6 +487,10 @@ std::vector<std::unique_ptr<const DexFile>> OatFileManager::OpenDexFilesFromOat(
     Runtime::Current()->GetJit()->RegisterDexFiles(dex_files, class_loader);
   }
 
+  if (Runtime::Current()->BackgroundVerifyStartupClasses()) {
+    RecordStartupVerificationCandidate(dex_files, class_loader);
+  }
+
   // Now that we loaded the dex/odex files, notify the runtime.
   // Note that we do this everytime we load dex files.
   Runtime::Current()->NotifyDexFileLoaded();
@@ -851,6 +858,13 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
     return;
   }
 
+  AddVerificationTask(self, new BackgroundVerificationTask(
+      dex_files,
+      class_loader,
+      GetVdexFilename(odex_filename)));
+}
+
+void OatFileManager::AddVerificationTask(Thread* self, Task* task) {
   {
     WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
     if (verification_thread_pool_ == nullptr) {
@@ -859,10 +873,199 @@ void OatFileManager::RunBackgroundVerification(const std::vector<const DexFile*>
       verification_thread_pool_->StartWorkers(self);
     }
   }
-  verification_thread_pool_->AddTask(self, new BackgroundVerificationTask(
-      dex_files,
-      class_loader,
-      GetVdexFilename(odex_filename)));
+  verification_thread_pool_->AddTask(self, task);
+}
+
+class StartupClassVerificationTask final : public Task {
+ public:
+  StartupClassVerificationTask(std::vector<const DexFile*>&& dex_files,
+                               jobject class_loader,
+                               const std::string& profile_file)
+      : dex_files_(std::move(dex_files)),
+        class_loader_(class_loader),
+        profile_file_(profile_file) {}
+
+  ~StartupClassVerificationTask() {
+    Thread* const self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    soa.Vm()->DeleteGlobalRef(self, class_loader_);
+  }
+
+  void Run(Thread* self) override {
+    // Runtime threads cannot load classes when the runtime is debuggable.
+    if (!self->CanLoadClasses()) {
+      return;
+    }
+    ScopedTrace trace("Background verification of startup classes");
+
+    // Lock the file, it could be concurrently updated by the system. Don't block,
+    // the classes will then be verified when they are first used.
+    std::string error_msg;
+    ScopedFlock profile =
+        LockedFile::Open(profile_file_.c_str(), O_RDONLY, /*block=*/ false, &error_msg);
+    if (profile == nullptr) {
+      VLOG(verifier) << "Could not lock profile " << profile_file_ << ": " << error_msg;
+      return;
+    }
+    ProfileCompilationInfo profile_info(/*for_boot_image=*/ false);
+    if (!profile_info.Load(profile->Fd())) {
+      VLOG(verifier) << "Could not load profile " << profile_file_;
+      return;
+    }
+
+    Runtime* const runtime = Runtime::Current();
+    ClassLinker* const class_linker = runtime->GetClassLinker();
+    uint64_t number_of_classes = 0;
+    for (const DexFile* dex_file : dex_files_) {
+      const ArenaSet<dex::TypeIndex>* class_types = profile_info.GetClasses(*dex_file);
+      if (class_types == nullptr) {
+        // The profile does not reference this dex file.
+        continue;
+      }
+      for (dex::TypeIndex type_idx : *class_types) {
+        // The index is greater or equal to NumTypeIds if the type is an extra
+        // descriptor, not referenced by the dex file.
+        if (type_idx.index_ >= dex_file->NumTypeIds()) {
+          continue;
+        }
+        // Take handles inside the loop, like BackgroundVerificationTask, so that
+        // we do not block anyone else for long.
+        ScopedObjectAccess soa(self);
+        StackHandleScope<2> hs(self);
+        Handle<mirror::ClassLoader> h_loader(hs.NewHandle(
+            soa.Decode<mirror::ClassLoader>(class_loader_)));
+        Handle<mirror::Class> h_class(hs.NewHandle<mirror::Class>(class_linker->FindClass(
+            self,
+            dex_file->GetTypeDescriptor(type_idx),
+            h_loader)));
+        if (h_class == nullptr) {
+          DCHECK(self->IsExceptionPending());
+          self->ClearException();
+          continue;
+        }
+        if (h_class->IsPrimitive() ||
+            h_class->IsArrayClass() ||
+            &h_class->GetDexFile() != dex_file ||
+            h_class->IsVerified()) {
+          // Either not defined by this dex file, or there is nothing left to do.
+          continue;
+        }
+
+        // Only verify: speculatively running class initializers could change the
+        // semantics of the app.
+        metrics::AutoTimer timer{runtime->GetMetrics()->BackgroundClassVerificationTotalTime()};
+        class_linker->VerifyClass(self, /*verifier_deps=*/ nullptr, h_class);
+        if (self->IsExceptionPending()) {
+          // ClassLinker::VerifyClass can throw, but the exception isn't useful here.
+          self->ClearException();
+        }
+        ++number_of_classes;
+      }
+    }
+    runtime->GetMetrics()->BackgroundClassVerificationCount()->Add(number_of_classes);
+    VLOG(verifier) << "Verified " << number_of_classes << " startup classes in the background";
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  const std::vector<const DexFile*> dex_files_;
+  jobject class_loader_;
+  const std::string profile_file_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupClassVerificationTask);
+};
+
+void OatFileManager::RecordStartupVerificationCandidate(
+    const std::vector<std::unique_ptr<const DexFile>>& dex_files, jobject class_loader) {
+  Runtime* const runtime = Runtime::Current();
+  if (class_loader == nullptr ||
+      dex_files.empty() ||
+      runtime->IsZygote() ||
+      runtime->IsAotCompiler() ||
+      runtime->IsJavaDebuggable()) {
+    return;
+  }
+
+  Thread* const self = Thread::Current();
+  {
+    ReaderMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    if (startup_verification_started_ ||
+        startup_verification_candidates_.size() >= kMaxStartupVerificationCandidates) {
+      return;
+    }
+  }
+  StartupVerificationCandidate candidate;
+  candidate.base_location = DexFileLoader::GetBaseLocation(dex_files[0]->GetLocation());
+  for (const std::unique_ptr<const DexFile>& dex_file : dex_files) {
+    candidate.dex_files.push_back(dex_file.get());
+  }
+  {
+    ScopedObjectAccess soa(self);
+    candidate.class_loader =
+        soa.Vm()->AddWeakGlobalRef(self, soa.Decode<mirror::ClassLoader>(class_loader));
+  }
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    if (!startup_verification_started_ &&
+        startup_verification_candidates_.size() < kMaxStartupVerificationCandidates) {
+      startup_verification_candidates_.push_back(std::move(candidate));
+      return;
+    }
+  }
+  ScopedObjectAccess soa(self);
+  soa.Vm()->DeleteWeakGlobalRef(self, candidate.class_loader);
+}
+
+void OatFileManager::RunStartupClassVerification(const std::vector<std::string>& code_paths,
+                                                 const std::string& profile_file) {
+  Runtime* const runtime = Runtime::Current();
+  Thread* const self = Thread::Current();
+
+  // Take all the candidates, no more are recorded after this point. The app's own class loader
+  // has been created by now.
+  std::vector<StartupVerificationCandidate> candidates;
+  {
+    WriterMutexLock mu(self, *Locks::oat_file_manager_lock_);
+    startup_verification_started_ = true;
+    candidates.swap(startup_verification_candidates_);
+  }
+
+  for (StartupVerificationCandidate& candidate : candidates) {
+    jobject class_loader = nullptr;
+    {
+      ScopedObjectAccess soa(self);
+      // The dex files are freed with their class loader, so check that it is alive before
+      // using them. Holding the mutator lock keeps it alive until the global ref is created.
+      ObjPtr<mirror::ClassLoader> loader = soa.Decode<mirror::ClassLoader>(candidate.class_loader);
+      if (loader != nullptr && ContainsElement(code_paths, candidate.base_location)) {
+        // Create a global ref because the loader will be accessed from a different thread.
+        class_loader = soa.Vm()->AddGlobalRef(self, loader);
+      }
+      soa.Vm()->DeleteWeakGlobalRef(self, candidate.class_loader);
+    }
+    if (class_loader == nullptr) {
+      // The class loader has been unloaded, or is not for `code_paths`.
+      continue;
+    }
+
+    // Like for RunBackgroundVerification, we only verify for class loaders we know
+    // the lookup chain, because runtime threads do not call Java to load classes.
+    std::unique_ptr<ClassLoaderContext> context(
+        ClassLoaderContext::CreateContextForClassLoader(class_loader, nullptr));
+    if (context == nullptr || profile_file.empty() || runtime->IsShuttingDown(self)) {
+      ScopedObjectAccess soa(self);
+      soa.Vm()->DeleteGlobalRef(self, class_loader);
+      continue;
+    }
+
+    AddVerificationTask(self, new StartupClassVerificationTask(
+        std::move(candidate.dex_files),
+        class_loader,
+        profile_file));
+  }
 }
 
 void OatFileManager::WaitForWorkersToBeCreated() {
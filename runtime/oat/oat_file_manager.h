@@ -40,6 +40,7 @@ class ClassLoaderContext;
 class DexFile;
 class MemMap;
 class OatFile;
+class Task;
 class ThreadPool;
 
 // Class for dealing with oat file management.
@@ -128,6 +129,14 @@ class OatFileManager {
   void RunBackgroundVerification(const std::vector<const DexFile*>& dex_files,
                                  jobject class_loader);
 
+  // Verify the classes of the reference profile `profile_file` in the background, for the
+  // dex files opened earlier from `code_paths`. Only used with -Xbackground-verify-startup-classes.
+  // The work runs on the single verification thread: it is moved off the main thread but not
+  // parallelized, so that it does not compete with the app's own startup for cores.
+  void RunStartupClassVerification(const std::vector<std::string>& code_paths,
+                                   const std::string& profile_file)
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
   // Wait for thread pool workers to be created. This is used during shutdown as
   // threads are not allowed to attach while runtime is in shutdown lock.
   void WaitForWorkersToBeCreated();
@@ -161,15 +170,44 @@ class OatFileManager {
   // Return true if we should attempt to load the app image.
   bool ShouldLoadAppImage() const;
 
+  // Remember the dex files opened for `class_loader` until the app info is registered,
+  // so that RunStartupClassVerification() can find the dex files of the app.
+  void RecordStartupVerificationCandidate(
+      const std::vector<std::unique_ptr<const DexFile>>& dex_files, jobject class_loader)
+      REQUIRES(!Locks::oat_file_manager_lock_, !Locks::mutator_lock_);
+
+  // Add `task` to the verification thread pool, creating the pool if needed.
+  void AddVerificationTask(Thread* self, Task* task) REQUIRES(!Locks::oat_file_manager_lock_);
+
   std::set<std::unique_ptr<const OatFile>> oat_files_ GUARDED_BY(Locks::oat_file_manager_lock_);
 
   // Only use the compiled code in an OAT file when the file is on /system. If the OAT file
   // is not on /system, don't load it "executable".
   bool only_use_system_oat_files_;
 
-  // Single-thread pool used to run the verifier in the background.
+  // Single-thread pool used to run the verifier in the background, both for secondary dex
+  // files and for startup classes. Tasks run one after the other.
   std::unique_ptr<ThreadPool> verification_thread_pool_;
 
+  struct StartupVerificationCandidate {
+    // The base location of the dex files, which may only be accessed while `class_loader`,
+    // which owns them, is alive.
+    std::string base_location;
+    std::vector<const DexFile*> dex_files;
+    jweak class_loader;
+  };
+
+  // Maximum number of recorded candidates. The app info is registered early during app startup,
+  // so this only limits the weak references held by processes that never register it.
+  static constexpr size_t kMaxStartupVerificationCandidates = 32u;
+
+  // Dex files opened before the app info was registered, see RecordStartupVerificationCandidate().
+  std::vector<StartupVerificationCandidate> startup_verification_candidates_
+      GUARDED_BY(Locks::oat_file_manager_lock_);
+
+  // Whether the app info has been registered and no more candidates should be recorded.
+  bool startup_verification_started_ GUARDED_BY(Locks::oat_file_manager_lock_);
+
   DISALLOW_COPY_AND_ASSIGN(OatFileManager);
 };
 
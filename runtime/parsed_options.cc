@@ -263,6 +263,14 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XMadviseWillNeedArtFileSize:_")
           .WithType<unsigned int>()
           .IntoKey(M::MadviseWillNeedArtFileSize)
+      .Define("-Xlazy-image-decompression:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::LazyImageDecompression)
+      .Define("-Xbackground-verify-startup-classes:_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::BackgroundVerifyStartupClasses)
       .Define("-Xusejit:_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
@@ -411,10 +419,17 @@ std::unique_ptr<RuntimeParser> ParsedOptions::MakeParser(bool ignore_unrecognize
       .Define("-XX:ThreadSuspendTimeout=_")  // in ms
           .WithType<MillisecondsToNanoseconds>()  // store as ns
           .IntoKey(M::ThreadSuspendTimeout)
+      .Define("-XX:TimeToSafepointLogThreshold=_")  // in ms
+          .WithType<MillisecondsToNanoseconds>()  // store as ns
+          .IntoKey(M::TimeToSafepointLogThreshold)
       .Define("-XX:MonitorTimeoutEnable=_")
           .WithType<bool>()
           .WithValueMap({{"false", false}, {"true", true}})
           .IntoKey(M::MonitorTimeoutEnable)
+      .Define("-XX:LockContentionStats=_")
+          .WithType<bool>()
+          .WithValueMap({{"false", false}, {"true", true}})
+          .IntoKey(M::LockContentionStats)
       .Define("-XX:MonitorTimeout=_")  // in ms
           .WithType<int>()
           .IntoKey(M::MonitorTimeout)
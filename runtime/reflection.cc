@@ -31,6 +31,7 @@
 #include "mirror/object_array-inl.h"
 #include "nativehelper/scoped_local_ref.h"
 #include "nth_caller_visitor.h"
+#include "reflective_invoke_cache.h"
 #include "scoped_thread_state_change-inl.h"
 #include "stack_reference.h"
 #include "thread-inl.h"
@@ -222,6 +223,56 @@ class ArgArray {
                      PrettyDescriptor(found_descriptor).c_str()).c_str());
   }
 
+  // Fast path of BuildArgArrayFromObjectArray() for methods taking only references.
+  // Only the arguments flagged in `checked_arguments` are checked against their
+  // parameter types, the others are of type java.lang.Object.
+  bool BuildArgArrayFromReferences(ObjPtr<mirror::Object> receiver,
+                                   ObjPtr<mirror::ObjectArray<mirror::Object>> raw_args,
+                                   ArtMethod* m,
+                                   uint32_t checked_arguments,
+                                   Thread* self)
+      REQUIRES_SHARED(Locks::mutator_lock_) {
+    // Set receiver if non-null (method is not static)
+    if (receiver != nullptr) {
+      Append(receiver);
+    }
+    if (checked_arguments == 0u) {
+      for (size_t i = 1, args_offset = 0; i < shorty_len_; ++i, ++args_offset) {
+        DCHECK_EQ(shorty_[i], 'L');
+        Append(raw_args->GetWithoutChecks(args_offset));
+      }
+      return true;
+    }
+    const dex::TypeList* classes = m->GetParameterTypeList();
+    StackHandleScope<2> hs(self);
+    MutableHandle<mirror::Object> arg(hs.NewHandle<mirror::Object>(nullptr));
+    Handle<mirror::ObjectArray<mirror::Object>> args(
+        hs.NewHandle<mirror::ObjectArray<mirror::Object>>(raw_args));
+    for (size_t i = 1, args_offset = 0; i < shorty_len_; ++i, ++args_offset) {
+      DCHECK_EQ(shorty_[i], 'L');
+      arg.Assign(args->GetWithoutChecks(args_offset));
+      if (arg != nullptr && (checked_arguments & (1u << args_offset)) != 0u) {
+        ObjPtr<mirror::Class> dst_class(
+            m->ResolveClassFromTypeIndex(classes->GetTypeItem(args_offset).type_idx_));
+        if (dst_class == nullptr) {
+          CHECK(self->IsExceptionPending());
+          return false;
+        }
+        if (UNLIKELY(!arg->InstanceOf(dst_class))) {
+          ThrowIllegalArgumentException(
+              StringPrintf("method %s argument %zd has type %s, got %s",
+                  m->PrettyMethod(false).c_str(),
+                  args_offset + 1,  // Humans don't count from 0.
+                  mirror::Class::PrettyDescriptor(dst_class).c_str(),
+                  mirror::Object::PrettyTypeOf(arg.Get()).c_str()).c_str());
+          return false;
+        }
+      }
+      Append(arg.Get());
+    }
+    return true;
+  }
+
   bool BuildArgArrayFromObjectArray(ObjPtr<mirror::Object> receiver,
                                     ObjPtr<mirror::ObjectArray<mirror::Object>> raw_args,
                                     ArtMethod* m,
@@ -459,11 +510,11 @@ void InvokeWithArgArray(const ScopedObjectAccessAlreadyRunnable& soa,
 }
 
 ALWAYS_INLINE
-bool CheckArgsForInvokeMethod(ArtMethod* np_method,
+bool CheckArgsForInvokeMethod(const ReflectiveInvokeCache::Entry& invoke_info,
                               ObjPtr<mirror::ObjectArray<mirror::Object>> objects)
     REQUIRES_SHARED(Locks::mutator_lock_) {
-  const dex::TypeList* classes = np_method->GetParameterTypeList();
-  uint32_t classes_size = (classes == nullptr) ? 0 : classes->Size();
+  // The shorty has one character for the return type and one for each parameter.
+  uint32_t classes_size = invoke_info.shorty_len - 1u;
   uint32_t arg_count = (objects == nullptr) ? 0 : objects->GetLength();
   if (UNLIKELY(arg_count != classes_size)) {
     ThrowIllegalArgumentException(StringPrintf("Wrong number of arguments; expected %d, got %d",
@@ -477,15 +528,32 @@ ALWAYS_INLINE
 bool InvokeMethodImpl(const ScopedObjectAccessAlreadyRunnable& soa,
                       ArtMethod* m,
                       ArtMethod* np_method,
+                      const ReflectiveInvokeCache::Entry& invoke_info,
                       ObjPtr<mirror::Object> receiver,
                       ObjPtr<mirror::ObjectArray<mirror::Object>> objects,
                       const char** shorty,
                       JValue* result) REQUIRES_SHARED(Locks::mutator_lock_) {
+  DCHECK_EQ(invoke_info.method, np_method);
   // Invoke the method.
-  uint32_t shorty_len = 0;
-  *shorty = np_method->GetShorty(&shorty_len);
-  ArgArray arg_array(*shorty, shorty_len);
-  if (!arg_array.BuildArgArrayFromObjectArray(receiver, objects, np_method, soa.Self())) {
+  *shorty = invoke_info.shorty;
+  ArgArray arg_array(invoke_info.shorty, invoke_info.shorty_len);
+  bool success = false;
+  switch (invoke_info.kind) {
+    case ReflectiveInvokeCache::Kind::kNoArguments:
+      if (receiver != nullptr) {
+        arg_array.Append(receiver);
+      }
+      success = true;
+      break;
+    case ReflectiveInvokeCache::Kind::kReferenceArguments:
+      success = arg_array.BuildArgArrayFromReferences(
+          receiver, objects, np_method, invoke_info.checked_arguments, soa.Self());
+      break;
+    case ReflectiveInvokeCache::Kind::kGeneric:
+      success = arg_array.BuildArgArrayFromObjectArray(receiver, objects, np_method, soa.Self());
+      break;
+  }
+  if (!success) {
     CHECK(soa.Self()->IsExceptionPending());
     return false;
   }
@@ -745,7 +813,10 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
   ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>>(javaArgs);
   auto* np_method = m->GetInterfaceMethodIfProxy(kPointerSize);
-  if (!CheckArgsForInvokeMethod(np_method, objects)) {
+  // Copy the entry, the cache may be cleared at a suspend point before we are done with it.
+  const ReflectiveInvokeCache::Entry invoke_info =
+      soa.Self()->GetReflectiveInvokeCache()->Get(np_method);
+  if (!CheckArgsForInvokeMethod(invoke_info, objects)) {
     return nullptr;
   }
 
@@ -770,7 +841,7 @@ jobject InvokeMethod(const ScopedObjectAccessAlreadyRunnable& soa, jobject javaM
   // Invoke the method.
   JValue result;
   const char* shorty;
-  if (!InvokeMethodImpl(soa, m, np_method, receiver, objects, &shorty, &result)) {
+  if (!InvokeMethodImpl(soa, m, np_method, invoke_info, receiver, objects, &shorty, &result)) {
     return nullptr;
   }
   return soa.AddLocalReference<jobject>(BoxPrimitive(Primitive::GetType(shorty[0]), result));
@@ -822,14 +893,17 @@ void InvokeConstructor(const ScopedObjectAccessAlreadyRunnable& soa,
   ObjPtr<mirror::ObjectArray<mirror::Object>> objects =
       soa.Decode<mirror::ObjectArray<mirror::Object>>(javaArgs);
   ArtMethod* np_method = constructor->GetInterfaceMethodIfProxy(kRuntimePointerSize);
-  if (!CheckArgsForInvokeMethod(np_method, objects)) {
+  // Copy the entry, the cache may be cleared at a suspend point before we are done with it.
+  const ReflectiveInvokeCache::Entry invoke_info =
+      soa.Self()->GetReflectiveInvokeCache()->Get(np_method);
+  if (!CheckArgsForInvokeMethod(invoke_info, objects)) {
     return;
   }
 
   // Invoke the constructor.
   JValue result;
   const char* shorty;
-  InvokeMethodImpl(soa, constructor, np_method, receiver, objects, &shorty, &result);
+  InvokeMethodImpl(soa, constructor, np_method, invoke_info, receiver, objects, &shorty, &result);
 }
 
 ObjPtr<mirror::Object> BoxPrimitive(Primitive::Type src_class, const JValue& value) {
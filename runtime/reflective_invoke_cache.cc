@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "reflective_invoke_cache.h"
+
+#include "art_method-inl.h"
+#include "dex/dex_file-inl.h"
+#include "object_callbacks.h"
+#include "thread-inl.h"
+
+namespace art HIDDEN {
+
+void ReflectiveInvokeCache::Clear(Thread* owning_thread) {
+  DCHECK(owning_thread->GetReflectiveInvokeCache() == this);
+  DCHECK(owning_thread == Thread::Current() || owning_thread->IsSuspended());
+  entries_.fill(Entry{});
+}
+
+void ReflectiveInvokeCache::Sweep(IsMarkedVisitor* visitor) {
+  for (Entry& entry : entries_) {
+    if (entry.method == nullptr) {
+      continue;
+    }
+    mirror::Class* klass = entry.method->GetDeclaringClass<kWithoutReadBarrier>().Ptr();
+    if (visitor->IsMarked(klass) == nullptr) {
+      // The class is being unloaded, together with the method and the dex file.
+      entry = Entry{};
+    }
+  }
+}
+
+void ReflectiveInvokeCache::Fill(ArtMethod* method, /*out*/ Entry* entry) {
+  uint32_t shorty_len = 0u;
+  const char* shorty = method->GetShorty(&shorty_len);
+  Kind kind = Kind::kNoArguments;
+  uint32_t checked_arguments = 0u;
+  if (shorty_len > 1u) {
+    kind = Kind::kReferenceArguments;
+    const dex::TypeList* classes = method->GetParameterTypeList();
+    DCHECK_EQ(classes->Size(), shorty_len - 1u);
+    for (uint32_t i = 0; i != classes->Size(); ++i) {
+      if (shorty[i + 1u] != 'L' || i >= kMaxCheckedArguments) {
+        kind = Kind::kGeneric;
+        break;
+      }
+      // Anything can be passed as java.lang.Object, so we do not need to resolve the type.
+      std::string_view descriptor = method->GetDexFile()->GetTypeDescriptorView(
+          classes->GetTypeItem(i).type_idx_);
+      if (descriptor != "Ljava/lang/Object;") {
+        checked_arguments |= 1u << i;
+      }
+    }
+  }
+  entry->method = method;
+  entry->shorty = shorty;
+  entry->shorty_len = shorty_len;
+  entry->kind = kind;
+  entry->checked_arguments = (kind == Kind::kReferenceArguments) ? checked_arguments : 0u;
+}
+
+}  // namespace art
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_RUNTIME_REFLECTIVE_INVOKE_CACHE_H_
+#define ART_RUNTIME_REFLECTIVE_INVOKE_CACHE_H_
+
+#include <array>
+
+#include "base/bit_utils.h"
+#include "base/locks.h"
+#include "base/macros.h"
+
+namespace art HIDDEN {
+
+class ArtMethod;
+class IsMarkedVisitor;
+class Thread;
+
+// Small thread-local cache for Method.invoke() and Constructor.newInstance().
+// For each recently invoked method it holds the shorty and the way the boxed
+// arguments need to be converted, so that only the first invocation of a method
+// has to inspect its parameter types.
+// All operations must be done from the owning thread,
+// or at a point when the owning thread is suspended.
+//
+// The shorty points into the dex file and the method may belong to a class that
+// can be unloaded, so the cache is cleared whenever any dex file is unloaded and
+// entries of dead classes are swept by the GC.
+class ReflectiveInvokeCache {
+ public:
+  // How the boxed arguments are converted to the argument array.
+  enum class Kind : uint8_t {
+    kNoArguments,         // The method has no parameters.
+    kReferenceArguments,  // All parameters are references.
+    kGeneric,             // Some parameters are primitive and need unboxing and widening.
+  };
+
+  struct Entry {
+    ArtMethod* method = nullptr;
+    const char* shorty = nullptr;
+    uint32_t shorty_len = 0u;
+    Kind kind = Kind::kGeneric;
+    // For kReferenceArguments, bit `i` is set if the argument `i` needs to be checked
+    // against the parameter type, i.e. the parameter type is not java.lang.Object.
+    uint32_t checked_arguments = 0u;
+  };
+
+  static constexpr size_t kSize = 32;
+
+  // Methods with more reference parameters than this use the generic conversion.
+  static constexpr size_t kMaxCheckedArguments = BitSizeOf<uint32_t>();
+
+  // Clear the whole cache. It requires the owning thread for DCHECKs.
+  void Clear(Thread* owning_thread);
+
+  // Return the entry for `method`, computing it on a miss.
+  ALWAYS_INLINE const Entry& Get(ArtMethod* method) REQUIRES_SHARED(Locks::mutator_lock_) {
+    Entry& entry = entries_[IndexOf(method)];
+    if (UNLIKELY(entry.method != method)) {
+      Fill(method, &entry);
+    }
+    return entry;
+  }
+
+  // Remove the entries of methods whose declaring class is not marked.
+  void Sweep(IsMarkedVisitor* visitor) REQUIRES_SHARED(Locks::mutator_lock_);
+
+ private:
+  static ALWAYS_INLINE size_t IndexOf(ArtMethod* method) {
+    static_assert(IsPowerOfTwo(kSize), "Size must be power of two");
+    size_t index = (reinterpret_cast<uintptr_t>(method) >> 4) & (kSize - 1);
+    DCHECK_LT(index, kSize);
+    return index;
+  }
+
+  static void Fill(ArtMethod* method, /*out*/ Entry* entry) REQUIRES_SHARED(Locks::mutator_lock_);
+
+  std::array<Entry, kSize> entries_;
+};
+
+}  // namespace art
+
+#endif  // ART_RUNTIME_REFLECTIVE_INVOKE_CACHE_H_
@@ -309,6 +309,8 @@ Runtime::Runtime()
       madvise_willneed_total_dex_size_(0),
       madvise_willneed_odex_filesize_(0),
       madvise_willneed_art_filesize_(0),
+      use_lazy_image_decompression_(false),
+      background_verify_startup_classes_(false),
       safe_mode_(false),
       hidden_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
       core_platform_api_policy_(hiddenapi::EnforcementPolicy::kDisabled),
@@ -1665,10 +1667,13 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
 
   monitor_list_ = new MonitorList;
   monitor_pool_ = MonitorPool::Create();
-  thread_list_ = new ThreadList(GetThreadSuspendTimeout(&runtime_options));
+  thread_list_ = new ThreadList(
+      GetThreadSuspendTimeout(&runtime_options),
+      runtime_options.GetOrDefault(Opt::TimeToSafepointLogThreshold).GetNanoseconds());
   intern_table_ = new InternTable;
 
   monitor_timeout_enable_ = runtime_options.GetOrDefault(Opt::MonitorTimeoutEnable);
+  BaseMutex::SetContentionStatsEnabled(runtime_options.GetOrDefault(Opt::LockContentionStats));
   int monitor_timeout_ms = runtime_options.GetOrDefault(Opt::MonitorTimeout);
   if (monitor_timeout_ms < Monitor::kMonitorTimeoutMinMs) {
     LOG(WARNING) << "Monitor timeout too short: Increasing";
@@ -1719,6 +1724,9 @@ bool Runtime::Init(RuntimeArgumentMap&& runtime_options_in) {
   madvise_willneed_total_dex_size_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedVdexFileSize);
   madvise_willneed_odex_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedOdexFileSize);
   madvise_willneed_art_filesize_ = runtime_options.GetOrDefault(Opt::MadviseWillNeedArtFileSize);
+  use_lazy_image_decompression_ = runtime_options.GetOrDefault(Opt::LazyImageDecompression);
+  background_verify_startup_classes_ =
+      runtime_options.GetOrDefault(Opt::BackgroundVerifyStartupClasses);
 
   jni_ids_indirection_ = runtime_options.GetOrDefault(Opt::OpaqueJniIds);
   automatically_set_jni_ids_indirection_ =
@@ -2458,6 +2466,7 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   GetClassLinker()->DumpForSigQuit(os);
   GetInternTable()->DumpForSigQuit(os);
   GetJavaVM()->DumpForSigQuit(os);
+  monitor_list_->DumpForSigQuit(os);
   GetHeap()->DumpForSigQuit(os);
   oat_file_manager_->DumpForSigQuit(os);
   if (GetJit() != nullptr) {
@@ -2471,6 +2480,9 @@ void Runtime::DumpForSigQuit(std::ostream& os) {
   os << "\n";
 
   BaseMutex::DumpAll(os);
+  if (BaseMutex::IsContentionStatsEnabled()) {
+    BaseMutex::DumpContentionStats(os);
+  }
 
   // Inform anyone else who is interested in SigQuit.
   {
@@ -2878,6 +2890,12 @@ void Runtime::RegisterAppInfo(const std::string& package_name,
     metrics_reporter_->NotifyAppInfoUpdated(&app_info_);
   }
 
+  if (background_verify_startup_classes_) {
+    // The class loader of `code_paths` has been created by now, verify the classes of
+    // the reference profile on a background thread before the app gets to use them.
+    GetOatFileManager().RunStartupClassVerification(code_paths, ref_profile_filename);
+  }
+
   if (jit_.get() == nullptr) {
     // We are not JITing. Nothing to do.
     return;
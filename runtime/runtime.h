@@ -971,6 +971,14 @@ class Runtime {
     return madvise_willneed_art_filesize_;
   }
 
+  bool UseLazyImageDecompression() const {
+    return use_lazy_image_decompression_;
+  }
+
+  bool BackgroundVerifyStartupClasses() const {
+    return background_verify_startup_classes_;
+  }
+
   const std::string& GetJdwpOptions() {
     return jdwp_options_;
   }
@@ -1441,6 +1449,13 @@ class Runtime {
   // A 0 for this will turn off madvising to MADV_WILLNEED
   size_t madvise_willneed_art_filesize_;
 
+  // Whether compressed image blocks are decompressed on first access rather than at load time.
+  bool use_lazy_image_decompression_;
+
+  // Whether the classes of the app's reference profile are verified on a background thread
+  // at startup, rather than lazily on the thread that first uses them.
+  bool background_verify_startup_classes_;
+
   // Whether the application should run in safe mode, that is, interpreter only.
   bool safe_mode_;
 
@@ -1918,6 +1918,8 @@ bool RuntimeImage::WriteImageToDisk(std::string* error_msg) {
           reinterpret_cast<const uint8_t*>(image->GetImageBitmap().Begin()),
           kImageStorageMode,
           kMaxImageBlockSize,
+          /* compression_level= */ 0u,
+          /* train_zstd_dictionary= */ false,
           /* update_checksum= */ false,
           error_msg)) {
     return false;
@@ -1511,6 +1511,7 @@ bool Thread::PassActiveSuspendBarriers() {
       // We have at most one active active_suspendall_barrier. See thread.h comment.
       pass_barriers.push_back(tlsPtr_.active_suspendall_barrier);
       tlsPtr_.active_suspendall_barrier = nullptr;
+      suspend_all_barrier_pass_time_ns_ = NanoTime();
     }
     for (WrappedSuspend1Barrier* w = tlsPtr_.active_suspend1_barriers; w != nullptr; w = w->next_) {
       CHECK_EQ(w->magic_, WrappedSuspend1Barrier::kMagic)
@@ -1550,9 +1551,12 @@ void Thread::RunCheckpointFunction() {
   // Grab the suspend_count lock, get the next checkpoint and update all the checkpoint fields. If
   // there are no more checkpoints we will also clear the kCheckpointRequest flag.
   Closure* checkpoint;
+  uint64_t request_time_ns;
   {
     MutexLock mu(this, *Locks::thread_suspend_count_lock_);
     checkpoint = tlsPtr_.checkpoint_function;
+    request_time_ns = checkpoint_request_time_ns_;
+    checkpoint_request_time_ns_ = 0u;
     if (!checkpoint_overflow_.empty()) {
       // Overflow list not empty, copy the first one out and continue.
       tlsPtr_.checkpoint_function = checkpoint_overflow_.front();
@@ -1563,6 +1567,10 @@ void Thread::RunCheckpointFunction() {
       AtomicClearFlag(ThreadFlag::kCheckpointRequest);
     }
   }
+  if (request_time_ns != 0u) {
+    Runtime::Current()->GetThreadList()->RecordTimeToCheckpoint(this,
+                                                                NanoTime() - request_time_ns);
+  }
   // Outside the lock, run the checkpoint function.
   ScopedTrace trace("Run checkpoint function");
   CHECK(checkpoint != nullptr) << "Checkpoint flag set without pending checkpoint";
@@ -1592,6 +1600,7 @@ bool Thread::RequestCheckpoint(Closure* function) {
   // Succeeded setting checkpoint flag, now insert the actual checkpoint.
   if (tlsPtr_.checkpoint_function == nullptr) {
     tlsPtr_.checkpoint_function = function;
+    checkpoint_request_time_ns_ = NanoTime();
   } else {
     checkpoint_overflow_.push_back(function);
   }
@@ -4426,6 +4435,10 @@ void Thread::VisitReflectiveTargets(ReflectiveValueVisitor* visitor) {
        brhs = brhs->GetLink()) {
     brhs->VisitTargets(visitor);
   }
+  // Structural redefinition replaces the methods, so drop what we cached about the old ones.
+  if (reflective_invoke_cache_ != nullptr) {
+    reflective_invoke_cache_->Clear(this);
+  }
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
@@ -4561,6 +4574,9 @@ void Thread::SweepInterpreterCache(IsMarkedVisitor* visitor) {
   for (InterpreterCache::Entry& entry : GetInterpreterCache()->GetArray()) {
     SweepCacheEntry(visitor, reinterpret_cast<const Instruction*>(entry.first), &entry.second);
   }
+  if (reflective_invoke_cache_ != nullptr) {
+    reflective_invoke_cache_->Sweep(visitor);
+  }
 }
 
 // FIXME: clang-r433403 reports the below function exceeds frame size limit.
@@ -4815,6 +4831,9 @@ void Thread::ClearAllInterpreterCaches() {
   static struct ClearInterpreterCacheClosure : Closure {
     void Run(Thread* thread) override {
       thread->GetInterpreterCache()->Clear(thread);
+      if (thread->reflective_invoke_cache_ != nullptr) {
+        thread->reflective_invoke_cache_->Clear(thread);
+      }
     }
   } closure;
   Runtime::Current()->GetThreadList()->RunCheckpoint(&closure);
@@ -45,6 +45,7 @@
 #include "offsets.h"
 #include "read_barrier_config.h"
 #include "reflective_handle_scope.h"
+#include "reflective_invoke_cache.h"
 #include "runtime_globals.h"
 #include "runtime_stats.h"
 #include "suspend_reason.h"
@@ -1582,6 +1583,16 @@ class EXPORT Thread {
   // called if the pre-conditions might no longer hold true.
   static void ClearAllInterpreterCaches();
 
+  // Return the thread-local cache used by Method.invoke() and Constructor.newInstance(),
+  // allocating it on first use. Like the interpreter cache, it is cleared by
+  // ClearAllInterpreterCaches().
+  ReflectiveInvokeCache* GetReflectiveInvokeCache() {
+    if (UNLIKELY(reflective_invoke_cache_ == nullptr)) {
+      reflective_invoke_cache_.reset(new ReflectiveInvokeCache());
+    }
+    return reflective_invoke_cache_.get();
+  }
+
   template<PointerSize pointer_size>
   static constexpr ThreadOffset<pointer_size> InterpreterCacheOffset() {
     return ThreadOffset<pointer_size>(OFFSETOF_MEMBER(Thread, interpreter_cache_));
@@ -2358,9 +2369,20 @@ class EXPORT Thread {
                                                // running checkpoints.
   std::atomic<uint8_t> checkpoint_count_ = 0;  // Number of checkpoints we started running.
 
+  // Time at which we last passed a SuspendAll barrier. Used by the suspending thread to compute
+  // how long it took us to reach a suspend point.
+  uint64_t suspend_all_barrier_pass_time_ns_ GUARDED_BY(Locks::thread_suspend_count_lock_) = 0;
+
+  // Time at which a checkpoint was requested while none was pending, cleared when we start
+  // running it. Used to compute how long it took us to reach a checkpoint.
+  uint64_t checkpoint_request_time_ns_ GUARDED_BY(Locks::thread_suspend_count_lock_) = 0;
+
   // Note that it is not in the packed struct, may not be accessed for cross compilation.
   uintptr_t poison_object_cookie_ = 0;
 
+  // Cache for reflective invokes, allocated on first use since most threads never need it.
+  std::unique_ptr<ReflectiveInvokeCache> reflective_invoke_cache_;
+
   // Pending extra checkpoints if checkpoint_function_ is already used.
   std::list<Closure*> checkpoint_overflow_ GUARDED_BY(Locks::thread_suspend_count_lock_);
 
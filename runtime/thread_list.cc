@@ -23,6 +23,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <map>
 #include <sstream>
 #include <tuple>
@@ -30,6 +31,7 @@
 
 #include "android-base/stringprintf.h"
 #include "art_field-inl.h"
+#include "art_method.h"
 #include "base/aborting.h"
 #include "base/histogram-inl.h"
 #include "base/mutex-inl.h"
@@ -72,13 +74,18 @@ static constexpr uint64_t kLongThreadSuspendThreshold = MsToNs(5);
 // some history.
 static constexpr bool kDumpUnattachedThreadNativeStackForSigQuit = true;
 
-ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns)
+ThreadList::ThreadList(uint64_t thread_suspend_timeout_ns,
+                       uint64_t time_to_safepoint_log_threshold_ns)
     : suspend_all_count_(0),
       unregistering_count_(0),
       suspend_all_histogram_("suspend all histogram", 16, 64),
+      time_to_safepoint_histogram_("time to safepoint histogram", 16, 64),
+      suspend_all_request_time_ns_(0u),
+      last_time_to_safepoint_ns_(0u),
       long_suspend_(false),
       shut_down_(false),
       thread_suspend_timeout_ns_(thread_suspend_timeout_ns),
+      time_to_safepoint_log_threshold_ns_(time_to_safepoint_log_threshold_ns),
       empty_checkpoint_barrier_(new Barrier(0)) {
   CHECK(Monitor::IsValidLockWord(LockWord::FromThinLockId(kMaxThreadId, 1, 0U)));
 }
@@ -141,6 +148,11 @@ void ThreadList::DumpForSigQuit(std::ostream& os) {
       suspend_all_histogram_.CreateHistogram(&data);
       suspend_all_histogram_.PrintConfidenceIntervals(os, 0.99, data);  // Dump time to suspend.
     }
+    if (time_to_safepoint_histogram_.SampleSize() > 0) {
+      Histogram<uint64_t>::CumulativeData data;
+      time_to_safepoint_histogram_.CreateHistogram(&data);
+      time_to_safepoint_histogram_.PrintConfidenceIntervals(os, 0.99, data);
+    }
   }
   bool dump_native_stack = Runtime::Current()->GetDumpNativeStackOnSigQuit();
   Dump(os, dump_native_stack);
@@ -528,6 +540,13 @@ void ThreadList::RunEmptyCheckpoint() {
   }
 }
 
+// Logs the reports collected by RecordTimeToSafepoint(), after resuming the threads.
+static void LogSafepointReports(const std::vector<std::string>& reports) {
+  for (const std::string& report : reports) {
+    LOG(WARNING) << report;
+  }
+}
+
 // Separate function to disable just the right amount of thread-safety analysis.
 ALWAYS_INLINE void AcquireMutatorLockSharedUncontended(Thread* self)
     ACQUIRE_SHARED(*Locks::mutator_lock_) NO_THREAD_SAFETY_ANALYSIS {
@@ -557,13 +576,15 @@ void ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   const uint64_t suspend_start_time = NanoTime();
   VLOG(threads) << "Suspending all for thread flip";
   SuspendAllInternal(self);
-  if (pause_listener != nullptr) {
-    pause_listener->StartPause();
-  }
 
   // Run the flip callback for the collector.
   Locks::mutator_lock_->ExclusiveLock(self);
   suspend_all_histogram_.AdjustAndAddValue(NanoTime() - suspend_start_time);
+  RecordTimeToSafepoint(self, "thread flip");
+  if (pause_listener != nullptr) {
+    pause_listener->SafepointReached(last_time_to_safepoint_ns_);
+    pause_listener->StartPause();
+  }
   flip_callback->Run(self);
 
   std::vector<Thread*> flipping_threads;  // All suspended threads. Includes us.
@@ -604,11 +625,14 @@ void ThreadList::FlipThreadRoots(Closure* thread_flip_visitor,
   // the mutator_lock_ in shared mode, and decremented suspend_all_count_.  This avoids a
   // concurrent SuspendAll, and ensures that newly started threads see a correct value of
   // suspend_all_count.
+  std::vector<std::string> safepoint_reports;
+  safepoint_reports.swap(pending_safepoint_reports_);
   {
     MutexLock mu(self, *Locks::thread_list_lock_);
     Locks::thread_suspend_count_lock_->Lock(self);
     ResumeAllInternal(self);
   }
+  LogSafepointReports(safepoint_reports);
 
   collector->RegisterPause(NanoTime() - suspend_start_time);
 
@@ -803,6 +827,7 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
     if (suspend_time > kLongThreadSuspendThreshold) {
       LOG(WARNING) << "Suspending all threads took: " << PrettyDuration(suspend_time);
     }
+    RecordTimeToSafepoint(self, cause);
 
     if (kDebugLocking) {
       // Debug check that all threads are suspended.
@@ -823,6 +848,72 @@ void ThreadList::SuspendAll(const char* cause, bool long_suspend) {
   }
 }
 
+void ThreadList::RecordTimeToSafepoint(Thread* self, const char* cause) {
+  // Threads that were already suspended when we requested the suspension were passed by us and
+  // keep an older pass time. Only look at the threads we had to wait for.
+  std::vector<std::pair<uint64_t, Thread*>> waited_for;
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    for (Thread* thread : list_) {
+      uint64_t pass_time_ns = thread->suspend_all_barrier_pass_time_ns_;
+      if (thread != self && pass_time_ns >= suspend_all_request_time_ns_) {
+        waited_for.emplace_back(pass_time_ns - suspend_all_request_time_ns_, thread);
+      }
+    }
+  }
+  // The other threads stay suspended, and therefore registered, until we resume them, so we can
+  // keep using them without the locks.
+  for (const auto& [time_ns, thread] : waited_for) {
+    time_to_safepoint_histogram_.AdjustAndAddValue(time_ns);
+    Runtime::Current()->GetMetrics()->TimeToSafepoint()->Add(NsToUs(time_ns));
+  }
+  if (waited_for.empty()) {
+    last_time_to_safepoint_ns_ = 0u;
+    return;
+  }
+  std::sort(waited_for.begin(), waited_for.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first;
+  });
+  last_time_to_safepoint_ns_ = waited_for.front().first;
+
+  if (ATraceEnabled()) {
+    std::string name;
+    waited_for.front().second->GetThreadName(name);
+    ScopedTrace trace("Slowest thread to suspend for " + std::string(cause) + ": " + name + " (" +
+                      PrettyDuration(last_time_to_safepoint_ns_) + ")");
+  }
+  if (time_to_safepoint_log_threshold_ns_ == 0u) {
+    return;
+  }
+  // The threads are now suspended at the suspend point they reached last, so their stacks show
+  // where they were running when the suspension was requested, e.g. a long loop or a JNI call.
+  // The stacks can only be walked while the threads are suspended, but the reports are logged
+  // by ResumeAll() once the threads run again.
+  DCHECK(pending_safepoint_reports_.empty());
+  for (const auto& [time_ns, thread] : waited_for) {
+    if (time_ns <= time_to_safepoint_log_threshold_ns_ ||
+        pending_safepoint_reports_.size() == kMaxLoggedSafepointOffenders) {
+      break;
+    }
+    std::ostringstream oss;
+    oss << "Suspending all threads for " << cause << ": " << *thread << " took "
+        << PrettyDuration(time_ns) << " to reach a suspend point\n";
+    thread->DumpJavaStack(oss, /*check_suspended=*/ true, /*dump_locks=*/ false);
+    pending_safepoint_reports_.push_back(oss.str());
+  }
+}
+
+void ThreadList::RecordTimeToCheckpoint(Thread* thread, uint64_t time_ns) {
+  Runtime::Current()->GetMetrics()->TimeToCheckpoint()->Add(NsToUs(time_ns));
+  if (time_to_safepoint_log_threshold_ns_ != 0u && time_ns > time_to_safepoint_log_threshold_ns_) {
+    std::ostringstream oss;
+    oss << *thread << " took " << PrettyDuration(time_ns) << " to reach a checkpoint\n";
+    thread->DumpJavaStack(oss, /*check_suspended=*/ false, /*dump_locks=*/ false);
+    LOG(WARNING) << oss.str();
+  }
+}
+
 // Ensures all threads running Java suspend and that those not running Java don't start.
 void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
   // self can be nullptr if this is an unregistered thread.
@@ -855,6 +946,7 @@ void ThreadList::SuspendAllInternal(Thread* self, SuspendReason reason) {
         bool found_myself = false;
         // Update global suspend all state for attaching threads.
         ++suspend_all_count_;
+        suspend_all_request_time_ns_ = NanoTime();
         pending_threads.store(list_.size() - (self == nullptr ? 0 : 1), std::memory_order_relaxed);
         // Increment everybody else's suspend count.
         for (const auto& thread : list_) {
@@ -956,9 +1048,14 @@ void ThreadList::ResumeAll() {
     // Debug check that all threads are suspended.
     AssertOtherThreadsAreSuspended(self);
   }
-  MutexLock mu(self, *Locks::thread_list_lock_);
-  MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
-  ResumeAllInternal(self);
+  std::vector<std::string> safepoint_reports;
+  safepoint_reports.swap(pending_safepoint_reports_);
+  {
+    MutexLock mu(self, *Locks::thread_list_lock_);
+    MutexLock mu2(self, *Locks::thread_suspend_count_lock_);
+    ResumeAllInternal(self);
+  }
+  LogSafepointReports(safepoint_reports);
 }
 
 // Holds thread_list_lock_ and suspend_count_lock_
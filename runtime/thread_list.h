@@ -19,6 +19,7 @@
 
 #include <bitset>
 #include <list>
+#include <string>
 #include <vector>
 
 #include "barrier.h"
@@ -57,7 +58,12 @@ class ThreadList {
   static constexpr int kMaxSuspendRetries = kIsDebugBuild ? 500 : 5000;
   static constexpr useconds_t kThreadSuspendSleepUs = 100;
 
-  explicit ThreadList(uint64_t thread_suspend_timeout_ns);
+  // Time-to-safepoint logging is disabled by default.
+  static constexpr uint64_t kDefaultTimeToSafepointLogThreshold = 0u;
+  // The maximum number of threads logged for a single suspension that took too long.
+  static constexpr size_t kMaxLoggedSafepointOffenders = 3u;
+
+  ThreadList(uint64_t thread_suspend_timeout_ns, uint64_t time_to_safepoint_log_threshold_ns);
   ~ThreadList();
 
   void ShutDown();
@@ -215,6 +221,16 @@ class ThreadList {
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_,
                !Locks::mutator_lock_);
 
+  // Returns how long the slowest thread took to reach a suspend point during the last SuspendAll
+  // or FlipThreadRoots, or 0 if no thread was running when it was requested.
+  uint64_t GetLastTimeToSafepoint() const REQUIRES(Locks::mutator_lock_) {
+    return last_time_to_safepoint_ns_;
+  }
+
+  // Record that `thread` took `time_ns` between a checkpoint request and running it.
+  void RecordTimeToCheckpoint(Thread* thread, uint64_t time_ns)
+      REQUIRES_SHARED(Locks::mutator_lock_);
+
   // Wait for suspend barrier to reach zero. Return a string possibly containing diagnostic
   // information on timeout, nothing on success.  The argument t specifies a thread to monitor for
   // the diagnostic information. If 0 is passed, we return an empty string on timeout.  Normally
@@ -257,6 +273,12 @@ class ThreadList {
                !Locks::thread_suspend_count_lock_,
                !Locks::mutator_lock_);
 
+  // Record how long each thread took to pass the barrier of the SuspendAllInternal call that just
+  // completed, and prepare reports for the slowest ones if they exceed the time-to-safepoint log
+  // threshold. The reports are logged after resuming the threads.
+  void RecordTimeToSafepoint(Thread* self, const char* cause)
+      REQUIRES(Locks::mutator_lock_, !Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
+
   void AssertOtherThreadsAreSuspended(Thread* self)
       REQUIRES(!Locks::thread_list_lock_, !Locks::thread_suspend_count_lock_);
 
@@ -278,6 +300,20 @@ class ThreadList {
   // by mutator lock ensures no thread can read when another thread is modifying it.
   Histogram<uint64_t> suspend_all_histogram_ GUARDED_BY(Locks::mutator_lock_);
 
+  // Per-thread time between a SuspendAll request and the thread passing the suspend barrier, for
+  // the threads that were not already suspended. Guarded like suspend_all_histogram_.
+  Histogram<uint64_t> time_to_safepoint_histogram_ GUARDED_BY(Locks::mutator_lock_);
+
+  // Time at which the ongoing SuspendAll requested all threads to suspend.
+  uint64_t suspend_all_request_time_ns_ GUARDED_BY(Locks::thread_suspend_count_lock_);
+
+  // Time the slowest thread took to reach a suspend point during the last SuspendAll.
+  uint64_t last_time_to_safepoint_ns_ GUARDED_BY(Locks::mutator_lock_);
+
+  // Reports for the threads that exceeded the time-to-safepoint log threshold during the ongoing
+  // SuspendAll, logged when the threads are resumed.
+  std::vector<std::string> pending_safepoint_reports_ GUARDED_BY(Locks::mutator_lock_);
+
   // Whether or not the current thread suspension is long.
   bool long_suspend_;
 
@@ -288,6 +324,10 @@ class ThreadList {
   // Thread suspension timeout in nanoseconds.
   const uint64_t thread_suspend_timeout_ns_;
 
+  // Threads taking longer than this to reach a suspend point or checkpoint are logged, with their
+  // state and stack. Zero disables logging.
+  const uint64_t time_to_safepoint_log_threshold_ns_;
+
   std::unique_ptr<Barrier> empty_checkpoint_barrier_;
 
   friend class Thread;
@@ -16,12 +16,18 @@
 
 #include "thread.h"
 
+#include <atomic>
+
 #include "android-base/logging.h"
 #include "base/locks.h"
 #include "base/mutex.h"
+#include "base/time_utils.h"
 #include "common_runtime_test.h"
+#include "scoped_thread_state_change-inl.h"
 #include "thread-current-inl.h"
 #include "thread-inl.h"
+#include "thread_list.h"
+#include "thread_pool.h"
 
 namespace art HIDDEN {
 
@@ -96,4 +102,55 @@ TEST_F(ThreadTest, ThreadExitSignalTest) {
   Thread::DCheckUnregisteredEverywhere(&tefs[0], &tefs[2]);
 }
 
+// Runnable task that only checks for suspension once every millisecond.
+class SlowSuspendCheckTask : public Task {
+ public:
+  SlowSuspendCheckTask(std::atomic<bool>* started, std::atomic<bool>* stop)
+      : started_(started), stop_(stop) {}
+
+  void Run(Thread* self) override {
+    ScopedObjectAccess soa(self);
+    started_->store(true);
+    while (!stop_->load()) {
+      uint64_t end_time = NanoTime() + MsToNs(1);
+      while (NanoTime() < end_time) {
+      }
+      self->AllowThreadSuspension();
+    }
+  }
+
+  void Finalize() override {
+    delete this;
+  }
+
+ private:
+  std::atomic<bool>* const started_;
+  std::atomic<bool>* const stop_;
+};
+
+// Test that SuspendAll records the time it took a runnable thread to reach a suspend point.
+TEST_F(ThreadTest, TimeToSafepoint) {
+  Thread* self = Thread::Current();
+  std::unique_ptr<ThreadPool> thread_pool(ThreadPool::Create("the pool", 1));
+  std::atomic<bool> started(false);
+  std::atomic<bool> stop(false);
+  thread_pool->AddTask(self, new SlowSuspendCheckTask(&started, &stop));
+  thread_pool->StartWorkers(self);
+  while (!started.load()) {
+    usleep(1000);
+  }
+  ThreadList* thread_list = Runtime::Current()->GetThreadList();
+  {
+    ScopedSuspendAll ssa(__FUNCTION__);
+    EXPECT_GT(thread_list->GetLastTimeToSafepoint(), 0u);
+  }
+  stop.store(true);
+  thread_pool->Wait(self, /*do_work=*/ false, /*may_hold_locks=*/ false);
+  thread_pool->StopWorkers(self);
+
+  std::ostringstream oss;
+  thread_list->DumpForSigQuit(oss);
+  EXPECT_NE(oss.str().find("time to safepoint histogram"), std::string::npos);
+}
+
 }  // namespace art
@@ -547,10 +547,20 @@ bool VerifierDeps::DecodeDexFileDeps(DexFileDeps& deps,
 
 bool VerifierDeps::ParseStoredData(const std::vector<const DexFile*>& dex_files,
                                    ArrayRef<const uint8_t> data) {
+  return ParseStoredData(dex_files, data, std::vector<bool>(dex_files.size(), true));
+}
+
+bool VerifierDeps::ParseStoredData(const std::vector<const DexFile*>& dex_files,
+                                   ArrayRef<const uint8_t> data,
+                                   const std::vector<bool>& dex_files_to_parse) {
+  DCHECK_EQ(dex_files.size(), dex_files_to_parse.size());
   if (data.empty()) {
     // Return eagerly, as the first thing we expect from VerifierDeps data is
     // the number of created strings, even if there is no dependency.
     // Currently, only the boot image does not have any VerifierDeps data.
+    for (size_t i = 0; i < dex_files.size(); ++i) {
+      GetDexFileDeps(*dex_files[i])->has_stored_data_ = dex_files_to_parse[i];
+    }
     return true;
   }
   const uint8_t* data_start = data.data();
@@ -558,6 +568,10 @@ bool VerifierDeps::ParseStoredData(const std::vector<const DexFile*>& dex_files,
   const uint8_t* cursor = data_start;
   uint32_t dex_file_index = 0;
   for (const DexFile* dex_file : dex_files) {
+    if (!dex_files_to_parse[dex_file_index]) {
+      ++dex_file_index;
+      continue;
+    }
     DexFileDeps* deps = GetDexFileDeps(*dex_file);
     // Fetch the offset of this dex file's verifier data.
     cursor = data_start + reinterpret_cast<const uint32_t*>(data_start)[dex_file_index++];
@@ -567,6 +581,7 @@ bool VerifierDeps::ParseStoredData(const std::vector<const DexFile*>& dex_files,
       LOG(ERROR) << "Failed to parse dex file dependencies for " << dex_file->GetLocation();
       return false;
     }
+    deps->has_stored_data_ = true;
   }
   // TODO: We should check that `data_start == data_end`. Why are we passing excessive data?
   return true;
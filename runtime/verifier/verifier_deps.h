@@ -72,6 +72,13 @@ class VerifierDeps {
   EXPORT bool ParseStoredData(const std::vector<const DexFile*>& dex_files,
                               ArrayRef<const uint8_t> data);
 
+  // Fill dependencies from stored data, but only for the dex files at the positions
+  // set in `dex_files_to_parse`. Other dex files are left without stored data so that
+  // they can be verified and recorded from scratch. Returns true on success.
+  EXPORT bool ParseStoredData(const std::vector<const DexFile*>& dex_files,
+                              ArrayRef<const uint8_t> data,
+                              const std::vector<bool>& dex_files_to_parse);
+
   // Merge `other` into this `VerifierDeps`'. `other` and `this` must be for the
   // same set of dex files.
   EXPORT void MergeWith(std::unique_ptr<VerifierDeps> other,
@@ -143,6 +150,12 @@ class VerifierDeps {
     return GetDexFileDeps(dex_file) != nullptr;
   }
 
+  // Whether the dependencies of `dex_file` were filled from stored data.
+  bool HasStoredData(const DexFile& dex_file) const {
+    const DexFileDeps* deps = GetDexFileDeps(dex_file);
+    return deps != nullptr && deps->has_stored_data_;
+  }
+
   // Parses raw VerifierDeps data to extract bitvectors of which class def indices
   // were verified or not. The given `dex_files` must match the order and count of
   // dex files used to create the VerifierDeps.
@@ -182,6 +195,9 @@ class VerifierDeps {
     // class was successfully verified.
     std::vector<bool> verified_classes_;
 
+    // Whether the fields above were decoded from stored data.
+    bool has_stored_data_ = false;
+
     bool Equals(const DexFileDeps& rhs) const;
   };
 
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for loops that are vectorized under runtime a != b tests.
+ */
+public class Main {
+
+  static boolean doThrow = false;
+
+  // Needs two runtime tests (dst != a, dst != b), which versions the loop into
+  // a vector loop for disjoint arrays and a scalar loop for the other cases.
+  //
+  /// CHECK-START-ARM64: void Main.addShifted(int[], int[], int[]) loop_optimization (after)
+  /// CHECK-IF:     hasIsaFeature("sve") and os.environ.get('ART_FORCE_TRY_PREDICATED_SIMD') == 'true'
+  //
+  ///     CHECK-DAG:                    VecStore                           loop:<<Loop:B\d+>> outer_loop:none
+  //
+  /// CHECK-ELSE:
+  //
+  ///     CHECK-DAG: <<Zero:i\d+>>      IntConstant 0                      loop:none
+  ///     CHECK-DAG: <<Test1:z\d+>>     NotEqual                           loop:none
+  ///     CHECK-DAG: <<Test2:z\d+>>     NotEqual                           loop:none
+  ///     CHECK-DAG: <<Both:i\d+>>      Select [<<Zero>>,<<Test2>>,<<Test1>>] loop:none
+  ///     CHECK-DAG:                    If [<<Both>>]                      loop:none
+  ///     CHECK-DAG: <<Load1:d\d+>>     VecLoad                            loop:<<Loop:B\d+>> outer_loop:none
+  ///     CHECK-DAG: <<Load2:d\d+>>     VecLoad                            loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG: <<Add:d\d+>>       VecAdd [<<Load1>>,<<Load2>>]       loop:<<Loop>>      outer_loop:none
+  ///     CHECK-DAG:                    VecStore [{{l\d+}},{{i\d+}},<<Add>>] loop:<<Loop>>    outer_loop:none
+  ///     CHECK-DAG:                    ArraySet                           loop:<<Scalar:B\d+>> outer_loop:none
+  //
+  /// CHECK-FI:
+  static void addShifted(int[] dst, int[] a, int[] b) {
+    for (int i = 0; i < dst.length - 1; i++) {
+      dst[i + 1] = a[i] + b[i];
+    }
+  }
+
+  // Reference implementation that is not vectorized.
+  static void addShiftedScalar(int[] dst, int[] a, int[] b) {
+    for (int i = 0; i < dst.length - 1; i++) {
+      dst[i + 1] = a[i] + b[i];
+      if (doThrow) {
+        throw new Error("unreachable");  // control flow prevents vectorization
+      }
+    }
+  }
+
+  static int[] init(int n, int seed) {
+    int[] x = new int[n];
+    for (int i = 0; i < n; i++) {
+      x[i] = i * seed + 1;
+    }
+    return x;
+  }
+
+  static void expectEquals(int[] expected, int[] result, String what) {
+    for (int i = 0; i < expected.length; i++) {
+      if (expected[i] != result[i]) {
+        throw new Error(what + ": expected " + expected[i] + " at " + i + ", got " + result[i]);
+      }
+    }
+  }
+
+  static void test(int n) {
+    // Disjoint arrays: vector loop.
+    int[] dst1 = new int[n];
+    int[] dst2 = new int[n];
+    int[] a = init(n, 3);
+    int[] b = init(n, 7);
+    addShifted(dst1, a, b);
+    addShiftedScalar(dst2, a, b);
+    expectEquals(dst2, dst1, "disjoint");
+
+    // dst == a: scalar loop, recurrence through dst.
+    int[] x1 = init(n, 5);
+    int[] x2 = init(n, 5);
+    addShifted(x1, x1, b);
+    addShiftedScalar(x2, x2, b);
+    expectEquals(x2, x1, "dst == a");
+
+    // dst == b == a.
+    int[] y1 = init(n, 11);
+    int[] y2 = init(n, 11);
+    addShifted(y1, y1, y1);
+    addShiftedScalar(y2, y2, y2);
+    expectEquals(y2, y1, "dst == a == b");
+  }
+
+  public static void main(String[] args) {
+    for (int n = 0; n < 100; n++) {
+      test(n);
+    }
+    System.out.println("passed");
+  }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for String.indexOf(String), covering compressed and uncompressed strings,
+ * matches around the vector width and out of range start indexes.
+ */
+public class Main {
+  public static void main(String[] args) {
+    testCompressed();
+    testUncompressed();
+    testMixedCompression();
+    testEdgeCases();
+    System.out.println("passed");
+  }
+
+  static void testCompressed() {
+    for (int length = 0; length <= 40; ++length) {
+      String haystack = makeString(length, 'a');
+      for (int start = 0; start <= length; ++start) {
+        for (int patternLength = 1; patternLength <= 4; ++patternLength) {
+          if (start + patternLength > length) {
+            break;
+          }
+          check(haystack, haystack.substring(start, start + patternLength));
+        }
+      }
+      check(haystack, "ab_");
+      check(haystack, "zz");
+    }
+  }
+
+  static void testUncompressed() {
+    for (int length = 0; length <= 40; ++length) {
+      String haystack = makeString(length, '\u0440');
+      for (int start = 0; start <= length; ++start) {
+        for (int patternLength = 1; patternLength <= 4; ++patternLength) {
+          if (start + patternLength > length) {
+            break;
+          }
+          check(haystack, haystack.substring(start, start + patternLength));
+        }
+      }
+      check(haystack, "\u0440\u0441_");
+      check(haystack, "\u0100");
+    }
+  }
+
+  static void testMixedCompression() {
+    String compressed = "abcabcabdabcabcabcabcd";
+    String uncompressed = "abc\u0100abcabcabd\u0100abcabcabcabcd";
+    check(compressed, "abcd");
+    check(uncompressed, "abcd");
+    check(uncompressed, "abd\u0100");
+    check(compressed, "abd\u0100");
+  }
+
+  static void testEdgeCases() {
+    String s = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    check(s, "");
+    check(s, s);
+    check(s, s + "!");
+    check("", "a");
+    check("", "");
+    // Repeated first characters make many candidates fail late.
+    check("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab", "aaab");
+    check("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", "aaab");
+    try {
+      $noinline$indexOf(s, null);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    try {
+      $noinline$indexOf(s, null, 0);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+  }
+
+  // Build a string of `length` characters where every third character is the same,
+  // so that the first character of most patterns has several candidate matches.
+  static String makeString(int length, char base) {
+    StringBuilder sb = new StringBuilder(length);
+    for (int i = 0; i < length; ++i) {
+      sb.append((char) (base + ((i % 3 == 0) ? 0 : i % 7)));
+    }
+    return sb.toString();
+  }
+
+  static void check(String haystack, String pattern) {
+    assertEquals(referenceIndexOf(haystack, pattern, 0), $noinline$indexOf(haystack, pattern));
+    for (int from = -2; from <= haystack.length() + 2; ++from) {
+      assertEquals(referenceIndexOf(haystack, pattern, from),
+                   $noinline$indexOf(haystack, pattern, from));
+    }
+  }
+
+  static int referenceIndexOf(String haystack, String pattern, int from) {
+    int start = Math.max(from, 0);
+    if (pattern.isEmpty()) {
+      return Math.min(start, haystack.length());
+    }
+    for (int i = start; i + pattern.length() <= haystack.length(); ++i) {
+      if (haystack.regionMatches(i, pattern, 0, pattern.length())) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  static int $noinline$indexOf(String haystack, String pattern) {
+    return haystack.indexOf(pattern);
+  }
+
+  static int $noinline$indexOf(String haystack, String pattern, int from) {
+    return haystack.indexOf(pattern, from);
+  }
+
+  static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
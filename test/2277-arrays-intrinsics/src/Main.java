@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.util.Arrays;
+
+/**
+ * Tests for the Arrays and String.hashCode() intrinsics, covering every length around the
+ * 16-byte vector width, differences at every position, and null arguments.
+ */
+public class Main {
+  private static final int MAX_LENGTH = 70;
+
+  public static void main(String[] args) {
+    testEquals();
+    testMismatch();
+    testHashCode();
+    testFill();
+    testStringHashCode();
+    System.out.println("passed");
+  }
+
+  private static byte[] bytes(int length) {
+    byte[] result = new byte[length];
+    for (int i = 0; i < length; ++i) {
+      result[i] = (byte) (i * 7 + 3);
+    }
+    return result;
+  }
+
+  private static int[] ints(int length) {
+    int[] result = new int[length];
+    for (int i = 0; i < length; ++i) {
+      result[i] = i * 0x01010101 + 0x7f;
+    }
+    return result;
+  }
+
+  private static void testEquals() {
+    assertEquals(true, Arrays.equals((byte[]) null, (byte[]) null));
+    assertEquals(false, Arrays.equals(new byte[0], (byte[]) null));
+    assertEquals(false, Arrays.equals((int[]) null, new int[0]));
+    for (int length = 0; length < MAX_LENGTH; ++length) {
+      byte[] b = bytes(length);
+      int[] n = ints(length);
+      char[] c = new char[length];
+      for (int i = 0; i < length; ++i) {
+        c[i] = (char) (0x100 + i);
+      }
+      assertEquals(true, Arrays.equals(b, b.clone()));
+      assertEquals(true, Arrays.equals(c, c.clone()));
+      assertEquals(true, Arrays.equals(n, n.clone()));
+      assertEquals(false, Arrays.equals(b, bytes(length + 1)));
+      for (int i = 0; i < length; ++i) {
+        byte[] b2 = b.clone();
+        b2[i] ^= 1;
+        assertEquals(false, Arrays.equals(b, b2));
+        char[] c2 = c.clone();
+        c2[i] ^= 0x8000;
+        assertEquals(false, Arrays.equals(c, c2));
+        int[] n2 = n.clone();
+        n2[i] ^= 0x10000;
+        assertEquals(false, Arrays.equals(n, n2));
+      }
+    }
+  }
+
+  private static void testMismatch() {
+    try {
+      Arrays.mismatch((byte[]) null, new byte[0]);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    for (int length = 0; length < MAX_LENGTH; ++length) {
+      byte[] b = bytes(length);
+      assertEquals(-1, Arrays.mismatch(b, b.clone()));
+      assertEquals(length, Arrays.mismatch(b, bytes(length + 3)));
+      assertEquals(length, Arrays.mismatch(bytes(length + 1), b));
+      for (int i = 0; i < length; ++i) {
+        byte[] b2 = b.clone();
+        b2[i] = (byte) ~b2[i];
+        assertEquals(i, Arrays.mismatch(b, b2));
+      }
+    }
+  }
+
+  private static void testHashCode() {
+    assertEquals(0, Arrays.hashCode((byte[]) null));
+    assertEquals(0, Arrays.hashCode((int[]) null));
+    for (int length = 0; length < MAX_LENGTH; ++length) {
+      byte[] b = bytes(length);
+      int[] n = ints(length);
+      int expectedBytes = 1;
+      int expectedInts = 1;
+      for (int i = 0; i < length; ++i) {
+        expectedBytes = 31 * expectedBytes + b[i];
+        expectedInts = 31 * expectedInts + n[i];
+      }
+      assertEquals(expectedBytes, Arrays.hashCode(b));
+      assertEquals(expectedInts, Arrays.hashCode(n));
+    }
+  }
+
+  private static void testFill() {
+    try {
+      Arrays.fill((int[]) null, 0);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    for (int length = 0; length < MAX_LENGTH; ++length) {
+      byte[] b = new byte[length];
+      Arrays.fill(b, (byte) -3);
+      for (int i = 0; i < length; ++i) {
+        assertEquals(-3, b[i]);
+      }
+      int[] n = new int[length];
+      Arrays.fill(n, 0x80402010);
+      for (int i = 0; i < length; ++i) {
+        assertEquals(0x80402010, n[i]);
+      }
+    }
+  }
+
+  private static void testStringHashCode() {
+    StringBuilder ascii = new StringBuilder();
+    StringBuilder wide = new StringBuilder();
+    for (int length = 0; length < MAX_LENGTH; ++length) {
+      assertEquals(referenceHashCode(ascii.toString()), ascii.toString().hashCode());
+      assertEquals(referenceHashCode(wide.toString()), wide.toString().hashCode());
+      ascii.append((char) ('a' + length % 26));
+      wide.append((char) ('\u0400' + length));
+    }
+  }
+
+  private static int referenceHashCode(String s) {
+    int hash = 0;
+    for (char c : s.toCharArray()) {
+      hash = 31 * hash + c;
+    }
+    return hash;
+  }
+
+  private static void assertEquals(boolean expected, boolean actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+
+  private static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected " + expected + ", got " + actual);
+    }
+  }
+}
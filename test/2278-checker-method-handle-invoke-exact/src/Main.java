@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import annotations.ConstantMethodHandle;
+
+import java.lang.invoke.MethodHandle;
+import java.lang.invoke.WrongMethodTypeException;
+
+final class FinalTarget {
+    private final int base;
+
+    FinalTarget(int base) {
+        this.base = base;
+    }
+
+    int plus(int value) {
+        return base + value;
+    }
+
+    int $noinline$times(int value) {
+        return base * value;
+    }
+}
+
+public class Main {
+    public static void main(String[] args) throws Throwable {
+        assertEquals(42, $noinline$addViaHandle(40, 2));
+        assertEquals(42, $noinline$plusViaHandle(new FinalTarget(40), 2));
+        try {
+            $noinline$plusViaHandle(null, 2);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException expected) {
+        }
+        assertEquals(38, $noinline$subViaHandle(40, 2));
+        assertEquals(80, $noinline$timesViaHandle(new FinalTarget(40), 2));
+        try {
+            $noinline$timesViaHandle(null, 2);
+            throw new Error("Expected NullPointerException");
+        } catch (NullPointerException expected) {
+        }
+        try {
+            $noinline$addViaHandleWithWrongType(40, 2);
+            throw new Error("Expected WrongMethodTypeException");
+        } catch (WrongMethodTypeException expected) {
+        }
+        System.out.println("passed");
+    }
+
+    private static void unreachable() {
+        throw new Error("unreachable");
+    }
+
+    public static int add(int a, int b) {
+        return a + b;
+    }
+
+    @ConstantMethodHandle(
+            kind = ConstantMethodHandle.INVOKE_STATIC,
+            owner = "Main",
+            fieldOrMethodName = "add",
+            descriptor = "(II)I")
+    private static MethodHandle addHandle() {
+        unreachable();
+        return null;
+    }
+
+    @ConstantMethodHandle(
+            kind = ConstantMethodHandle.INVOKE_VIRTUAL,
+            owner = "FinalTarget",
+            fieldOrMethodName = "plus",
+            descriptor = "(I)I")
+    private static MethodHandle plusHandle() {
+        unreachable();
+        return null;
+    }
+
+    public static int $noinline$sub(int a, int b) {
+        return a - b;
+    }
+
+    @ConstantMethodHandle(
+            kind = ConstantMethodHandle.INVOKE_STATIC,
+            owner = "Main",
+            fieldOrMethodName = "$noinline$sub",
+            descriptor = "(II)I")
+    private static MethodHandle subHandle() {
+        unreachable();
+        return null;
+    }
+
+    @ConstantMethodHandle(
+            kind = ConstantMethodHandle.INVOKE_VIRTUAL,
+            owner = "FinalTarget",
+            fieldOrMethodName = "$noinline$times",
+            descriptor = "(I)I")
+    private static MethodHandle timesHandle() {
+        unreachable();
+        return null;
+    }
+
+    /// CHECK-START: int Main.$noinline$addViaHandle(int, int) inliner (before)
+    /// CHECK:       InvokePolymorphic
+
+    /// CHECK-START: int Main.$noinline$addViaHandle(int, int) inliner (after)
+    /// CHECK-NOT:   InvokePolymorphic
+
+    /// CHECK-START: int Main.$noinline$addViaHandle(int, int) inliner (after)
+    /// CHECK-NOT:   InvokeStaticOrDirect method_name:Main.add
+
+    /// CHECK-START: int Main.$noinline$addViaHandle(int, int) inliner (after)
+    /// CHECK:       Add
+    private static int $noinline$addViaHandle(int a, int b) throws Throwable {
+        return (int) addHandle().invokeExact(a, b);
+    }
+
+    /// CHECK-START: int Main.$noinline$plusViaHandle(FinalTarget, int) inliner (before)
+    /// CHECK:       InvokePolymorphic
+
+    /// CHECK-START: int Main.$noinline$plusViaHandle(FinalTarget, int) inliner (after)
+    /// CHECK-NOT:   InvokePolymorphic
+
+    /// CHECK-START: int Main.$noinline$plusViaHandle(FinalTarget, int) inliner (after)
+    /// CHECK:       <<Target:l\d+>> ParameterValue
+    /// CHECK:       NullCheck [<<Target>>]
+    /// CHECK:       Add
+    private static int $noinline$plusViaHandle(FinalTarget target, int value) throws Throwable {
+        return (int) plusHandle().invokeExact(target, value);
+    }
+
+    // The targets below are not inlined. With AOT compilation, calling them directly
+    // would need a .bss entry resolved at the call site, so the original call is kept.
+
+    /// CHECK-START: int Main.$noinline$subViaHandle(int, int) inliner (after)
+    /// CHECK:       InvokePolymorphic
+
+    /// CHECK-START: int Main.$noinline$subViaHandle(int, int) inliner (after)
+    /// CHECK-NOT:   InvokeStaticOrDirect method_name:Main.$noinline$sub
+    private static int $noinline$subViaHandle(int a, int b) throws Throwable {
+        return (int) subHandle().invokeExact(a, b);
+    }
+
+    /// CHECK-START: int Main.$noinline$timesViaHandle(FinalTarget, int) inliner (after)
+    /// CHECK:       InvokePolymorphic
+
+    /// CHECK-START: int Main.$noinline$timesViaHandle(FinalTarget, int) inliner (after)
+    /// CHECK-NOT:   InvokeStaticOrDirect method_name:FinalTarget.$noinline$times
+    private static int $noinline$timesViaHandle(FinalTarget target, int value) throws Throwable {
+        return (int) timesHandle().invokeExact(target, value);
+    }
+
+    /// CHECK-START: long Main.$noinline$addViaHandleWithWrongType(int, int) inliner (after)
+    /// CHECK:       InvokePolymorphic
+    private static long $noinline$addViaHandleWithWrongType(int a, int b) throws Throwable {
+        return (long) addHandle().invokeExact(a, b);
+    }
+
+    private static void assertEquals(int expected, int actual) {
+        if (expected != actual) {
+            throw new Error("Expected: " + expected + ", found: " + actual);
+        }
+    }
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests for vector loops with more live vector values than SIMD registers.
+ *
+ * Every (v + k) needs a loop-invariant broadcast of k, so the register allocator
+ * has to spill some of them. With AVX2, the loop without a reduction uses 256-bit
+ * vectors, while the reduction falls back to 128-bit vectors; the spill slots of
+ * both must not overlap with each other or with the scalar spill slots.
+ */
+public class Main {
+
+  /// CHECK-START-X86_64: void Main.$noinline$wideLoop(int[], int[]) loop_optimization (after)
+  /// CHECK-DAG: <<Load:d\d+>>  VecLoad                     loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                VecXor                      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                VecStore                    loop:<<Loop>>      outer_loop:none
+
+  /// CHECK-START-X86_64: void Main.$noinline$wideLoop(int[], int[]) register (after)
+  /// CHECK:                    ParallelMove moves:{{.*}}->4x{{\d+}}(sp){{.*}}
+  public static void $noinline$wideLoop(int[] a, int[] r) {
+    for (int i = 0; i < a.length; i++) {
+      int v = a[i];
+      r[i] = ((v + 1) ^ (v + 2)) + ((v + 3) ^ (v + 4)) + ((v + 5) ^ (v + 6)) +
+             ((v + 7) ^ (v + 8)) + ((v + 9) ^ (v + 10)) + ((v + 11) ^ (v + 12)) +
+             ((v + 13) ^ (v + 14)) + ((v + 15) ^ (v + 16)) + ((v + 17) ^ (v + 18)) +
+             ((v + 19) ^ (v + 20)) + ((v + 21) ^ (v + 22));
+    }
+  }
+
+  /// CHECK-START-X86_64: int Main.$noinline$reductionLoop(int[]) loop_optimization (after)
+  /// CHECK-DAG:                VecLoad                     loop:<<Loop:B\d+>> outer_loop:none
+  /// CHECK-DAG:                VecAdd                      loop:<<Loop>>      outer_loop:none
+  /// CHECK-DAG:                VecReduce                   loop:none
+
+  /// CHECK-START-X86_64: int Main.$noinline$reductionLoop(int[]) register (after)
+  /// CHECK:                    ParallelMove moves:{{.*}}->4x{{\d+}}(sp){{.*}}
+  public static int $noinline$reductionLoop(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      int v = a[i];
+      sum += ((v + 1) ^ (v + 2)) + ((v + 3) ^ (v + 4)) + ((v + 5) ^ (v + 6)) +
+             ((v + 7) ^ (v + 8)) + ((v + 9) ^ (v + 10)) + ((v + 11) ^ (v + 12)) +
+             ((v + 13) ^ (v + 14)) + ((v + 15) ^ (v + 16)) + ((v + 17) ^ (v + 18)) +
+             ((v + 19) ^ (v + 20)) + ((v + 21) ^ (v + 22));
+    }
+    return sum;
+  }
+
+  // Both vector widths in the same method, with scalar floating point values live
+  // across the loops that compete for the same registers and stack area.
+  //
+  /// CHECK-START-X86_64: double Main.$noinline$mixedLoops(int[], int[], double) loop_optimization (after)
+  /// CHECK-DAG:                VecStore                    loop:<<Loop1:B\d+>> outer_loop:none
+  /// CHECK-DAG:                VecReduce                   loop:none
+  public static double $noinline$mixedLoops(int[] a, int[] r, double x) {
+    double d0 = x * 1.5;
+    double d1 = x * 2.5;
+    double d2 = x * 3.5;
+    double d3 = x * 4.5;
+    for (int i = 0; i < a.length; i++) {
+      int v = a[i];
+      r[i] = ((v + 1) ^ (v + 2)) + ((v + 3) ^ (v + 4)) + ((v + 5) ^ (v + 6)) +
+             ((v + 7) ^ (v + 8)) + ((v + 9) ^ (v + 10)) + ((v + 11) ^ (v + 12)) +
+             ((v + 13) ^ (v + 14)) + ((v + 15) ^ (v + 16)) + ((v + 17) ^ (v + 18));
+    }
+    int sum = 0;
+    for (int i = 0; i < r.length; i++) {
+      int v = r[i];
+      sum += ((v + 31) ^ (v + 32)) + ((v + 33) ^ (v + 34)) + ((v + 35) ^ (v + 36)) +
+             ((v + 37) ^ (v + 38)) + ((v + 39) ^ (v + 40)) + ((v + 41) ^ (v + 42)) +
+             ((v + 43) ^ (v + 44)) + ((v + 45) ^ (v + 46)) + ((v + 47) ^ (v + 48));
+    }
+    return d0 + d1 * 2 + d2 * 3 + d3 * 4 + sum;
+  }
+
+  // Scalar reference implementations, not vectorized because of the call.
+
+  private static int $noinline$element(int v) {
+    return ((v + 1) ^ (v + 2)) + ((v + 3) ^ (v + 4)) + ((v + 5) ^ (v + 6)) +
+           ((v + 7) ^ (v + 8)) + ((v + 9) ^ (v + 10)) + ((v + 11) ^ (v + 12)) +
+           ((v + 13) ^ (v + 14)) + ((v + 15) ^ (v + 16)) + ((v + 17) ^ (v + 18)) +
+           ((v + 19) ^ (v + 20)) + ((v + 21) ^ (v + 22));
+  }
+
+  private static int $noinline$mixedFirst(int v) {
+    return ((v + 1) ^ (v + 2)) + ((v + 3) ^ (v + 4)) + ((v + 5) ^ (v + 6)) +
+           ((v + 7) ^ (v + 8)) + ((v + 9) ^ (v + 10)) + ((v + 11) ^ (v + 12)) +
+           ((v + 13) ^ (v + 14)) + ((v + 15) ^ (v + 16)) + ((v + 17) ^ (v + 18));
+  }
+
+  private static int $noinline$mixedSecond(int v) {
+    return ((v + 31) ^ (v + 32)) + ((v + 33) ^ (v + 34)) + ((v + 35) ^ (v + 36)) +
+           ((v + 37) ^ (v + 38)) + ((v + 39) ^ (v + 40)) + ((v + 41) ^ (v + 42)) +
+           ((v + 43) ^ (v + 44)) + ((v + 45) ^ (v + 46)) + ((v + 47) ^ (v + 48));
+  }
+
+  public static void main(String[] args) {
+    // Lengths around multiples of the vector lengths, to also run the cleanup loops.
+    for (int n : new int[] { 0, 1, 7, 8, 15, 16, 31, 32, 33, 100, 1027 }) {
+      int[] a = new int[n];
+      for (int i = 0; i < n; i++) {
+        a[i] = i * 0x9E3779B1 - 77;
+      }
+
+      int[] r = new int[n];
+      $noinline$wideLoop(a, r);
+      int expectedSum = 0;
+      for (int i = 0; i < n; i++) {
+        int expected = $noinline$element(a[i]);
+        expectEquals(expected, r[i]);
+        expectedSum += expected;
+      }
+
+      expectEquals(expectedSum, $noinline$reductionLoop(a));
+
+      int[] r2 = new int[n];
+      double x = n + 0.25;
+      int mixedSum = 0;
+      for (int i = 0; i < n; i++) {
+        mixedSum += $noinline$mixedSecond($noinline$mixedFirst(a[i]));
+      }
+      double expectedMixed = x * 1.5 + x * 2.5 * 2 + x * 3.5 * 3 + x * 4.5 * 4 + mixedSum;
+      expectEquals(expectedMixed, $noinline$mixedLoops(a, r2, x));
+      for (int i = 0; i < n; i++) {
+        expectEquals($noinline$mixedFirst(a[i]), r2[i]);
+      }
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+
+  private static void expectEquals(double expected, double result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
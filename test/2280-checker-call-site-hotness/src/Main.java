@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+class Square {
+  Square(int side) {
+    this.side = side;
+  }
+
+  // Too large to be inlined at cold call sites.
+  int measure() {
+    int s = side;
+    return ((s * s * 3) + (s << 4) - (s >> 2) + (s * 7)) ^ (s | 0x55);
+  }
+
+  int side;
+}
+
+class Circle {
+  Circle(int radius) {
+    this.radius = radius;
+  }
+
+  // Same as `Square.measure()`.
+  int measure() {
+    int r = radius;
+    return ((r * r * 3) + (r << 4) - (r >> 2) + (r * 7)) ^ (r | 0x55);
+  }
+
+  int radius;
+}
+
+public class Main {
+  public static void main(String[] args) {
+    for (int i = -5; i != 50; ++i) {
+      assertEquals(3 * $noinline$referenceMeasure(i),
+                   $noinline$measure(new Square(i), new Circle(i), i));
+    }
+    System.out.println("passed");
+  }
+
+  /// CHECK-START: int Main.$noinline$measure(Square, Circle, int) inliner (before)
+  /// CHECK-DAG:     InvokeVirtual method_name:Square.measure
+  /// CHECK-DAG:     InvokeVirtual method_name:Circle.measure
+  /// CHECK-DAG:     Invoke{{(Virtual|StaticOrDirect)}} method_name:Circle.measure
+
+  // The profile reports the call to `Square.measure()` as executed and its target as hot,
+  // so the call is inlined.
+  /// CHECK-START: int Main.$noinline$measure(Square, Circle, int) inliner (after)
+  /// CHECK-NOT:     Invoke{{.*}} method_name:Square.measure
+
+  // The receiver of `circle.measure()` is a parameter, so the call would have an inline cache
+  // in the profile if it had been executed. It is cold and remains a virtual call.
+  //
+  // The receiver of the second call to `Circle.measure()` is exact, so the call has no inline
+  // cache to tell us whether it was executed. It falls back to the hotness of its target and
+  // gets the normal budget, which is enough to inline it.
+  /// CHECK-START: int Main.$noinline$measure(Square, Circle, int) inliner (after)
+  /// CHECK:         InvokeVirtual method_name:Circle.measure
+  /// CHECK-NOT:     Invoke{{.*}} method_name:Circle.measure
+  public static int $noinline$measure(Square square, Circle circle, int size) {
+    return square.measure() + circle.measure() + new Circle(size).measure();
+  }
+
+  public static int $noinline$referenceMeasure(int s) {
+    return ((s * s * 3) + (s << 4) - (s >> 2) + (s * 7)) ^ (s | 0x55);
+  }
+
+  public static void assertEquals(int expected, int actual) {
+    if (expected != actual) {
+      throw new Error("Expected: " + expected + ", found: " + actual);
+    }
+  }
+}
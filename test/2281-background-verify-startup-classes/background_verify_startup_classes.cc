@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "app_info.h"
+#include "base/metrics/metrics.h"
+#include "class_linker.h"
+#include "class_loader_utils.h"
+#include "jni.h"
+#include "mirror/class-inl.h"
+#include "nativehelper/scoped_local_ref.h"
+#include "nativehelper/scoped_utf_chars.h"
+#include "profile/profile_compilation_info.h"
+#include "runtime.h"
+#include "scoped_thread_state_change-inl.h"
+#include "thread.h"
+
+namespace art {
+namespace Test2281BackgroundVerifyStartupClasses {
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isVerificationEnabled(JNIEnv*, jclass) {
+  return Runtime::Current()->IsVerificationEnabled() ? JNI_TRUE : JNI_FALSE;
+}
+
+// Write a reference profile listing the classes `descriptors` of the dex files of `loader`.
+extern "C" JNIEXPORT void JNICALL Java_Main_writeProfile(JNIEnv* env,
+                                                         jclass,
+                                                         jobject loader,
+                                                         jobjectArray descriptors,
+                                                         jstring profile) {
+  std::vector<const DexFile*> dex_files;
+  {
+    ScopedObjectAccess soa(Thread::Current());
+    StackHandleScope<1> hs(soa.Self());
+    Handle<mirror::ClassLoader> h_loader(hs.NewHandle(soa.Decode<mirror::ClassLoader>(loader)));
+    VisitClassLoaderDexFiles(
+        soa.Self(),
+        h_loader,
+        [&](const DexFile* dex_file) {
+          dex_files.push_back(dex_file);
+          return true;
+        });
+  }
+
+  ProfileCompilationInfo info;
+  for (jsize i = 0, size = env->GetArrayLength(descriptors); i != size; ++i) {
+    ScopedLocalRef<jstring> jdescriptor(
+        env, reinterpret_cast<jstring>(env->GetObjectArrayElement(descriptors, i)));
+    ScopedUtfChars descriptor(env, jdescriptor.get());
+    bool found = false;
+    for (const DexFile* dex_file : dex_files) {
+      const dex::TypeId* type_id = dex_file->FindTypeId(descriptor.c_str());
+      if (type_id != nullptr) {
+        CHECK(info.AddClass(*dex_file, dex_file->GetIndexForTypeId(*type_id)));
+        found = true;
+        break;
+      }
+    }
+    CHECK(found) << "Could not find " << descriptor.c_str();
+  }
+
+  ScopedUtfChars profile_path(env, profile);
+  CHECK(info.Save(profile_path.c_str(), /*bytes_written=*/ nullptr));
+}
+
+// Register `code_path` as the app with the reference profile `profile`, like
+// VMRuntime.registerAppInfo() does for an app started by the framework.
+extern "C" JNIEXPORT void JNICALL Java_Main_registerAppInfo(JNIEnv* env,
+                                                            jclass,
+                                                            jstring code_path,
+                                                            jstring profile) {
+  ScopedUtfChars code_path_chars(env, code_path);
+  ScopedUtfChars profile_chars(env, profile);
+  Runtime::Current()->RegisterAppInfo(/*package_name=*/ "test.app",
+                                      {code_path_chars.c_str()},
+                                      /*profile_output_filename=*/ "",
+                                      profile_chars.c_str(),
+                                      kVMRuntimeSecondaryDex);
+}
+
+extern "C" JNIEXPORT jboolean JNICALL Java_Main_isClassVerified(JNIEnv* env,
+                                                                jclass,
+                                                                jobject loader,
+                                                                jstring descriptor) {
+  ScopedUtfChars descriptor_chars(env, descriptor);
+  ScopedObjectAccess soa(Thread::Current());
+  StackHandleScope<2> hs(soa.Self());
+  Handle<mirror::ClassLoader> h_loader(hs.NewHandle(soa.Decode<mirror::ClassLoader>(loader)));
+  // Finding the class loads and links it, but does not verify it.
+  Handle<mirror::Class> h_class(hs.NewHandle(Runtime::Current()->GetClassLinker()->FindClass(
+      soa.Self(), descriptor_chars.c_str(), h_loader)));
+  CHECK(h_class != nullptr) << "Could not find class " << descriptor_chars.c_str();
+  return h_class->IsVerified() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C" JNIEXPORT jlong JNICALL Java_Main_getBackgroundVerificationCount(JNIEnv*, jclass) {
+  return static_cast<jlong>(
+      Runtime::Current()->GetMetrics()->BackgroundClassVerificationCount()->Value());
+}
+
+}  // namespace Test2281BackgroundVerifyStartupClasses
+}  // namespace art
@@ -0,0 +1,26 @@
+#!/bin/bash
+#
+# Copyright (C) 2024 The Android Open Source Project
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+
+def run(ctx, args):
+  # Do not compile the secondary dex file, its classes must not be verified ahead of time.
+  ctx.default_run(
+      args,
+      runtime_option=["-Xbackground-verify-startup-classes:true"],
+      secondary_compilation=False)
+
+  # The test registers the app info without a profile output file. Ignore the warning.
+  ctx.run(fr"sed -i '/JIT profile information will not be recorded/d' '{args.stderr_file}'")
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import dalvik.system.PathClassLoader;
+
+public class Main {
+    static final String DEX_FILE_EX =
+        System.getenv("DEX_LOCATION") + "/2281-background-verify-startup-classes-ex.jar";
+    static final String PROFILE =
+        System.getenv("DEX_LOCATION") + "/2281-background-verify-startup-classes-ex.prof";
+
+    public static void main(String[] args) throws Exception {
+        System.loadLibrary(args[0]);
+        if (isDebuggable() || !isVerificationEnabled()) {
+            // Startup classes are only verified in the background by a verifying,
+            // non-debuggable runtime.
+            return;
+        }
+
+        ClassLoader loader = new PathClassLoader(DEX_FILE_EX, Main.class.getClassLoader());
+        String[] startupClasses = { "LStartupA;", "LStartupB;" };
+        writeProfile(loader, startupClasses, PROFILE);
+
+        long countBefore = getBackgroundVerificationCount();
+        registerAppInfo(DEX_FILE_EX, PROFILE);
+        waitForVerifier();
+
+        for (String descriptor : startupClasses) {
+            if (!isClassVerified(loader, descriptor)) {
+                throw new Error(descriptor + " was not verified in the background");
+            }
+        }
+        if (isClassVerified(loader, "LNotStartup;")) {
+            throw new Error("NotStartup is not in the profile and should not be verified");
+        }
+        long count = getBackgroundVerificationCount() - countBefore;
+        if (count != startupClasses.length) {
+            throw new Error("Expected " + startupClasses.length + " classes verified in the "
+                + "background, got " + count);
+        }
+    }
+
+    private static native boolean isDebuggable();
+    private static native boolean isVerificationEnabled();
+    private static native void writeProfile(
+        ClassLoader loader, String[] descriptors, String profile);
+    private static native void registerAppInfo(String codePath, String profile);
+    private static native void waitForVerifier();
+    private static native boolean isClassVerified(ClassLoader loader, String descriptor);
+    private static native long getBackgroundVerificationCount();
+}
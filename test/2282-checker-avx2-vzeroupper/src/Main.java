@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * Tests that vzeroupper is emitted on exit from methods that use 256-bit AVX2 vectors,
+ * but not from methods whose vector loops fall back to 128-bit SSE vectors or that have
+ * no vector code at all.
+ */
+public class Main {
+
+  /// CHECK-START-X86_64: void Main.$noinline$wideLoop(int[], int[]) disassembly (after)
+  /// CHECK-IF: hasIsaFeature("avx2")
+  ///      CHECK:                VecAdd
+  ///      CHECK:                Return
+  ///      CHECK:                vzeroupper
+  ///      CHECK-NEXT:           ret
+  /// CHECK-ELSE:
+  ///      CHECK-NOT:            vzeroupper
+  /// CHECK-FI:
+  public static void $noinline$wideLoop(int[] a, int[] r) {
+    for (int i = 0; i < a.length; i++) {
+      r[i] = a[i] + 42;
+    }
+  }
+
+  // The reduction has no 256-bit implementation, so the loop uses 128-bit vectors.
+  //
+  /// CHECK-START-X86_64: int Main.$noinline$reductionLoop(int[]) loop_optimization (after)
+  /// CHECK-DAG:                 VecReduce                   loop:none
+
+  /// CHECK-START-X86_64: int Main.$noinline$reductionLoop(int[]) disassembly (after)
+  /// CHECK-NOT:                 vzeroupper
+  public static int $noinline$reductionLoop(int[] a) {
+    int sum = 0;
+    for (int i = 0; i < a.length; i++) {
+      sum += a[i];
+    }
+    return sum;
+  }
+
+  /// CHECK-START-X86_64: int Main.$noinline$scalar(int[]) disassembly (after)
+  /// CHECK-NOT:                 vzeroupper
+  public static int $noinline$scalar(int[] a) {
+    return a[0] + a[a.length - 1];
+  }
+
+  public static void main(String[] args) {
+    for (int n : new int[] { 1, 7, 8, 15, 16, 33, 100 }) {
+      int[] a = new int[n];
+      for (int i = 0; i < n; i++) {
+        a[i] = i * 3 - 5;
+      }
+      int[] r = new int[n];
+      $noinline$wideLoop(a, r);
+      int expectedSum = 0;
+      for (int i = 0; i < n; i++) {
+        expectEquals(a[i] + 42, r[i]);
+        expectedSum += a[i];
+      }
+      expectEquals(expectedSum, $noinline$reductionLoop(a));
+      expectEquals(a[0] + a[n - 1], $noinline$scalar(a));
+    }
+    System.out.println("passed");
+  }
+
+  private static void expectEquals(int expected, int result) {
+    if (expected != result) {
+      throw new Error("Expected: " + expected + ", found: " + result);
+    }
+  }
+}
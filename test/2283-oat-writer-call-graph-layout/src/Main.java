@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Collections;
+
+public class Main {
+
+  static class OatMethodAndOffset implements Comparable<OatMethodAndOffset> {
+    Method method;
+    long codeOffset;
+
+    public OatMethodAndOffset(Method method, long codeOffset) {
+      this.method = method;
+      this.codeOffset = codeOffset;
+    }
+
+    // e.g. "Foo::Bar"
+    public String methodReferenceString() {
+      return method.getDeclaringClass().getName() + "::" + method.getName();
+    }
+
+    @Override
+    public int compareTo(OatMethodAndOffset other) {
+      return Long.compareUnsigned(codeOffset, other.codeOffset);
+    }
+  }
+
+  // Print the test methods sorted by their OAT code address.
+  public static void main(String[] args) throws Exception {
+    System.loadLibrary(args[0]);
+
+    if (!hasOatCompiledCode(Test.class)) {
+      System.out.println("No OAT class");
+      return;
+    }
+
+    ArrayList<OatMethodAndOffset> offsets_list = new ArrayList<OatMethodAndOffset>();
+    for (Method m : Test.getTestMethods()) {
+      offsets_list.add(new OatMethodAndOffset(m, getOatMethodQuickCode(m)));
+    }
+    Collections.sort(offsets_list);
+    for (OatMethodAndOffset m : offsets_list) {
+      System.out.println(m.methodReferenceString());
+    }
+  }
+
+  // Implemented in 661-oat-writer-layout.
+  private static native boolean hasOatCompiledCode(Class kls);
+  private static native long getOatMethodQuickCode(Method method);
+}
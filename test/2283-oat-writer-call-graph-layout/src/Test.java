@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+import java.lang.reflect.Method;
+
+// Methods of a class are ordered by name in the dex file, so without the call graph they are
+// laid out alphabetically. `$noinline$aCaller` calls `$noinline$eCallee` directly and
+// `$noinline$fVirtualCaller` calls `$noinline$wTarget` through a profiled inline cache, so
+// each callee should be placed right after its caller.
+public class Test {
+  public static Method[] getTestMethods() throws NoSuchMethodException, SecurityException {
+    return new Method[] {
+      Test.class.getDeclaredMethod("$noinline$aCaller", int.class),
+      Test.class.getDeclaredMethod("$noinline$bFiller", int.class),
+      Test.class.getDeclaredMethod("$noinline$cFiller", int.class),
+      Test.class.getDeclaredMethod("$noinline$dFiller", int.class),
+      Test.class.getDeclaredMethod("$noinline$eCallee", int.class),
+      Test.class.getDeclaredMethod("$noinline$fVirtualCaller", Test.class, int.class),
+      Test.class.getDeclaredMethod("$noinline$uFiller", int.class),
+      Test.class.getDeclaredMethod("$noinline$wTarget", int.class),
+    };
+  }
+
+  public static int $noinline$aCaller(int x) {
+    return $noinline$eCallee(x) + 1;
+  }
+
+  public static int $noinline$bFiller(int x) {
+    return x * 3;
+  }
+
+  public static int $noinline$cFiller(int x) {
+    return x * 5;
+  }
+
+  public static int $noinline$dFiller(int x) {
+    return x * 7;
+  }
+
+  public static int $noinline$eCallee(int x) {
+    return x * 11;
+  }
+
+  public static int $noinline$fVirtualCaller(Test t, int x) {
+    return t.$noinline$wTarget(x) + 1;
+  }
+
+  public int $noinline$uFiller(int x) {
+    return x * 13;
+  }
+
+  public int $noinline$wTarget(int x) {
+    return x * 17;
+  }
+}